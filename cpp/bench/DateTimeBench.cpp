@@ -0,0 +1,100 @@
+// 时间编解码微基准：对比原先的 istringstream/get_time/mktime、put_time 路径与 util::DateTime。
+// 用法：quickgrab_datetime_bench [迭代次数]
+#include "quickgrab/util/DateTime.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using quickgrab::util::formatDateTime;
+using quickgrab::util::parseDateTime;
+
+// 防止编译器把被测代码整体优化掉
+volatile std::int64_t gSink = 0;
+
+std::string legacySanitize(std::string text) {
+    if (text.size() > 1 && text.front() == '\'' && text.back() == '\'') {
+        text = text.substr(1, text.size() - 2);
+    }
+    std::replace(text.begin(), text.end(), 'T', ' ');
+    if (auto dot = text.find('.'); dot != std::string::npos) {
+        text = text.substr(0, dot);
+    }
+    return text;
+}
+
+std::chrono::system_clock::time_point legacyParse(const std::string& input) {
+    std::tm tm{};
+    std::istringstream iss(legacySanitize(input));
+    iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+}
+
+std::string legacyFormat(std::chrono::system_clock::time_point tp) {
+    auto tt = std::chrono::system_clock::to_time_t(tp);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &tt);
+#else
+    localtime_r(&tt, &tm);
+#endif
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    return oss.str();
+}
+
+template <typename Fn>
+void run(const char* name, std::size_t iterations, Fn&& fn) {
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    std::printf("%-28s %10.1f ns/op %12.0f ops/s\n", name, elapsed / static_cast<double>(iterations),
+                static_cast<double>(iterations) * 1e9 / elapsed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    // 取一年内分布的时间点，模拟不同行的时间列
+    std::vector<std::chrono::system_clock::time_point> points;
+    std::vector<std::string> texts;
+    const auto base = std::chrono::system_clock::now();
+    for (int i = 0; i < 1024; ++i) {
+        points.push_back(base - std::chrono::seconds(static_cast<std::int64_t>(i) * 30'817));
+        texts.push_back(formatDateTime(points.back()));
+    }
+    const auto mask = points.size() - 1;
+
+    run("legacy parse (get_time)", iterations, [&](std::size_t i) {
+        gSink = gSink + legacyParse(texts[i & mask]).time_since_epoch().count();
+    });
+    run("util::parseDateTime", iterations, [&](std::size_t i) {
+        gSink = gSink + parseDateTime(texts[i & mask])->time_since_epoch().count();
+    });
+    run("legacy format (put_time)", iterations, [&](std::size_t i) {
+        gSink = gSink + static_cast<std::int64_t>(legacyFormat(points[i & mask]).size());
+    });
+    run("util::formatDateTime", iterations, [&](std::size_t i) {
+        gSink = gSink + static_cast<std::int64_t>(formatDateTime(points[i & mask]).size());
+    });
+    run("formatDateTimeMillis (buf)", iterations, [&](std::size_t) {
+        char buffer[quickgrab::util::kDateTimeMillisLength];
+        gSink = gSink + static_cast<std::int64_t>(
+                            quickgrab::util::formatDateTimeMillis(std::chrono::system_clock::now(), buffer));
+    });
+    return 0;
+}
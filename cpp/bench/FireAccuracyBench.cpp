@@ -0,0 +1,451 @@
+// 定时精度回归基准：经 GrabService（handleRequest 入库 + processPending 扫描 → executeGrab）对本地模拟上游
+// 布置数千个定时抢购，同时施加竞争负载（捡漏模式轮询占用 worker、列表分页查询、日志刷屏），
+// 输出每个抢购的触发偏差直方图、服务端首单到达偏差与 worker 排队延迟，p99 超过阈值时以非零状态退出。
+// 需要本地 MySQL（QUICKGRAB_DB_HOST/PORT/USER/PASSWORD/NAME，库默认 quickgrab_bench，表结构同 sql/），
+// 插入的请求在结束时删除。
+// 用法：quickgrab_fire_accuracy_bench --grabs=2000 --lead-ms=15000 --spread-ms=10000 --max-p99-ms=20
+//         [--pickers=8] [--listers=2] [--loggers=2] [--workers=16] [--buyer-id=1] [--keep]
+#include "mock/MockUpstream.hpp"
+#include "mock/TestCertificate.hpp"
+
+#include "quickgrab/model/Request.hpp"
+#include "quickgrab/proxy/ProxyPool.hpp"
+#include "quickgrab/repository/DatabaseConfig.hpp"
+#include "quickgrab/repository/DatabaseExecutor.hpp"
+#include "quickgrab/repository/MySqlConnectionPool.hpp"
+#include "quickgrab/repository/RequestsRepository.hpp"
+#include "quickgrab/repository/ResultsRepository.hpp"
+#include "quickgrab/service/GrabEventBus.hpp"
+#include "quickgrab/service/GrabService.hpp"
+#include "quickgrab/service/MailService.hpp"
+#include "quickgrab/util/CommonUtil.hpp"
+#include "quickgrab/util/HttpClient.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
+#include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/Metrics.hpp"
+#include "quickgrab/util/WeidianParser.hpp"
+#include "quickgrab/workflow/GrabWorkflow.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using namespace quickgrab;
+using Clock = std::chrono::system_clock;
+
+std::optional<std::string_view> option(int argc, char** argv, std::string_view name) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg.substr(0, 2) != "--" || arg.substr(2, name.size()) != name) {
+            continue;
+        }
+        if (arg.size() == name.size() + 2) {
+            return std::string_view{};
+        }
+        if (arg[name.size() + 2] == '=') {
+            return arg.substr(name.size() + 3);
+        }
+    }
+    return std::nullopt;
+}
+
+long long intOption(int argc, char** argv, std::string_view name, long long fallback) {
+    auto value = option(argc, argv, name);
+    return value && !value->empty() ? std::strtoll(std::string(*value).c_str(), nullptr, 10) : fallback;
+}
+
+double doubleOption(int argc, char** argv, std::string_view name, double fallback) {
+    auto value = option(argc, argv, name);
+    return value && !value->empty() ? std::strtod(std::string(*value).c_str(), nullptr) : fallback;
+}
+
+repository::DatabaseConfig databaseConfig() {
+    repository::DatabaseConfig config;
+    config.host = "127.0.0.1";
+    config.user = "root";
+    config.database = "quickgrab_bench";
+    if (const char* value = std::getenv("QUICKGRAB_DB_HOST")) config.host = value;
+    if (const char* value = std::getenv("QUICKGRAB_DB_PORT")) config.port = static_cast<std::uint16_t>(std::strtoul(value, nullptr, 10));
+    if (const char* value = std::getenv("QUICKGRAB_DB_USER")) config.user = value;
+    if (const char* value = std::getenv("QUICKGRAB_DB_PASSWORD")) config.password = value;
+    if (const char* value = std::getenv("QUICKGRAB_DB_NAME")) config.database = value;
+    return config;
+}
+
+// 最近秩法，values 须已排序；单位毫秒
+double percentile(const std::vector<double>& values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const auto rank = static_cast<std::size_t>(q * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(rank, values.size() - 1)];
+}
+
+void report(const char* name, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    if (values.empty()) {
+        std::printf("%-28s 无样本\n", name);
+        return;
+    }
+    std::printf("%-28s n=%-5zu p50=%9.3fms p99=%9.3fms min=%9.3fms max=%9.3fms\n", name, values.size(),
+                percentile(values, 0.50), percentile(values, 0.99), values.front(), values.back());
+}
+
+// 两次快照之差，只统计本轮布置的抢购
+util::Histogram::Snapshot delta(const util::Histogram::Snapshot& after, const util::Histogram::Snapshot& before) {
+    util::Histogram::Snapshot result = after;
+    result.count -= before.count;
+    result.sumMicros -= before.sumMicros;
+    for (std::size_t i = 0; i < result.buckets.size(); ++i) {
+        result.buckets[i] -= before.buckets[i];
+    }
+    return result;
+}
+
+// 按桶打印非空区间及其占比条形
+void printHistogram(const char* name, const util::Histogram::Snapshot& snapshot) {
+    std::printf("%s（n=%llu）\n", name, static_cast<unsigned long long>(snapshot.count));
+    std::uint64_t widest = 1;
+    for (auto bucket : snapshot.buckets) {
+        widest = std::max(widest, bucket);
+    }
+    std::uint64_t lower = 0;
+    for (std::size_t i = 0; i < snapshot.buckets.size(); ++i) {
+        const auto upper = util::Histogram::bucketUpperBound(i);
+        const auto bucket = snapshot.buckets[i];
+        if (bucket != 0) {
+            const auto bar = static_cast<int>(40.0 * static_cast<double>(bucket) / static_cast<double>(widest) + 0.5);
+            std::printf("  %9.3f ~ %9.3fms %7llu %5.1f%% %.*s\n", static_cast<double>(lower) / 1000.0,
+                        static_cast<double>(upper) / 1000.0, static_cast<unsigned long long>(bucket),
+                        100.0 * static_cast<double>(bucket) / static_cast<double>(snapshot.count), bar,
+                        "########################################");
+        }
+        lower = upper;
+    }
+}
+
+double millisBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    util::initLogging(option(argc, argv, "verbose") ? util::LogLevel::info : util::LogLevel::warn);
+
+    const int grabs = static_cast<int>(std::max<long long>(1, intOption(argc, argv, "grabs", 2000)));
+    const auto lead = std::chrono::milliseconds(std::max<long long>(1000, intOption(argc, argv, "lead-ms", 15000)));
+    const auto spread = std::chrono::milliseconds(std::max<long long>(0, intOption(argc, argv, "spread-ms", 10000)));
+    const int pickers = static_cast<int>(std::max<long long>(0, intOption(argc, argv, "pickers", 8)));
+    const int listers = static_cast<int>(std::max<long long>(0, intOption(argc, argv, "listers", 2)));
+    const int loggers = static_cast<int>(std::max<long long>(0, intOption(argc, argv, "loggers", 2)));
+    const int buyerId = static_cast<int>(intOption(argc, argv, "buyer-id", 1));
+    const double maxP99Ms = doubleOption(argc, argv, "max-p99-ms", 20.0);
+    const bool keep = option(argc, argv, "keep").has_value();
+
+    const std::vector<std::string> hosts{"thor.weidian.com", "weidian.com"};
+    const auto certificate = mock::generateTestCertificate(hosts);
+    const auto armedAt = Clock::now();
+    const auto windowEnd = armedAt + lead + spread + std::chrono::seconds(2);
+
+    mock::MockUpstreamConfig upstreamConfig;
+    upstreamConfig.threads = static_cast<std::size_t>(intOption(argc, argv, "upstream-threads", 4));
+    upstreamConfig.latency = std::chrono::microseconds(intOption(argc, argv, "latency-us", 2000));
+    upstreamConfig.latencyJitter = std::chrono::microseconds(intOption(argc, argv, "jitter-us", 1000));
+    upstreamConfig.stock = grabs * 10;
+    mock::MockUpstream upstream(upstreamConfig, certificate);
+    upstream.start();
+
+    // 捡漏轮询单独对着一个始终无货的上游，保证它们整窗口占用 worker 而不会提前下单结束
+    mock::MockUpstreamConfig soldOutConfig = upstreamConfig;
+    soldOutConfig.threads = 2;
+    soldOutConfig.stockAt = windowEnd + std::chrono::hours(1);
+    mock::MockUpstream soldOut(soldOutConfig, certificate);
+    soldOut.start();
+
+    boost::asio::io_context io;
+    auto guard = boost::asio::make_work_guard(io);
+    std::vector<std::thread> ioThreads;
+    for (int i = 0; i < 2; ++i) {
+        ioThreads.emplace_back([&io] { io.run(); });
+    }
+    boost::asio::thread_pool worker(static_cast<std::size_t>(intOption(argc, argv, "workers", 16)));
+    proxy::ProxyPool proxyPool(std::chrono::seconds{1});
+
+    util::HttpClient httpClient(io, proxyPool);
+    util::HttpClient pickClient(io, proxyPool);
+    for (const auto& host : hosts) {
+        httpClient.overrideHost(host, upstream.address(), upstream.port());
+        pickClient.overrideHost(host, soldOut.address(), soldOut.port());
+    }
+    httpClient.trustCertificateAuthority(certificate.caPem);
+    pickClient.trustCertificateAuthority(certificate.caPem);
+
+    const auto dbConfig = databaseConfig();
+    repository::MySqlConnectionPool pool(dbConfig);
+    repository::RequestsRepository requests(pool);
+    repository::ResultsRepository results(pool);
+    repository::DatabaseExecutor database(dbConfig.poolSize, dbConfig.executorQueueLimit);
+
+    const auto spool = std::filesystem::temp_directory_path() / "quickgrab_fire_accuracy_outbox";
+    service::MailService::Config mailConfig;
+    mailConfig.spoolDirectory = spool;
+    service::MailService mailService(mailConfig);
+    service::GrabEventBus eventBus;
+    service::GrabService grabService(io, worker, database, requests, results, httpClient, proxyPool, mailService,
+                                     eventBus);
+    workflow::GrabWorkflow pickWorkflow(io, worker, pickClient, proxyPool);
+
+    const auto page = upstream.handle("GET", "/buy/add-order/index.php?itemId=7250000000", "", "");
+    const auto pageData = util::extractDataObject(page.body);
+    upstream.clearRecords();
+    if (!pageData || !pageData->is_object()) {
+        std::fprintf(stderr, "模拟加购页缺少 data-obj\n");
+        return 1;
+    }
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::unordered_set<int> armed;
+    std::size_t finished = 0;
+    eventBus.subscribe(std::nullopt, [&](const service::GrabEvent& event) {
+        if (event.kind != service::GrabEvent::Kind::result_created) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (armed.count(event.requestId) != 0) {
+            ++finished;
+            done.notify_all();
+        }
+    });
+
+    auto& fireHistogram = util::metrics().histogram(
+        "quickgrab_grab_fire_error_seconds", "Lateness of the first CreateOrder relative to its scheduled time");
+    const auto fireBefore = fireHistogram.snapshot();
+
+    // 开抢时刻按毫秒均匀铺开：startTime 取整秒，毫秒部分放进 delay（上报 adjustedFactor=100，无实测时延时提前 100ms）
+    std::unordered_map<std::string, Clock::time_point> plannedByCookie;
+    const auto firstFire = std::chrono::time_point_cast<std::chrono::seconds>(armedAt + lead) + std::chrono::seconds(1);
+    for (int i = 0; i < grabs; ++i) {
+        const auto offset = grabs > 1 ? spread * i / (grabs - 1) : std::chrono::milliseconds(0);
+        const auto fireAt = firstFire + std::chrono::duration_cast<std::chrono::milliseconds>(offset);
+        const auto second = std::chrono::time_point_cast<std::chrono::seconds>(fireAt);
+
+        model::Request request;
+        request.buyerId = buyerId;
+        request.type = 1;
+        request.quantity = 1;
+        request.status = 0;
+        request.startTime = second;
+        request.delay = 100 + static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(fireAt - second).count());
+        request.link = "https://weidian.com/buy/add-order/index.php?itemId=7250000000";
+        request.cookies = "wdtoken=fire-" + std::to_string(i);
+        request.extension = boost::json::object{{"domains", boost::json::array{"thor.weidian.com"}}, {"adjustedFactor", 100}};
+        auto params = util::generateOrderParameters(request, pageData->as_object(), false);
+        if (!params) {
+            std::fprintf(stderr, "生成订单参数失败\n");
+            return 1;
+        }
+        request.orderParameters = *params;
+
+        auto id = grabService.handleRequest(request);
+        if (!id) {
+            std::fprintf(stderr, "插入抢购请求失败，检查数据库配置\n");
+            return 1;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        armed.insert(*id);
+        plannedByCookie.emplace(request.cookies, fireAt);
+    }
+    std::printf("已布置 %d 个抢购，首个开抢距今 %.1fs，铺开 %.1fs\n", grabs,
+                millisBetween(Clock::now(), firstFire) / 1000.0, static_cast<double>(spread.count()) / 1000.0);
+
+    // 与服务进程相同的扫描节奏
+    std::atomic<bool> stopping{false};
+    boost::asio::steady_timer pump(io);
+    std::function<void()> schedulePump = [&] {
+        pump.expires_after(std::chrono::milliseconds(500));
+        pump.async_wait([&](const boost::system::error_code& ec) {
+            if (ec || stopping.load()) {
+                return;
+            }
+            grabService.processPending();
+            schedulePump();
+        });
+    };
+    boost::asio::post(io, [&] { grabService.processPending(); });
+    schedulePump();
+
+    // 竞争负载一：捡漏轮询，每个在窗口内独占一个 worker 线程
+    std::atomic<int> picksDone{0};
+    for (int i = 0; i < pickers; ++i) {
+        model::Request request;
+        request.id = 700000 + i;
+        request.buyerId = buyerId;
+        request.type = 3;
+        request.quantity = 1;
+        request.frequency = 200;
+        request.startTime = armedAt;
+        request.endTime = windowEnd;
+        request.link = "https://weidian.com/item.html?itemId=7250000000";
+        request.cookies = "wdtoken=pick-" + std::to_string(i);
+        request.orderParameters = boost::json::object{};
+        request.extension = boost::json::object{{"domains", boost::json::array{"thor.weidian.com"}}};
+        pickWorkflow.run(request, [&](const workflow::GrabResult&) { picksDone.fetch_add(1); });
+    }
+
+    // 竞争负载二：列表分页查询；三：日志刷屏
+    std::atomic<std::uint64_t> listPages{0};
+    std::atomic<std::uint64_t> logLines{0};
+    std::vector<std::thread> background;
+    for (int i = 0; i < listers; ++i) {
+        background.emplace_back([&, i] {
+            std::string body;
+            while (!stopping.load()) {
+                repository::ListPageRequest pageRequest;
+                pageRequest.orderColumn = i % 2 == 0 ? "id" : "start_time";
+                pageRequest.orderDirection = "DESC";
+                pageRequest.limit = 20;
+                try {
+                    for (int pageIndex = 0; pageIndex < 5 && !stopping.load(); ++pageIndex) {
+                        body.clear();
+                        util::JsonWriter writer(body);
+                        auto next = requests.writePage(pageRequest, writer);
+                        listPages.fetch_add(1, std::memory_order_relaxed);
+                        if (!next.next) {
+                            break;
+                        }
+                        pageRequest.after = next.next;
+                    }
+                } catch (const std::exception& ex) {
+                    QG_LOG_WARN("列表查询失败: {}", ex.what());
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+            }
+        });
+    }
+    for (int i = 0; i < loggers; ++i) {
+        background.emplace_back([&, i] {
+            std::uint64_t n = 0;
+            while (!stopping.load()) {
+                QG_LOG_WARN("定时精度基准日志负载 thread={} seq={} payload={}", i, n++, std::string(96, 'x'));
+                logLines.fetch_add(1, std::memory_order_relaxed);
+                if ((n & 63) == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+
+    // worker 排队延迟探针：定期投递空任务，记录从投递到开始执行的间隔
+    util::Histogram queueDelay;
+    background.emplace_back([&] {
+        while (!stopping.load()) {
+            const auto posted = std::chrono::steady_clock::now();
+            boost::asio::post(worker, [&queueDelay, posted] {
+                queueDelay.observe(std::chrono::steady_clock::now() - posted);
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    const auto deadline = windowEnd + std::chrono::seconds(30);
+    bool complete = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        complete = done.wait_until(lock, deadline, [&] { return finished == armed.size(); });
+    }
+
+    stopping.store(true);
+    boost::asio::post(io, [&] { pump.cancel(); });
+    for (auto& thread : background) {
+        thread.join();
+    }
+    worker.join();
+    guard.reset();
+    io.stop();
+    for (auto& thread : ioThreads) {
+        thread.join();
+    }
+    soldOut.stop();
+    upstream.stop();
+
+    std::unordered_map<std::string, Clock::time_point> firstArrival;
+    std::size_t succeeded = 0;
+    for (const auto& record : upstream.records()) {
+        if (record.endpoint != "CreateOrder") {
+            continue;
+        }
+        succeeded += record.outcome == "success" ? 1 : 0;
+        auto [it, inserted] = firstArrival.try_emplace(record.cookie, record.arrivedAt);
+        if (!inserted && record.arrivedAt < it->second) {
+            it->second = record.arrivedAt;
+        }
+    }
+    std::vector<double> arrival;
+    for (const auto& [cookie, planned] : plannedByCookie) {
+        if (auto it = firstArrival.find(cookie); it != firstArrival.end()) {
+            arrival.push_back(millisBetween(planned, it->second));
+        }
+    }
+
+    const auto fire = delta(fireHistogram.snapshot(), fireBefore);
+    const auto queue = queueDelay.snapshot();
+    const double fireP99 = fire.quantileMicros(0.99) / 1000.0;
+
+    std::printf("抢购 %d 个，完成 %zu，成功 %zu%s\n", grabs, finished, succeeded, complete ? "" : "（超时未全部完成）");
+    std::printf("背景负载：捡漏 %d 个（结束 %d），列表分页 %llu 次，日志 %llu 行\n", pickers, picksDone.load(),
+                static_cast<unsigned long long>(listPages.load()), static_cast<unsigned long long>(logLines.load()));
+    printHistogram("触发偏差分布(客户端)", fire);
+    std::printf("%-28s p50=%9.3fms p99=%9.3fms 均值=%9.3fms\n", "触发偏差(客户端)", fire.quantileMicros(0.50) / 1000.0,
+                fireP99,
+                fire.count != 0 ? static_cast<double>(fire.sumMicros) / static_cast<double>(fire.count) / 1000.0 : 0.0);
+    report("首单到达偏差(服务端)", arrival);
+    std::printf("%-28s n=%-5llu p50=%9.3fms p99=%9.3fms p99.9=%9.3fms\n", "worker 排队延迟",
+                static_cast<unsigned long long>(queue.count), queue.quantileMicros(0.50) / 1000.0,
+                queue.quantileMicros(0.99) / 1000.0, queue.quantileMicros(0.999) / 1000.0);
+
+    if (!keep) {
+        for (int id : armed) {
+            try {
+                requests.deleteById(id);
+            } catch (const std::exception& ex) {
+                QG_LOG_WARN("清理请求 id={} 失败: {}", id, ex.what());
+            }
+        }
+    }
+    util::shutdownLogging();
+
+    if (!complete || fire.count < static_cast<std::uint64_t>(grabs)) {
+        std::printf("失败：%llu/%d 个抢购记录了触发偏差\n", static_cast<unsigned long long>(fire.count), grabs);
+        return 1;
+    }
+    if (fireP99 > maxP99Ms) {
+        std::printf("失败：触发偏差 p99 %.3fms 超过阈值 %.3fms\n", fireP99, maxP99Ms);
+        return 1;
+    }
+    std::printf("通过：触发偏差 p99 %.3fms ≤ %.3fms\n", fireP99, maxP99Ms);
+    return 0;
+}
@@ -0,0 +1,286 @@
+// 开抢路径分配检查：对本地模拟上游用真实的 GrabWorkflow 布置定时抢购（预热直连 → armFire → fireCreateOrder），
+// 经 GrabWorkflow::setFireProbe 统计从定时器触发到预序列化的 CreateOrder 写出之间该 worker 线程的堆分配次数，
+// 任一次非零即以状态 1 退出。计数同时覆盖 operator new 与 OpenSSL 的 malloc/realloc（CRYPTO_set_mem_functions），
+// TLS 写出路径上的分配不会漏计。另给出逐次序列化（stringifyJson + toQuery + 构建 beast 请求）的旧路径开销作对比。
+// 用法：quickgrab_fire_path_bench [--iterations=200] [--gap-ms=10] [--latency-us=0]
+#include "mock/MockUpstream.hpp"
+#include "mock/TestCertificate.hpp"
+
+#include "quickgrab/model/Request.hpp"
+#include "quickgrab/proxy/ProxyPool.hpp"
+#include "quickgrab/util/CommonUtil.hpp"
+#include "quickgrab/util/HttpClient.hpp"
+#include "quickgrab/util/JsonUtil.hpp"
+#include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/WeidianParser.hpp"
+#include "quickgrab/workflow/GrabWorkflow.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+
+#include <openssl/crypto.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 按线程计数：模拟上游与 io 线程在同一进程内分配，不能混入被测线程
+thread_local std::uint64_t tAllocations = 0;
+
+// OpenSSL 的分配不经过 operator new，须在任何 OpenSSL 调用之前经 CRYPTO_set_mem_functions 接入计数
+void* countingMalloc(std::size_t size, const char*, int) {
+    ++tAllocations;
+    return std::malloc(size);
+}
+
+void* countingRealloc(void* ptr, std::size_t size, const char*, int) {
+    ++tAllocations;
+    return std::realloc(ptr, size);
+}
+
+void countingFree(void* ptr, const char*, int) {
+    std::free(ptr);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    ++tAllocations;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++tAllocations;
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void* ptr = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using namespace quickgrab;
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr char kFireDomain[] = "thor.weidian.com";
+
+std::optional<std::string_view> option(int argc, char** argv, std::string_view name) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg.size() > name.size() + 3 && arg.substr(0, 2) == "--" && arg.substr(2, name.size()) == name &&
+            arg[name.size() + 2] == '=') {
+            return arg.substr(name.size() + 3);
+        }
+    }
+    return std::nullopt;
+}
+
+// 与 GrabWorkflow::buildPost 相同的头部
+util::HttpClient::HttpRequest buildCreateOrder(const model::Request& request, const std::string& body) {
+    util::HttpClient::HttpRequest req{boost::beast::http::verb::post, "/vbuy/CreateOrder/1.0", 11};
+    req.set(boost::beast::http::field::host, kFireDomain);
+    req.set(boost::beast::http::field::content_type, "application/x-www-form-urlencoded;charset=UTF-8");
+    req.set(boost::beast::http::field::user_agent, "Android/9 WDAPP(WDBuyer/7.6.2) Thor/2.3.25");
+    req.set(boost::beast::http::field::referer, "https://android.weidian.com/");
+    req.set(boost::beast::http::field::cookie, request.cookies);
+    req.set("X-Quick-Scheme", "https");
+    req.body() = body;
+    req.prepare_payload();
+    return req;
+}
+
+double micros(SteadyClock::duration elapsed) {
+    return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+double percentile(std::vector<double> values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const auto rank = static_cast<std::size_t>(q * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(rank, values.size() - 1)];
+}
+
+// 触发到写出之间的一次观测；未经预热连接写出（退回普通路径）的抢购没有样本
+struct FireSample {
+    std::uint64_t allocations{};
+    double writeMicros{};
+};
+
+// 观测点在 worker 线程上成对调用，触发时刻与计数按线程保存
+thread_local std::uint64_t tFiredAllocations = 0;
+thread_local SteadyClock::time_point tFiredAt;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (CRYPTO_set_mem_functions(countingMalloc, countingRealloc, countingFree) == 0) {
+        std::fprintf(stderr, "无法接管 OpenSSL 内存分配（须在首次调用 OpenSSL 之前设置）\n");
+        return 1;
+    }
+    util::initLogging(util::LogLevel::error);
+    const int iterations = std::max(1, std::atoi(std::string(option(argc, argv, "iterations").value_or("200")).c_str()));
+    const auto gap = std::chrono::milliseconds(
+        std::max(1, std::atoi(std::string(option(argc, argv, "gap-ms").value_or("10")).c_str())));
+
+    const std::vector<std::string> hosts{kFireDomain, "weidian.com"};
+    const auto certificate = mock::generateTestCertificate(hosts);
+    mock::MockUpstreamConfig upstreamConfig;
+    upstreamConfig.latency = std::chrono::microseconds(
+        std::atoll(std::string(option(argc, argv, "latency-us").value_or("0")).c_str()));
+    upstreamConfig.latencyJitter = std::chrono::microseconds(0);
+    upstreamConfig.stock = iterations * 2;
+    mock::MockUpstream upstream(upstreamConfig, certificate);
+    upstream.start();
+
+    boost::asio::io_context io;
+    auto guard = boost::asio::make_work_guard(io);
+    std::thread ioThread([&io] { io.run(); });
+    // 单个 worker 线程：各次开抢的回调依次执行，观测点之间不会混入其他抢购
+    boost::asio::thread_pool worker(1);
+    proxy::ProxyPool proxyPool(std::chrono::seconds{1});
+    util::HttpClient httpClient(io, proxyPool);
+    for (const auto& host : hosts) {
+        httpClient.overrideHost(host, upstream.address(), upstream.port());
+    }
+    httpClient.trustCertificateAuthority(certificate.caPem);
+    workflow::GrabWorkflow workflow(io, worker, httpClient, proxyPool);
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<FireSample> samples;
+    samples.reserve(static_cast<std::size_t>(iterations));
+    workflow.setFireProbe([&](bool written) {
+        if (!written) {
+            tFiredAt = SteadyClock::now();
+            tFiredAllocations = tAllocations;
+            return;
+        }
+        const auto allocations = tAllocations - tFiredAllocations;
+        const auto writeMicros = micros(SteadyClock::now() - tFiredAt);
+        std::lock_guard<std::mutex> lock(mutex);
+        samples.push_back(FireSample{allocations, writeMicros});
+    });
+
+    const auto page = upstream.handle("GET", "/buy/add-order/index.php?itemId=7250000000", "", "");
+    const auto pageData = util::extractDataObject(page.body);
+    if (!pageData || !pageData->is_object()) {
+        std::fprintf(stderr, "模拟加购页缺少 data-obj\n");
+        return 1;
+    }
+    model::Request request;
+    request.id = 1;
+    request.buyerId = 1;
+    request.type = 1;
+    request.quantity = 1;
+    request.link = "https://weidian.com/buy/add-order/index.php?itemId=7250000000";
+    request.cookies = "wdtoken=fire-path";
+    request.extension = boost::json::object{{"domains", boost::json::array{kFireDomain}}};
+    auto params = util::generateOrderParameters(request, pageData->as_object(), false);
+    if (!params) {
+        std::fprintf(stderr, "生成订单参数失败\n");
+        return 1;
+    }
+    request.orderParameters = *params;
+
+    // 旧路径：每次下单都重新序列化参数并构建请求
+    std::uint64_t legacyAllocations = 0;
+    std::vector<double> legacyMicros;
+    for (int i = 0; i < iterations; ++i) {
+        const auto before = tAllocations;
+        const auto started = SteadyClock::now();
+        auto req = buildCreateOrder(request, util::toQuery(util::stringifyJson(*params)));
+        legacyMicros.push_back(micros(SteadyClock::now() - started));
+        legacyAllocations += tAllocations - before;
+        if (req.body().empty()) {
+            return 1;
+        }
+    }
+
+    // 开抢时刻在预热提前量（2s）之后依次错开，每个抢购都先预热直连再由定时器触发首个 CreateOrder
+    const auto firstFire = std::chrono::system_clock::now() + std::chrono::milliseconds(2500);
+    std::size_t finished = 0;
+    std::size_t failedOrders = 0;
+    for (int i = 0; i < iterations; ++i) {
+        model::Request grab = request;
+        grab.id = 800000 + i;
+        grab.cookies = "wdtoken=fire-path-" + std::to_string(i);
+        grab.startTime = firstFire + gap * i;
+        workflow.run(grab, [&](const workflow::GrabResult& result) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++finished;
+            failedOrders += result.success ? 0 : 1;
+            done.notify_all();
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return finished == static_cast<std::size_t>(iterations); });
+    }
+
+    worker.join();
+    guard.reset();
+    io.stop();
+    ioThread.join();
+    upstream.stop();
+
+    const std::size_t failedWrites = static_cast<std::size_t>(iterations) - samples.size();
+    std::uint64_t maxAllocations = 0;
+    std::vector<double> writeMicros;
+    for (const auto& sample : samples) {
+        maxAllocations = std::max(maxAllocations, sample.allocations);
+        writeMicros.push_back(sample.writeMicros);
+    }
+
+    std::printf("旧路径（序列化+构建请求）：每次 %.1f 次分配，p50=%.1fus p99=%.1fus\n",
+                static_cast<double>(legacyAllocations) / iterations, percentile(legacyMicros, 0.50),
+                percentile(legacyMicros, 0.99));
+    std::printf("GrabWorkflow 开抢（预序列化+预热连接）：触发到写出最多 %llu 次分配，p50=%.1fus p99=%.1fus\n",
+                static_cast<unsigned long long>(maxAllocations), percentile(writeMicros, 0.50),
+                percentile(writeMicros, 0.99));
+    std::printf("未经预热连接写出 %zu 次，下单未成功 %zu 次（共 %d 次）\n", failedWrites, failedOrders, iterations);
+    util::shutdownLogging();
+
+    if (maxAllocations != 0 || failedWrites != 0 || failedOrders != 0) {
+        std::printf("失败：开抢路径出现堆分配或请求未正确送达\n");
+        return 1;
+    }
+    std::printf("通过：开抢路径零堆分配\n");
+    return 0;
+}
@@ -0,0 +1,287 @@
+// 端到端抢购基准：本地启动模拟上游（可选经 CONNECT 代理），用真实的 GrabWorkflow/HttpClient 同时发起 N 个定时抢购，
+// 统计首个 CreateOrder 到达服务端的时刻相对计划开抢时刻的偏差，以及从计划开抢到拿到最终结果的耗时分布。
+// 用法：quickgrab_e2e_bench --grabs=50 --lead-ms=1500 --workers=16 --latency-us=2000 --jitter-us=1000
+//         [--failures=拥挤,确认] [--failure-rate=0.1] [--proxy] [--proxy-delay-us=500] [--record=e2e.qgc]
+#include "mock/MockConnectProxy.hpp"
+#include "mock/MockUpstream.hpp"
+#include "mock/TestCertificate.hpp"
+
+#include "quickgrab/model/Request.hpp"
+#include "quickgrab/proxy/ProxyPool.hpp"
+#include "quickgrab/util/CommonUtil.hpp"
+#include "quickgrab/util/HttpClient.hpp"
+#include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/Metrics.hpp"
+#include "quickgrab/util/WeidianParser.hpp"
+#include "quickgrab/workflow/GrabWorkflow.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace quickgrab;
+using Clock = std::chrono::system_clock;
+
+std::optional<std::string_view> option(int argc, char** argv, std::string_view name) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg.substr(0, 2) != "--" || arg.substr(2, name.size()) != name) {
+            continue;
+        }
+        if (arg.size() == name.size() + 2) {
+            return std::string_view{};
+        }
+        if (arg[name.size() + 2] == '=') {
+            return arg.substr(name.size() + 3);
+        }
+    }
+    return std::nullopt;
+}
+
+long long intOption(int argc, char** argv, std::string_view name, long long fallback) {
+    auto value = option(argc, argv, name);
+    return value && !value->empty() ? std::strtoll(std::string(*value).c_str(), nullptr, 10) : fallback;
+}
+
+double doubleOption(int argc, char** argv, std::string_view name, double fallback) {
+    auto value = option(argc, argv, name);
+    return value && !value->empty() ? std::strtod(std::string(*value).c_str(), nullptr) : fallback;
+}
+
+std::vector<std::string> parseFailures(std::string_view text) {
+    std::vector<std::string> failures;
+    while (!text.empty()) {
+        auto comma = text.find(',');
+        auto item = text.substr(0, comma);
+        if (item == "拥挤" || item == "crowded") {
+            failures.emplace_back(mock::kCrowdedMessage);
+        } else if (item == "重试" || item == "retry") {
+            failures.emplace_back(mock::kRetryMessage);
+        } else if (item == "确认" || item == "confirm") {
+            failures.emplace_back(mock::kConfirmMessage);
+        } else if (!item.empty()) {
+            failures.emplace_back(item);
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(comma + 1);
+    }
+    return failures;
+}
+
+// 最近秩法，values 须已排序；单位毫秒
+double percentile(const std::vector<double>& values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const auto rank = static_cast<std::size_t>(q * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(rank, values.size() - 1)];
+}
+
+void report(const char* name, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    if (values.empty()) {
+        std::printf("%-28s 无样本\n", name);
+        return;
+    }
+    std::printf("%-28s n=%-5zu p50=%9.3fms p99=%9.3fms min=%9.3fms max=%9.3fms\n", name, values.size(),
+                percentile(values, 0.50), percentile(values, 0.99), values.front(), values.back());
+}
+
+double millisBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    util::initLogging(option(argc, argv, "verbose") ? util::LogLevel::info : util::LogLevel::error);
+
+    const int grabs = static_cast<int>(std::max<long long>(1, intOption(argc, argv, "grabs", 50)));
+    const auto lead = std::chrono::milliseconds(intOption(argc, argv, "lead-ms", 1500));
+    // 无实测时延时按上报的 adjustedFactor 提前启动，这里固定为 100ms，delay=100 时计划开抢时刻恰为 startTime
+    const int delayMs = static_cast<int>(intOption(argc, argv, "delay-ms", 100));
+    const bool useProxy = option(argc, argv, "proxy").has_value();
+
+    const std::vector<std::string> hosts{"thor.weidian.com", "weidian.com"};
+    const auto certificate = mock::generateTestCertificate(hosts);
+    const auto startTime = Clock::now() + lead;
+
+    mock::MockUpstreamConfig upstreamConfig;
+    upstreamConfig.threads = static_cast<std::size_t>(intOption(argc, argv, "upstream-threads", 4));
+    upstreamConfig.latency = std::chrono::microseconds(intOption(argc, argv, "latency-us", 2000));
+    upstreamConfig.latencyJitter = std::chrono::microseconds(intOption(argc, argv, "jitter-us", 1000));
+    upstreamConfig.saleStart = startTime + std::chrono::milliseconds(intOption(argc, argv, "sale-offset-ms", 0));
+    upstreamConfig.stock = static_cast<int>(intOption(argc, argv, "stock", grabs * 10));
+    upstreamConfig.failureRate = doubleOption(argc, argv, "failure-rate", 0.0);
+    upstreamConfig.reconfirmSuccessRate = doubleOption(argc, argv, "reconfirm-rate", 1.0);
+    if (auto failures = option(argc, argv, "failures")) {
+        upstreamConfig.failureScript = parseFailures(*failures);
+    }
+    mock::MockUpstream upstream(upstreamConfig, certificate);
+    upstream.start();
+
+    std::optional<mock::MockConnectProxy> connectProxy;
+    if (useProxy) {
+        mock::MockConnectProxyConfig proxyConfig;
+        proxyConfig.username = "bench";
+        proxyConfig.password = "bench";
+        proxyConfig.connectDelay = std::chrono::microseconds(intOption(argc, argv, "proxy-delay-us", 0));
+        connectProxy.emplace(proxyConfig);
+        for (const auto& host : hosts) {
+            connectProxy->route(host + ":443", upstream.address(), upstream.port());
+        }
+        connectProxy->start();
+    }
+
+    boost::asio::io_context io;
+    auto guard = boost::asio::make_work_guard(io);
+    std::thread ioThread([&io] { io.run(); });
+    boost::asio::thread_pool worker(static_cast<std::size_t>(intOption(argc, argv, "workers", 16)));
+
+    proxy::ProxyPool proxyPool(std::chrono::seconds{1});
+    if (connectProxy) {
+        proxy::ProxyEndpoint endpoint;
+        endpoint.host = upstream.address();
+        endpoint.port = connectProxy->port();
+        endpoint.username = "bench";
+        endpoint.password = "bench";
+        endpoint.nextAvailable = std::chrono::steady_clock::now();
+        proxyPool.hydrate({endpoint});
+    }
+
+    util::HttpClient httpClient(io, proxyPool);
+    for (const auto& host : hosts) {
+        httpClient.overrideHost(host, upstream.address(), upstream.port());
+    }
+    httpClient.trustCertificateAuthority(certificate.caPem);
+    if (auto record = option(argc, argv, "record"); record && !record->empty()) {
+        httpClient.startRecording(std::string(*record));
+    }
+    workflow::GrabWorkflow workflow(io, worker, httpClient, proxyPool);
+
+    // 订单参数按模拟加购页生成，与线上 submit 流程一致
+    const auto page = upstream.handle("GET", "/buy/add-order/index.php?itemId=7250000000", "", "");
+    const auto pageData = util::extractDataObject(page.body);
+    upstream.clearRecords();
+    if (!pageData || !pageData->is_object()) {
+        std::fprintf(stderr, "模拟加购页缺少 data-obj\n");
+        return 1;
+    }
+
+    struct Outcome {
+        bool success{};
+        int attempts{};
+        Clock::time_point finishedAt;
+    };
+    std::mutex mutex;
+    std::condition_variable done;
+    std::unordered_map<std::string, Outcome> outcomes;
+
+    for (int i = 0; i < grabs; ++i) {
+        model::Request request;
+        request.id = 900000 + i;
+        request.buyerId = 1;
+        request.type = 1;
+        request.quantity = 1;
+        request.delay = delayMs;
+        request.startTime = startTime;
+        request.link = "https://weidian.com/buy/add-order/index.php?itemId=7250000000";
+        request.cookies = "wdtoken=bench-" + std::to_string(i);
+        boost::json::object extension{{"domains", boost::json::array{"thor.weidian.com"}}, {"adjustedFactor", 100}};
+        if (useProxy) {
+            extension["useProxy"] = true;
+            extension["proxyAffinity"] = "bench-" + std::to_string(i);
+        }
+        request.extension = extension;
+        auto params = util::generateOrderParameters(request, pageData->as_object(), false);
+        if (!params) {
+            std::fprintf(stderr, "生成订单参数失败\n");
+            return 1;
+        }
+        request.orderParameters = *params;
+
+        const auto cookie = request.cookies;
+        workflow.run(request, [&, cookie](const workflow::GrabResult& result) {
+            std::lock_guard<std::mutex> lock(mutex);
+            outcomes[cookie] = Outcome{result.success, result.attempts, Clock::now()};
+            done.notify_all();
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return outcomes.size() == static_cast<std::size_t>(grabs); });
+    }
+
+    worker.join();
+    guard.reset();
+    io.stop();
+    ioThread.join();
+    if (connectProxy) {
+        connectProxy->stop();
+    }
+    upstream.stop();
+
+    const auto plannedFire = startTime + std::chrono::milliseconds(delayMs - 100);
+    std::unordered_map<std::string, Clock::time_point> firstArrival;
+    for (const auto& record : upstream.records()) {
+        if (record.endpoint != "CreateOrder") {
+            continue;
+        }
+        auto [it, inserted] = firstArrival.try_emplace(record.cookie, record.arrivedAt);
+        if (!inserted && record.arrivedAt < it->second) {
+            it->second = record.arrivedAt;
+        }
+    }
+
+    std::vector<double> arrival;
+    std::vector<double> timeToOrder;
+    std::size_t succeeded = 0;
+    double attempts = 0;
+    for (const auto& [cookie, outcome] : outcomes) {
+        if (auto it = firstArrival.find(cookie); it != firstArrival.end()) {
+            arrival.push_back(millisBetween(plannedFire, it->second));
+        }
+        if (outcome.success) {
+            ++succeeded;
+            timeToOrder.push_back(millisBetween(plannedFire, outcome.finishedAt));
+        }
+        attempts += outcome.attempts;
+    }
+
+    std::printf("抢购数 %d，成功 %zu，平均尝试 %.2f 次%s\n", grabs, succeeded, attempts / grabs,
+                useProxy ? "（经 CONNECT 代理）" : "");
+    report("首单到达偏差(服务端)", arrival);
+    const auto fire = util::metrics()
+                          .histogram("quickgrab_grab_fire_error_seconds",
+                                     "Lateness of the first CreateOrder relative to its scheduled time")
+                          .snapshot();
+    std::printf("%-28s n=%-5llu p50=%9.3fms p99=%9.3fms\n", "定时器触发偏差(客户端)",
+                static_cast<unsigned long long>(fire.count), fire.quantileMicros(0.50) / 1000.0,
+                fire.quantileMicros(0.99) / 1000.0);
+    report("下单耗时(成功)", timeToOrder);
+    if (connectProxy) {
+        std::printf("代理隧道 %llu 条，拒绝 %llu 次\n", static_cast<unsigned long long>(connectProxy->tunnels()),
+                    static_cast<unsigned long long>(connectProxy->rejected()));
+    }
+    util::shutdownLogging();
+    return 0;
+}
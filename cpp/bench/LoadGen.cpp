@@ -0,0 +1,507 @@
+// 入站 API 压测：按配置的比例混合登录、submitRequest、键集分页列表、统计与透传接口，
+// 输出各类请求的吞吐与延迟分位数。--submit-steps 逐级提高提交速率，每级结束后抓取服务端 /metrics 中
+// quickgrab_grab_fire_error_seconds 的增量，得到“每秒提交多少单之后开抢精度开始劣化”。
+// 被测服务应指向模拟上游与本地 MySQL：先运行 quickgrab_mock_upstream，按其提示设置
+// QUICKGRAB_UPSTREAM_OVERRIDE / QUICKGRAB_UPSTREAM_CA 后启动 quickgrab_server。
+// 用法：quickgrab_loadgen --username=bench --password=bench [--host=127.0.0.1] [--port=8080]
+//         [--connections=16] [--duration-s=30] [--rate=0] [--mix=login:1,submit:5,list:20,stats:5,passthrough:5]
+//         [--submit-steps=5,10,20,50] [--step-s=20] [--fire-lead-ms=3000] [--pages=3]
+// --rate 为混合流量的总请求速率（0 表示闭环、每个连接收到响应后立即发下一个）；
+// 开环模式下延迟从计划发送时刻算起，避免协调遗漏。
+#include "quickgrab/util/DateTime.hpp"
+#include "quickgrab/util/Metrics.hpp"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace beast = boost::beast;
+namespace http = boost::beast::http;
+using tcp = boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using quickgrab::util::Histogram;
+
+enum class Kind : std::size_t { login, submit, list, stats, passthrough, count };
+
+constexpr std::array<const char*, static_cast<std::size_t>(Kind::count)> kKindNames{
+    "login", "submit", "list", "stats", "passthrough"};
+
+using Weights = std::array<double, static_cast<std::size_t>(Kind::count)>;
+
+struct Options {
+    std::string host{"127.0.0.1"};
+    std::string port{"8080"};
+    std::string username;
+    std::string password;
+    std::size_t connections{16};
+    std::chrono::seconds duration{30};
+    double rate{0};
+    Weights mix{1, 5, 20, 5, 5};
+    std::vector<double> submitSteps;
+    std::chrono::seconds stepDuration{20};
+    std::chrono::milliseconds fireLead{3000};
+    int pages{3};
+    std::string link{"https://weidian.com/buy/add-order/index.php?itemId=7250000000"};
+    std::string itemId{"7250000000"};
+};
+
+struct KindStats {
+    Histogram latency;
+    std::atomic<std::uint64_t> ok{0};
+    std::atomic<std::uint64_t> httpErrors{0};
+    std::atomic<std::uint64_t> transportErrors{0};
+};
+
+struct StageStats {
+    std::array<KindStats, static_cast<std::size_t>(Kind::count)> kinds;
+};
+
+std::optional<std::string_view> option(int argc, char** argv, std::string_view name) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg.size() > name.size() + 3 && arg.substr(0, 2) == "--" && arg.substr(2, name.size()) == name &&
+            arg[name.size() + 2] == '=') {
+            return arg.substr(name.size() + 3);
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::string_view> split(std::string_view text, char delimiter) {
+    std::vector<std::string_view> parts;
+    while (!text.empty()) {
+        auto pos = text.find(delimiter);
+        parts.push_back(text.substr(0, pos));
+        if (pos == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(pos + 1);
+    }
+    return parts;
+}
+
+double toDouble(std::string_view text) {
+    return std::strtod(std::string(text).c_str(), nullptr);
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    if (auto v = option(argc, argv, "host")) options.host = std::string(*v);
+    if (auto v = option(argc, argv, "port")) options.port = std::string(*v);
+    if (auto v = option(argc, argv, "username")) options.username = std::string(*v);
+    if (auto v = option(argc, argv, "password")) options.password = std::string(*v);
+    if (auto v = option(argc, argv, "connections")) options.connections = std::max<std::size_t>(1, static_cast<std::size_t>(toDouble(*v)));
+    if (auto v = option(argc, argv, "duration-s")) options.duration = std::chrono::seconds(static_cast<long>(toDouble(*v)));
+    if (auto v = option(argc, argv, "rate")) options.rate = toDouble(*v);
+    if (auto v = option(argc, argv, "step-s")) options.stepDuration = std::chrono::seconds(static_cast<long>(toDouble(*v)));
+    if (auto v = option(argc, argv, "fire-lead-ms")) options.fireLead = std::chrono::milliseconds(static_cast<long>(toDouble(*v)));
+    if (auto v = option(argc, argv, "pages")) options.pages = std::max(1, static_cast<int>(toDouble(*v)));
+    if (auto v = option(argc, argv, "link")) options.link = std::string(*v);
+    if (auto v = option(argc, argv, "item-id")) options.itemId = std::string(*v);
+    if (auto v = option(argc, argv, "mix")) {
+        options.mix.fill(0);
+        for (auto part : split(*v, ',')) {
+            auto colon = part.find(':');
+            auto name = part.substr(0, colon);
+            for (std::size_t i = 0; i < kKindNames.size(); ++i) {
+                if (name == kKindNames[i]) {
+                    options.mix[i] = colon == std::string_view::npos ? 1.0 : toDouble(part.substr(colon + 1));
+                }
+            }
+        }
+    }
+    if (auto v = option(argc, argv, "submit-steps")) {
+        for (auto part : split(*v, ',')) {
+            if (!part.empty()) {
+                options.submitSteps.push_back(toDouble(part));
+            }
+        }
+    }
+    return options;
+}
+
+std::string urlEncode(std::string_view value) {
+    static constexpr char hex[] = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : value) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            out.push_back(static_cast<char>(c));
+        } else {
+            out.push_back('%');
+            out.push_back(hex[c >> 4]);
+            out.push_back(hex[c & 0x0F]);
+        }
+    }
+    return out;
+}
+
+// 每个压测线程独占一条 keep-alive 连接，出错时重连
+class Connection {
+public:
+    explicit Connection(const Options& options) : options_(options), stream_(io_) {}
+
+    http::response<http::string_body> send(http::verb method,
+                                           std::string target,
+                                           std::string body,
+                                           const char* contentType,
+                                           const std::string& cookie) {
+        http::request<http::string_body> request{method, target, 11};
+        request.set(http::field::host, options_.host + ":" + options_.port);
+        request.set(http::field::user_agent, "quickgrab-loadgen");
+        request.keep_alive(true);
+        if (!cookie.empty()) {
+            request.set(http::field::cookie, cookie);
+        }
+        if (!body.empty()) {
+            request.set(http::field::content_type, contentType);
+            request.body() = std::move(body);
+        }
+        request.prepare_payload();
+
+        for (int attempt = 0;; ++attempt) {
+            try {
+                if (!connected_) {
+                    tcp::resolver resolver(io_);
+                    stream_.connect(resolver.resolve(options_.host, options_.port));
+                    stream_.socket().set_option(tcp::no_delay(true));
+                    connected_ = true;
+                }
+                stream_.expires_after(std::chrono::seconds(30));
+                http::write(stream_, request);
+                http::response<http::string_body> response;
+                http::read(stream_, buffer_, response);
+                if (!response.keep_alive()) {
+                    reset();
+                }
+                return response;
+            } catch (const std::exception&) {
+                reset();
+                // 服务端关闭空闲连接后首次写入失败属正常，重试一次
+                if (attempt > 0) {
+                    throw;
+                }
+            }
+        }
+    }
+
+private:
+    void reset() {
+        beast::error_code ignored;
+        stream_.socket().shutdown(tcp::socket::shutdown_both, ignored);
+        stream_.close();
+        buffer_.clear();
+        connected_ = false;
+    }
+
+    const Options& options_;
+    boost::asio::io_context io_;
+    beast::tcp_stream stream_;
+    beast::flat_buffer buffer_;
+    bool connected_{false};
+};
+
+std::string sessionCookieFrom(const http::response<http::string_body>& response) {
+    for (const auto& field : response.base()) {
+        if (field.name() != http::field::set_cookie) {
+            continue;
+        }
+        std::string_view value(field.value().data(), field.value().size());
+        return std::string(value.substr(0, value.find(';')));
+    }
+    return {};
+}
+
+std::string login(Connection& connection, const Options& options) {
+    auto response = connection.send(http::verb::post, "/api/login",
+                                    "username=" + urlEncode(options.username) + "&password=" +
+                                        urlEncode(options.password) + "&rememberMe=false",
+                                    "application/x-www-form-urlencoded", {});
+    if (response.result() != http::status::ok) {
+        throw std::runtime_error("登录失败: HTTP " + std::to_string(response.result_int()) + " " + response.body());
+    }
+    return sessionCookieFrom(response);
+}
+
+// 开抢时刻落在 now + fireLead 附近；startTime 只有秒精度，毫秒部分通过 delay 表达
+// （上报 adjustedFactor=100，无实测时延时 GrabWorkflow 在 startTime + delay - 100ms 开抢）
+std::string submitBody(const Options& options, std::uint64_t sequence) {
+    const auto fireAt = std::chrono::system_clock::now() + options.fireLead;
+    const auto seconds = std::chrono::floor<std::chrono::seconds>(fireAt);
+    const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(fireAt - seconds).count();
+    std::string body;
+    body.reserve(512);
+    body.append("{\"link\":\"").append(options.link).append("\",\"cookies\":\"wdtoken=loadgen-")
+        .append(std::to_string(sequence)).append("\",\"startTime\":\"")
+        .append(quickgrab::util::formatDateTime(seconds)).append("\",\"delay\":")
+        .append(std::to_string(100 + millis))
+        .append(",\"type\":1,\"quantity\":1,\"message\":\"loadgen\",\"extension\":{\"domains\":[\"thor.weidian.com\"],\"adjustedFactor\":100}}");
+    return body;
+}
+
+// 从 {"...","nextCursor":"..."} 中取出游标，避免为压测工具引入 JSON 解析
+std::string nextCursorFrom(std::string_view body) {
+    constexpr std::string_view key = "\"nextCursor\":\"";
+    auto pos = body.find(key);
+    if (pos == std::string_view::npos) {
+        return {};
+    }
+    pos += key.size();
+    auto end = body.find('"', pos);
+    return end == std::string_view::npos ? std::string{} : std::string(body.substr(pos, end - pos));
+}
+
+std::atomic<std::uint64_t> gSubmitSequence{0};
+
+// 执行一个请求（list 为一串分页请求），返回是否得到 2xx
+bool execute(Kind kind, Connection& connection, const Options& options, const std::string& cookie, std::mt19937& rng) {
+    http::response<http::string_body> response;
+    switch (kind) {
+    case Kind::login:
+        return !login(connection, options).empty();
+    case Kind::submit:
+        response = connection.send(http::verb::post, "/api/submitRequest",
+                                   submitBody(options, gSubmitSequence.fetch_add(1)), "application/json", cookie);
+        break;
+    case Kind::list: {
+        const char* endpoint = (rng() & 1) ? "/api/getRequests" : "/api/getResults";
+        std::string cursor;
+        for (int page = 0; page < options.pages; ++page) {
+            response = connection.send(http::verb::get,
+                                       std::string(endpoint) + "?view=summary&limit=20&cursor=" + urlEncode(cursor),
+                                       {}, {}, cookie);
+            cursor = nextCursorFrom(response.body());
+            if (response.result_int() >= 300 || cursor.empty()) {
+                break;
+            }
+        }
+        break;
+    }
+    case Kind::stats: {
+        static constexpr std::array<const char*, 3> targets{"/api/statistics", "/api/dailyStats", "/api/hourlyStats"};
+        response = connection.send(http::verb::get, targets[rng() % targets.size()], {}, {}, cookie);
+        break;
+    }
+    case Kind::passthrough:
+        response = connection.send(http::verb::get,
+                                   "/api/getItemSkuInfo?param=" + urlEncode("{\"itemId\":\"" + options.itemId + "\"}"),
+                                   {}, {}, cookie);
+        break;
+    case Kind::count:
+        return false;
+    }
+    return response.result_int() < 300;
+}
+
+// 一组连接按 weights 抽样请求类型；rate > 0 时按总速率均分到各连接做开环调度
+void runGroup(const Options& options,
+              const Weights& weights,
+              std::size_t connections,
+              double rate,
+              std::chrono::seconds duration,
+              const std::string& cookie,
+              StageStats& stats) {
+    if (std::all_of(weights.begin(), weights.end(), [](double w) { return w <= 0; })) {
+        return;
+    }
+    const auto deadline = Clock::now() + duration;
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < connections; ++i) {
+        threads.emplace_back([&, i] {
+            std::mt19937 rng(static_cast<std::uint32_t>(i * 7919 + 17));
+            std::discrete_distribution<std::size_t> pick(weights.begin(), weights.end());
+            Connection connection(options);
+            const auto interval = rate > 0
+                                      ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+                                            static_cast<double>(connections) / rate))
+                                      : Clock::duration::zero();
+            // 错开各连接的起点，避免整齐的突发
+            auto scheduled = Clock::now() + (rate > 0 ? interval * static_cast<long>(i) / static_cast<long>(connections) : Clock::duration::zero());
+            while (scheduled < deadline && Clock::now() < deadline) {
+                if (rate > 0) {
+                    std::this_thread::sleep_until(scheduled);
+                } else {
+                    scheduled = Clock::now();
+                }
+                const auto kind = static_cast<Kind>(pick(rng));
+                auto& kindStats = stats.kinds[static_cast<std::size_t>(kind)];
+                try {
+                    if (execute(kind, connection, options, cookie, rng)) {
+                        kindStats.ok.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        kindStats.httpErrors.fetch_add(1, std::memory_order_relaxed);
+                    }
+                } catch (const std::exception&) {
+                    kindStats.transportErrors.fetch_add(1, std::memory_order_relaxed);
+                }
+                kindStats.latency.observe(Clock::now() - scheduled);
+                scheduled += interval;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void report(const StageStats& stats, double seconds) {
+    std::printf("%-12s %10s %8s %8s %10s %10s %10s %10s\n", "kind", "req/s", "http_err", "io_err", "p50(ms)",
+                "p90(ms)", "p99(ms)", "mean(ms)");
+    for (std::size_t i = 0; i < kKindNames.size(); ++i) {
+        const auto& kind = stats.kinds[i];
+        const auto snapshot = kind.latency.snapshot();
+        if (snapshot.count == 0) {
+            continue;
+        }
+        std::printf("%-12s %10.1f %8llu %8llu %10.2f %10.2f %10.2f %10.2f\n", kKindNames[i],
+                    static_cast<double>(snapshot.count) / seconds,
+                    static_cast<unsigned long long>(kind.httpErrors.load()),
+                    static_cast<unsigned long long>(kind.transportErrors.load()),
+                    snapshot.quantileMicros(0.50) / 1000.0, snapshot.quantileMicros(0.90) / 1000.0,
+                    snapshot.quantileMicros(0.99) / 1000.0,
+                    static_cast<double>(snapshot.sumMicros) / static_cast<double>(snapshot.count) / 1000.0);
+    }
+}
+
+// 服务端 /metrics 中 quickgrab_grab_fire_error_seconds 的累计桶：le（秒）→ 计数
+std::map<double, double> scrapeFireError(Connection& connection) {
+    std::map<double, double> buckets;
+    auto response = connection.send(http::verb::get, "/metrics", {}, {}, {});
+    constexpr std::string_view prefix = "quickgrab_grab_fire_error_seconds_bucket{le=\"";
+    for (auto line : split(response.body(), '\n')) {
+        if (line.substr(0, prefix.size()) != prefix) {
+            continue;
+        }
+        line.remove_prefix(prefix.size());
+        const auto quote = line.find('"');
+        const auto le = line.substr(0, quote);
+        const auto space = line.rfind(' ');
+        if (quote == std::string_view::npos || space == std::string_view::npos) {
+            continue;
+        }
+        const double bound = le == "+Inf" ? std::numeric_limits<double>::infinity() : toDouble(le);
+        buckets[bound] = toDouble(line.substr(space + 1));
+    }
+    return buckets;
+}
+
+// 对两次抓取的累计桶做差，在桶内线性插值得到分位数（毫秒）
+double fireQuantile(const std::map<double, double>& before, const std::map<double, double>& after, double q, double& count) {
+    std::vector<std::pair<double, double>> cumulative;
+    for (const auto& [bound, value] : after) {
+        auto it = before.find(bound);
+        cumulative.emplace_back(bound, value - (it == before.end() ? 0.0 : it->second));
+    }
+    count = cumulative.empty() ? 0.0 : cumulative.back().second;
+    if (count <= 0) {
+        return 0.0;
+    }
+    const double rank = q * count;
+    double lowerBound = 0.0;
+    double lowerCount = 0.0;
+    for (const auto& [bound, value] : cumulative) {
+        if (value >= rank) {
+            if (std::isinf(bound)) {
+                return lowerBound * 1000.0;
+            }
+            const double width = value - lowerCount;
+            const double fraction = width > 0 ? (rank - lowerCount) / width : 1.0;
+            return (lowerBound + (bound - lowerBound) * fraction) * 1000.0;
+        }
+        lowerBound = bound;
+        lowerCount = value;
+    }
+    return lowerBound * 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parseOptions(argc, argv);
+    if (options.username.empty()) {
+        std::fprintf(stderr, "需要 --username/--password（用于登录并取得会话）\n");
+        return 2;
+    }
+
+    Connection control(options);
+    std::string cookie;
+    try {
+        cookie = login(control, options);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "%s\n", ex.what());
+        return 1;
+    }
+
+    if (options.submitSteps.empty()) {
+        StageStats stats;
+        const auto started = Clock::now();
+        runGroup(options, options.mix, options.connections, options.rate, options.duration, cookie, stats);
+        const double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+        std::printf("混合流量 %.1fs，%zu 个连接%s\n", seconds, options.connections,
+                    options.rate > 0 ? "（开环）" : "（闭环）");
+        report(stats, seconds);
+        return 0;
+    }
+
+    // 逐级提交：背景流量按 mix（不含 submit）持续，submit 由独立连接组按本级速率开环发送
+    Weights background = options.mix;
+    background[static_cast<std::size_t>(Kind::submit)] = 0;
+    Weights submitOnly{};
+    submitOnly[static_cast<std::size_t>(Kind::submit)] = 1;
+    const auto submitConnections = std::max<std::size_t>(4, options.connections / 2);
+
+    std::printf("%-10s %12s %14s %14s %12s %12s %10s\n", "submit/s", "achieved/s", "submit p99(ms)", "background/s",
+                "fire p50(ms)", "fire p99(ms)", "fired");
+    for (double step : options.submitSteps) {
+        const auto before = scrapeFireError(control);
+        StageStats stats;
+        const auto started = Clock::now();
+        std::thread submitter([&] {
+            runGroup(options, submitOnly, submitConnections, step, options.stepDuration, cookie, stats);
+        });
+        runGroup(options, background, options.connections, options.rate, options.stepDuration, cookie, stats);
+        submitter.join();
+        const double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+        // 等本级最后提交的抢购开抢完毕再抓取
+        std::this_thread::sleep_for(options.fireLead + std::chrono::seconds(2));
+        const auto after = scrapeFireError(control);
+        double fired = 0;
+        const double fireP50 = fireQuantile(before, after, 0.50, fired);
+        const double fireP99 = fireQuantile(before, after, 0.99, fired);
+
+        const auto submitSnapshot = stats.kinds[static_cast<std::size_t>(Kind::submit)].latency.snapshot();
+        std::uint64_t backgroundCount = 0;
+        for (std::size_t i = 0; i < kKindNames.size(); ++i) {
+            if (i != static_cast<std::size_t>(Kind::submit)) {
+                backgroundCount += stats.kinds[i].latency.snapshot().count;
+            }
+        }
+        std::printf("%-10.1f %12.1f %14.2f %14.1f %12.2f %12.2f %10.0f\n", step,
+                    static_cast<double>(submitSnapshot.count) / seconds, submitSnapshot.quantileMicros(0.99) / 1000.0,
+                    static_cast<double>(backgroundCount) / seconds, fireP50, fireP99, fired);
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,144 @@
+// 独立运行的本地模拟微店上游（可选附带 CONNECT 代理），用于手工联调或让真实服务进程对着它压测。
+// 用法：quickgrab_mock_upstream --port=8443 --latency-us=2000 --jitter-us=1000 --sale-in-ms=30000
+//         --failures=拥挤,重试,确认 --failure-rate=0.2 --stock=100 --ca-out=mock-ca.pem [--proxy-port=8080]
+// 启动后按提示设置 QUICKGRAB_UPSTREAM_OVERRIDE / QUICKGRAB_UPSTREAM_CA 再启动 quickgrab_server。
+#include "mock/MockConnectProxy.hpp"
+#include "mock/MockUpstream.hpp"
+#include "mock/TestCertificate.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/signal_set.hpp>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace quickgrab;
+
+std::optional<std::string_view> option(int argc, char** argv, std::string_view name) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg.size() > name.size() + 3 && arg.substr(0, 2) == "--" && arg.substr(2, name.size()) == name &&
+            arg[name.size() + 2] == '=') {
+            return arg.substr(name.size() + 3);
+        }
+    }
+    return std::nullopt;
+}
+
+long long intOption(int argc, char** argv, std::string_view name, long long fallback) {
+    auto value = option(argc, argv, name);
+    return value ? std::strtoll(std::string(*value).c_str(), nullptr, 10) : fallback;
+}
+
+double doubleOption(int argc, char** argv, std::string_view name, double fallback) {
+    auto value = option(argc, argv, name);
+    return value ? std::strtod(std::string(*value).c_str(), nullptr) : fallback;
+}
+
+// 拥挤/重试/确认 是三类提示的简写，其他文本原样作为 msg 返回
+std::vector<std::string> parseFailures(std::string_view text) {
+    std::vector<std::string> failures;
+    while (!text.empty()) {
+        auto comma = text.find(',');
+        auto item = text.substr(0, comma);
+        if (item == "拥挤" || item == "crowded") {
+            failures.emplace_back(mock::kCrowdedMessage);
+        } else if (item == "重试" || item == "retry") {
+            failures.emplace_back(mock::kRetryMessage);
+        } else if (item == "确认" || item == "confirm") {
+            failures.emplace_back(mock::kConfirmMessage);
+        } else if (!item.empty()) {
+            failures.emplace_back(item);
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(comma + 1);
+    }
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::vector<std::string> hosts{"thor.weidian.com", "weidian.com", "logtake.weidian.com"};
+    const auto certificate = mock::generateTestCertificate(hosts);
+    const auto now = std::chrono::system_clock::now();
+
+    mock::MockUpstreamConfig config;
+    config.port = static_cast<std::uint16_t>(intOption(argc, argv, "port", 8443));
+    config.threads = static_cast<std::size_t>(intOption(argc, argv, "threads", 2));
+    config.latency = std::chrono::microseconds(intOption(argc, argv, "latency-us", 2000));
+    config.latencyJitter = std::chrono::microseconds(intOption(argc, argv, "jitter-us", 1000));
+    config.saleStart = now + std::chrono::milliseconds(intOption(argc, argv, "sale-in-ms", 0));
+    config.stockAt = now + std::chrono::milliseconds(intOption(argc, argv, "stock-in-ms", 0));
+    config.stock = static_cast<int>(intOption(argc, argv, "stock", 1000));
+    config.failureRate = doubleOption(argc, argv, "failure-rate", 0.0);
+    config.reconfirmSuccessRate = doubleOption(argc, argv, "reconfirm-rate", 1.0);
+    if (auto failures = option(argc, argv, "failures")) {
+        config.failureScript = parseFailures(*failures);
+    }
+
+    mock::MockUpstream upstream(config, certificate);
+    upstream.start();
+
+    std::optional<mock::MockConnectProxy> proxy;
+    if (auto proxyPort = option(argc, argv, "proxy-port")) {
+        mock::MockConnectProxyConfig proxyConfig;
+        proxyConfig.port = static_cast<std::uint16_t>(std::strtoul(std::string(*proxyPort).c_str(), nullptr, 10));
+        proxyConfig.connectDelay = std::chrono::microseconds(intOption(argc, argv, "proxy-delay-us", 0));
+        proxy.emplace(proxyConfig);
+        for (const auto& host : hosts) {
+            proxy->route(host + ":443", upstream.address(), upstream.port());
+        }
+        proxy->start();
+    }
+
+    const std::string caPath{option(argc, argv, "ca-out").value_or("mock-ca.pem")};
+    std::ofstream(caPath, std::ios::binary) << certificate.caPem;
+
+    std::string overrides;
+    for (const auto& host : hosts) {
+        if (!overrides.empty()) {
+            overrides += ',';
+        }
+        overrides += host + "=" + upstream.address() + ":" + std::to_string(upstream.port());
+    }
+    std::printf("模拟上游已启动: https://%s:%u\n", upstream.address().c_str(), upstream.port());
+    if (proxy) {
+        std::printf("CONNECT 代理: %s:%u\n", upstream.address().c_str(), proxy->port());
+    }
+    std::printf("export QUICKGRAB_UPSTREAM_OVERRIDE=%s\n", overrides.c_str());
+    std::printf("export QUICKGRAB_UPSTREAM_CA=%s\n", caPath.c_str());
+    std::fflush(stdout);
+
+    boost::asio::io_context io;
+    boost::asio::signal_set signals(io, SIGINT, SIGTERM);
+    signals.async_wait([&](const boost::system::error_code&, int) { io.stop(); });
+    io.run();
+
+    if (proxy) {
+        proxy->stop();
+    }
+    upstream.stop();
+
+    std::size_t created = 0;
+    std::size_t succeeded = 0;
+    for (const auto& record : upstream.records()) {
+        if (record.endpoint == "CreateOrder") {
+            ++created;
+            succeeded += record.outcome == "success" ? 1 : 0;
+        }
+    }
+    std::printf("CreateOrder 请求 %zu 次，成功 %zu 次\n", created, succeeded);
+    return 0;
+}
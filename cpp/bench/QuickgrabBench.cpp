@@ -0,0 +1,365 @@
+// 热路径微基准（Google Benchmark）。夹具数据位于 bench/fixtures，按抓包结构整理的脱敏样例。
+// 用法：quickgrab_bench --benchmark_out=bench.json --benchmark_out_format=json
+// 部署前用 benchmark 自带的 tools/compare.py 与上一版结果对比即可发现回退。
+#include "quickgrab/model/Buyer.hpp"
+#include "quickgrab/model/JsonColumn.hpp"
+#include "quickgrab/model/Request.hpp"
+#include "quickgrab/model/RowJson.hpp"
+#include "quickgrab/proxy/ProxyPool.hpp"
+#include "quickgrab/repository/BuyersRepository.hpp"
+#include "quickgrab/repository/MySqlConnectionPool.hpp"
+#include "quickgrab/server/Router.hpp"
+#include "quickgrab/service/AuthService.hpp"
+#include "quickgrab/util/CommonUtil.hpp"
+#include "quickgrab/util/DomainScoreboard.hpp"
+#include "quickgrab/util/JsonUtil.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
+#include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/WeidianParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <boost/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// 按线程计数堆分配，供需要报告分配次数的基准读取；多线程基准的其他线程不计入
+thread_local std::uint64_t tAllocations = 0;
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    ++tAllocations;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace quickgrab::service {
+
+struct AuthServiceBenchAccess {
+    static AuthService::SessionInfo issueSession(AuthService& auth, const model::Buyer& buyer, bool rememberMe) {
+        return auth.issueSession(buyer, rememberMe);
+    }
+};
+
+} // namespace quickgrab::service
+
+namespace {
+
+using namespace quickgrab;
+
+std::string loadFixture(const char* name) {
+    const std::string path = std::string(QUICKGRAB_BENCH_FIXTURE_DIR) + "/" + name;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("无法读取基准夹具: " + path);
+    }
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+const std::string& addOrderHtml() {
+    static const std::string html = loadFixture("add_order.html");
+    return html;
+}
+
+const boost::json::object& addOrderData() {
+    static const boost::json::object data = util::extractDataObject(addOrderHtml()).value().as_object();
+    return data;
+}
+
+model::Request sampleRequest() {
+    model::Request request;
+    request.id = 10086;
+    request.buyerId = 42;
+    request.threadId = "thread-10086";
+    request.message = "请尽快发货";
+    request.quantity = 1;
+    request.extension = boost::json::object{{"quickMode", true}, {"domains", boost::json::array{"thor.weidian.com"}}};
+    return request;
+}
+
+// 与各控制器注册的路由表一致（顺序、参数路由与重复的 /api 前缀）
+server::Router& routeTable() {
+    static server::Router router = [] {
+        server::Router r;
+        const auto noop = [](server::RequestContext&) {};
+        const auto offload = [](std::function<void()> task) {
+            task();
+            return true;
+        };
+        for (const char* path : {"/metrics", "/api/traces", "/api/user"}) {
+            r.addRoute("GET", path, noop);
+        }
+        for (const char* path : {"/api/submitRequest", "/api/login", "/api/logout"}) {
+            r.addRoute("POST", path, noop);
+        }
+        for (const char* path : {"/api/grab/pending", "/getRequests", "/api/getRequests", "/getResults", "/api/getResults"}) {
+            r.addAsyncRoute("GET", path, noop, offload);
+        }
+        for (const char* path : {"/deleteRequest/:id", "/api/deleteRequest/:id", "/deleteResult/:id", "/api/deleteResult/:id"}) {
+            r.addAsyncRoute("DELETE", path, noop, offload);
+        }
+        for (const char* path : {"/getResult/:id", "/api/getResult/:id", "/getRequest/:id", "/api/getRequest/:id",
+                                 "/getBuyer", "/api/getBuyer", "/api/statistics", "/api/dailyStats",
+                                 "/api/hourlyStats", "/api/buyers"}) {
+            r.addAsyncRoute("GET", path, noop, offload);
+        }
+        for (const char* path : {"/api/upload", "/api/loginbyvcode", "/api/getListCart", "/api/getUserInfo",
+                                 "/api/getAddOrderData", "/api/proxy", "/getNote", "/api/getNote", "/fetchItemInfo",
+                                 "/api/fetchItemInfo", "/checkLatency", "/api/checkLatency", "/api/grab/run"}) {
+            r.addRoute("POST", path, noop);
+        }
+        for (const char* path : {"/api/expand", "/api/getItemSkuInfo", "/checkCookiesValidity",
+                                 "/api/checkCookiesValidity", "/api/events"}) {
+            r.addRoute("GET", path, noop);
+        }
+        return r;
+    }();
+    return router;
+}
+
+void BM_RouterResolve(benchmark::State& state) {
+    auto& router = routeTable();
+    const std::array<std::pair<std::string, std::string>, 6> requests{{
+        {"GET", "/api/getRequests"},
+        {"GET", "/api/getResult/123456"},
+        {"POST", "/api/grab/run"},
+        {"GET", "/api/events"},
+        {"DELETE", "/api/deleteRequest/98765"},
+        {"GET", "/favicon.ico"},
+    }};
+    std::unordered_map<std::string, std::string> params;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto& [method, path] = requests[i++ % requests.size()];
+        params.clear();
+        auto route = router.resolve(method, path, params);
+        benchmark::DoNotOptimize(route);
+    }
+}
+BENCHMARK(BM_RouterResolve);
+
+void BM_ParseCreateOrderResponse(benchmark::State& state, const char* fixture) {
+    const auto body = loadFixture(fixture);
+    for (auto _ : state) {
+        auto json = util::parseJson(body);
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * body.size()));
+}
+BENCHMARK_CAPTURE(BM_ParseCreateOrderResponse, success, "create_order_success.json");
+BENCHMARK_CAPTURE(BM_ParseCreateOrderResponse, retry, "create_order_retry.json");
+
+void BM_StringifyOrderParameters(benchmark::State& state) {
+    const auto params = util::generateOrderParameters(sampleRequest(), addOrderData(), false).value();
+    const boost::json::value value = params;
+    for (auto _ : state) {
+        auto text = util::stringifyJson(value);
+        benchmark::DoNotOptimize(text);
+    }
+}
+BENCHMARK(BM_StringifyOrderParameters);
+
+void BM_ExtractDataObject(benchmark::State& state) {
+    const auto& html = addOrderHtml();
+    for (auto _ : state) {
+        auto data = util::extractDataObject(html);
+        benchmark::DoNotOptimize(data);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * html.size()));
+}
+BENCHMARK(BM_ExtractDataObject);
+
+void BM_GenerateOrderParameters(benchmark::State& state) {
+    const auto request = sampleRequest();
+    const auto& data = addOrderData();
+    for (auto _ : state) {
+        auto params = util::generateOrderParameters(request, data, false);
+        benchmark::DoNotOptimize(params);
+    }
+}
+BENCHMARK(BM_GenerateOrderParameters);
+
+void BM_ToQuery(benchmark::State& state) {
+    const auto payload =
+        util::stringifyJson(util::generateOrderParameters(sampleRequest(), addOrderData(), false).value());
+    for (auto _ : state) {
+        auto query = util::toQuery(payload);
+        benchmark::DoNotOptimize(query);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * payload.size()));
+}
+BENCHMARK(BM_ToQuery);
+
+// 详情/待处理接口的行编码：数据库读出的请求经 requestColumns + writeRequestJson 写为 JSON。
+// 参数 1 为 JSON 类型列（迁移后，原文直接透传），0 为 TEXT 列（每列先校验）；报告 rows/s 与每行分配次数
+void BM_EncodeRequestRows(benchmark::State& state) {
+    const bool trusted = state.range(0) != 0;
+    const auto orderInfo = loadFixture("create_order_success.json");
+    const std::string userInfo = R"({"nickName":"小明","telephone":"13800000000","orderNote":"请尽快发货"})";
+    const auto extension = util::stringifyJson(sampleRequest().extension.get());
+
+    constexpr std::size_t kRows = 256;
+    std::vector<model::Request> rows;
+    rows.reserve(kRows);
+    for (std::size_t i = 0; i < kRows; ++i) {
+        auto request = sampleRequest();
+        request.id = static_cast<int>(i);
+        request.orderInfo = model::JsonColumn::fromRaw(orderInfo, boost::json::object{}, "order_info", trusted);
+        request.userInfo = model::JsonColumn::fromRaw(userInfo, boost::json::object{}, "user_info", trusted);
+        request.orderTemplate = model::JsonColumn::fromRaw("{}", boost::json::object{}, "order_template", trusted);
+        request.extension = model::JsonColumn::fromRaw(extension, boost::json::object{}, "extension", trusted);
+        rows.push_back(std::move(request));
+    }
+
+    std::string out;
+    out.reserve(kRows * (orderInfo.size() + 1024));
+    std::uint64_t allocations = 0;
+    for (auto _ : state) {
+        out.clear();
+        const auto before = tAllocations;
+        util::JsonWriter writer(out);
+        writer.beginArray();
+        for (const auto& request : rows) {
+            model::writeRequestJson(writer, model::requestColumns(request));
+        }
+        writer.endArray();
+        allocations += tAllocations - before;
+        benchmark::DoNotOptimize(out.data());
+    }
+    const auto encoded = static_cast<std::int64_t>(state.iterations() * kRows);
+    state.SetItemsProcessed(encoded);
+    state.counters["allocs_per_row"] = static_cast<double>(allocations) / static_cast<double>(std::max<std::int64_t>(1, encoded));
+}
+BENCHMARK(BM_EncodeRequestRows)->ArgName("json_type")->Arg(0)->Arg(1);
+
+proxy::ProxyPool& sharedProxyPool() {
+    static proxy::ProxyPool pool(std::chrono::seconds{1});
+    static const bool hydrated = [] {
+        std::vector<proxy::ProxyEndpoint> endpoints;
+        for (int i = 0; i < 64; ++i) {
+            proxy::ProxyEndpoint endpoint;
+            endpoint.host = "10.8." + std::to_string(i / 16) + "." + std::to_string(i % 16 + 10);
+            endpoint.port = static_cast<std::uint16_t>(20000 + i);
+            endpoint.latency = std::chrono::milliseconds(30 + i);
+            endpoints.push_back(std::move(endpoint));
+        }
+        pool.hydrate(std::move(endpoints));
+        return true;
+    }();
+    (void)hydrated;
+    return pool;
+}
+
+// 多个 worker 线程共享一个代理池：每次抢购 acquire 一次，结束后上报，约 1/16 失败进入冷却
+void BM_ProxyPoolAcquireReport(benchmark::State& state) {
+    auto& pool = sharedProxyPool();
+
+    std::vector<std::string> affinities;
+    for (int i = 0; i < 8; ++i) {
+        affinities.push_back("thread-" + std::to_string(state.thread_index() * 8 + i));
+    }
+    std::size_t n = 0;
+    for (auto _ : state) {
+        const auto& affinity = affinities[n % affinities.size()];
+        if (auto endpoint = pool.acquire(affinity)) {
+            if ((n & 15) == 15) {
+                pool.reportFailure(affinity, *endpoint);
+            } else {
+                pool.reportSuccess(affinity, *endpoint);
+            }
+        }
+        ++n;
+    }
+    if (state.thread_index() == 0) {
+        pool.tick();
+    }
+}
+BENCHMARK(BM_ProxyPoolAcquireReport)->ThreadRange(1, 8)->UseRealTime();
+
+// 重试下单每次都会选域名；同时校验只失败的域名不会按最优权重被选中（被选比例须低于 10%，否则报错）
+void BM_DomainScoreboardPick(benchmark::State& state) {
+    util::DomainScoreboard scoreboard;
+    const std::vector<std::string_view> candidates{"thor.weidian.com", "vap.weidian.com", "dead.weidian.com"};
+    for (int i = 0; i < 32; ++i) {
+        scoreboard.recordRequest(candidates[0], std::chrono::milliseconds{20}, false);
+        scoreboard.recordRequest(candidates[1], std::chrono::milliseconds{30}, false);
+        scoreboard.recordRequest(candidates[2], std::chrono::seconds{3}, true);
+    }
+    std::array<std::size_t, 3> picks{};
+    for (auto _ : state) {
+        const auto index = scoreboard.pick(candidates);
+        ++picks[index];
+        benchmark::DoNotOptimize(index);
+    }
+    const double total = static_cast<double>(picks[0] + picks[1] + picks[2]);
+    const double failingShare = total > 0 ? static_cast<double>(picks[2]) / total : 0.0;
+    state.counters["failing_share"] = failingShare;
+    if (total >= 1000 && failingShare >= 0.10) {
+        state.SkipWithError("只失败的域名被选比例过高");
+    }
+}
+BENCHMARK(BM_DomainScoreboardPick);
+
+// 每个请求都会 touchSession；参数为在线会话数
+void BM_AuthTouchSession(benchmark::State& state) {
+    repository::DatabaseConfig config;
+    config.database = "quickgrab_bench";
+    repository::MySqlConnectionPool pool(config);
+    repository::BuyersRepository buyers(pool);
+    service::AuthService auth(buyers);
+
+    std::vector<std::string> tokens;
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        model::Buyer buyer;
+        buyer.id = static_cast<int>(i);
+        buyer.username = "buyer" + std::to_string(i);
+        buyer.accessLevel = 1;
+        tokens.push_back(service::AuthServiceBenchAccess::issueSession(auth, buyer, (i & 1) == 0).token);
+    }
+    std::size_t n = 0;
+    for (auto _ : state) {
+        auto session = auth.touchSession(tokens[n++ % tokens.size()]);
+        benchmark::DoNotOptimize(session);
+    }
+}
+BENCHMARK(BM_AuthTouchSession)->Arg(16)->Arg(1024)->Arg(16384);
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // 日志写入会干扰计时，只保留错误
+    quickgrab::util::initLogging(quickgrab::util::LogLevel::error);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    quickgrab::util::shutdownLogging();
+    return 0;
+}
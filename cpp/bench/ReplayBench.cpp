@@ -0,0 +1,161 @@
+// 磁带回放基准：HttpClient 从磁带返回录制的上游响应，GrabWorkflow/WeidianParser/CommonUtil 照常执行，
+// 不访问网络。统计每次抢购的 CPU 时间与堆分配次数/字节数，用于不同构建间的确定性对比。
+// 磁带来源：服务端设置 QUICKGRAB_HTTP_RECORD=day.qgc 录制线上流量，或 quickgrab_e2e_bench --record=day.qgc。
+// 用法：quickgrab_replay_bench --cassette=day.qgc [--grabs=1000] [--workers=1] [--timing=immediate|recorded]
+//         [--link=https://weidian.com/buy/add-order/index.php?itemId=...]
+#include "quickgrab/model/Request.hpp"
+#include "quickgrab/proxy/ProxyPool.hpp"
+#include "quickgrab/util/HttpCassette.hpp"
+#include "quickgrab/util/HttpClient.hpp"
+#include "quickgrab/util/Logging.hpp"
+#include "quickgrab/workflow/GrabWorkflow.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/json.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+std::atomic<std::uint64_t> gAllocations{0};
+std::atomic<std::uint64_t> gAllocatedBytes{0};
+
+} // namespace
+
+// 统计全进程堆分配；只在本基准可执行文件中替换
+void* operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using namespace quickgrab;
+
+std::optional<std::string_view> option(int argc, char** argv, std::string_view name) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg.size() > name.size() + 3 && arg.substr(0, 2) == "--" && arg.substr(2, name.size()) == name &&
+            arg[name.size() + 2] == '=') {
+            return arg.substr(name.size() + 3);
+        }
+    }
+    return std::nullopt;
+}
+
+double cpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto cassette = option(argc, argv, "cassette");
+    if (!cassette) {
+        std::fprintf(stderr, "用法: quickgrab_replay_bench --cassette=<文件> [--grabs=N] [--workers=N] [--timing=immediate|recorded]\n");
+        return 2;
+    }
+    util::initLogging(util::LogLevel::error);
+
+    const int grabs = std::max(1, std::atoi(std::string(option(argc, argv, "grabs").value_or("1000")).c_str()));
+    const auto workers = static_cast<std::size_t>(
+        std::max(1, std::atoi(std::string(option(argc, argv, "workers").value_or("1")).c_str())));
+    const auto timing = option(argc, argv, "timing").value_or("immediate") == "recorded"
+                            ? util::CassetteTiming::recorded
+                            : util::CassetteTiming::immediate;
+    const std::string link{option(argc, argv, "link").value_or(
+        "https://weidian.com/buy/add-order/index.php?itemId=7250000000")};
+
+    boost::asio::io_context io;
+    auto guard = boost::asio::make_work_guard(io);
+    std::thread ioThread([&io] { io.run(); });
+    boost::asio::thread_pool worker(workers);
+    proxy::ProxyPool proxyPool(std::chrono::seconds{1});
+    util::HttpClient httpClient(io, proxyPool);
+    httpClient.startReplay(std::string(*cassette), timing);
+    workflow::GrabWorkflow workflow(io, worker, httpClient, proxyPool);
+
+    std::mutex mutex;
+    std::condition_variable done;
+    int finished = 0;
+    int succeeded = 0;
+    long attempts = 0;
+
+    const auto allocationsBefore = gAllocations.load();
+    const auto bytesBefore = gAllocatedBytes.load();
+    const auto cpuBefore = cpuSeconds();
+    const auto wallBefore = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < grabs; ++i) {
+        model::Request request;
+        request.id = 800000 + i;
+        request.buyerId = 1;
+        request.type = 1;
+        request.quantity = 1;
+        request.startTime = std::chrono::system_clock::now();
+        request.link = link;
+        request.cookies = "wdtoken=replay-" + std::to_string(i);
+        request.orderParameters = boost::json::object{};
+        request.extension = boost::json::object{{"domains", boost::json::array{"thor.weidian.com"}}};
+        workflow.run(request, [&](const workflow::GrabResult& result) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++finished;
+            succeeded += result.success ? 1 : 0;
+            attempts += result.attempts;
+            done.notify_all();
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return finished == grabs; });
+    }
+
+    const auto wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallBefore).count();
+    const auto cpu = cpuSeconds() - cpuBefore;
+    const auto allocations = gAllocations.load() - allocationsBefore;
+    const auto bytes = gAllocatedBytes.load() - bytesBefore;
+
+    worker.join();
+    guard.reset();
+    io.stop();
+    ioThread.join();
+
+    std::printf("抢购 %d 次，成功 %d，平均尝试 %.2f 次\n", grabs, succeeded, static_cast<double>(attempts) / grabs);
+    std::printf("墙钟 %.3fs，CPU %.3fs，每次抢购 CPU %.1fus\n", wall, cpu, cpu * 1e6 / grabs);
+    std::printf("堆分配 %llu 次 / %.1f KiB，每次抢购 %.1f 次 / %.1f KiB\n",
+                static_cast<unsigned long long>(allocations), static_cast<double>(bytes) / 1024.0,
+                static_cast<double>(allocations) / grabs, static_cast<double>(bytes) / 1024.0 / grabs);
+    util::shutdownLogging();
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include "mock/MockConnectProxy.hpp"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+
+namespace quickgrab::mock {
+namespace {
+
+namespace beast = boost::beast;
+namespace http = boost::beast::http;
+using tcp = boost::asio::ip::tcp;
+
+std::string base64(std::string_view input) {
+    static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    std::uint32_t value = 0;
+    int bits = -6;
+    for (unsigned char c : input) {
+        value = (value << 8) | c;
+        bits += 8;
+        while (bits >= 0) {
+            out.push_back(alphabet[(value >> bits) & 0x3F]);
+            bits -= 6;
+        }
+    }
+    if (bits > -6) {
+        out.push_back(alphabet[((value << 8) >> (bits + 8)) & 0x3F]);
+    }
+    while (out.size() % 4 != 0) {
+        out.push_back('=');
+    }
+    return out;
+}
+
+// 单向转发：from 读到的数据原样写入 to，任一侧出错时关闭两端
+class Pipe : public std::enable_shared_from_this<Pipe> {
+public:
+    Pipe(std::shared_ptr<tcp::socket> from, std::shared_ptr<tcp::socket> to)
+        : from_(std::move(from)), to_(std::move(to)) {}
+
+    void start() { read(); }
+
+private:
+    void read() {
+        from_->async_read_some(boost::asio::buffer(buffer_), [self = shared_from_this()](beast::error_code ec, std::size_t n) {
+            if (ec) {
+                self->shutdown();
+                return;
+            }
+            boost::asio::async_write(*self->to_, boost::asio::buffer(self->buffer_.data(), n),
+                                     [self](beast::error_code writeEc, std::size_t) {
+                                         if (writeEc) {
+                                             self->shutdown();
+                                             return;
+                                         }
+                                         self->read();
+                                     });
+        });
+    }
+
+    void shutdown() {
+        beast::error_code ignored;
+        to_->shutdown(tcp::socket::shutdown_send, ignored);
+        from_->close(ignored);
+    }
+
+    std::shared_ptr<tcp::socket> from_;
+    std::shared_ptr<tcp::socket> to_;
+    std::array<char, 16 * 1024> buffer_{};
+};
+
+} // namespace
+
+class ProxySession : public std::enable_shared_from_this<ProxySession> {
+public:
+    ProxySession(tcp::socket socket, MockConnectProxy& proxy)
+        : client_(std::make_shared<tcp::socket>(std::move(socket)))
+        , upstream_(std::make_shared<tcp::socket>(client_->get_executor()))
+        , timer_(client_->get_executor())
+        , proxy_(proxy) {}
+
+    void start() {
+        parser_.skip(true);
+        http::async_read_header(*client_, buffer_, parser_, [self = shared_from_this()](beast::error_code ec, std::size_t) {
+            self->onRequest(ec);
+        });
+    }
+
+private:
+    void onRequest(beast::error_code ec) {
+        if (ec) {
+            return;
+        }
+        const auto& request = parser_.get();
+        if (request.method() != http::verb::connect) {
+            reject(http::status::method_not_allowed);
+            return;
+        }
+        if (!proxy_.expectedAuthorization_.empty()) {
+            auto it = request.find(http::field::proxy_authorization);
+            if (it == request.end() || std::string_view(it->value().data(), it->value().size()) != proxy_.expectedAuthorization_) {
+                reject(http::status::proxy_authentication_required);
+                return;
+            }
+        }
+        const std::string authority(request.target().data(), request.target().size());
+        auto route = proxy_.routes_.find(authority);
+        if (route == proxy_.routes_.end()) {
+            reject(http::status::forbidden);
+            return;
+        }
+        target_ = route->second;
+
+        if (proxy_.config_.connectDelay.count() > 0) {
+            timer_.expires_after(proxy_.config_.connectDelay);
+            timer_.async_wait([self = shared_from_this()](beast::error_code) { self->connect(); });
+        } else {
+            connect();
+        }
+    }
+
+    void connect() {
+        tcp::endpoint endpoint{boost::asio::ip::make_address(target_.address), target_.port};
+        upstream_->async_connect(endpoint, [self = shared_from_this()](beast::error_code ec) {
+            if (ec) {
+                self->reject(http::status::bad_gateway);
+                return;
+            }
+            self->upstream_->set_option(tcp::no_delay(true));
+            static constexpr char kEstablished[] = "HTTP/1.1 200 Connection Established\r\n\r\n";
+            boost::asio::async_write(*self->client_, boost::asio::buffer(kEstablished, sizeof(kEstablished) - 1),
+                                     [self](beast::error_code writeEc, std::size_t) {
+                                         if (writeEc) {
+                                             return;
+                                         }
+                                         self->proxy_.tunnels_.fetch_add(1, std::memory_order_relaxed);
+                                         std::make_shared<Pipe>(self->client_, self->upstream_)->start();
+                                         std::make_shared<Pipe>(self->upstream_, self->client_)->start();
+                                     });
+        });
+    }
+
+    void reject(http::status status) {
+        proxy_.rejected_.fetch_add(1, std::memory_order_relaxed);
+        auto response = std::make_shared<http::response<http::empty_body>>(status, 11);
+        response->keep_alive(false);
+        if (status == http::status::proxy_authentication_required) {
+            response->set(http::field::proxy_authenticate, "Basic realm=\"mock\"");
+        }
+        response->prepare_payload();
+        http::async_write(*client_, *response, [self = shared_from_this(), response](beast::error_code, std::size_t) {
+            beast::error_code ignored;
+            self->client_->shutdown(tcp::socket::shutdown_both, ignored);
+            self->client_->close(ignored);
+        });
+    }
+
+    std::shared_ptr<tcp::socket> client_;
+    std::shared_ptr<tcp::socket> upstream_;
+    boost::asio::steady_timer timer_;
+    beast::flat_buffer buffer_;
+    http::request_parser<http::empty_body> parser_;
+    MockConnectProxy::Target target_;
+    MockConnectProxy& proxy_;
+};
+
+MockConnectProxy::MockConnectProxy(MockConnectProxyConfig config)
+    : config_(std::move(config)), acceptor_(io_) {
+    if (!config_.username.empty() || !config_.password.empty()) {
+        expectedAuthorization_ = "Basic " + base64(config_.username + ":" + config_.password);
+    }
+}
+
+MockConnectProxy::~MockConnectProxy() {
+    stop();
+}
+
+void MockConnectProxy::route(const std::string& authority, std::string address, std::uint16_t port) {
+    routes_.insert_or_assign(authority, Target{std::move(address), port});
+}
+
+void MockConnectProxy::start() {
+    tcp::endpoint endpoint{boost::asio::ip::make_address(config_.address), config_.port};
+    acceptor_.open(endpoint.protocol());
+    acceptor_.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor_.bind(endpoint);
+    acceptor_.listen(boost::asio::socket_base::max_listen_connections);
+    port_ = acceptor_.local_endpoint().port();
+    accept();
+    for (std::size_t i = 0; i < std::max<std::size_t>(1, config_.threads); ++i) {
+        threads_.emplace_back([this] { io_.run(); });
+    }
+}
+
+void MockConnectProxy::stop() {
+    if (threads_.empty()) {
+        return;
+    }
+    io_.stop();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+    beast::error_code ignored;
+    acceptor_.close(ignored);
+}
+
+void MockConnectProxy::accept() {
+    acceptor_.async_accept(boost::asio::make_strand(io_), [this](beast::error_code ec, tcp::socket socket) {
+        if (ec) {
+            return;
+        }
+        socket.set_option(tcp::no_delay(true));
+        std::make_shared<ProxySession>(std::move(socket), *this)->start();
+        accept();
+    });
+}
+
+} // namespace quickgrab::mock
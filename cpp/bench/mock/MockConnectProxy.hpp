@@ -0,0 +1,67 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace quickgrab::mock {
+
+struct MockConnectProxyConfig {
+    std::string address{"127.0.0.1"};
+    std::uint16_t port{0};
+    std::size_t threads{2};
+    // 非空时要求 Proxy-Authorization: Basic，否则返回 407
+    std::string username;
+    std::string password;
+    // 建立隧道前的额外延迟，模拟代理出口的一跳
+    std::chrono::microseconds connectDelay{0};
+};
+
+// 只支持 CONNECT 的 HTTP 代理：按 routes 把 "host:port" 改写到本地地址后双向转发，
+// 配合 MockUpstream 让 HttpClient 的代理分支（CONNECT → TLS → 请求）在本地完整跑通。
+class MockConnectProxy {
+public:
+    explicit MockConnectProxy(MockConnectProxyConfig config);
+    ~MockConnectProxy();
+    MockConnectProxy(const MockConnectProxy&) = delete;
+    MockConnectProxy& operator=(const MockConnectProxy&) = delete;
+
+    // 须在 start() 之前调用
+    void route(const std::string& authority, std::string address, std::uint16_t port);
+
+    void start();
+    void stop();
+
+    std::uint16_t port() const noexcept { return port_; }
+    std::uint64_t tunnels() const noexcept { return tunnels_.load(std::memory_order_relaxed); }
+    std::uint64_t rejected() const noexcept { return rejected_.load(std::memory_order_relaxed); }
+
+private:
+    struct Target {
+        std::string address;
+        std::uint16_t port;
+    };
+
+    void accept();
+
+    friend class ProxySession;
+
+    MockConnectProxyConfig config_;
+    std::string expectedAuthorization_;
+    std::unordered_map<std::string, Target> routes_;
+    boost::asio::io_context io_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::uint16_t port_{0};
+    std::vector<std::thread> threads_;
+    std::atomic<std::uint64_t> tunnels_{0};
+    std::atomic<std::uint64_t> rejected_{0};
+};
+
+} // namespace quickgrab::mock
@@ -0,0 +1,376 @@
+#include "mock/MockUpstream.hpp"
+
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/json.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace quickgrab::mock {
+namespace {
+
+namespace beast = boost::beast;
+namespace http = boost::beast::http;
+using tcp = boost::asio::ip::tcp;
+
+constexpr char kItemId[] = "7250000000";
+constexpr char kSkuId[] = "150000000000";
+constexpr char kShopId[] = "1683219042";
+
+std::string htmlEscape(std::string_view text) {
+    std::string out;
+    out.reserve(text.size() + text.size() / 4);
+    for (char ch : text) {
+        switch (ch) {
+        case '"': out.append("&quot;"); break;
+        case '&': out.append("&amp;"); break;
+        case '<': out.append("&lt;"); break;
+        case '>': out.append("&gt;"); break;
+        case '\'': out.append("&#39;"); break;
+        default: out.push_back(ch); break;
+        }
+    }
+    return out;
+}
+
+// 与线上加购页相同的结构：data-obj 中 order.result 为 generateOrderParameters 的输入
+std::string buildAddOrderHtml() {
+    boost::json::object item{
+        {"item_id", kItemId},
+        {"item_sku_id", kSkuId},
+        {"item_title", "【现货】限定款联名手办 盲盒 单只随机"},
+        {"quantity", 1},
+        {"price", 59.0},
+        {"ori_price", 69.0},
+        {"item_convey_info", boost::json::object{{"convey_type", 0}}},
+    };
+    boost::json::object shop{
+        {"shop", boost::json::object{{"shop_id", kShopId}, {"shop_name", "次元潮玩旗舰店"}}},
+        {"item_list", boost::json::array{item}},
+        {"express_list", boost::json::array{boost::json::object{{"express_type", 0}, {"express_fee", 8.0}}}},
+    };
+    boost::json::object result{
+        {"shop_list", boost::json::array{shop}},
+        {"buyer_address", boost::json::object{{"buyer_name", "张三"}, {"phone", "138****5678"}, {"address_id", 98765432}}},
+        {"agreement_info_list", boost::json::array{boost::json::object{{"agreement_type", "presale"}}}},
+        {"express_types", boost::json::object{{"type_list", boost::json::array{boost::json::object{{"type", 0}, {"desc", "快递"}}}}}},
+        {"only_self_delivery", "0"},
+        {"is_no_ship_addr", "0"},
+        {"source_id", "h5_add_order"},
+    };
+    boost::json::object data{{"order", boost::json::object{{"result", std::move(result)}}}};
+
+    std::string html;
+    html.append("<!DOCTYPE html><html lang=\"zh-CN\"><head><meta charset=\"utf-8\"><title>确认订单</title></head><body>");
+    html.append("<div id=\"app\"></div><div id=\"__rocker-render-inject__\" data-obj=\"");
+    html.append(htmlEscape(boost::json::serialize(data)));
+    html.append("\"></div></body></html>");
+    return html;
+}
+
+std::string statusJson(int code, std::string_view message, bool success, boost::json::value result) {
+    boost::json::object root{
+        {"status", boost::json::object{{"code", code}, {"message", message}, {"description", ""}}},
+        {"isSuccess", success ? 1 : 0},
+        {"result", std::move(result)},
+    };
+    return boost::json::serialize(root);
+}
+
+class Session : public std::enable_shared_from_this<Session> {
+public:
+    Session(tcp::socket socket, boost::asio::ssl::context& ssl, MockUpstream& upstream)
+        : stream_(std::move(socket), ssl), timer_(stream_.get_executor()), upstream_(upstream) {}
+
+    void start() {
+        beast::get_lowest_layer(stream_).expires_after(std::chrono::seconds(30));
+        stream_.async_handshake(boost::asio::ssl::stream_base::server,
+                                [self = shared_from_this()](beast::error_code ec) {
+                                    if (!ec) {
+                                        self->read();
+                                    }
+                                });
+    }
+
+private:
+    void read() {
+        request_ = {};
+        beast::get_lowest_layer(stream_).expires_after(std::chrono::seconds(30));
+        http::async_read(stream_, buffer_, request_, [self = shared_from_this()](beast::error_code ec, std::size_t) {
+            self->onRead(ec);
+        });
+    }
+
+    void onRead(beast::error_code ec) {
+        if (ec) {
+            close();
+            return;
+        }
+        std::string_view cookie;
+        if (auto it = request_.find(http::field::cookie); it != request_.end()) {
+            cookie = std::string_view(it->value().data(), it->value().size());
+        }
+        auto reply = upstream_.handle(std::string_view(request_.method_string().data(), request_.method_string().size()),
+                                      std::string_view(request_.target().data(), request_.target().size()),
+                                      cookie,
+                                      request_.body());
+        response_ = {};
+        response_.version(request_.version());
+        response_.result(reply.status);
+        response_.set(http::field::server, "mock-weidian");
+        response_.set(http::field::content_type, reply.contentType);
+        response_.keep_alive(request_.keep_alive());
+        response_.body() = std::move(reply.body);
+        response_.prepare_payload();
+
+        timer_.expires_after(upstream_.nextLatency());
+        timer_.async_wait([self = shared_from_this()](beast::error_code) { self->write(); });
+    }
+
+    void write() {
+        http::async_write(stream_, response_, [self = shared_from_this()](beast::error_code ec, std::size_t) {
+            if (ec) {
+                self->close();
+                return;
+            }
+            if (self->response_.keep_alive()) {
+                self->read();
+            } else {
+                self->close();
+            }
+        });
+    }
+
+    void close() {
+        beast::get_lowest_layer(stream_).expires_after(std::chrono::seconds(5));
+        stream_.async_shutdown([self = shared_from_this()](beast::error_code) {
+            beast::error_code ignored;
+            beast::get_lowest_layer(self->stream_).socket().close(ignored);
+        });
+    }
+
+    beast::ssl_stream<beast::tcp_stream> stream_;
+    boost::asio::steady_timer timer_;
+    beast::flat_buffer buffer_;
+    http::request<http::string_body> request_;
+    http::response<http::string_body> response_;
+    MockUpstream& upstream_;
+};
+
+} // namespace
+
+MockUpstream::MockUpstream(MockUpstreamConfig config, const TestCertificate& certificate)
+    : config_(std::move(config))
+    , ssl_(boost::asio::ssl::context::tls_server)
+    , acceptor_(io_)
+    , addOrderHtml_(buildAddOrderHtml()) {
+    ssl_.use_certificate_chain(boost::asio::buffer(certificate.certPem));
+    ssl_.use_private_key(boost::asio::buffer(certificate.keyPem), boost::asio::ssl::context::pem);
+}
+
+MockUpstream::~MockUpstream() {
+    stop();
+}
+
+void MockUpstream::start() {
+    tcp::endpoint endpoint{boost::asio::ip::make_address(config_.address), config_.port};
+    acceptor_.open(endpoint.protocol());
+    acceptor_.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor_.bind(endpoint);
+    acceptor_.listen(boost::asio::socket_base::max_listen_connections);
+    port_ = acceptor_.local_endpoint().port();
+    accept();
+    for (std::size_t i = 0; i < std::max<std::size_t>(1, config_.threads); ++i) {
+        threads_.emplace_back([this] { io_.run(); });
+    }
+}
+
+void MockUpstream::stop() {
+    if (threads_.empty()) {
+        return;
+    }
+    io_.stop();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+    beast::error_code ignored;
+    acceptor_.close(ignored);
+}
+
+void MockUpstream::accept() {
+    acceptor_.async_accept(boost::asio::make_strand(io_), [this](beast::error_code ec, tcp::socket socket) {
+        if (ec) {
+            return;
+        }
+        socket.set_option(tcp::no_delay(true));
+        std::make_shared<Session>(std::move(socket), ssl_, *this)->start();
+        accept();
+    });
+}
+
+std::vector<MockRequestRecord> MockUpstream::records() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+}
+
+void MockUpstream::clearRecords() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.clear();
+    createAttempts_.clear();
+    sold_ = 0;
+}
+
+std::chrono::microseconds MockUpstream::nextLatency() {
+    if (config_.latencyJitter.count() <= 0) {
+        return config_.latency;
+    }
+    thread_local std::mt19937 rng{std::random_device{}()};
+    std::uniform_int_distribution<std::int64_t> dist(0, config_.latencyJitter.count());
+    return config_.latency + std::chrono::microseconds(dist(rng));
+}
+
+int MockUpstream::currentStock(std::chrono::system_clock::time_point now) const {
+    if (now < config_.stockAt) {
+        return 0;
+    }
+    return std::max(0, config_.stock - sold_);
+}
+
+MockUpstream::Reply MockUpstream::handle(std::string_view method,
+                                         std::string_view target,
+                                         std::string_view cookie,
+                                         std::string_view /*body*/) {
+    MockRequestRecord record;
+    record.arrivedAt = std::chrono::system_clock::now();
+    record.arrivedSteady = std::chrono::steady_clock::now();
+    record.cookie = std::string(cookie);
+    const auto path = target.substr(0, target.find('?'));
+
+    Reply reply;
+    if (path.find("/vbuy/CreateOrder/") != std::string_view::npos) {
+        record.endpoint = "CreateOrder";
+        reply = createOrder(cookie, record);
+    } else if (path.find("/vbuy/ReConfirmOrder/") != std::string_view::npos) {
+        record.endpoint = "ReConfirmOrder";
+        reply = reconfirmOrder();
+    } else if (path.find("/vcart/addCart/") != std::string_view::npos) {
+        record.endpoint = "addCart";
+        reply = inventory();
+    } else if (path.find("getItemSkuInfo") != std::string_view::npos) {
+        record.endpoint = "getItemSkuInfo";
+        reply = skuInfo();
+    } else if (path.find("getUserInfoById") != std::string_view::npos) {
+        record.endpoint = "getUserInfoById";
+        reply = userInfo(cookie);
+    } else if (method == "GET") {
+        record.endpoint = "addOrderPage";
+        reply = addOrderPage();
+    } else {
+        record.endpoint = "unknown";
+        reply = Reply{404, "text/plain", "not found"};
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.push_back(std::move(record));
+    return reply;
+}
+
+MockUpstream::Reply MockUpstream::createOrder(std::string_view cookie, MockRequestRecord& record) {
+    const auto now = record.arrivedAt;
+    Reply reply{200, "application/json;charset=UTF-8", {}};
+    if (now < config_.saleStart) {
+        record.outcome = "not_on_sale";
+        reply.body = statusJson(2, kNotOnSaleMessage, false, nullptr);
+        return reply;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto attempt = createAttempts_[std::string(cookie)]++;
+    if (attempt < config_.failureScript.size()) {
+        record.outcome = "failure";
+        reply.body = statusJson(2, config_.failureScript[attempt], false, nullptr);
+        return reply;
+    }
+    if (config_.failureRate > 0.0 && !config_.failureMessages.empty() &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < config_.failureRate) {
+        std::uniform_int_distribution<std::size_t> pick(0, config_.failureMessages.size() - 1);
+        record.outcome = "failure";
+        reply.body = statusJson(2, config_.failureMessages[pick(rng_)], false, nullptr);
+        return reply;
+    }
+    if (currentStock(now) <= 0) {
+        record.outcome = "sold_out";
+        reply.body = statusJson(5, "商品已售罄", false, nullptr);
+        return reply;
+    }
+
+    ++sold_;
+    record.outcome = "success";
+    const auto orderId = std::to_string(8493012749182LL + sold_);
+    reply.body = statusJson(0, "OK", true,
+                            boost::json::object{
+                                {"order_id_list", boost::json::array{orderId}},
+                                {"pay_url", "https://weidian.com/pay/cashier.html?pay_id=" + orderId},
+                                {"total_pay_price", "67.00"},
+                            });
+    return reply;
+}
+
+MockUpstream::Reply MockUpstream::reconfirmOrder() {
+    bool success = true;
+    if (config_.reconfirmSuccessRate < 1.0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        success = std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < config_.reconfirmSuccessRate;
+    }
+    if (!success) {
+        return Reply{200, "application/json;charset=UTF-8", statusJson(2, kRetryMessage, false, nullptr)};
+    }
+    return Reply{200, "application/json;charset=UTF-8",
+                 statusJson(0, "OK", true, boost::json::object{{"total_pay_price", "67.00"}, {"confirmed", true}})};
+}
+
+MockUpstream::Reply MockUpstream::inventory() {
+    int stock = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stock = currentStock(std::chrono::system_clock::now());
+    }
+    if (stock <= 0) {
+        return Reply{200, "application/json;charset=UTF-8", statusJson(2, "库存不足", false, nullptr)};
+    }
+    return Reply{200, "application/json;charset=UTF-8",
+                 statusJson(0, "OK", true, boost::json::object{{"cartId", 1}, {"stock", stock}})};
+}
+
+MockUpstream::Reply MockUpstream::skuInfo() {
+    int stock = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stock = currentStock(std::chrono::system_clock::now());
+    }
+    boost::json::object result{
+        {"itemStock", stock},
+        {"skuInfos", boost::json::array{boost::json::object{{"id", kSkuId}, {"stock", stock}}}},
+    };
+    return Reply{200, "application/json;charset=UTF-8", statusJson(0, "OK", true, std::move(result))};
+}
+
+MockUpstream::Reply MockUpstream::userInfo(std::string_view cookie) {
+    if (cookie.empty()) {
+        return Reply{200, "application/json;charset=UTF-8", statusJson(10, "请先登录", false, nullptr)};
+    }
+    boost::json::object result{{"userId", "1290000001"}, {"nickName", "mock-buyer"}, {"telephone", "138****5678"}};
+    return Reply{200, "application/json;charset=UTF-8", statusJson(0, "OK", true, std::move(result))};
+}
+
+MockUpstream::Reply MockUpstream::addOrderPage() {
+    return Reply{200, "text/html;charset=UTF-8", addOrderHtml_};
+}
+
+} // namespace quickgrab::mock
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "mock/TestCertificate.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl/context.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace quickgrab::mock {
+
+// 开售后 CreateOrder 常见的失败提示，分别落入 GrabWorkflow 的重试/重试/重新确认分支
+inline constexpr std::string_view kCrowdedMessage = "啊哦~ 人潮拥挤，请稍后重试~";
+inline constexpr std::string_view kRetryMessage = "请稍后再试";
+inline constexpr std::string_view kConfirmMessage = "商品信息变更，请重新确认";
+inline constexpr std::string_view kNotOnSaleMessage = "商品尚未开售";
+
+struct MockUpstreamConfig {
+    std::string address{"127.0.0.1"};
+    // 0 表示由系统分配端口，启动后通过 port() 读取
+    std::uint16_t port{0};
+    std::size_t threads{2};
+    // 每个请求的模拟处理耗时：latency + U[0, latencyJitter]
+    std::chrono::microseconds latency{std::chrono::milliseconds(2)};
+    std::chrono::microseconds latencyJitter{std::chrono::milliseconds(1)};
+    // 开售时刻。此前 CreateOrder 返回“商品尚未开售”（重试分支）
+    std::chrono::system_clock::time_point saleStart{};
+    // 开售后每个抢购（按 Cookie 区分）的前几次 CreateOrder 依次返回这些提示，用完后才可能成功
+    std::vector<std::string> failureScript;
+    // 脚本用完后仍以该概率返回 failureMessages 中随机一条
+    double failureRate{0.0};
+    std::vector<std::string> failureMessages{std::string(kCrowdedMessage), std::string(kRetryMessage)};
+    // 库存在 stockAt 之前为 0（库存/SKU 接口返回无货），之后为 stock，每成功下单一次减去下单数量
+    std::chrono::system_clock::time_point stockAt{};
+    int stock{1000};
+    double reconfirmSuccessRate{1.0};
+};
+
+// 服务端看到的一次请求，供基准统计首单到达时刻等
+struct MockRequestRecord {
+    std::string endpoint;
+    std::string cookie;
+    std::chrono::system_clock::time_point arrivedAt;
+    std::chrono::steady_clock::time_point arrivedSteady;
+    // CreateOrder 的结果：success / not_on_sale / failure / sold_out；其他接口为空
+    std::string outcome;
+};
+
+// 本地 HTTPS 模拟微店上游（仅监听回环地址），实现加购页 data-obj、CreateOrder、ReConfirmOrder、
+// 库存/SKU 与 getUserInfoById。按路径分发，不区分主机名，客户端用 HttpClient::overrideHost 指向这里。
+class MockUpstream {
+public:
+    MockUpstream(MockUpstreamConfig config, const TestCertificate& certificate);
+    ~MockUpstream();
+    MockUpstream(const MockUpstream&) = delete;
+    MockUpstream& operator=(const MockUpstream&) = delete;
+
+    void start();
+    void stop();
+
+    std::uint16_t port() const noexcept { return port_; }
+    const std::string& address() const noexcept { return config_.address; }
+
+    std::vector<MockRequestRecord> records() const;
+    void clearRecords();
+
+    struct Reply {
+        unsigned status{200};
+        std::string contentType;
+        std::string body;
+    };
+    // 供会话调用，按路径生成响应并记录请求
+    Reply handle(std::string_view method, std::string_view target, std::string_view cookie, std::string_view body);
+    std::chrono::microseconds nextLatency();
+
+private:
+    Reply createOrder(std::string_view cookie, MockRequestRecord& record);
+    Reply reconfirmOrder();
+    Reply inventory();
+    Reply skuInfo();
+    Reply userInfo(std::string_view cookie);
+    Reply addOrderPage();
+    int currentStock(std::chrono::system_clock::time_point now) const;
+
+    void accept();
+
+    MockUpstreamConfig config_;
+    boost::asio::io_context io_;
+    boost::asio::ssl::context ssl_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::uint16_t port_{0};
+    std::vector<std::thread> threads_;
+    std::string addOrderHtml_;
+
+    mutable std::mutex mutex_;
+    std::vector<MockRequestRecord> records_;
+    std::unordered_map<std::string, std::size_t> createAttempts_;
+    int sold_{0};
+    std::mt19937 rng_{20240601};
+};
+
+} // namespace quickgrab::mock
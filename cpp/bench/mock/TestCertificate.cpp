@@ -0,0 +1,106 @@
+#include "mock/TestCertificate.hpp"
+
+#include <openssl/bio.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <openssl/x509v3.h>
+
+#include <memory>
+#include <stdexcept>
+
+namespace quickgrab::mock {
+namespace {
+
+using PkeyPtr = std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)>;
+using X509Ptr = std::unique_ptr<X509, decltype(&X509_free)>;
+
+void check(int ok, const char* what) {
+    if (ok <= 0) {
+        throw std::runtime_error(std::string{"生成测试证书失败: "} + what);
+    }
+}
+
+PkeyPtr generateKey() {
+    std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr),
+                                                                    &EVP_PKEY_CTX_free);
+    check(ctx != nullptr, "EVP_PKEY_CTX_new_id");
+    check(EVP_PKEY_keygen_init(ctx.get()), "keygen_init");
+    check(EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx.get(), NID_X9_62_prime256v1), "curve");
+    EVP_PKEY* key = nullptr;
+    check(EVP_PKEY_keygen(ctx.get(), &key), "keygen");
+    return PkeyPtr(key, &EVP_PKEY_free);
+}
+
+void addExtension(X509* cert, X509* issuer, int nid, const std::string& value) {
+    X509V3_CTX ctx;
+    X509V3_set_ctx_nodb(&ctx);
+    X509V3_set_ctx(&ctx, issuer, cert, nullptr, nullptr, 0);
+    std::unique_ptr<X509_EXTENSION, decltype(&X509_EXTENSION_free)> ext(
+        X509V3_EXT_conf_nid(nullptr, &ctx, nid, value.c_str()), &X509_EXTENSION_free);
+    check(ext != nullptr, "X509V3_EXT_conf_nid");
+    check(X509_add_ext(cert, ext.get(), -1), "X509_add_ext");
+}
+
+X509Ptr makeCertificate(EVP_PKEY* key, const char* commonName, long serial) {
+    X509Ptr cert(X509_new(), &X509_free);
+    check(cert != nullptr, "X509_new");
+    check(X509_set_version(cert.get(), 2), "version");
+    check(ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), serial), "serial");
+    // 起始时间回拨一小时，容忍本机与容器间的时钟偏差
+    X509_gmtime_adj(X509_getm_notBefore(cert.get()), -3600);
+    X509_gmtime_adj(X509_getm_notAfter(cert.get()), 7L * 24 * 3600);
+    check(X509_set_pubkey(cert.get(), key), "pubkey");
+    auto* name = X509_get_subject_name(cert.get());
+    X509_NAME_add_entry_by_txt(name, "O", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("QuickGrab Mock"), -1, -1, 0);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>(commonName), -1, -1, 0);
+    return cert;
+}
+
+std::string toPem(X509* cert) {
+    std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new(BIO_s_mem()), &BIO_free);
+    check(PEM_write_bio_X509(bio.get(), cert), "PEM_write_bio_X509");
+    char* data = nullptr;
+    const auto size = BIO_get_mem_data(bio.get(), &data);
+    return std::string(data, static_cast<std::size_t>(size));
+}
+
+std::string toPem(EVP_PKEY* key) {
+    std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new(BIO_s_mem()), &BIO_free);
+    check(PEM_write_bio_PrivateKey(bio.get(), key, nullptr, nullptr, 0, nullptr, nullptr), "PEM_write_bio_PrivateKey");
+    char* data = nullptr;
+    const auto size = BIO_get_mem_data(bio.get(), &data);
+    return std::string(data, static_cast<std::size_t>(size));
+}
+
+} // namespace
+
+TestCertificate generateTestCertificate(const std::vector<std::string>& dnsNames) {
+    auto caKey = generateKey();
+    auto ca = makeCertificate(caKey.get(), "QuickGrab Mock CA", 1);
+    check(X509_set_issuer_name(ca.get(), X509_get_subject_name(ca.get())), "issuer");
+    addExtension(ca.get(), ca.get(), NID_basic_constraints, "critical,CA:TRUE");
+    addExtension(ca.get(), ca.get(), NID_key_usage, "critical,keyCertSign,cRLSign");
+    addExtension(ca.get(), ca.get(), NID_subject_key_identifier, "hash");
+    check(X509_sign(ca.get(), caKey.get(), EVP_sha256()), "sign ca");
+
+    auto leafKey = generateKey();
+    auto leaf = makeCertificate(leafKey.get(), dnsNames.empty() ? "localhost" : dnsNames.front().c_str(), 2);
+    check(X509_set_issuer_name(leaf.get(), X509_get_subject_name(ca.get())), "issuer");
+    std::string san = "IP:127.0.0.1";
+    for (const auto& name : dnsNames) {
+        san.append(",DNS:").append(name);
+    }
+    addExtension(leaf.get(), ca.get(), NID_basic_constraints, "critical,CA:FALSE");
+    addExtension(leaf.get(), ca.get(), NID_key_usage, "critical,digitalSignature");
+    addExtension(leaf.get(), ca.get(), NID_ext_key_usage, "serverAuth");
+    addExtension(leaf.get(), ca.get(), NID_subject_alt_name, san);
+    addExtension(leaf.get(), ca.get(), NID_authority_key_identifier, "keyid:always");
+    check(X509_sign(leaf.get(), caKey.get(), EVP_sha256()), "sign leaf");
+
+    return TestCertificate{toPem(ca.get()), toPem(leaf.get()), toPem(leafKey.get())};
+}
+
+} // namespace quickgrab::mock
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace quickgrab::mock {
+
+// 进程内生成的测试 CA 与由其签发的服务器证书（P-256，有效期 7 天），全部为 PEM 文本。
+// 客户端通过 HttpClient::trustCertificateAuthority(caPem) 信任该 CA 后即可完整校验证书链与主机名。
+struct TestCertificate {
+    std::string caPem;
+    std::string certPem;
+    std::string keyPem;
+};
+
+// dnsNames 写入 subjectAltName，可含通配符（如 *.weidian.com）；127.0.0.1 总会作为 IP SAN 加入
+TestCertificate generateTestCertificate(const std::vector<std::string>& dnsNames);
+
+} // namespace quickgrab::mock
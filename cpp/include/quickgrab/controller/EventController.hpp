@@ -0,0 +1,22 @@
+#pragma once
+
+#include "quickgrab/server/Router.hpp"
+#include "quickgrab/service/AuthService.hpp"
+#include "quickgrab/service/GrabEventBus.hpp"
+
+namespace quickgrab::controller {
+
+class EventController {
+public:
+    EventController(service::GrabEventBus& eventBus, service::AuthService& authService);
+
+    void registerRoutes(quickgrab::server::Router& router);
+
+private:
+    void handleEvents(quickgrab::server::RequestContext& ctx);
+
+    service::GrabEventBus& eventBus_;
+    service::AuthService& authService_;
+};
+
+} // namespace quickgrab::controller
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "quickgrab/server/Router.hpp"
+
+namespace quickgrab::proxy {
+class ProxyPool;
+}
+
+namespace quickgrab::repository {
+class DatabaseExecutor;
+class MySqlConnectionPool;
+}
+
+namespace quickgrab::controller {
+
+// GET /metrics：Prometheus 文本格式。连接池、代理池、数据库执行器等状态在抓取时采样为 gauge
+// GET /api/traces?limit=&requestId=：最近完成的抢购时间线，Chrome trace 格式
+// GET /api/latency：按 (主机, 代理) 的实测时延估计（EWMA 与分位数）及据此推算的开抢提前量
+class MetricsController {
+public:
+    MetricsController(repository::MySqlConnectionPool& connectionPool,
+                      proxy::ProxyPool& proxyPool,
+                      repository::DatabaseExecutor& database);
+
+    void registerRoutes(quickgrab::server::Router& router);
+
+private:
+    void handleMetrics(quickgrab::server::RequestContext& ctx);
+    void handleTraces(quickgrab::server::RequestContext& ctx);
+    void handleLatency(quickgrab::server::RequestContext& ctx);
+    void sample();
+
+    repository::MySqlConnectionPool& connectionPool_;
+    proxy::ProxyPool& proxyPool_;
+    repository::DatabaseExecutor& database_;
+};
+
+} // namespace quickgrab::controller
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "quickgrab/repository/DatabaseExecutor.hpp"
 #include "quickgrab/server/Router.hpp"
 #include "quickgrab/service/QueryService.hpp"
 
@@ -7,7 +8,7 @@ namespace quickgrab::controller {
 
 class QueryController {
 public:
-    explicit QueryController(service::QueryService& queryService);
+    QueryController(service::QueryService& queryService, repository::DatabaseExecutor& database);
 
     void registerRoutes(quickgrab::server::Router& router);
 
@@ -18,9 +19,11 @@ private:
     void handleDeleteRequest(quickgrab::server::RequestContext& ctx, int requestId);
     void handleDeleteResult(quickgrab::server::RequestContext& ctx, int resultId);
     void handleGetResult(quickgrab::server::RequestContext& ctx, int resultId);
+    void handleGetRequest(quickgrab::server::RequestContext& ctx, int requestId);
     void handleGetBuyers(quickgrab::server::RequestContext& ctx);
 
     service::QueryService& queryService_;
+    repository::DatabaseExecutor& database_;
 };
 
 } // namespace quickgrab::controller
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "quickgrab/repository/DatabaseExecutor.hpp"
 #include "quickgrab/server/Router.hpp"
 #include "quickgrab/service/StatisticsService.hpp"
 
@@ -7,7 +8,7 @@ namespace quickgrab::controller {
 
 class StatisticsController {
 public:
-    explicit StatisticsController(service::StatisticsService& statisticsService);
+    StatisticsController(service::StatisticsService& statisticsService, repository::DatabaseExecutor& database);
 
     void registerRoutes(quickgrab::server::Router& router);
 
@@ -18,6 +19,7 @@ private:
     void handleBuyers(quickgrab::server::RequestContext& ctx);
 
     service::StatisticsService& statisticsService_;
+    repository::DatabaseExecutor& database_;
 };
 
 } // namespace quickgrab::controller
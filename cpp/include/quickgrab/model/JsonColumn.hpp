@@ -0,0 +1,56 @@
+#pragma once
+
+#include <boost/json.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace quickgrab::model {
+
+// 数据库 JSON 文本列的延迟解析包装：映射行时只保存原文，第一次 get() 时才解析。
+// 副本共享同一份原文与解析结果（解析只执行一次且线程安全），mutate() 时写时复制。
+class JsonColumn {
+public:
+    JsonColumn() = default;
+    JsonColumn(boost::json::value value);
+    JsonColumn& operator=(boost::json::value value);
+
+    // 原文解析失败时回退为 fallback 并告警；column 须为静态字符串（列名字面量）。
+    // trusted 表示来自 MySQL JSON 类型列，服务器写入时已校验，原文无需再校验即可透传
+    static JsonColumn fromRaw(std::string raw, boost::json::value fallback, std::string_view column,
+                              bool trusted = false);
+
+    const boost::json::value& get() const;
+    // 返回可修改的值，与其他副本共享时先复制一份
+    boost::json::value& mutate();
+
+    bool parsed() const noexcept;
+    // 来自数据库、尚未修改且内容合法的原文，否则为 nullptr；可原样输出或写回数据库。
+    // trusted 的原文直接返回；已解析的按解析结果；其余做一次不建 DOM 的校验
+    const std::string* raw() const;
+
+    bool is_null() const { return get().is_null(); }
+    bool is_object() const { return get().is_object(); }
+    bool is_array() const { return get().is_array(); }
+    const boost::json::object& as_object() const { return get().as_object(); }
+    const boost::json::object* if_object() const { return get().if_object(); }
+
+private:
+    struct State {
+        std::string raw;
+        std::string_view column;
+        boost::json::value value;
+        std::once_flag once;
+        std::atomic<bool> parsed{false};
+        bool trusted{false};
+        // 在 parsed 置位前写入，读取前先 acquire parsed
+        bool failed{false};
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace quickgrab::model
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "quickgrab/model/JsonColumn.hpp"
+
 #include <boost/json.hpp>
 #include <chrono>
 #include <optional>
@@ -14,9 +16,9 @@ struct Request {
     std::string threadId;
     std::string link;
     std::string cookies;
-    boost::json::value orderInfo;
-    boost::json::value userInfo;
-    boost::json::value orderTemplate;
+    JsonColumn orderInfo;
+    JsonColumn userInfo;
+    JsonColumn orderTemplate;
     std::string message;
     std::string idNumber;
     std::string keyword;
@@ -28,10 +30,10 @@ struct Request {
     int type{};
     int status{};
     std::string orderParametersRaw;
-    boost::json::value orderParameters;
+    JsonColumn orderParameters;
     double actualEarnings{};
     double estimatedEarnings{};
-    boost::json::value extension;
+    JsonColumn extension;
 };
 
 } // namespace quickgrab::model
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "quickgrab/model/JsonColumn.hpp"
+
 #include <boost/json.hpp>
 #include <chrono>
 #include <optional>
@@ -15,9 +17,9 @@ struct Result {
     std::string threadId;
     std::string link;
     std::string cookies;
-    boost::json::value orderInfo;
-    boost::json::value userInfo;
-    boost::json::value orderTemplate;
+    JsonColumn orderInfo;
+    JsonColumn userInfo;
+    JsonColumn orderTemplate;
     std::string message;
     std::string idNumber;
     std::string keyword;
@@ -28,11 +30,11 @@ struct Result {
     int frequency{};
     int type{};
     int status{};
-    boost::json::value responseMessage;
+    JsonColumn responseMessage;
     double actualEarnings{};
     double estimatedEarnings{};
-    boost::json::value extension;
-    boost::json::value payload;
+    JsonColumn extension;
+    JsonColumn payload;
     std::chrono::system_clock::time_point createdAt{};
 };
 
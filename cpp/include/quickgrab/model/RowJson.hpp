@@ -0,0 +1,91 @@
+#pragma once
+
+#include "quickgrab/model/JsonColumn.hpp"
+#include "quickgrab/model/Request.hpp"
+#include "quickgrab/model/Result.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
+
+#include <boost/json.hpp>
+
+#include <string>
+
+namespace quickgrab::model {
+
+// JSON 列：text 为可直接透传的原文（JSON 类型列由服务器保证合法，TEXT 列已校验），为空时写出 value；
+// 两者都没有（SQL NULL 或内容非法）时按各表约定回退
+struct JsonField {
+    std::string text;
+    const boost::json::value* value{};
+};
+
+JsonField jsonField(const JsonColumn& column);
+
+// 请求/结果一行的列视图。列表接口由仓储直接从数据库行填充，详情与待处理接口由模型对象转换，
+// 两条路径共用下面唯一的一组编码函数，输出字段保持一致。时间列为 "YYYY-MM-DD HH:MM:SS"，空值为空串
+struct RequestColumns {
+    int id{};
+    int deviceId{};
+    int buyerId{};
+    std::string threadId;
+    std::string link;
+    std::string cookies;
+    JsonField orderInfo;
+    JsonField userInfo;
+    JsonField orderTemplate;
+    std::string message;
+    std::string idNumber;
+    std::string keyword;
+    std::string startTime;
+    std::string endTime;
+    int quantity{};
+    int delay{};
+    int frequency{};
+    int type{};
+    int status{};
+    std::string orderParametersRaw;
+    JsonField orderParameters;
+    double actualEarnings{};
+    double estimatedEarnings{};
+    JsonField extension;
+};
+
+struct ResultColumns {
+    int id{};
+    int requestId{};
+    int deviceId{};
+    int buyerId{};
+    std::string threadId;
+    std::string link;
+    std::string cookies;
+    JsonField orderInfo;
+    JsonField userInfo;
+    JsonField orderTemplate;
+    std::string message;
+    std::string idNumber;
+    std::string keyword;
+    std::string startTime;
+    std::string endTime;
+    int quantity{};
+    int delay{};
+    int frequency{};
+    int type{};
+    int status{};
+    JsonField responseMessage;
+    double actualEarnings{};
+    double estimatedEarnings{};
+    JsonField extension;
+    JsonField payload;
+    std::string createdAt;
+};
+
+RequestColumns requestColumns(const Request& request);
+ResultColumns resultColumns(const Result& result);
+
+// 请求的 JSON 列缺失时输出 {}，结果的输出 null，与两张表映射模型时的回退一致
+void writeRequestJson(util::JsonWriter& writer, const RequestColumns& request);
+void writeResultJson(util::JsonWriter& writer, const ResultColumns& result);
+// 列表卡片的摘要投影，只写 summary 查询选出的列
+void writeRequestSummaryJson(util::JsonWriter& writer, const RequestColumns& request);
+void writeResultSummaryJson(util::JsonWriter& writer, const ResultColumns& result);
+
+} // namespace quickgrab::model
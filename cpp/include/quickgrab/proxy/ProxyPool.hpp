@@ -28,6 +28,16 @@ struct AffinityState {
 
 class ProxyPool {
 public:
+    struct Stats {
+        // 未绑定、冷却结束可立即分配的代理
+        std::size_t available{};
+        // 未绑定但仍在冷却/退避中的代理
+        std::size_t coolingDown{};
+        // 粘滞绑定在某个 affinity 上的代理
+        std::size_t sticky{};
+        std::size_t affinities{};
+    };
+
     explicit ProxyPool(std::chrono::seconds cooldown);
 
     std::optional<ProxyEndpoint> acquire(const std::string& affinityKey);
@@ -35,6 +45,7 @@ public:
     void reportFailure(const std::string& affinityKey, ProxyEndpoint proxy);
     void hydrate(std::vector<ProxyEndpoint> fresh);
     void tick();
+    Stats stats() const;
 
 private:
     std::chrono::seconds cooldown_;
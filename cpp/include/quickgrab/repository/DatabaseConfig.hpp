@@ -1,6 +1,9 @@
 #pragma once
 
 #include <boost/json.hpp>
+
+#include <chrono>
+#include <cstdint>
 #include <string>
 
 namespace quickgrab::repository {
@@ -13,6 +16,22 @@ struct DatabaseConfig {
     std::string database;
     std::string charset{"utf8mb4"};
     unsigned int poolSize{8};
+    // 关闭后每次调用都重新获取表句柄并构建语句，用于对比缓存前后的开销
+    bool statementCache{true};
+    // 启动预热并由维护任务保持的最少空闲会话数
+    unsigned int minIdle{2};
+    // 池满时 acquire 的最长等待时间
+    std::chrono::milliseconds acquireTimeout{5000};
+    // 空闲超过该时长的会话在借出前先 ping 校验
+    std::chrono::milliseconds validateAfterIdle{60000};
+    // 维护任务对空闲超过该时长的会话发送 ping，保持连接活跃
+    std::chrono::milliseconds keepaliveInterval{30000};
+    // 会话最长存活时间，到期后在归还或维护时关闭并重建
+    std::chrono::milliseconds maxLifetime{30 * 60 * 1000};
+    // 数据库执行器线程数，0 表示与连接池大小一致
+    unsigned int executorThreads{0};
+    // 数据库执行器最多排队的可丢弃任务数，超出后查询接口返回 503
+    unsigned int executorQueueLimit{1024};
 };
 
 DatabaseConfig loadConfig(const boost::json::object& json);
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "quickgrab/util/Logging.hpp"
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace quickgrab::repository {
+
+// 专门执行数据库访问的有界线程池。抢购计时、CreateOrder 与选点循环留在 worker 线程池，
+// 慢查询或锁等待只会占住这里的线程，不会推迟下单。
+class DatabaseExecutor {
+public:
+    using Offload = std::function<bool(std::function<void()>)>;
+
+    DatabaseExecutor(std::size_t threads, std::size_t maxQueued);
+    ~DatabaseExecutor();
+
+    DatabaseExecutor(const DatabaseExecutor&) = delete;
+    DatabaseExecutor& operator=(const DatabaseExecutor&) = delete;
+
+    // 投递任务；排队（含执行中）任务数达到上限时拒绝并返回 false
+    template <typename Job>
+    bool post(Job&& job) {
+        if (!tryReserve()) {
+            return false;
+        }
+        submit(std::forward<Job>(job));
+        return true;
+    }
+
+    // 不可丢弃的写入（如抢购结果落库）不受排队上限约束
+    template <typename Job>
+    void enqueue(Job&& job) {
+        queued_.fetch_add(1, std::memory_order_acq_rel);
+        submit(std::forward<Job>(job));
+    }
+
+    // 在数据库线程执行 work，再把结果和异常投递回 completionExecutor。
+    // work 有返回值时 completion 签名为 (std::exception_ptr, T)，否则为 (std::exception_ptr)。
+    template <typename Work, typename Executor, typename Completion>
+    bool dispatch(Work work, Executor completionExecutor, Completion completion) {
+        return post([work = std::move(work), completionExecutor, completion = std::move(completion)]() mutable {
+            using Value = std::invoke_result_t<Work&>;
+            std::exception_ptr error;
+            if constexpr (std::is_void_v<Value>) {
+                try {
+                    work();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                boost::asio::post(completionExecutor, [completion = std::move(completion), error]() mutable {
+                    completion(error);
+                });
+            } else {
+                Value value{};
+                try {
+                    value = work();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                boost::asio::post(completionExecutor,
+                                  [completion = std::move(completion), error, value = std::move(value)]() mutable {
+                                      completion(error, std::move(value));
+                                  });
+            }
+        });
+    }
+
+    // 供 Router::addAsyncRoute 使用的投递函数
+    Offload offloader();
+
+    // 等待已投递的任务全部完成
+    void join();
+
+    std::size_t queued() const noexcept { return queued_.load(std::memory_order_acquire); }
+    std::size_t maxQueued() const noexcept { return maxQueued_; }
+    std::uint64_t rejected() const noexcept { return rejected_.load(std::memory_order_acquire); }
+    std::uint64_t completed() const noexcept { return completed_.load(std::memory_order_acquire); }
+
+private:
+    bool tryReserve();
+
+    template <typename Job>
+    void submit(Job&& job) {
+        boost::asio::post(pool_, [this, job = std::forward<Job>(job)]() mutable {
+            try {
+                job();
+            } catch (const std::exception& ex) {
+                util::log(util::LogLevel::error, std::string{"数据库任务异常: "} + ex.what());
+            } catch (...) {
+                util::log(util::LogLevel::error, "数据库任务发生未知异常");
+            }
+            queued_.fetch_sub(1, std::memory_order_acq_rel);
+            completed_.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    boost::asio::thread_pool pool_;
+    std::size_t maxQueued_;
+    std::atomic<std::size_t> queued_{0};
+    std::atomic<std::uint64_t> rejected_{0};
+    std::atomic<std::uint64_t> completed_{0};
+};
+
+} // namespace quickgrab::repository
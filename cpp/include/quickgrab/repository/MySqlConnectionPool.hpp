@@ -4,35 +4,142 @@
 
 #include <mysqlx/xdevapi.h>
 
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace quickgrab::repository {
 
+// 单个池化会话上的表句柄与 CRUD 语句缓存。X DevAPI 对同一语句对象重复执行且只改变绑定参数时
+// 会自动改用服务端预处理语句，因此热点操作缓存语句对象后每次只需重新 bind。
+// 语句按 key 缓存，同一 key 必须始终对应同一种语句类型。
+class StatementCache {
+public:
+    StatementCache(mysqlx::Session& session, std::string schemaName, bool enabled);
+
+    mysqlx::Table& table(const std::string& name);
+
+    template <typename Statement, typename Factory>
+    Statement& get(const std::string& key, Factory&& factory) {
+        auto it = statements_.find(key);
+        if (it == statements_.end() || !enabled_) {
+            auto statement = std::make_shared<Statement>(factory(*this));
+            it = statements_.insert_or_assign(key, std::move(statement)).first;
+        }
+        return *static_cast<Statement*>(it->second.get());
+    }
+
+private:
+    mysqlx::Schema& schema();
+
+    mysqlx::Session& session_;
+    std::string schemaName_;
+    bool enabled_;
+    std::optional<mysqlx::Schema> schema_;
+    std::unordered_map<std::string, mysqlx::Table> tables_;
+    std::unordered_map<std::string, std::shared_ptr<void>> statements_;
+};
+
+class MySqlConnectionPool;
+
+struct PooledSession {
+    PooledSession(std::unique_ptr<mysqlx::Session> sessionPtr,
+                  const std::string& schemaName,
+                  bool cacheStatements,
+                  std::chrono::steady_clock::time_point expiresAt);
+
+    std::unique_ptr<mysqlx::Session> session;
+    StatementCache statements;
+    std::chrono::steady_clock::time_point expiresAt;
+    // 最近一次确认可用的时间（成功归还或 ping 通过）
+    std::chrono::steady_clock::time_point lastVerified;
+    // 借出期间抛出过异常，下次借出前必须先校验
+    bool suspect{false};
+};
+
+// acquire() 返回的租约，析构时把会话连同语句缓存归还连接池。
+// 若在异常传播过程中析构，会话被标记为可疑，下次借出前先 ping 校验，失败则丢弃重建。
+class SessionLease {
+public:
+    SessionLease(MySqlConnectionPool* pool, std::unique_ptr<PooledSession> pooled);
+    SessionLease(SessionLease&& other) noexcept;
+    SessionLease& operator=(SessionLease&& other) noexcept;
+    SessionLease(const SessionLease&) = delete;
+    SessionLease& operator=(const SessionLease&) = delete;
+    ~SessionLease();
+
+    mysqlx::Session* operator->() const noexcept { return pooled_->session.get(); }
+    mysqlx::Session& operator*() const noexcept { return *pooled_->session; }
+    StatementCache& statements() const noexcept { return pooled_->statements; }
+
+private:
+    void reset() noexcept;
+
+    MySqlConnectionPool* pool_{};
+    std::unique_ptr<PooledSession> pooled_;
+    int uncaughtAtAcquire_{};
+};
+
+// 在 acquireTimeout 内拿不到会话时抛出
+class ConnectionPoolTimeout : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
 class MySqlConnectionPool {
 public:
+    struct Stats {
+        unsigned int total{};
+        unsigned int idle{};
+        unsigned int inUse{};
+        unsigned int waiting{};
+        std::uint64_t acquired{};
+        std::uint64_t timeouts{};
+        std::uint64_t created{};
+        std::uint64_t destroyed{};
+        std::uint64_t validationFailures{};
+        std::chrono::microseconds totalWait{};
+        std::chrono::microseconds maxWait{};
+    };
+
     explicit MySqlConnectionPool(DatabaseConfig config);
 
-    std::shared_ptr<mysqlx::Session> acquire();
+    SessionLease acquire();
+
+    // 启动时建立 minIdle 个会话；失败只记录日志，由 maintain() 继续补齐
+    void warmUp();
+    // 周期性维护：关闭到期会话、ping 空闲会话、补齐最少空闲数。会阻塞，需在工作线程调用
+    void maintain();
+    Stats stats();
 
     const std::string& schemaName() const noexcept { return config_.database; }
+    const DatabaseConfig& config() const noexcept { return config_; }
 
 private:
-    struct SessionDeleter {
-        MySqlConnectionPool* pool;
-        void operator()(mysqlx::Session* session) const noexcept;
-    };
+    friend class SessionLease;
 
     std::unique_ptr<mysqlx::Session> createSession();
-    void release(mysqlx::Session* session);
+    std::unique_ptr<PooledSession> createPooled();
+    bool ping(PooledSession& pooled);
+    void discard(std::unique_ptr<PooledSession> pooled);
+    void release(std::unique_ptr<PooledSession> pooled, bool suspect);
+    void refill();
 
     DatabaseConfig config_;
     std::mutex mutex_;
     std::condition_variable cv_;
-    std::vector<std::unique_ptr<mysqlx::Session>> idle_;
+    // 后进先出，优先复用最近用过的会话，其余会话自然老化后由维护任务回收
+    std::vector<std::unique_ptr<PooledSession>> idle_;
     unsigned int currentSize_{};
+    unsigned int waiting_{};
+    Stats counters_{};
 };
 
 } // namespace quickgrab::repository
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <mysqlx/xdevapi.h>
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quickgrab::repository {
+
+struct ListFilter {
+    std::optional<std::string> keyword;
+    std::optional<int> buyerId;
+    std::optional<int> type;
+    std::optional<int> status;
+    // 表上已有 sql/002_keyword_search.sql 建立的 user_search 全文索引时由仓储置位
+    bool keywordIndexed{false};
+};
+
+// 键集分页游标：上一页最后一行的排序列取值与 id。value 为空表示该行排序列为 NULL。
+struct ListCursor {
+    std::optional<std::string> value;
+    int id{};
+};
+
+struct ListPageRequest {
+    ListFilter filter;
+    std::string_view orderColumn;
+    std::string_view orderDirection;
+    std::optional<ListCursor> after;
+    int limit{};
+    // 列表视图只取渲染所需列，完整记录由详情接口加载
+    bool summary{true};
+};
+
+struct ListPageResult {
+    std::size_t count{};
+    std::optional<ListCursor> next;
+};
+
+struct TotalCount {
+    std::int64_t value{};
+    bool exact{true};
+};
+
+// 游标格式为 "<id>" 或 "<id>.<YYYY-MM-DD HH:MM:SS>"，对客户端不透明。
+std::string encodeCursor(const ListCursor& cursor);
+std::optional<ListCursor> decodeCursor(std::string_view text);
+
+// 追加 WHERE 条件，参数按顺序写入 params。关键词在 keywordIndexed 时走 user_search 的
+// ngram 全文索引（单字退化为 user_search LIKE），否则保持旧的 user_info LIKE 全表扫描。
+void appendFilterConditions(std::ostringstream& sql,
+                            std::vector<mysqlx::Value>& params,
+                            const ListFilter& filter);
+
+// 追加 (排序列, id) 的键集条件。排序列可为 NULL：MySQL 升序时 NULL 在前、降序时在后。
+void appendKeysetCondition(std::ostringstream& sql,
+                           std::vector<mysqlx::Value>& params,
+                           std::string_view orderColumn,
+                           std::string_view orderDirection,
+                           const ListCursor& cursor);
+
+std::string buildKeysetOrderClause(std::string_view orderColumn, std::string_view orderDirection, int limit);
+
+// 无筛选条件时用 information_schema 的行数估计，避免 COUNT(*) 全表扫描；
+// 有 buyer/type/status 条件时走组合索引做精确计数；关键词只在有全文索引时计数。
+std::optional<TotalCount> countRows(mysqlx::Session& session,
+                                    const std::string& schema,
+                                    std::string_view table,
+                                    const ListFilter& filter);
+
+// 探测表上是否已执行关键词索引迁移。成功探测的结果缓存到进程结束，
+// 探测失败时本次按未建索引处理，下次调用重试。
+class KeywordIndexProbe {
+public:
+    explicit KeywordIndexProbe(std::string table);
+
+    bool available(mysqlx::Session& session, const std::string& schema);
+
+private:
+    std::string table_;
+    std::atomic<int> state_{-1};
+};
+
+} // namespace quickgrab::repository
@@ -2,9 +2,13 @@
 
 #include "quickgrab/model/Request.hpp"
 #include "quickgrab/repository/MySqlConnectionPool.hpp"
+#include "quickgrab/repository/Pagination.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
 
 #include <mysqlx/xdevapi.h>
 
+#include <atomic>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -25,15 +29,37 @@ public:
                                               std::string_view orderDirection,
                                               int offset,
                                               int limit);
+    // 与 findByFilters 相同的查询，但逐行直接编码为 JSON 数组写入 writer，返回行数
+    std::size_t writeByFilters(const std::optional<std::string>& keyword,
+                               const std::optional<int>& buyerId,
+                               const std::optional<int>& type,
+                               const std::optional<int>& status,
+                               std::string_view orderColumn,
+                               std::string_view orderDirection,
+                               int offset,
+                               int limit,
+                               util::JsonWriter& writer);
+    // 键集分页：按 (排序列, id) 续读，写出 JSON 数组并返回下一页游标
+    ListPageResult writePage(const ListPageRequest& page, util::JsonWriter& writer);
+    std::optional<TotalCount> countByFilters(const ListFilter& filter);
+    std::optional<model::Request> findById(int requestId);
     int insert(const model::Request& request);
     void updateStatus(int requestId, int status);
     void updateThreadId(int requestId, const std::string& threadId);
     void deleteById(int requestId);
 
+    // 本进程内成功写入后递增，用于生成 ETag；其他进程直接写库不会反映在这里
+    std::uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
 private:
-    model::Request mapRow(mysqlx::Row row);
+    void bumpVersion() { version_.fetch_add(1, std::memory_order_acq_rel); }
+
+    // json 为结果集各列是否为 MySQL JSON 类型，见 jsonColumnTypes
+    model::Request mapRow(mysqlx::Row row, const std::vector<bool>& json);
 
     MySqlConnectionPool& pool_;
+    KeywordIndexProbe keywordIndex_;
+    std::atomic<std::uint64_t> version_{1};
 };
 
 } // namespace quickgrab::repository
@@ -2,10 +2,13 @@
 
 #include "quickgrab/model/Result.hpp"
 #include "quickgrab/repository/MySqlConnectionPool.hpp"
+#include "quickgrab/repository/Pagination.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
 
 #include <boost/json.hpp>
 #include <mysqlx/xdevapi.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <optional>
@@ -19,7 +22,7 @@ class ResultsRepository {
 public:
     explicit ResultsRepository(MySqlConnectionPool& pool);
 
-    void insertResult(const model::Result& result);
+    int insertResult(const model::Result& result);
     std::optional<model::Result> findById(int resultId);
     void deleteById(int resultId);
     std::vector<model::Result> findByFilters(const std::optional<std::string>& keyword,
@@ -30,6 +33,19 @@ public:
                                              std::string_view orderDirection,
                                              int offset,
                                              int limit);
+    // 与 findByFilters 相同的查询，但逐行直接编码为 JSON 数组写入 writer，返回行数
+    std::size_t writeByFilters(const std::optional<std::string>& keyword,
+                               const std::optional<int>& buyerId,
+                               const std::optional<int>& type,
+                               const std::optional<int>& status,
+                               std::string_view orderColumn,
+                               std::string_view orderDirection,
+                               int offset,
+                               int limit,
+                               util::JsonWriter& writer);
+    // 键集分页：按 (排序列, id) 续读，写出 JSON 数组并返回下一页游标
+    ListPageResult writePage(const ListPageRequest& page, util::JsonWriter& writer);
+    std::optional<TotalCount> countByFilters(const ListFilter& filter);
 
     struct AggregatedStats {
         std::string type;
@@ -63,8 +79,31 @@ public:
     std::vector<HourlyStat> getHourlyStats(const std::optional<int>& buyerId,
                                            const std::optional<int>& status);
 
+    // 启动时调用：确认 result_rollups 汇总表存在，表为空而 results 有数据时先回填。
+    // 返回 false 表示未执行 sql/003_result_rollups.sql，统计接口继续实时聚合 results。
+    bool prepareRollups();
+    // 按 results 全量重建汇总表（quickgrab_app --rebuild-rollups）。重建期间锁住 results 与 result_rollups，
+    // 其他实例的结果写入会等待重建完成，可在服务运行时执行
+    void rebuildRollups();
+
+    // 本进程内成功写入后递增，用于生成 ETag；其他进程直接写库不会反映在这里
+    std::uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
 private:
+    void bumpVersion() { version_.fetch_add(1, std::memory_order_acq_rel); }
+
+    std::vector<AggregatedStats> getStatisticsFromRollups(const std::optional<int>& buyerId,
+                                                          const std::optional<std::string>& startTime,
+                                                          const std::optional<std::string>& endTime);
+    std::vector<DailyStat> getDailyStatsFromRollups(const std::optional<int>& buyerId,
+                                                    const std::optional<int>& status);
+    std::vector<HourlyStat> getHourlyStatsFromRollups(const std::optional<int>& buyerId,
+                                                      const std::optional<int>& status);
+
     MySqlConnectionPool& pool_;
+    KeywordIndexProbe keywordIndex_;
+    std::atomic<std::uint64_t> version_{1};
+    std::atomic<bool> rollupsEnabled_{false};
 };
 
 } // namespace quickgrab::repository
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <boost/beast/core/tcp_stream.hpp>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace quickgrab::server {
+
+// 分块传输的响应体：接管 HttpSession 写完头部后移交的 tcp_stream，在连接自身的 strand 上
+// 逐块 async_write，每块都有写超时，读得慢或不读的客户端到期即断开，不占用任何执行器线程。
+// 内容须在移交前全部生成好（查询结束、数据库会话已归还），这里只做网络写出。
+class ChunkedResponse : public std::enable_shared_from_this<ChunkedResponse> {
+public:
+    ChunkedResponse(boost::beast::tcp_stream stream,
+                    std::vector<std::string> chunks,
+                    std::chrono::seconds writeTimeout = std::chrono::seconds{30});
+
+    void start();
+
+private:
+    void doWrite();
+    void shutdown();
+
+    boost::beast::tcp_stream stream_;
+    std::deque<std::string> chunks_;
+    std::chrono::seconds writeTimeout_;
+    bool lastSent_{false};
+};
+
+} // namespace quickgrab::server
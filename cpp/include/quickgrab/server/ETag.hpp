@@ -0,0 +1,20 @@
+#pragma once
+
+#include "quickgrab/server/RequestContext.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace quickgrab::server {
+
+// 由数据版本号与请求目标（路径 + 查询串）派生强 ETag。
+// 进程启动时生成的随机盐也参与计算，重启后版本号归零不会与旧 ETag 冲突。
+std::string makeETag(std::initializer_list<std::uint64_t> versions, std::string_view target);
+
+// If-None-Match 命中时写出 304 并返回 true，调用方应直接返回而不再访问数据库；
+// 未命中时只设置 ETag/Cache-Control 头，由调用方继续生成响应体。
+bool handleConditionalGet(RequestContext& ctx, const std::string& etag);
+
+} // namespace quickgrab::server
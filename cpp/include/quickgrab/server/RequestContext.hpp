@@ -1,8 +1,11 @@
 #pragma once
 
+#include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/http.hpp>
 #include <chrono>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace quickgrab::server {
@@ -10,11 +13,18 @@ namespace quickgrab::server {
 struct RequestContext {
     using HttpRequest = boost::beast::http::request<boost::beast::http::string_body>;
     using HttpResponse = boost::beast::http::response<boost::beast::http::string_body>;
+    using StreamHandler = std::function<void(boost::beast::tcp_stream stream)>;
 
     HttpRequest request;
     HttpResponse response;
     std::unordered_map<std::string, std::string> pathParameters;
     std::chrono::steady_clock::time_point startedAt;
+    // 匹配到的路由模板，未匹配时为空
+    std::string_view route;
+
+    // 处理器设置后，HttpSession 只写出 response 头部，随后在连接的 strand 上把连接整体移交给该回调，
+    // 用于 SSE、分块输出等；回调只能发起异步操作，不得阻塞。连接此后不再回到 keep-alive 循环。
+    StreamHandler streamHandler;
 };
 
 } // namespace quickgrab::server
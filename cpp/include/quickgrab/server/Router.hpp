@@ -5,6 +5,7 @@
 #include <functional>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -13,11 +14,29 @@ namespace quickgrab::server {
 class Router {
 public:
     using Handler = std::function<void(RequestContext&)>;
+    // 把任务投递到其他执行器（如数据库执行器），队列已满时返回 false
+    using Offload = std::function<bool(std::function<void()>)>;
+    // 投递前在 I/O 线程上运行的廉价检查（如 If-None-Match 命中时直接 304），返回 true 表示响应已写好、无需投递
+    using Precheck = std::function<bool(RequestContext&)>;
+
+    struct Route {
+        Handler handler;
+        Offload offload;
+        Precheck precheck;
+        // 注册时的路由模板（如 /api/getRequest/:id），用作指标标签
+        std::string_view path;
+
+        explicit operator bool() const noexcept { return static_cast<bool>(handler); }
+    };
 
     void addRoute(std::string method, std::string path, Handler handler);
-    Handler resolve(const std::string& method,
-                    const std::string& path,
-                    std::unordered_map<std::string, std::string>& params) const;
+    // 处理器经 offload 投递到其他线程执行，完成后由 HttpSession 回到连接所在的 strand 写响应；
+    // 设置了 streamHandler 时流式输出回到连接的 strand 上异步进行，不占用该执行器。
+    void addAsyncRoute(std::string method, std::string path, Handler handler, Offload offload,
+                       Precheck precheck = {});
+    Route resolve(const std::string& method,
+                  const std::string& path,
+                  std::unordered_map<std::string, std::string>& params) const;
 
 private:
     struct RouteEntry {
@@ -26,6 +45,8 @@ private:
         std::regex pattern;
         std::vector<std::string> tokens;
         Handler handler;
+        Offload offload;
+        Precheck precheck;
     };
 
     std::vector<RouteEntry> routes_;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace quickgrab::server {
+
+// Server-Sent Events 连接：接管 HttpSession 移交的 tcp_stream，所有写操作都在连接自身的
+// strand 上串行执行，可从任意线程调用 send()。
+class SseChannel : public std::enable_shared_from_this<SseChannel> {
+public:
+    explicit SseChannel(boost::beast::tcp_stream stream,
+                        std::chrono::seconds heartbeat = std::chrono::seconds{15},
+                        std::size_t maxPending = 256);
+
+    void start(std::function<void()> onClosed);
+    void send(std::string event, std::string data);
+    void close();
+
+private:
+    void enqueue(std::string frame);
+    void doWrite();
+    void scheduleHeartbeat();
+    void watchPeer();
+    void shutdown();
+
+    boost::beast::tcp_stream stream_;
+    boost::asio::steady_timer heartbeatTimer_;
+    boost::beast::flat_buffer readBuffer_;
+    std::chrono::seconds heartbeat_;
+    std::size_t maxPending_;
+    std::deque<std::string> pending_;
+    std::function<void()> onClosed_;
+    bool writing_{false};
+    bool closed_{false};
+};
+
+} // namespace quickgrab::server
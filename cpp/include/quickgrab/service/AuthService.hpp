@@ -47,6 +47,9 @@ public:
     std::optional<model::Buyer> getBuyerByToken(const std::string& token);
 
 private:
+    // 基准测试无数据库时经此预置会话，仅在 bench/QuickgrabBench.cpp 中定义
+    friend struct AuthServiceBenchAccess;
+
     struct StoredSession {
         model::Buyer buyer;
         std::chrono::system_clock::time_point expiresAt;
@@ -59,6 +62,8 @@ private:
     std::mutex mutex_;
     std::unordered_map<std::string, StoredSession> sessions_;
 
+    // 为已通过校验的买家签发会话（authenticate 成功后调用）
+    SessionInfo issueSession(const model::Buyer& buyer, bool rememberMe);
     std::string generateToken();
     void purgeExpiredLocked(std::chrono::system_clock::time_point now);
 };
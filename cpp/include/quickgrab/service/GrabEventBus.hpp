@@ -0,0 +1,59 @@
+#pragma once
+
+#include <boost/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace quickgrab::service {
+
+struct GrabEvent {
+    enum class Kind {
+        request_status,
+        request_removed,
+        result_created
+    };
+
+    Kind kind{Kind::request_status};
+    int buyerId{};
+    int requestId{};
+    int resultId{};
+    int type{};
+    int status{};
+    std::string message;
+    boost::json::value detail;
+    std::chrono::system_clock::time_point at{};
+};
+
+// 进程内抢购事件总线：GrabService 发布请求状态变化与新结果，SSE 连接按买家订阅。
+// 回调在发布者线程上同步执行，订阅方必须自行切换到自己的执行器，不能阻塞。
+class GrabEventBus {
+public:
+    using Subscriber = std::function<void(const GrabEvent&)>;
+    using SubscriptionId = std::uint64_t;
+
+    SubscriptionId subscribe(std::optional<int> buyerId, Subscriber subscriber);
+    void unsubscribe(SubscriptionId id);
+    void publish(const GrabEvent& event);
+    std::size_t subscriberCount() const;
+
+private:
+    struct Entry {
+        std::optional<int> buyerId;
+        Subscriber subscriber;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<SubscriptionId, Entry> subscribers_;
+    SubscriptionId nextId_{1};
+};
+
+const char* toString(GrabEvent::Kind kind);
+boost::json::object toJson(const GrabEvent& event);
+
+} // namespace quickgrab::service
@@ -2,8 +2,10 @@
 
 #include "quickgrab/proxy/KdlProxyClient.hpp"
 #include "quickgrab/proxy/ProxyPool.hpp"
+#include "quickgrab/repository/DatabaseExecutor.hpp"
 #include "quickgrab/repository/RequestsRepository.hpp"
 #include "quickgrab/repository/ResultsRepository.hpp"
+#include "quickgrab/service/GrabEventBus.hpp"
 #include "quickgrab/service/MailService.hpp"
 #include "quickgrab/util/HttpClient.hpp"
 #include "quickgrab/workflow/GrabWorkflow.hpp"
@@ -23,13 +25,17 @@ class GrabService {
 public:
     GrabService(boost::asio::io_context& io,
                 boost::asio::thread_pool& worker,
+                repository::DatabaseExecutor& database,
                 repository::RequestsRepository& requests,
                 repository::ResultsRepository& results,
                 util::HttpClient& client,
                 proxy::ProxyPool& proxies,
-                MailService& mailService);
+                MailService& mailService,
+                GrabEventBus& eventBus);
 
     void setProxyConfig(proxy::KdlProxyConfig config);
+    // 须在处理请求前调用
+    void setParameterRefresh(workflow::ParameterRefreshConfig config);
 
     void processPending();
     std::optional<int> handleRequest(const model::Request& request);
@@ -38,19 +44,25 @@ private:
     void executeRequest(model::Request request);
     void executeGrab(model::Request request);
     void handleResult(const model::Request& request, const workflow::GrabResult& result);
+    void persistResult(const model::Request& request, const workflow::GrabResult& result, model::Result& stored);
     long computeAdjustedLatency(const model::Request& request) const;
     long computeProcessingTime(const model::Request& request) const;
     long computeSchedulingTime() const;
     std::optional<proxy::ProxyEndpoint> fetchProxyForRequest(const model::Request& request);
     bool requestWantsProxy(const boost::json::object& extension) const;
+    void publishStatus(const model::Request& request, int status, std::string message = {});
+    void publishRemoved(const model::Request& request);
+    void publishResult(const model::Result& result, int resultId);
 
     boost::asio::io_context& io_;
     boost::asio::thread_pool& worker_;
+    repository::DatabaseExecutor& database_;
     repository::RequestsRepository& requests_;
     repository::ResultsRepository& results_;
     util::HttpClient& httpClient_;
     proxy::ProxyPool& proxyPool_;
     MailService& mailService_;
+    GrabEventBus& eventBus_;
     std::unique_ptr<workflow::GrabWorkflow> workflow_;
     std::atomic<bool> pendingDrainInFlight_{false};
     std::atomic<long> adjustedFactor_;
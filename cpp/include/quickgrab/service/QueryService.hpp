@@ -3,8 +3,9 @@
 #include "quickgrab/repository/BuyersRepository.hpp"
 #include "quickgrab/repository/RequestsRepository.hpp"
 #include "quickgrab/repository/ResultsRepository.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
 
-#include <optional>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -35,10 +36,43 @@ public:
                                                    std::string_view order,
                                                    int offset,
                                                    int limit);
+    std::size_t writeRequestsByFilters(const std::optional<std::string>& keyword,
+                                       const std::optional<int>& buyerId,
+                                       const std::optional<int>& type,
+                                       const std::optional<int>& status,
+                                       std::string_view order,
+                                       int offset,
+                                       int limit,
+                                       util::JsonWriter& writer);
+    std::size_t writeResultsByFilters(const std::optional<std::string>& keyword,
+                                      const std::optional<int>& buyerId,
+                                      const std::optional<int>& type,
+                                      const std::optional<int>& status,
+                                      std::string_view order,
+                                      int offset,
+                                      int limit,
+                                      util::JsonWriter& writer);
+    repository::ListPageResult writeRequestsPage(const repository::ListFilter& filter,
+                                                 std::string_view order,
+                                                 const std::optional<repository::ListCursor>& after,
+                                                 int limit,
+                                                 bool summary,
+                                                 util::JsonWriter& writer);
+    repository::ListPageResult writeResultsPage(const repository::ListFilter& filter,
+                                                std::string_view order,
+                                                const std::optional<repository::ListCursor>& after,
+                                                int limit,
+                                                bool summary,
+                                                util::JsonWriter& writer);
+    std::optional<repository::TotalCount> countRequests(const repository::ListFilter& filter);
+    std::optional<repository::TotalCount> countResults(const repository::ListFilter& filter);
+    std::optional<model::Request> getRequestById(int requestId);
     bool deleteRequestById(int requestId);
     bool deleteResultById(int resultId);
     bool checkCookies(const std::string& cookies) const;
     std::vector<model::Buyer> getAllBuyers();
+    std::uint64_t requestsVersion() const;
+    std::uint64_t resultsVersion() const;
 
 private:
     static std::pair<std::string_view, std::string_view> resolveRequestOrder(std::string_view order);
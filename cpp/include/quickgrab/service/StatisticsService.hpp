@@ -3,6 +3,7 @@
 #include "quickgrab/repository/BuyersRepository.hpp"
 #include "quickgrab/repository/ResultsRepository.hpp"
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
@@ -26,6 +27,7 @@ public:
                                                                          const std::optional<int>& status);
 
     std::vector<model::Buyer> getAllBuyers();
+    std::uint64_t resultsVersion() const;
 
 private:
     repository::ResultsRepository& results_;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace quickgrab::util {
+
+// 上游时钟相对本机 system_clock 的偏移（上游 - 本机）。
+// 每个样本是“上游时间戳 S（精度 resolution）在本机 [sent, received] 之间某一刻生成”，
+// 由此偏移落在 [S - received, S + resolution - sent]，区间宽度即往返时间加时间戳精度。
+struct ClockEstimate {
+    std::chrono::microseconds low{};
+    std::chrono::microseconds high{};
+    std::size_t samples{};
+
+    std::chrono::microseconds offset() const noexcept { return (low + high) / 2; }
+    std::chrono::microseconds uncertainty() const noexcept { return (high - low) / 2; }
+    // 实际用于校正的偏移：区间内最接近 0 的值，只校正样本能证明的部分，
+    // 单个秒级 Date 样本不会把已同步的本机时钟拨偏
+    std::chrono::microseconds correction() const noexcept;
+};
+
+// 按主机维护时钟偏移。样本从新到旧求区间交集，遇到与更新样本矛盾的旧样本（本机时钟跳变、
+// 上游换机）即停止，因此估计随样本增多收敛到约一个往返时间，又能跟上时钟变化。
+// 读取时也只用 kMaxSampleAge 以内的样本，久未收到新样本的主机不再给出估计
+class ClockSync {
+public:
+    static constexpr std::size_t kMaxSamples = 64;
+    static constexpr std::chrono::minutes kMaxSampleAge{15};
+
+    // source 只用于指标标签（"date"、"access_time"）
+    void observe(std::string_view host,
+                 std::chrono::system_clock::time_point sent,
+                 std::chrono::system_clock::time_point received,
+                 std::chrono::system_clock::time_point serverTime,
+                 std::chrono::microseconds resolution,
+                 std::string_view source);
+
+    std::optional<ClockEstimate> estimate(std::string_view host) const;
+    // 所有主机中不确定度最小的估计
+    std::optional<ClockEstimate> bestEstimate() const;
+
+    // 上游时刻换算为本机时刻；该主机没有样本时退回 bestEstimate，仍没有则原样返回
+    std::chrono::system_clock::time_point toLocal(std::string_view host,
+                                                  std::chrono::system_clock::time_point upstream) const;
+    std::chrono::system_clock::time_point toLocal(std::chrono::system_clock::time_point upstream) const;
+
+    void reset();
+
+private:
+    struct Sample {
+        std::chrono::system_clock::time_point at;
+        std::chrono::microseconds low;
+        std::chrono::microseconds high;
+    };
+
+    static std::optional<ClockEstimate> filter(const std::deque<Sample>& samples,
+                                               std::chrono::system_clock::time_point now);
+    std::optional<ClockEstimate> bestLocked(std::chrono::system_clock::time_point now) const;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::deque<Sample>> hosts_;
+};
+
+ClockSync& clockSync();
+
+} // namespace quickgrab::util
@@ -5,6 +5,8 @@
 #include <boost/json.hpp>
 
 #include <optional>
+#include <string>
+#include <string_view>
 
 namespace quickgrab::util {
 
@@ -13,5 +15,8 @@ std::optional<boost::json::object> generateOrderParameters(const model::Request&
                                                            const boost::json::object& dataObj,
                                                            bool includeInvalid);
 
+// 微店接口的表单/查询参数：param=<百分号编码的 JSON>
+std::string toQuery(std::string_view payload);
+
 } // namespace quickgrab::util
 
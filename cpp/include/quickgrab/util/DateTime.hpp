@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace quickgrab::util {
+
+// 固定格式的本地时间编解码，不经过 locale、流和 mktime。
+// 本地时区偏移按 15 分钟窗口缓存在线程本地变量中，夏令时切换后自动重新计算。
+
+// "YYYY-MM-DD HH:MM:SS" 的长度
+inline constexpr std::size_t kDateTimeLength = 19;
+// "YYYY-MM-DD HH:MM:SS.mmm" 的长度
+inline constexpr std::size_t kDateTimeMillisLength = 23;
+
+// 解析本地时间 "YYYY-MM-DD HH:MM:SS"，兼容 'T' 分隔、首尾引号与小数秒（忽略）
+std::optional<std::chrono::system_clock::time_point> parseDateTime(std::string_view text);
+
+// 写入 out 并返回写入的字符数，out 至少需要对应长度的空间
+std::size_t formatDateTime(std::chrono::system_clock::time_point tp, char* out);
+std::size_t formatDateTimeMillis(std::chrono::system_clock::time_point tp, char* out);
+
+std::string formatDateTime(std::chrono::system_clock::time_point tp);
+std::string formatDateTimeMillis(std::chrono::system_clock::time_point tp);
+// "YYYYMMDD-HHMMSS"，用于文件名
+std::string formatCompactDateTime(std::chrono::system_clock::time_point tp);
+
+// 解析 HTTP Date 头（IMF-fixdate，UTC，如 "Sun, 06 Nov 1994 08:49:37 GMT"）
+std::optional<std::chrono::system_clock::time_point> parseHttpDate(std::string_view text);
+
+// 给定 UTC 时刻的本地时区偏移（秒）
+std::chrono::seconds localUtcOffset(std::chrono::system_clock::time_point tp);
+
+} // namespace quickgrab::util
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace quickgrab::util {
+
+// 各上游域名的共享计分板：HttpClient 每次直连请求写入首字节耗时（写出到响应头，冷热连接可比）与失败，
+// 下单流程写入“人潮拥挤”等繁忙响应。选域名时按期望代价 耗时 × (1 + 失败惩罚 × 失败率 + 繁忙惩罚 × 繁忙率) 加权，代价越低权重越高；
+// 另以 kExploration 的概率均匀随机，没有样本或样本过期的域名按最优权重参与，慢域名恢复后能重新被选中；
+// 只失败过的域名不算“没有样本”，按悲观耗时乘以失败惩罚计价
+class DomainScoreboard {
+public:
+    static constexpr double kLatencyAlpha = 0.2;
+    static constexpr double kRateAlpha = 0.1;
+    static constexpr double kErrorPenalty = 4.0;
+    static constexpr double kBusyPenalty = 2.0;
+    static constexpr double kExploration = 0.1;
+    static constexpr std::chrono::minutes kStaleAfter{5};
+    // 只有失败、没有成功样本的域名按该耗时（或候选中最慢的实测耗时，取较大者）计价
+    static constexpr double kFailureLatencyMicros = 1'000'000.0;
+
+    struct Score {
+        std::string host;
+        std::size_t requests{};
+        double latencyMicros{};
+        double errorRate{};
+        double busyRate{};
+        std::chrono::steady_clock::time_point updated{};
+    };
+
+    // firstByte：写出请求到响应头到达；failed：连接、TLS、读写失败或 5xx 响应（此时不计耗时）
+    void recordRequest(std::string_view host, std::chrono::steady_clock::duration firstByte, bool failed);
+    // busy：上游以“人潮拥挤”“系统开小差”等拒绝下单
+    void recordBusy(std::string_view host, bool busy);
+
+    // 返回 candidates 中选中的下标；candidates 为空时返回 0
+    std::size_t pick(const std::vector<std::string_view>& candidates);
+
+    std::vector<Score> snapshot() const;
+    void reset();
+
+private:
+    Score& scoreLocked(std::string_view host);
+    // 期望代价；没有可用样本时返回负数。failureLatencyMicros 为只有失败样本时使用的耗时
+    double costLocked(std::string_view host, std::chrono::steady_clock::time_point now,
+                      double failureLatencyMicros) const;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Score> scores_;
+    std::mt19937 rng_{std::random_device{}()};
+};
+
+DomainScoreboard& domainScoreboard();
+
+} // namespace quickgrab::util
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <boost/beast/http.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace quickgrab::util {
+
+// 一次上游往返：请求的方法/主机/目标/正文与完整响应，以及当时从发出到读完响应的耗时
+struct CassetteEntry {
+    std::string method;
+    std::string host;
+    std::string target;
+    std::string requestBody;
+    unsigned status{};
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+    std::chrono::microseconds elapsed{};
+};
+
+// 录制：把 HttpClient 的每次往返追加到磁带文件（长度前缀的二进制记录，逐条落盘，进程中途退出也可回放已写部分）
+class CassetteRecorder {
+public:
+    explicit CassetteRecorder(const std::filesystem::path& path);
+
+    void append(const CassetteEntry& entry);
+    std::size_t size() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::ofstream out_;
+    std::size_t count_{0};
+};
+
+enum class CassetteTiming {
+    // 按录制时的耗时阻塞后再返回响应
+    recorded,
+    // 立即返回，用于隔离测量工作流本身的 CPU 与分配
+    immediate,
+};
+
+// 回放：整盘载入内存，按 (方法, 主机, 路径) 分组依次返回录制的响应；
+// 同组用完后重复最后一条，查询串与正文中的时间戳、token 不参与匹配
+class CassettePlayer {
+public:
+    using Response = boost::beast::http::response<boost::beast::http::string_body>;
+
+    CassettePlayer(const std::filesystem::path& path, CassetteTiming timing);
+    explicit CassettePlayer(std::vector<CassetteEntry> entries, CassetteTiming timing = CassetteTiming::immediate);
+
+    // 无匹配记录时抛出 std::runtime_error
+    Response play(std::string_view method, std::string_view host, std::string_view target);
+
+    std::size_t size() const noexcept { return entries_.size(); }
+    // 回到每组的第一条，便于同一进程内重复回放
+    void rewind();
+
+private:
+    struct Track {
+        std::vector<std::size_t> entries;
+        std::size_t next{0};
+    };
+
+    static std::string keyFor(std::string_view method, std::string_view host, std::string_view target);
+
+    std::vector<CassetteEntry> entries_;
+    CassetteTiming timing_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Track> tracks_;
+};
+
+std::vector<CassetteEntry> loadCassette(const std::filesystem::path& path);
+
+} // namespace quickgrab::util
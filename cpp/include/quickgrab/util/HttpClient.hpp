@@ -1,14 +1,23 @@
 #pragma once
 
 #include "quickgrab/proxy/ProxyPool.hpp"
+#include "quickgrab/util/HttpCassette.hpp"
 
+#include <boost/asio/buffer.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl/context.hpp>
 #include <boost/beast/http.hpp>
 
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace quickgrab::util {
@@ -34,6 +43,26 @@ private:
     int status_;
 };
 
+// 预先序列化的 HTTP/1.1 请求：除 Host 外的请求行、头部与正文在参数刷新时一次生成，
+// 每次发送只替换 Host（重试时可能换域名），写出时不再分配内存
+class PreparedRequest {
+public:
+    using HttpRequest = boost::beast::http::request<boost::beast::http::string_body>;
+
+    // request 须已设置正文与 Content-Length；其中的 Host 在发送时按域名替换，X-Quick-Scheme 保留给 toRequest
+    explicit PreparedRequest(HttpRequest request);
+
+    // 未持有预热连接时走 HttpClient::fetch 的完整请求
+    HttpRequest toRequest(std::string_view host) const;
+    // 引用内部存储与 host，写出完成前二者须保持有效
+    std::array<boost::asio::const_buffer, 3> buffers(std::string_view host) const noexcept;
+
+private:
+    HttpRequest request_;
+    std::string head_;
+    std::string tail_;
+};
+
 class HttpClient {
 public:
     using HttpRequest = boost::beast::http::request<boost::beast::http::string_body>;
@@ -64,11 +93,51 @@ public:
                        bool useProxy = false,
                        const proxy::ProxyEndpoint* overrideProxy = nullptr);
 
+    // 已完成解析、TCP 连接与 TLS 握手的直连 HTTPS 连接，只承载一次请求
+    class WarmConnection;
+
+    // 提前建立到 host:443 的直连；录制/回放模式下返回 nullptr。失败时抛出异常
+    std::shared_ptr<WarmConnection> warmUp(const std::string& host, std::chrono::seconds timeout);
+    // 在预热连接上写出预序列化的请求，不分配内存。连接已被对端关闭或写出失败时返回 false，
+    // 此时请求未发出，调用方应改走 fetch
+    bool writePrepared(WarmConnection& connection, const PreparedRequest& request, std::string_view host) noexcept;
+    // 读取 writePrepared 之后的响应并关闭连接
+    HttpResponse readPrepared(WarmConnection& connection);
+
+    // 直连时把主机固定解析到指定地址（类似 curl --resolve），TLS 的 SNI 与证书校验仍按原主机名。
+    // 用于本地模拟上游与压测；须在发起请求之前配置，运行期间不可修改
+    void overrideHost(std::string host, std::string address, std::uint16_t port);
+    // 追加信任的 CA 证书（PEM），如本地模拟上游的测试 CA
+    void trustCertificateAuthority(std::string_view pem);
+
+    // 录制：此后每次往返（含重定向的每一跳）追加写入磁带文件
+    void startRecording(const std::filesystem::path& path);
+    // 回放：不再访问网络，按 (方法, 主机, 路径) 从磁带返回录制的响应；与录制互斥
+    void startReplay(const std::filesystem::path& path, CassetteTiming timing);
+    // 回放时响应里的时间戳来自录制当时，不能用作时钟样本
+    bool replaying() const noexcept { return player_ != nullptr; }
+
 private:
+    HttpResponse send(HttpRequest request,
+                      const std::string& affinityKey,
+                      std::chrono::seconds timeout,
+                      bool useProxy,
+                      const proxy::ProxyEndpoint* overrideProxy);
+
+    boost::asio::ip::tcp::resolver::results_type resolveDirect(const std::string& host, const std::string& port);
+
+    struct HostOverride {
+        std::string address;
+        std::string port;
+    };
+
     boost::asio::io_context& io_;
     proxy::ProxyPool& proxyPool_;
     boost::asio::ssl::context sslContext_;
     bool verifyCertificates_;
+    std::unordered_map<std::string, HostOverride> hostOverrides_;
+    std::unique_ptr<CassetteRecorder> recorder_;
+    std::unique_ptr<CassettePlayer> player_;
 };
 
 } // namespace quickgrab::util
@@ -2,10 +2,13 @@
 
 #include <boost/json.hpp>
 #include <string>
+#include <string_view>
 
 namespace quickgrab::util {
 
 boost::json::value parseJson(const std::string& payload);
 std::string stringifyJson(const boost::json::value& value);
+// 只做语法校验，不构建 DOM，用于把数据库中的 JSON 文本原样写入响应
+bool isValidJson(std::string_view payload);
 
 } // namespace quickgrab::util
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <boost/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quickgrab::util {
+
+// 顺序写出 JSON 文本的轻量写入器，直接追加到目标字符串，不构建 DOM。
+// 设置 flush 处理器后，每写完一个顶层数组元素且缓冲超过阈值时回调一次，
+// 由调用方把已生成的内容发送出去并清空缓冲（用于分块传输）。
+class JsonWriter {
+public:
+    using FlushHandler = std::function<void(std::string&)>;
+
+    explicit JsonWriter(std::string& out);
+
+    void setFlushHandler(std::size_t threshold, FlushHandler handler);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const char* text) { return value(std::string_view{text}); }
+    JsonWriter& value(const std::string& text) { return value(std::string_view{text}); }
+    JsonWriter& value(std::int64_t number);
+    JsonWriter& value(int number) { return value(static_cast<std::int64_t>(number)); }
+    JsonWriter& value(double number);
+    JsonWriter& value(bool flag);
+    JsonWriter& value(const boost::json::value& json);
+    JsonWriter& null();
+    // 写入调用方保证合法的 JSON 片段（如数据库中已校验的 JSON 列）
+    JsonWriter& raw(std::string_view json);
+
+    template <typename T>
+    JsonWriter& field(std::string_view name, T&& v) {
+        key(name);
+        return value(std::forward<T>(v));
+    }
+
+    void flush();
+
+private:
+    void separate();
+    void appendEscaped(std::string_view text);
+    void maybeFlush();
+
+    std::string& out_;
+    std::vector<bool> first_;
+    bool afterKey_{false};
+    std::size_t flushThreshold_{0};
+    FlushHandler flushHandler_;
+};
+
+} // namespace quickgrab::util
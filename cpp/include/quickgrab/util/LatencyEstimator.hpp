@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quickgrab::util {
+
+// setup：解析、连接、代理隧道与 TLS 握手，至开始写请求为止；
+// first_byte：请求写出后到响应头到达，即一次往返加上游处理时间
+enum class LatencyKind { setup, first_byte };
+
+std::string_view latencyKindName(LatencyKind kind) noexcept;
+
+struct LatencySummary {
+    std::size_t samples{};
+    double ewmaMicros{};
+    // 最近 kWindow 个样本的分位数
+    double p50Micros{};
+    double p90Micros{};
+    double p99Micros{};
+    std::chrono::steady_clock::time_point updated{};
+};
+
+// 按 (目标主机, 代理) 跟踪实测网络时延：EWMA 反映当前水平，滑动窗口给出分位数。
+// HttpClient 每次请求写入，开抢提前量由此推算，不再依赖客户端上报或写死的常量
+class LatencyEstimator {
+public:
+    static constexpr double kAlpha = 0.2;
+    static constexpr std::size_t kWindow = 256;
+    // 样本少于该数或久未更新时不给出提前量，调用方回退到默认值
+    static constexpr std::size_t kMinSamples = 5;
+    static constexpr std::chrono::minutes kMaxAge{30};
+
+    struct Entry {
+        std::string host;
+        std::string proxy;
+        LatencyKind kind{};
+        LatencySummary summary;
+    };
+
+    void observe(std::string_view host, std::string_view proxy, LatencyKind kind,
+                 std::chrono::steady_clock::duration elapsed);
+
+    std::optional<LatencySummary> summary(std::string_view host, std::string_view proxy, LatencyKind kind) const;
+    std::vector<Entry> snapshot() const;
+
+    // 开抢时应提前的时长：单程时延（first_byte 的一半）；不复用预热连接时再加上建连耗时
+    std::optional<std::chrono::microseconds> fireLead(std::string_view host, std::string_view proxy, bool warm) const;
+
+    void reset();
+
+private:
+    struct Series {
+        double ewmaMicros{};
+        std::size_t count{};
+        std::size_t next{};
+        std::array<std::uint32_t, kWindow> window{};
+        std::chrono::steady_clock::time_point updated{};
+    };
+
+    struct Track {
+        std::string host;
+        std::string proxy;
+        std::array<Series, 2> kinds{};
+    };
+
+    static std::string keyFor(std::string_view host, std::string_view proxy);
+    static LatencySummary summarize(const Series& series);
+    const Series* findLocked(std::string_view host, std::string_view proxy, LatencyKind kind) const;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Track, std::less<>> tracks_;
+};
+
+LatencyEstimator& latencyEstimator();
+
+} // namespace quickgrab::util
@@ -1,9 +1,23 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
 #include <mutex>
 #include <string>
 
+// 编译期最低日志级别（0=trace … 4=error）：低于该级别的 QG_LOG_* 调用连同参数一起被编译器丢弃。
+// Release（定义了 NDEBUG）默认只保留 info 及以上，可用 -DQUICKGRAB_LOG_MIN_LEVEL=<n> 覆盖
+#ifndef QUICKGRAB_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define QUICKGRAB_LOG_MIN_LEVEL 2
+#else
+#define QUICKGRAB_LOG_MIN_LEVEL 0
+#endif
+#endif
+
 namespace quickgrab::util {
 
 enum class LogLevel {
@@ -14,7 +28,59 @@ enum class LogLevel {
     error
 };
 
+// 异步日志配置：调用线程只把消息放入无锁环形队列，由后台线程写文件并按大小/时间轮转
+struct LogConfig {
+    LogLevel level{LogLevel::info};
+    // 为空时不写文件，只输出到控制台
+    std::string directory{"logs"};
+    std::string baseName{"quickgrab"};
+    std::size_t maxFileBytes{64 * 1024 * 1024};
+    std::chrono::minutes rotateInterval{24 * 60};
+    // 保留的已轮转文件数
+    std::size_t maxFiles{14};
+    // 队列容量（向上取 2 的幂），满时丢弃新消息并计数
+    std::size_t queueCapacity{16384};
+    bool console{true};
+};
+
 void initLogging(LogLevel level);
-void log(LogLevel level, const std::string& message);
+// 启动后台写线程；未调用时 log() 在调用线程上同步写控制台
+void initLogging(const LogConfig& config);
+// 写出队列中剩余的消息并停止后台线程，之后的日志回到同步输出
+void shutdownLogging();
+// 因队列已满被丢弃的消息数
+std::uint64_t droppedLogCount();
+
+void log(LogLevel level, std::string message);
+
+namespace detail {
+extern std::atomic<LogLevel> runtimeLevel;
+}
+
+constexpr bool isCompiledIn(LogLevel level) noexcept {
+    return static_cast<int>(level) >= QUICKGRAB_LOG_MIN_LEVEL;
+}
+
+// 运行期级别判断，只有一次 relaxed 读
+inline bool isEnabled(LogLevel level) noexcept {
+    return isCompiledIn(level) &&
+           static_cast<int>(level) >= static_cast<int>(detail::runtimeLevel.load(std::memory_order_relaxed));
+}
 
 } // namespace quickgrab::util
+
+// 级别未开启时不求值参数、不格式化；编译期剔除的级别仍检查格式串，但不生成代码
+#define QG_LOG(level, ...)                                                                  \
+    do {                                                                                    \
+        if constexpr (::quickgrab::util::isCompiledIn(level)) {                             \
+            if (::quickgrab::util::isEnabled(level)) {                                      \
+                ::quickgrab::util::log(level, ::std::format(__VA_ARGS__));                  \
+            }                                                                               \
+        }                                                                                   \
+    } while (false)
+
+#define QG_LOG_TRACE(...) QG_LOG(::quickgrab::util::LogLevel::trace, __VA_ARGS__)
+#define QG_LOG_DEBUG(...) QG_LOG(::quickgrab::util::LogLevel::debug, __VA_ARGS__)
+#define QG_LOG_INFO(...) QG_LOG(::quickgrab::util::LogLevel::info, __VA_ARGS__)
+#define QG_LOG_WARN(...) QG_LOG(::quickgrab::util::LogLevel::warn, __VA_ARGS__)
+#define QG_LOG_ERROR(...) QG_LOG(::quickgrab::util::LogLevel::error, __VA_ARGS__)
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace quickgrab::util {
+
+// 进程内指标。计数与直方图按线程分片累加（每个分片独占缓存行，relaxed 原子加），
+// 只有 /metrics 抓取时才合并各分片，热路径上没有锁也没有跨线程争用。
+namespace detail {
+constexpr std::size_t kMetricShards = 8;
+// 当前线程固定使用的分片序号
+std::size_t metricShard() noexcept;
+} // namespace detail
+
+using MetricLabels = std::initializer_list<std::pair<std::string_view, std::string_view>>;
+
+class Counter {
+public:
+    void inc(std::uint64_t delta = 1) noexcept {
+        cells_[detail::metricShard()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+    std::uint64_t value() const noexcept;
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> value{0};
+    };
+    std::array<Cell, detail::kMetricShards> cells_{};
+};
+
+class Gauge {
+public:
+    void set(std::int64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+    void add(std::int64_t delta) noexcept { value_.fetch_add(delta, std::memory_order_relaxed); }
+    std::int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> value_{0};
+};
+
+// HDR 风格的对数-线性直方图：以微秒计，每个 2 的幂区间再均分 8 个子桶（相对误差 ≤ 12.5%），
+// 覆盖 1µs 到约 19 小时。
+class Histogram {
+public:
+    static constexpr std::size_t kSubBuckets = 8;
+    static constexpr std::size_t kMaxExponent = 36;
+    static constexpr std::size_t kBucketCount = kSubBuckets + (kMaxExponent - 2) * kSubBuckets;
+
+    struct Snapshot {
+        std::array<std::uint64_t, kBucketCount> buckets{};
+        std::uint64_t count{};
+        std::uint64_t sumMicros{};
+
+        // q ∈ [0, 1]，返回所在桶的中点（微秒）
+        double quantileMicros(double q) const noexcept;
+    };
+
+    void observe(std::chrono::steady_clock::duration elapsed) noexcept {
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        observeMicros(micros > 0 ? static_cast<std::uint64_t>(micros) : 0);
+    }
+    void observeMicros(std::uint64_t micros) noexcept {
+        auto& shard = shards_[detail::metricShard()];
+        shard.buckets[bucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+        shard.count.fetch_add(1, std::memory_order_relaxed);
+        shard.sumMicros.fetch_add(micros, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const noexcept;
+
+    static std::size_t bucketFor(std::uint64_t micros) noexcept;
+    // 桶的上界（不含），单位微秒
+    static std::uint64_t bucketUpperBound(std::size_t index) noexcept;
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, kBucketCount> buckets{};
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sumMicros{0};
+    };
+    std::array<Shard, detail::kMetricShards> shards_{};
+};
+
+// 按 (名称, 标签) 注册指标。返回的引用在进程生命周期内有效，热点调用方可缓存引用；
+// 每个指标族最多 kMaxSeries 组标签，超出后归入 label="other" 的溢出序列，避免标签值失控。
+class MetricsRegistry {
+public:
+    static constexpr std::size_t kMaxSeries = 256;
+
+    Counter& counter(std::string_view name, std::string_view help, MetricLabels labels = {});
+    Gauge& gauge(std::string_view name, std::string_view help, MetricLabels labels = {});
+    Histogram& histogram(std::string_view name, std::string_view help, MetricLabels labels = {});
+
+    // Prometheus 文本格式（version 0.0.4）
+    std::string renderPrometheus() const;
+
+private:
+    enum class Type { counter, gauge, histogram };
+
+    struct Series {
+        std::vector<std::pair<std::string, std::string>> labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family {
+        Type type{Type::counter};
+        std::string help;
+        std::map<std::string, Series, std::less<>> series;
+    };
+
+    Series& resolve(Type type, std::string_view name, std::string_view help, MetricLabels labels);
+
+    mutable std::shared_mutex mutex_;
+    std::map<std::string, Family, std::less<>> families_;
+};
+
+MetricsRegistry& metrics();
+
+} // namespace quickgrab::util
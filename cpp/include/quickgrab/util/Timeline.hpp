@@ -0,0 +1,93 @@
+#pragma once
+
+#include "quickgrab/util/JsonWriter.hpp"
+
+#include <boost/json.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace quickgrab::util {
+
+// 单次抢购的时间线：按单调时钟记录各阶段（armed、prewarm、fire、connect、tls、write、
+// first_byte、parsed、classified …）。同一时间线任一时刻只由执行该抢购的线程写入，不加锁；
+// 完成后以 shared_ptr<const> 交给其他线程只读。
+class GrabTimeline {
+public:
+    using Clock = std::chrono::steady_clock;
+    // 单条时间线最多保留的事件数，捡漏循环等长流程超出后只计数
+    static constexpr std::size_t kMaxEvents = 512;
+
+    explicit GrabTimeline(int requestId);
+
+    // name 须为静态字符串
+    void mark(const char* name, std::string detail = {});
+    void span(const char* name, Clock::time_point start, Clock::time_point end, std::string detail = {});
+
+    int requestId() const noexcept { return requestId_; }
+
+    // 写入 Result.extension 的紧凑形式，时间为相对创建时刻的微秒数
+    boost::json::object toJson() const;
+    // Chrome trace 事件（traceEvents 数组中的元素），每个请求占一行（tid = 请求 ID）
+    void appendTraceEvents(JsonWriter& writer) const;
+
+private:
+    struct Event {
+        const char* name;
+        Clock::time_point start;
+        Clock::time_point end;
+        std::string detail;
+        bool instant;
+    };
+
+    void push(Event event);
+
+    int requestId_;
+    Clock::time_point origin_;
+    std::chrono::system_clock::time_point wallOrigin_;
+    std::vector<Event> events_;
+    std::size_t dropped_{0};
+};
+
+// 记录 [构造, 析构) 区间
+class TimelineSpan {
+public:
+    TimelineSpan(GrabTimeline* timeline, const char* name, std::string detail = {});
+    ~TimelineSpan();
+    TimelineSpan(const TimelineSpan&) = delete;
+    TimelineSpan& operator=(const TimelineSpan&) = delete;
+
+private:
+    GrabTimeline* timeline_;
+    const char* name_;
+    std::string detail_;
+    GrabTimeline::Clock::time_point start_;
+};
+
+// 当前线程正在执行的抢购时间线，供 HttpClient 等下层组件记录连接阶段；没有时为 nullptr
+GrabTimeline* currentTimeline() noexcept;
+
+class TimelineScope {
+public:
+    explicit TimelineScope(GrabTimeline* timeline) noexcept;
+    ~TimelineScope();
+    TimelineScope(const TimelineScope&) = delete;
+    TimelineScope& operator=(const TimelineScope&) = delete;
+
+private:
+    GrabTimeline* previous_;
+};
+
+// 保存最近完成的时间线（环形，最多 256 条）
+void recordTimeline(std::shared_ptr<const GrabTimeline> timeline);
+// 按完成顺序从新到旧返回；requestId 有值时只返回该请求的时间线
+std::vector<std::shared_ptr<const GrabTimeline>> recentTimelines(std::size_t limit,
+                                                                 std::optional<int> requestId = std::nullopt);
+// {"traceEvents":[...],"displayTimeUnit":"ms"}，可直接在 chrome://tracing 或 Perfetto 中打开
+std::string chromeTraceJson(const std::vector<std::shared_ptr<const GrabTimeline>>& timelines);
+
+} // namespace quickgrab::util
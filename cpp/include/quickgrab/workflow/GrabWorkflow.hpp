@@ -4,14 +4,18 @@
 #include "quickgrab/proxy/ProxyPool.hpp"
 #include "quickgrab/util/HttpClient.hpp"
 #include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/Timeline.hpp"
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/thread_pool.hpp>
 #include <boost/json.hpp>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -28,6 +32,33 @@ struct GrabResult {
     std::string error;
     int statusCode{};
     int attempts{};
+    std::shared_ptr<util::GrabTimeline> timeline;
+};
+
+// 已布置抢购的最新订单参数：后台刷新任务写入，开抢与重试时取用
+struct OrderParametersSlot {
+    std::mutex mutex;
+    model::JsonColumn parameters;
+    std::shared_ptr<const util::PreparedRequest> prepared;
+    std::uint64_t version{0};
+    // 抢购结束后置位，刷新任务随之停止
+    std::atomic<bool> finished{false};
+    // 要求刷新任务立即拉取一次（下单被要求重新确认、而槽中没有更新的参数时）
+    std::function<void()> refreshNow;
+};
+
+// 订单参数后台刷新：布置后每 interval 重新拉取加购页生成参数，开抢前 guard 内暂停，之后持续到抢购结束，
+// 重试时取用失败之后完成的刷新结果。刷新在独立的小线程池上执行，阻塞的加购页请求不占用开抢所用的 worker。
+// interval 为 0 时关闭，回到布置时同步刷新一次、重试时现场刷新
+struct ParameterRefreshConfig {
+    std::chrono::milliseconds interval{10000};
+    std::chrono::milliseconds guard{500};
+};
+
+// 开抢提前量；measured 为 false 时来自客户端上报的 networkDelay / adjustedFactor
+struct FireLead {
+    std::chrono::milliseconds lead{};
+    bool measured{false};
 };
 
 struct GrabContext {
@@ -44,6 +75,14 @@ struct GrabContext {
     bool useProxy{false};
     std::string proxyAffinity;
     std::optional<proxy::ProxyEndpoint> assignedProxy;
+    std::shared_ptr<util::GrabTimeline> timeline;
+    // 与 request.orderParameters 同步预先序列化的 CreateOrder，参数刷新后重建
+    std::shared_ptr<const util::PreparedRequest> preparedOrder;
+    // 开抢前建立的直连，只供首个 CreateOrder 使用
+    std::shared_ptr<util::HttpClient::WarmConnection> warmConnection;
+    // 启用后台刷新时指向共享的参数槽，parametersVersion 为已取用的版本
+    std::shared_ptr<OrderParametersSlot> freshParameters;
+    std::uint64_t parametersVersion{0};
 };
 
 class GrabWorkflow {
@@ -56,8 +95,28 @@ public:
     void run(const model::Request& request,
              std::function<void(const GrabResult&)> onFinished);
 
+    // 须在布置第一个抢购之前调用
+    void setParameterRefresh(ParameterRefreshConfig config);
+
+    // 开抢路径观测点，供 quickgrab_fire_path_bench 统计触发到写出之间的堆分配：定时器触发时以 false、
+    // 预序列化的 CreateOrder 经预热连接写出后以 true，在同一 worker 线程上调用。须在布置第一个抢购之前设置
+    void setFireProbe(std::function<void(bool written)> probe);
+
+    // 下单（CreateOrder）所用的上游主机；开售时刻按该主机的时钟换算，调度与定时须用同一换算
+    static const std::string& fireDomain();
+
+    // 开抢提前量：按 (thor, 代理) 的实测时延估计，样本不足或经代理池出口不确定时退回上报的 reportedMs。
+    // 只按路由查 LatencyEstimator，不准备上下文也不选域名；调度日志与实际定时都经由这里和 fireDelay
+    static FireLead fireLead(bool useProxy, const std::optional<proxy::ProxyEndpoint>& assignedProxy, long reportedMs);
+    // 距首个 CreateOrder 的等待时长：按下单主机时钟换算的开售时刻 + delay - 提前量，不小于 0
+    static std::chrono::milliseconds fireDelay(const model::Request& request,
+                                               std::chrono::milliseconds lead,
+                                               std::chrono::system_clock::time_point now);
+
 private:
     using TimerPtr = std::shared_ptr<boost::asio::steady_timer>;
+    struct ParameterRefresh;
+
     //预售预售
     void scheduleExecution(GrabContext ctx,
         std::function<void(const GrabResult&)> onFinished);
@@ -65,15 +124,37 @@ private:
     void schedulePick(GrabContext ctx,
         std::function<void(const GrabResult&)> onFinished);
 
+    void armFire(GrabContext ctx,
+        std::function<void(const GrabResult&)> onFinished,
+        TimerPtr timer,
+        std::chrono::steady_clock::time_point target);
+
 
     void prepareContext(const model::Request& request, GrabContext& ctx);
 
 
-    GrabResult createOrder(const GrabContext& ctx, const boost::json::object& payload);
+    GrabResult createOrder(const GrabContext& ctx, const std::string& domain, const boost::json::object& payload);
+    GrabResult fireCreateOrder(GrabContext& ctx,
+                               std::chrono::steady_clock::time_point fired,
+                               std::chrono::steady_clock::time_point target);
+    void classifyCreateOrder(const GrabContext& ctx,
+                             std::string_view domain,
+                             const util::HttpClient::HttpResponse& response,
+                             GrabResult& result,
+                             std::chrono::steady_clock::time_point started) const;
     GrabResult reConfirmOrder(const GrabContext& ctx, const boost::json::object& payload);
 
 
-    void refreshOrderParameters(GrabContext& ctx);
+    bool refreshOrderParameters(GrabContext& ctx);
+    void prepareOrderRequest(GrabContext& ctx) const;
+    void startParameterRefresh(GrabContext& ctx,
+                               std::chrono::steady_clock::time_point fireAt,
+                               std::chrono::steady_clock::time_point first);
+    void scheduleParameterRefresh(std::shared_ptr<ParameterRefresh> refresh,
+                                  std::chrono::steady_clock::time_point next);
+    // 槽中有比 ctx 更新的版本时取用并返回 true
+    bool adoptRefreshedParameters(GrabContext& ctx) const;
+    void warmConnection(GrabContext& ctx);
     std::optional<boost::json::object> fetchAddOrderData(const GrabContext& ctx) const;
 
     boost::beast::http::request<boost::beast::http::string_body>
@@ -87,6 +168,10 @@ private:
     boost::asio::thread_pool& worker_;
     util::HttpClient& httpClient_;
     proxy::ProxyPool& proxyPool_;
+    ParameterRefreshConfig refreshConfig_;
+    std::function<void(bool)> fireProbe_;
+    // 参数刷新专用线程池；最后声明，析构时先停止，刷新任务不会访问已析构的成员
+    boost::asio::thread_pool refreshPool_;
 };
 
 } // namespace quickgrab::workflow
@@ -0,0 +1,17 @@
+-- 列表键集分页与计数所需的组合索引
+-- 排序列 + id 作为尾列，使 ORDER BY col, id 与 (col, id) < (?, ?) 续读都能走索引；
+-- 以 buyer_id / status 为前缀的索引同时覆盖带筛选条件的 COUNT(*)。
+
+USE grab_system;
+
+ALTER TABLE requests
+    ADD INDEX idx_requests_start_time_id (start_time, id),
+    ADD INDEX idx_requests_buyer_start_time (buyer_id, start_time, id),
+    ADD INDEX idx_requests_status_start_time (status, start_time, id),
+    ADD INDEX idx_requests_type_status (type, status);
+
+ALTER TABLE results
+    ADD INDEX idx_results_end_time_id (end_time, id),
+    ADD INDEX idx_results_buyer_end_time (buyer_id, end_time, id),
+    ADD INDEX idx_results_status_end_time (status, end_time, id),
+    ADD INDEX idx_results_type_status (type, status);
@@ -0,0 +1,34 @@
+-- 关键词搜索索引
+-- 从 user_info(JSON 文本) 抽取昵称/手机号/备注到 STORED 生成列 user_search，并建立 ngram 全文索引，
+-- 替代 user_info LIKE '%kw%' 的全表扫描。服务启动后按表探测该索引，未执行本脚本时仍走旧的 LIKE。
+--
+-- 注意：
+-- 1. ngram_token_size 使用默认值 2（只能在服务器启动参数中修改），少于两个字符的关键词退化为 user_search LIKE。
+-- 2. 默认停用词表会剔除包含停用词的 ngram（如含字母 a 的二元组），建索引前需关闭停用词。
+-- 3. 添加 STORED 列会重建整表，大表请在低峰期执行。
+
+USE grab_system;
+
+SET SESSION innodb_ft_enable_stopword = OFF;
+
+ALTER TABLE requests
+    ADD COLUMN user_search VARCHAR(512) AS (
+        CASE WHEN JSON_VALID(user_info) THEN CONCAT_WS(' ',
+            JSON_UNQUOTE(JSON_EXTRACT(user_info, '$.nickName')),
+            JSON_UNQUOTE(JSON_EXTRACT(user_info, '$.telephone')),
+            JSON_UNQUOTE(JSON_EXTRACT(user_info, '$.orderNote')))
+        END) STORED;
+
+ALTER TABLE requests
+    ADD FULLTEXT INDEX ft_requests_user_search (user_search) WITH PARSER ngram;
+
+ALTER TABLE results
+    ADD COLUMN user_search VARCHAR(512) AS (
+        CASE WHEN JSON_VALID(user_info) THEN CONCAT_WS(' ',
+            JSON_UNQUOTE(JSON_EXTRACT(user_info, '$.nickName')),
+            JSON_UNQUOTE(JSON_EXTRACT(user_info, '$.telephone')),
+            JSON_UNQUOTE(JSON_EXTRACT(user_info, '$.orderNote')))
+        END) STORED;
+
+ALTER TABLE results
+    ADD FULLTEXT INDEX ft_results_user_search (user_search) WITH PARSER ngram;
@@ -0,0 +1,36 @@
+-- 统计汇总表
+-- 按 (买家, 类型, 状态, 开售时间所在小时) 累计 results 的行数与实际收益，由 ResultsRepository 在
+-- insertResult / deleteById 的同一事务内增量维护；统计接口只读取汇总桶，时间窗口两端不足一小时的部分
+-- 通过 start_time 索引回表补齐。
+--
+-- type/status 为 NULL 的行记为 -1，start_time 为 NULL 的行记入 1000-01-01 00:00:00 桶，
+-- 使其仍计入不带时间条件的总数。
+
+USE grab_system;
+
+CREATE TABLE IF NOT EXISTS result_rollups
+(
+    buyer_id     INT            NOT NULL COMMENT '抢购者ID',
+    type         INT            NOT NULL COMMENT '类型，NULL 记为 -1',
+    status       INT            NOT NULL COMMENT '状态，NULL 记为 -1',
+    bucket_start DATETIME       NOT NULL COMMENT '开售时间截断到整点',
+    total_count  BIGINT         NOT NULL DEFAULT 0 COMMENT '结果数',
+    earnings     DECIMAL(16, 2) NOT NULL DEFAULT 0 COMMENT '实际收益合计',
+    PRIMARY KEY (buyer_id, type, status, bucket_start),
+    INDEX idx_result_rollups_bucket (bucket_start)
+);
+
+ALTER TABLE results
+    ADD INDEX idx_results_start_time (start_time);
+
+-- 回填历史数据；服务启动时若发现汇总表为空而 results 非空也会自动执行同样的回填
+INSERT INTO result_rollups (buyer_id, type, status, bucket_start, total_count, earnings)
+SELECT buyer_id,
+       IFNULL(type, -1),
+       IFNULL(status, -1),
+       IFNULL(DATE_FORMAT(start_time, '%Y-%m-%d %H:00:00'), '1000-01-01 00:00:00') AS bucket_start,
+       COUNT(*),
+       IFNULL(SUM(actual_earnings), 0)
+FROM results
+GROUP BY buyer_id, IFNULL(type, -1), IFNULL(status, -1), bucket_start
+ON DUPLICATE KEY UPDATE total_count = VALUES(total_count), earnings = VALUES(earnings);
@@ -0,0 +1,44 @@
+-- JSON 文本列改为 MySQL JSON 类型
+-- 服务器写入时即校验内容，服务读取时按结果集元数据识别 JSON 类型列，原文直接透传给列表/详情接口，
+-- 不再逐行逐列校验；未执行本迁移时这些列仍为 TEXT，照旧先校验再透传。
+-- order_parameters 保存前端提交的原文（可能不是 JSON），保持 TEXT。
+--
+-- 历史数据中的空串与非法内容先置为 NULL（读取时本就按缺省值处理），否则 MODIFY 会失败。
+-- MODIFY 需要重建表，请在低峰期执行。
+
+USE grab_system;
+
+UPDATE requests
+SET order_info     = IF(JSON_VALID(order_info), order_info, NULL),
+    user_info      = IF(JSON_VALID(user_info), user_info, NULL),
+    order_template = IF(JSON_VALID(order_template), order_template, NULL),
+    extension      = IF(JSON_VALID(extension), extension, NULL)
+WHERE NOT JSON_VALID(order_info)
+   OR NOT JSON_VALID(user_info)
+   OR NOT JSON_VALID(order_template)
+   OR NOT JSON_VALID(extension);
+
+UPDATE results
+SET order_info       = IF(JSON_VALID(order_info), order_info, NULL),
+    user_info        = IF(JSON_VALID(user_info), user_info, NULL),
+    order_template   = IF(JSON_VALID(order_template), order_template, NULL),
+    response_message = IF(JSON_VALID(response_message), response_message, NULL),
+    extension        = IF(JSON_VALID(extension), extension, NULL)
+WHERE NOT JSON_VALID(order_info)
+   OR NOT JSON_VALID(user_info)
+   OR NOT JSON_VALID(order_template)
+   OR NOT JSON_VALID(response_message)
+   OR NOT JSON_VALID(extension);
+
+ALTER TABLE requests
+    MODIFY order_info     JSON COMMENT '订单信息',
+    MODIFY user_info      JSON COMMENT '用户信息',
+    MODIFY order_template JSON COMMENT '下单模板',
+    MODIFY extension      JSON COMMENT '扩展';
+
+ALTER TABLE results
+    MODIFY order_info       JSON COMMENT '订单信息',
+    MODIFY user_info        JSON COMMENT '用户信息',
+    MODIFY order_template   JSON COMMENT '下单模板',
+    MODIFY response_message JSON COMMENT '返回信息',
+    MODIFY extension        JSON COMMENT '扩展';
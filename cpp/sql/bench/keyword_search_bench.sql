@@ -0,0 +1,77 @@
+-- 关键词搜索基准：在独立库中生成数百万行 results 样本，对比 user_info LIKE 与 ngram 全文索引。
+-- 用法：mysql -u root -p < sql/bench/keyword_search_bench.sql
+-- 生成 4,000,000 行约需数分钟，可调整 @rows。结果以 EXPLAIN ANALYZE 的 actual time 为准，
+-- 每条查询执行两次，只看第二次（缓冲池已预热）。
+-- 样本表结构复制自 grab_system.results，需在执行 002_keyword_search.sql 之前的库上运行。
+
+SET @rows = 4000000;
+
+DROP DATABASE IF EXISTS quickgrab_bench;
+CREATE DATABASE quickgrab_bench CHARACTER SET utf8mb4 COLLATE utf8mb4_unicode_ci;
+USE quickgrab_bench;
+
+CREATE TABLE results LIKE grab_system.results;
+
+CREATE TABLE digits (d INT PRIMARY KEY);
+INSERT INTO digits VALUES (0), (1), (2), (3), (4), (5), (6), (7), (8), (9);
+
+-- 10^7 以内的序号，按 @rows 截断
+INSERT INTO results (request_id, device_id, buyer_id, thread_id, link, cookies, order_info, user_info,
+                     order_template, message, id_number, keyword, start_time, end_time,
+                     type, status, response_message, extension)
+SELECT seq,
+       0,
+       seq % 500,
+       '',
+       CONCAT('https://weidian.com/item.html?itemID=', 100000 + seq % 9000),
+       '',
+       '{}',
+       JSON_OBJECT('nickName', CONCAT(ELT(1 + seq % 6, '小明', '阿花', 'Lucky', '大白', '橙子', 'Momo'), seq % 10007),
+                   'telephone', CONCAT('13', LPAD(seq * 7919 % 1000000000, 9, '0')),
+                   'orderNote', IF(seq % 13 = 0, '加急', '')),
+       NULL, '', NULL, NULL,
+       NOW() - INTERVAL (seq % 525600) MINUTE,
+       NOW() - INTERVAL (seq % 525600) MINUTE + INTERVAL 3 SECOND,
+       seq % 4, 1 + seq % 3, '', '{}'
+FROM (
+    SELECT a.d + b.d * 10 + c.d * 100 + e.d * 1000 + f.d * 10000 + g.d * 100000 + h.d * 1000000 AS seq
+    FROM digits a, digits b, digits c, digits e, digits f, digits g, digits h
+) s
+WHERE seq < @rows;
+
+ANALYZE TABLE results;
+
+-- 基线：迁移前的查询形状
+EXPLAIN ANALYZE SELECT id FROM results WHERE user_info LIKE '%Lucky1234%' ORDER BY end_time DESC, id DESC LIMIT 50;
+EXPLAIN ANALYZE SELECT id FROM results WHERE user_info LIKE '%Lucky1234%' ORDER BY end_time DESC, id DESC LIMIT 50;
+EXPLAIN ANALYZE SELECT id FROM results WHERE user_info LIKE '%138000%' ORDER BY end_time DESC, id DESC LIMIT 50;
+EXPLAIN ANALYZE SELECT id FROM results WHERE user_info LIKE '%138000%' ORDER BY end_time DESC, id DESC LIMIT 50;
+
+-- 执行与 sql/002_keyword_search.sql 相同的变更
+SET SESSION innodb_ft_enable_stopword = OFF;
+ALTER TABLE results
+    ADD COLUMN user_search VARCHAR(512) AS (
+        CASE WHEN JSON_VALID(user_info) THEN CONCAT_WS(' ',
+            JSON_UNQUOTE(JSON_EXTRACT(user_info, '$.nickName')),
+            JSON_UNQUOTE(JSON_EXTRACT(user_info, '$.telephone')),
+            JSON_UNQUOTE(JSON_EXTRACT(user_info, '$.orderNote')))
+        END) STORED;
+ALTER TABLE results
+    ADD FULLTEXT INDEX ft_results_user_search (user_search) WITH PARSER ngram;
+
+-- 索引后：与 Pagination.cpp 生成的条件一致
+EXPLAIN ANALYZE SELECT id FROM results WHERE MATCH(user_search) AGAINST('"Lucky1234"' IN BOOLEAN MODE) ORDER BY end_time DESC, id DESC LIMIT 50;
+EXPLAIN ANALYZE SELECT id FROM results WHERE MATCH(user_search) AGAINST('"Lucky1234"' IN BOOLEAN MODE) ORDER BY end_time DESC, id DESC LIMIT 50;
+EXPLAIN ANALYZE SELECT id FROM results WHERE MATCH(user_search) AGAINST('"138000"' IN BOOLEAN MODE) ORDER BY end_time DESC, id DESC LIMIT 50;
+EXPLAIN ANALYZE SELECT id FROM results WHERE MATCH(user_search) AGAINST('"138000"' IN BOOLEAN MODE) ORDER BY end_time DESC, id DESC LIMIT 50;
+SELECT COUNT(*) FROM results WHERE MATCH(user_search) AGAINST('"小明12"' IN BOOLEAN MODE);
+
+-- 单字关键词的退化路径
+EXPLAIN ANALYZE SELECT id FROM results WHERE user_search LIKE '%明%' ORDER BY end_time DESC, id DESC LIMIT 50;
+
+-- 校验两种写法结果一致
+SELECT
+    (SELECT COUNT(*) FROM results WHERE user_info LIKE '%Lucky1234%') AS like_rows,
+    (SELECT COUNT(*) FROM results WHERE MATCH(user_search) AGAINST('"Lucky1234"' IN BOOLEAN MODE)) AS fulltext_rows;
+
+DROP DATABASE quickgrab_bench;
@@ -0,0 +1,156 @@
+#include "quickgrab/controller/EventController.hpp"
+#include "quickgrab/server/SseChannel.hpp"
+#include "quickgrab/util/Logging.hpp"
+
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace quickgrab::controller {
+namespace {
+
+std::unordered_map<std::string, std::string> parseCookies(const std::string& header) {
+    std::unordered_map<std::string, std::string> cookies;
+    std::size_t start = 0;
+    while (start < header.size()) {
+        auto end = header.find(';', start);
+        if (end == std::string::npos) {
+            end = header.size();
+        }
+        auto pair = header.substr(start, end - start);
+        auto eq = pair.find('=');
+        if (eq != std::string::npos) {
+            std::string key = pair.substr(0, eq);
+            std::string value = pair.substr(eq + 1);
+            auto trim = [](std::string str) {
+                auto begin = std::find_if_not(str.begin(), str.end(), [](unsigned char ch) { return std::isspace(ch); });
+                auto endIt = std::find_if_not(str.rbegin(), str.rend(), [](unsigned char ch) { return std::isspace(ch); }).base();
+                if (begin >= endIt) {
+                    return std::string{};
+                }
+                return std::string(begin, endIt);
+            };
+            cookies.emplace(trim(std::move(key)), trim(std::move(value)));
+        }
+        start = end + 1;
+    }
+    return cookies;
+}
+
+std::unordered_map<std::string, std::string> parseQueryParameters(const boost::beast::string_view& target) {
+    std::unordered_map<std::string, std::string> params;
+    auto pos = target.find('?');
+    if (pos == boost::beast::string_view::npos) {
+        return params;
+    }
+    auto query = target.substr(pos + 1);
+    std::size_t start = 0;
+    while (start < query.size()) {
+        auto end = query.find('&', start);
+        if (end == boost::beast::string_view::npos) {
+            end = query.size();
+        }
+        auto token = query.substr(start, end - start);
+        auto eq = token.find('=');
+        if (eq != boost::beast::string_view::npos) {
+            params.emplace(std::string(token.substr(0, eq)), std::string(token.substr(eq + 1)));
+        } else {
+            params.emplace(std::string(token), "");
+        }
+        start = end + 1;
+    }
+    return params;
+}
+
+std::optional<int> parseOptionalInt(const std::unordered_map<std::string, std::string>& params,
+                                    const std::string& key) {
+    auto it = params.find(key);
+    if (it == params.end() || it->second.empty()) {
+        return std::nullopt;
+    }
+    try {
+        return std::stoi(it->second);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+void sendJsonResponse(quickgrab::server::RequestContext& ctx,
+                      boost::beast::http::status status,
+                      const boost::json::value& payload) {
+    ctx.response.result(status);
+    ctx.response.set(boost::beast::http::field::content_type, "application/json; charset=utf-8");
+    ctx.response.body() = boost::json::serialize(payload);
+    ctx.response.prepare_payload();
+}
+
+void sendUnauthorized(quickgrab::server::RequestContext& ctx) {
+    boost::json::object payload{{"status", "error"}, {"message", "未登录"}};
+    sendJsonResponse(ctx, boost::beast::http::status::unauthorized, payload);
+}
+
+} // namespace
+
+EventController::EventController(service::GrabEventBus& eventBus, service::AuthService& authService)
+    : eventBus_(eventBus), authService_(authService) {}
+
+void EventController::registerRoutes(quickgrab::server::Router& router) {
+    router.addRoute("GET", "/api/events", [this](auto& ctx) { handleEvents(ctx); });
+}
+
+void EventController::handleEvents(quickgrab::server::RequestContext& ctx) {
+    std::string token;
+    if (auto header = ctx.request.find(boost::beast::http::field::cookie); header != ctx.request.end()) {
+        auto cookies = parseCookies(std::string(header->value()));
+        if (auto it = cookies.find(std::string(service::AuthService::kSessionCookie)); it != cookies.end()) {
+            token = it->second;
+        }
+    }
+
+    auto session = token.empty() ? std::nullopt : authService_.touchSession(token);
+    if (!session) {
+        sendUnauthorized(ctx);
+        return;
+    }
+
+    // 管理员可订阅全部买家或指定买家，普通用户只能收到自己的事件
+    std::optional<int> filter = session->buyer.id;
+    if (session->buyer.accessLevel > 3) {
+        auto params = parseQueryParameters(ctx.request.target());
+        filter = parseOptionalInt(params, "buyerId");
+    }
+
+    ctx.response.result(boost::beast::http::status::ok);
+    ctx.response.set(boost::beast::http::field::content_type, "text/event-stream; charset=utf-8");
+    ctx.response.set(boost::beast::http::field::cache_control, "no-cache");
+    ctx.response.set("X-Accel-Buffering", "no");
+    ctx.response.keep_alive(false);
+
+    auto* bus = &eventBus_;
+    const auto buyerId = session->buyer.id;
+    ctx.streamHandler = [bus, filter, buyerId](boost::beast::tcp_stream stream) {
+        auto channel = std::make_shared<server::SseChannel>(std::move(stream));
+        std::weak_ptr<server::SseChannel> weak = channel;
+        auto subscription = bus->subscribe(filter, [weak](const service::GrabEvent& event) {
+            if (auto target = weak.lock()) {
+                target->send(service::toString(event.kind), boost::json::serialize(service::toJson(event)));
+            }
+        });
+        util::log(util::LogLevel::info,
+                  "SSE 订阅建立 buyerId=" + std::to_string(buyerId) + " 当前订阅数=" +
+                      std::to_string(bus->subscriberCount()));
+        channel->start([bus, subscription, buyerId]() {
+            bus->unsubscribe(subscription);
+            util::log(util::LogLevel::info, "SSE 订阅断开 buyerId=" + std::to_string(buyerId));
+        });
+    };
+}
+
+} // namespace quickgrab::controller
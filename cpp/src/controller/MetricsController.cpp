@@ -0,0 +1,187 @@
+#include "quickgrab/controller/MetricsController.hpp"
+
+#include "quickgrab/proxy/ProxyPool.hpp"
+#include "quickgrab/repository/DatabaseExecutor.hpp"
+#include "quickgrab/repository/MySqlConnectionPool.hpp"
+#include "quickgrab/util/DomainScoreboard.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
+#include "quickgrab/util/LatencyEstimator.hpp"
+#include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/Metrics.hpp"
+#include "quickgrab/util/Timeline.hpp"
+
+#include <boost/beast/http.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <unordered_map>
+
+namespace quickgrab::controller {
+namespace {
+void setGauge(std::string_view name, std::string_view help, util::MetricLabels labels, std::int64_t value) {
+    util::metrics().gauge(name, help, labels).set(value);
+}
+
+std::unordered_map<std::string, std::string> parseQueryParameters(const boost::beast::string_view& target) {
+    std::unordered_map<std::string, std::string> params;
+    auto pos = target.find('?');
+    if (pos == boost::beast::string_view::npos) {
+        return params;
+    }
+    auto query = target.substr(pos + 1);
+    std::size_t start = 0;
+    while (start < query.size()) {
+        auto end = query.find('&', start);
+        if (end == boost::beast::string_view::npos) {
+            end = query.size();
+        }
+        auto token = query.substr(start, end - start);
+        auto eq = token.find('=');
+        if (eq != boost::beast::string_view::npos) {
+            params.emplace(std::string(token.substr(0, eq)), std::string(token.substr(eq + 1)));
+        } else {
+            params.emplace(std::string(token), "");
+        }
+        start = end + 1;
+    }
+    return params;
+}
+
+std::optional<int> parseOptionalInt(const std::unordered_map<std::string, std::string>& params,
+                                    const std::string& key) {
+    auto it = params.find(key);
+    if (it == params.end() || it->second.empty()) {
+        return std::nullopt;
+    }
+    try {
+        return std::stoi(it->second);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+} // namespace
+
+MetricsController::MetricsController(repository::MySqlConnectionPool& connectionPool,
+                                     proxy::ProxyPool& proxyPool,
+                                     repository::DatabaseExecutor& database)
+    : connectionPool_(connectionPool), proxyPool_(proxyPool), database_(database) {}
+
+void MetricsController::registerRoutes(quickgrab::server::Router& router) {
+    router.addRoute("GET", "/metrics", [this](auto& ctx) { handleMetrics(ctx); });
+    router.addRoute("GET", "/api/traces", [this](auto& ctx) { handleTraces(ctx); });
+    router.addRoute("GET", "/api/latency", [this](auto& ctx) { handleLatency(ctx); });
+}
+
+void MetricsController::sample() {
+    const auto pool = connectionPool_.stats();
+    constexpr auto poolHelp = "MySqlConnectionPool sessions by state";
+    setGauge("quickgrab_db_pool_sessions", poolHelp, {{"state", "idle"}}, pool.idle);
+    setGauge("quickgrab_db_pool_sessions", poolHelp, {{"state", "in_use"}}, pool.inUse);
+    setGauge("quickgrab_db_pool_waiting", "Callers blocked in MySqlConnectionPool::acquire", {}, pool.waiting);
+
+    const auto proxies = proxyPool_.stats();
+    constexpr auto proxyHelp = "ProxyPool endpoints by state";
+    setGauge("quickgrab_proxy_pool_size", proxyHelp, {{"state", "available"}}, static_cast<std::int64_t>(proxies.available));
+    setGauge("quickgrab_proxy_pool_size", proxyHelp, {{"state", "cooling"}}, static_cast<std::int64_t>(proxies.coolingDown));
+    setGauge("quickgrab_proxy_pool_size", proxyHelp, {{"state", "sticky"}}, static_cast<std::int64_t>(proxies.sticky));
+    setGauge("quickgrab_proxy_affinities", "Affinity keys holding sticky proxies", {},
+             static_cast<std::int64_t>(proxies.affinities));
+
+    setGauge("quickgrab_db_executor_queue_depth", "Queued and running DatabaseExecutor jobs", {},
+             static_cast<std::int64_t>(database_.queued()));
+
+    for (const auto& score : util::domainScoreboard().snapshot()) {
+        const util::MetricLabels host{{"host", score.host}};
+        setGauge("quickgrab_domain_latency_microseconds", "DomainScoreboard latency EWMA by upstream domain", host,
+                 static_cast<std::int64_t>(score.latencyMicros));
+        setGauge("quickgrab_domain_error_permille", "DomainScoreboard transport/5xx error rate by upstream domain", host,
+                 static_cast<std::int64_t>(score.errorRate * 1000.0));
+        setGauge("quickgrab_domain_busy_permille", "DomainScoreboard crowded-response rate by upstream domain", host,
+                 static_cast<std::int64_t>(score.busyRate * 1000.0));
+    }
+
+    setGauge("quickgrab_log_dropped_lines", "Log lines dropped since start because the async queue was full", {},
+             static_cast<std::int64_t>(util::droppedLogCount()));
+}
+
+void MetricsController::handleMetrics(quickgrab::server::RequestContext& ctx) {
+    sample();
+    ctx.response.result(boost::beast::http::status::ok);
+    ctx.response.set(boost::beast::http::field::content_type, "text/plain; version=0.0.4; charset=utf-8");
+    ctx.response.set(boost::beast::http::field::cache_control, "no-store");
+    ctx.response.body() = util::metrics().renderPrometheus();
+    ctx.response.prepare_payload();
+}
+
+void MetricsController::handleTraces(quickgrab::server::RequestContext& ctx) {
+    auto params = parseQueryParameters(ctx.request.target());
+    const auto limit = std::clamp(parseOptionalInt(params, "limit").value_or(20), 1, 256);
+    auto timelines = util::recentTimelines(static_cast<std::size_t>(limit), parseOptionalInt(params, "requestId"));
+
+    ctx.response.result(boost::beast::http::status::ok);
+    ctx.response.set(boost::beast::http::field::content_type, "application/json; charset=utf-8");
+    ctx.response.set(boost::beast::http::field::cache_control, "no-store");
+    ctx.response.body() = util::chromeTraceJson(timelines);
+    ctx.response.prepare_payload();
+}
+
+void MetricsController::handleLatency(quickgrab::server::RequestContext& ctx) {
+    const auto& estimator = util::latencyEstimator();
+    const auto entries = estimator.snapshot();
+    const auto now = std::chrono::steady_clock::now();
+    auto millis = [](double micros) { return micros / 1000.0; };
+    auto writeLead = [&](util::JsonWriter& writer, std::string_view name, std::optional<std::chrono::microseconds> lead) {
+        writer.key(name);
+        if (lead) {
+            writer.value(millis(static_cast<double>(lead->count())));
+        } else {
+            writer.null();
+        }
+    };
+
+    std::string body;
+    util::JsonWriter writer(body);
+    writer.beginObject();
+    writer.key("estimates").beginArray();
+    for (const auto& entry : entries) {
+        const auto age = std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.summary.updated);
+        writer.beginObject()
+            .field("host", entry.host)
+            .field("proxy", entry.proxy)
+            .field("kind", util::latencyKindName(entry.kind))
+            .field("samples", static_cast<std::int64_t>(entry.summary.samples))
+            .field("ewmaMs", millis(entry.summary.ewmaMicros))
+            .field("p50Ms", millis(entry.summary.p50Micros))
+            .field("p90Ms", millis(entry.summary.p90Micros))
+            .field("p99Ms", millis(entry.summary.p99Micros))
+            .field("ageMs", static_cast<std::int64_t>(age.count()))
+            .endObject();
+    }
+    writer.endArray();
+
+    std::set<std::pair<std::string, std::string>> pairs;
+    for (const auto& entry : entries) {
+        pairs.emplace(entry.host, entry.proxy);
+    }
+    writer.key("fireLead").beginArray();
+    for (const auto& [host, proxy] : pairs) {
+        writer.beginObject().field("host", host).field("proxy", proxy);
+        writeLead(writer, "warmMs", estimator.fireLead(host, proxy, true));
+        writeLead(writer, "coldMs", estimator.fireLead(host, proxy, false));
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+
+    ctx.response.result(boost::beast::http::status::ok);
+    ctx.response.set(boost::beast::http::field::content_type, "application/json; charset=utf-8");
+    ctx.response.set(boost::beast::http::field::cache_control, "no-store");
+    ctx.response.body() = std::move(body);
+    ctx.response.prepare_payload();
+}
+
+} // namespace quickgrab::controller
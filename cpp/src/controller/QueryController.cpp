@@ -1,21 +1,39 @@
 #include "quickgrab/controller/QueryController.hpp"
+#include "quickgrab/model/RowJson.hpp"
+#include "quickgrab/server/ChunkedResponse.hpp"
+#include "quickgrab/server/ETag.hpp"
 #include "quickgrab/util/JsonUtil.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
 #include "quickgrab/util/Logging.hpp"
 
 #include <boost/beast/http.hpp>
 #include <boost/json.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
-#include <iomanip>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace quickgrab::controller {
 namespace {
+// limit 超过该行数时改用分块传输，不必预先计算 Content-Length，也不把整页拼成一个连续缓冲
+constexpr int kChunkedRowThreshold = 200;
+constexpr std::size_t kChunkFlushBytes = 64 * 1024;
+// 单行 JSON 的粗略估计，用于预留响应缓冲
+constexpr std::size_t kEstimatedRowBytes = 2048;
+// 键集分页单页上限；分页模式总是整页写入响应体
+constexpr int kMaxPageLimit = 500;
+
 std::string urlDecode(const std::string& value) {
     std::string result;
     result.reserve(value.size());
@@ -84,88 +102,6 @@ int parseIntOrDefault(const std::unordered_map<std::string, std::string>& params
     return fallback;
 }
 
-std::string formatTimestamp(const std::chrono::system_clock::time_point& tp) {
-    if (tp.time_since_epoch().count() == 0) {
-        return "";
-    }
-    auto tt = std::chrono::system_clock::to_time_t(tp);
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &tt);
-#else
-    localtime_r(&tt, &tm);
-#endif
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
-}
-
-boost::json::object requestToJson(const model::Request& request) {
-    boost::json::object obj;
-    obj["id"] = request.id;
-    obj["deviceId"] = request.deviceId;
-    obj["buyerId"] = request.buyerId;
-    obj["threadId"] = request.threadId;
-    obj["link"] = request.link;
-    obj["cookies"] = request.cookies;
-    obj["orderInfo"] = request.orderInfo;
-    obj["userInfo"] = request.userInfo;
-    obj["orderTemplate"] = request.orderTemplate;
-    obj["message"] = request.message;
-    obj["idNumber"] = request.idNumber;
-    obj["keyword"] = request.keyword;
-    obj["startTime"] = formatTimestamp(request.startTime);
-    obj["endTime"] = formatTimestamp(request.endTime);
-    obj["quantity"] = request.quantity;
-    obj["delay"] = request.delay;
-    obj["frequency"] = request.frequency;
-    obj["type"] = request.type;
-    obj["status"] = request.status;
-    if (!request.orderParametersRaw.empty()) {
-        obj["orderParameters"] = request.orderParametersRaw;
-    } else {
-        obj["orderParameters"] = request.orderParameters;
-    }
-    if (!request.orderParametersRaw.empty()) {
-        obj["orderParametersRaw"] = request.orderParametersRaw;
-    }
-    obj["actualEarnings"] = request.actualEarnings;
-    obj["estimatedEarnings"] = request.estimatedEarnings;
-    obj["extension"] = request.extension;
-    return obj;
-}
-
-boost::json::object resultToJson(const model::Result& result) {
-    boost::json::object obj;
-    obj["id"] = result.id;
-    obj["requestId"] = result.requestId;
-    obj["deviceId"] = result.deviceId;
-    obj["buyerId"] = result.buyerId;
-    obj["threadId"] = result.threadId;
-    obj["link"] = result.link;
-    obj["cookies"] = result.cookies;
-    obj["orderInfo"] = result.orderInfo;
-    obj["userInfo"] = result.userInfo;
-    obj["orderTemplate"] = result.orderTemplate;
-    obj["message"] = result.message;
-    obj["idNumber"] = result.idNumber;
-    obj["keyword"] = result.keyword;
-    obj["startTime"] = formatTimestamp(result.startTime);
-    obj["endTime"] = formatTimestamp(result.endTime);
-    obj["quantity"] = result.quantity;
-    obj["delay"] = result.delay;
-    obj["frequency"] = result.frequency;
-    obj["type"] = result.type;
-    obj["status"] = result.status;
-    obj["responseMessage"] = result.responseMessage;
-    obj["actualEarnings"] = result.actualEarnings;
-    obj["estimatedEarnings"] = result.estimatedEarnings;
-    obj["extension"] = result.extension;
-    obj["payload"] = result.payload;
-    obj["createdAt"] = formatTimestamp(result.createdAt);
-    return obj;
-}
-
 boost::json::object buyerToJson(const model::Buyer& buyer) {
     boost::json::object obj;
     obj["id"] = buyer.id;
@@ -180,6 +116,115 @@ void sendJsonResponse(quickgrab::server::RequestContext& ctx, const boost::json:
     ctx.response.prepare_payload();
 }
 
+using JsonProducer = std::function<void(quickgrab::util::JsonWriter&)>;
+
+// 小页直接写入响应体，不经过 boost::json DOM
+void sendJsonStream(quickgrab::server::RequestContext& ctx, int limit, const JsonProducer& produce) {
+    auto& body = ctx.response.body();
+    body.clear();
+    body.reserve(static_cast<std::size_t>(std::max(0, limit)) * kEstimatedRowBytes + 2);
+    quickgrab::util::JsonWriter writer(body);
+    produce(writer);
+    ctx.response.result(boost::beast::http::status::ok);
+    ctx.response.set(boost::beast::http::field::content_type, "application/json; charset=utf-8");
+    ctx.response.prepare_payload();
+}
+
+// 大页使用 chunked 编码：查询在当前（数据库执行器）线程上一次读完，每满 kChunkFlushBytes 切成一块，
+// 数据库会话随处理器返回立即归还；响应头写出后由 ChunkedResponse 在连接的 strand 上带超时逐块异步写出，
+// 慢客户端不会占住数据库会话或执行器线程。查询出错时头部尚未发出，调用方照常返回 500。
+void sendJsonChunked(quickgrab::server::RequestContext& ctx, const JsonProducer& produce) {
+    std::vector<std::string> chunks;
+    std::string buffer;
+    buffer.reserve(kChunkFlushBytes + kEstimatedRowBytes);
+    quickgrab::util::JsonWriter writer(buffer);
+    writer.setFlushHandler(kChunkFlushBytes, [&chunks](std::string& pending) {
+        chunks.push_back(std::move(pending));
+        pending.clear();
+        pending.reserve(kChunkFlushBytes + kEstimatedRowBytes);
+    });
+    produce(writer);
+    writer.flush();
+
+    ctx.response.result(boost::beast::http::status::ok);
+    ctx.response.set(boost::beast::http::field::content_type, "application/json; charset=utf-8");
+    ctx.response.chunked(true);
+    ctx.response.keep_alive(false);
+    ctx.streamHandler = [chunks = std::move(chunks)](boost::beast::tcp_stream stream) mutable {
+        std::make_shared<quickgrab::server::ChunkedResponse>(std::move(stream), std::move(chunks))->start();
+    };
+}
+
+void sendJsonRows(quickgrab::server::RequestContext& ctx, int limit, JsonProducer produce) {
+    if (limit > kChunkedRowThreshold) {
+        sendJsonChunked(ctx, produce);
+    } else {
+        sendJsonStream(ctx, limit, produce);
+    }
+}
+
+// 请求带 cursor 或 view 参数时启用键集分页，返回 {items, nextCursor, total, totalExact}；
+// 否则保持旧的 offset 分页与数组响应，兼容现有调用方。
+struct PageParams {
+    bool enabled{false};
+    bool invalidCursor{false};
+    bool summary{true};
+    bool withTotal{false};
+    std::optional<repository::ListCursor> after;
+};
+
+PageParams parsePageParams(const std::unordered_map<std::string, std::string>& params) {
+    PageParams page;
+    auto cursorIt = params.find("cursor");
+    auto viewIt = params.find("view");
+    page.enabled = cursorIt != params.end() || viewIt != params.end();
+    if (!page.enabled) {
+        return page;
+    }
+    if (cursorIt != params.end() && !cursorIt->second.empty()) {
+        page.after = repository::decodeCursor(cursorIt->second);
+        page.invalidCursor = !page.after.has_value();
+    }
+    page.summary = viewIt == params.end() || viewIt->second != "full";
+    if (auto it = params.find("withTotal"); it != params.end()) {
+        page.withTotal = it->second == "1" || it->second == "true";
+    }
+    return page;
+}
+
+void writePageEnvelope(quickgrab::util::JsonWriter& writer,
+                       const repository::ListPageResult& page,
+                       const std::optional<repository::TotalCount>& total) {
+    writer.key("nextCursor");
+    if (page.next) {
+        writer.value(repository::encodeCursor(*page.next));
+    } else {
+        writer.null();
+    }
+    writer.key("total");
+    if (total) {
+        writer.value(static_cast<std::int64_t>(total->value));
+        writer.field("totalExact", total->exact);
+    } else {
+        writer.null();
+    }
+}
+
+void sendBadRequest(quickgrab::server::RequestContext& ctx, std::string_view error) {
+    ctx.response.erase(boost::beast::http::field::etag);
+    ctx.response.result(boost::beast::http::status::bad_request);
+    ctx.response.set(boost::beast::http::field::content_type, "application/json; charset=utf-8");
+    boost::json::object obj;
+    obj["error"] = error;
+    ctx.response.body() = quickgrab::util::stringifyJson(obj);
+    ctx.response.prepare_payload();
+}
+
+std::string_view requestTarget(const quickgrab::server::RequestContext& ctx) {
+    auto target = ctx.request.target();
+    return std::string_view(target.data(), target.size());
+}
+
 void sendNotFound(quickgrab::server::RequestContext& ctx) {
     ctx.response.result(boost::beast::http::status::not_found);
     ctx.response.set(boost::beast::http::field::content_type, "application/json; charset=utf-8");
@@ -188,6 +233,7 @@ void sendNotFound(quickgrab::server::RequestContext& ctx) {
 }
 
 void sendServerError(quickgrab::server::RequestContext& ctx, std::string_view message) {
+    ctx.response.erase(boost::beast::http::field::etag);
     ctx.response.result(boost::beast::http::status::internal_server_error);
     ctx.response.set(boost::beast::http::field::content_type, "application/json; charset=utf-8");
     if (!message.empty()) {
@@ -203,19 +249,29 @@ void sendServerError(quickgrab::server::RequestContext& ctx, std::string_view me
 
 } // namespace
 
-QueryController::QueryController(service::QueryService& queryService)
-    : queryService_(queryService) {}
+QueryController::QueryController(service::QueryService& queryService, repository::DatabaseExecutor& database)
+    : queryService_(queryService), database_(database) {}
 
 void QueryController::registerRoutes(quickgrab::server::Router& router) {
-    router.addRoute("GET", "/api/grab/pending", [this](auto& ctx) { handlePending(ctx); });
+    // 这些接口都会同步访问 MySQL，统一投递到数据库执行器，避免阻塞 I/O 线程
+    auto offload = database_.offloader();
+    router.addAsyncRoute("GET", "/api/grab/pending", [this](auto& ctx) { handlePending(ctx); }, offload);
+
+    // ETag 只依赖进程内的版本计数，在 I/O 线程上投递前校验；版本号必须在查询前读取，查询期间若有写入，下次请求会得到新的 ETag
+    auto requestsPrecheck = [this](auto& ctx) {
+        return server::handleConditionalGet(ctx, server::makeETag({queryService_.requestsVersion()}, requestTarget(ctx)));
+    };
+    auto resultsPrecheck = [this](auto& ctx) {
+        return server::handleConditionalGet(ctx, server::makeETag({queryService_.resultsVersion()}, requestTarget(ctx)));
+    };
 
     auto bindGetRequests = [this](auto& ctx) { handleGetRequests(ctx); };
-    router.addRoute("GET", "/getRequests", bindGetRequests);
-    router.addRoute("GET", "/api/getRequests", bindGetRequests);
+    router.addAsyncRoute("GET", "/getRequests", bindGetRequests, offload, requestsPrecheck);
+    router.addAsyncRoute("GET", "/api/getRequests", bindGetRequests, offload, requestsPrecheck);
 
     auto bindGetResults = [this](auto& ctx) { handleGetResults(ctx); };
-    router.addRoute("GET", "/getResults", bindGetResults);
-    router.addRoute("GET", "/api/getResults", bindGetResults);
+    router.addAsyncRoute("GET", "/getResults", bindGetResults, offload, resultsPrecheck);
+    router.addAsyncRoute("GET", "/api/getResults", bindGetResults, offload, resultsPrecheck);
     auto bindDeleteRequest = [this](auto& ctx) {
         auto it = ctx.pathParameters.find("id");
         if (it == ctx.pathParameters.end()) {
@@ -228,8 +284,8 @@ void QueryController::registerRoutes(quickgrab::server::Router& router) {
             sendNotFound(ctx);
         }
     };
-    router.addRoute("DELETE", "/deleteRequest/:id", bindDeleteRequest);
-    router.addRoute("DELETE", "/api/deleteRequest/:id", bindDeleteRequest);
+    router.addAsyncRoute("DELETE", "/deleteRequest/:id", bindDeleteRequest, offload);
+    router.addAsyncRoute("DELETE", "/api/deleteRequest/:id", bindDeleteRequest, offload);
 
     auto bindDeleteResult = [this](auto& ctx) {
         auto it = ctx.pathParameters.find("id");
@@ -243,8 +299,8 @@ void QueryController::registerRoutes(quickgrab::server::Router& router) {
             sendNotFound(ctx);
         }
     };
-    router.addRoute("DELETE", "/deleteResult/:id", bindDeleteResult);
-    router.addRoute("DELETE", "/api/deleteResult/:id", bindDeleteResult);
+    router.addAsyncRoute("DELETE", "/deleteResult/:id", bindDeleteResult, offload);
+    router.addAsyncRoute("DELETE", "/api/deleteResult/:id", bindDeleteResult, offload);
 
     auto bindGetResult = [this](auto& ctx) {
         auto it = ctx.pathParameters.find("id");
@@ -258,23 +314,39 @@ void QueryController::registerRoutes(quickgrab::server::Router& router) {
             sendNotFound(ctx);
         }
     };
-    router.addRoute("GET", "/getResult/:id", bindGetResult);
-    router.addRoute("GET", "/api/getResult/:id", bindGetResult);
+    router.addAsyncRoute("GET", "/getResult/:id", bindGetResult, offload);
+    router.addAsyncRoute("GET", "/api/getResult/:id", bindGetResult, offload);
+
+    auto bindGetRequest = [this](auto& ctx) {
+        auto it = ctx.pathParameters.find("id");
+        if (it == ctx.pathParameters.end()) {
+            sendNotFound(ctx);
+            return;
+        }
+        try {
+            handleGetRequest(ctx, std::stoi(it->second));
+        } catch (...) {
+            sendNotFound(ctx);
+        }
+    };
+    router.addAsyncRoute("GET", "/getRequest/:id", bindGetRequest, offload);
+    router.addAsyncRoute("GET", "/api/getRequest/:id", bindGetRequest, offload);
 
     auto bindGetBuyers = [this](auto& ctx) { handleGetBuyers(ctx); };
-    router.addRoute("GET", "/getBuyer", bindGetBuyers);
-    router.addRoute("GET", "/api/getBuyer", bindGetBuyers);
+    router.addAsyncRoute("GET", "/getBuyer", bindGetBuyers, offload);
+    router.addAsyncRoute("GET", "/api/getBuyer", bindGetBuyers, offload);
 }
 
 void QueryController::handlePending(quickgrab::server::RequestContext& ctx) {
     try {
         auto pending = queryService_.listPending(20);
-        boost::json::array payload;
-        payload.reserve(pending.size());
-        for (const auto& request : pending) {
-            payload.emplace_back(requestToJson(request));
-        }
-        sendJsonResponse(ctx, payload);
+        sendJsonStream(ctx, static_cast<int>(pending.size()), [&pending](util::JsonWriter& writer) {
+            writer.beginArray();
+            for (const auto& request : pending) {
+                model::writeRequestJson(writer, model::requestColumns(request));
+            }
+            writer.endArray();
+        });
     } catch (const std::exception& ex) {
         util::log(util::LogLevel::error, std::string{"加载待处理请求失败: "} + ex.what());
         sendServerError(ctx, "数据库查询失败");
@@ -295,14 +367,32 @@ void QueryController::handleGetRequests(quickgrab::server::RequestContext& ctx)
     int offset = parseIntOrDefault(params, "offset", 0);
     int limit = parseIntOrDefault(params, "limit", 20);
 
+    auto page = parsePageParams(params);
+    if (page.invalidCursor) {
+        sendBadRequest(ctx, "invalid_cursor");
+        return;
+    }
+
     try {
-        auto requests = queryService_.getRequestsByFilters(keyword, buyerId, type, status, order, offset, limit);
-        boost::json::array payload;
-        payload.reserve(requests.size());
-        for (const auto& request : requests) {
-            payload.emplace_back(requestToJson(request));
+        if (page.enabled) {
+            repository::ListFilter filter{keyword, buyerId, type, status};
+            limit = std::clamp(limit, 1, kMaxPageLimit);
+            sendJsonStream(ctx, limit, [&](util::JsonWriter& writer) {
+                writer.beginObject();
+                writer.key("items");
+                auto result = queryService_.writeRequestsPage(filter, order, page.after, limit, page.summary, writer);
+                std::optional<repository::TotalCount> total;
+                if (page.withTotal) {
+                    total = queryService_.countRequests(filter);
+                }
+                writePageEnvelope(writer, result, total);
+                writer.endObject();
+            });
+            return;
         }
-        sendJsonResponse(ctx, payload);
+        sendJsonRows(ctx, limit, [this, keyword, buyerId, type, status, order, offset, limit](util::JsonWriter& writer) {
+            queryService_.writeRequestsByFilters(keyword, buyerId, type, status, order, offset, limit, writer);
+        });
     } catch (const std::exception& ex) {
         util::log(util::LogLevel::error, std::string{"加载抢购请求失败: "} + ex.what());
         sendServerError(ctx, "数据库查询失败");
@@ -323,14 +413,32 @@ void QueryController::handleGetResults(quickgrab::server::RequestContext& ctx) {
     int offset = parseIntOrDefault(params, "offset", 0);
     int limit = parseIntOrDefault(params, "limit", 20);
 
+    auto page = parsePageParams(params);
+    if (page.invalidCursor) {
+        sendBadRequest(ctx, "invalid_cursor");
+        return;
+    }
+
     try {
-        auto results = queryService_.getResultsByFilters(keyword, buyerId, type, status, order, offset, limit);
-        boost::json::array payload;
-        payload.reserve(results.size());
-        for (const auto& result : results) {
-            payload.emplace_back(resultToJson(result));
+        if (page.enabled) {
+            repository::ListFilter filter{keyword, buyerId, type, status};
+            limit = std::clamp(limit, 1, kMaxPageLimit);
+            sendJsonStream(ctx, limit, [&](util::JsonWriter& writer) {
+                writer.beginObject();
+                writer.key("items");
+                auto result = queryService_.writeResultsPage(filter, order, page.after, limit, page.summary, writer);
+                std::optional<repository::TotalCount> total;
+                if (page.withTotal) {
+                    total = queryService_.countResults(filter);
+                }
+                writePageEnvelope(writer, result, total);
+                writer.endObject();
+            });
+            return;
         }
-        sendJsonResponse(ctx, payload);
+        sendJsonRows(ctx, limit, [this, keyword, buyerId, type, status, order, offset, limit](util::JsonWriter& writer) {
+            queryService_.writeResultsByFilters(keyword, buyerId, type, status, order, offset, limit, writer);
+        });
     } catch (const std::exception& ex) {
         util::log(util::LogLevel::error, std::string{"加载抢购结果失败: "} + ex.what());
         sendServerError(ctx, "数据库查询失败");
@@ -372,7 +480,9 @@ void QueryController::handleGetResult(quickgrab::server::RequestContext& ctx, in
             sendNotFound(ctx);
             return;
         }
-        sendJsonResponse(ctx, resultToJson(*result));
+        sendJsonStream(ctx, 1, [&result](util::JsonWriter& writer) {
+            model::writeResultJson(writer, model::resultColumns(*result));
+        });
     } catch (const std::exception& ex) {
         util::log(util::LogLevel::error,
                   "查询抢购结果详情失败 id=" + std::to_string(resultId) + " error=" + ex.what());
@@ -380,6 +490,23 @@ void QueryController::handleGetResult(quickgrab::server::RequestContext& ctx, in
     }
 }
 
+void QueryController::handleGetRequest(quickgrab::server::RequestContext& ctx, int requestId) {
+    try {
+        auto request = queryService_.getRequestById(requestId);
+        if (!request) {
+            sendNotFound(ctx);
+            return;
+        }
+        sendJsonStream(ctx, 1, [&request](util::JsonWriter& writer) {
+            model::writeRequestJson(writer, model::requestColumns(*request));
+        });
+    } catch (const std::exception& ex) {
+        util::log(util::LogLevel::error,
+                  "查询抢购请求详情失败 id=" + std::to_string(requestId) + " error=" + ex.what());
+        sendServerError(ctx, "数据库查询失败");
+    }
+}
+
 void QueryController::handleGetBuyers(quickgrab::server::RequestContext& ctx) {
     try {
         auto buyers = queryService_.getAllBuyers();
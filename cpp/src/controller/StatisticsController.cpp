@@ -1,12 +1,17 @@
 #include "quickgrab/controller/StatisticsController.hpp"
+#include "quickgrab/server/ETag.hpp"
+#include "quickgrab/util/DateTime.hpp"
 #include "quickgrab/util/JsonUtil.hpp"
 
 #include <boost/beast/http.hpp>
 #include <boost/json.hpp>
 
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace quickgrab::controller {
@@ -77,16 +82,45 @@ void sendJson(quickgrab::server::RequestContext& ctx, const boost::json::value&
     ctx.response.prepare_payload();
 }
 
+// 按日统计依赖 CURDATE()，把本地日期计入 ETag，跨天后自动失效
+std::uint64_t localDayBucket() {
+    const auto now = std::chrono::system_clock::now();
+    const auto local = now.time_since_epoch() + quickgrab::util::localUtcOffset(now);
+    return static_cast<std::uint64_t>(std::chrono::floor<std::chrono::days>(local).count());
+}
+
+// 按小时统计是最近 24 小时的滚动窗口，按分钟分桶，旧数据最多滞后一分钟移出窗口
+std::uint64_t minuteBucket() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::minutes>(now).count());
+}
+
+std::string_view requestTarget(const quickgrab::server::RequestContext& ctx) {
+    auto target = ctx.request.target();
+    return std::string_view(target.data(), target.size());
+}
+
 } // namespace
 
-StatisticsController::StatisticsController(service::StatisticsService& statisticsService)
-    : statisticsService_(statisticsService) {}
+StatisticsController::StatisticsController(service::StatisticsService& statisticsService, repository::DatabaseExecutor& database)
+    : statisticsService_(statisticsService), database_(database) {}
 
 void StatisticsController::registerRoutes(quickgrab::server::Router& router) {
-    router.addRoute("GET", "/api/statistics", [this](auto& ctx) { handleStatistics(ctx); });
-    router.addRoute("GET", "/api/dailyStats", [this](auto& ctx) { handleDailyStats(ctx); });
-    router.addRoute("GET", "/api/hourlyStats", [this](auto& ctx) { handleHourlyStats(ctx); });
-    router.addRoute("GET", "/api/buyers", [this](auto& ctx) { handleBuyers(ctx); });
+    // 这些接口都会同步访问 MySQL，统一投递到数据库执行器，避免阻塞 I/O 线程
+    auto offload = database_.offloader();
+    // ETag 在 I/O 线程上投递前校验，304 不占用数据库执行器的队列
+    router.addAsyncRoute("GET", "/api/statistics", [this](auto& ctx) { handleStatistics(ctx); }, offload, [this](auto& ctx) {
+        return server::handleConditionalGet(ctx, server::makeETag({statisticsService_.resultsVersion()}, requestTarget(ctx)));
+    });
+    router.addAsyncRoute("GET", "/api/dailyStats", [this](auto& ctx) { handleDailyStats(ctx); }, offload, [this](auto& ctx) {
+        return server::handleConditionalGet(
+            ctx, server::makeETag({statisticsService_.resultsVersion(), localDayBucket()}, requestTarget(ctx)));
+    });
+    router.addAsyncRoute("GET", "/api/hourlyStats", [this](auto& ctx) { handleHourlyStats(ctx); }, offload, [this](auto& ctx) {
+        return server::handleConditionalGet(
+            ctx, server::makeETag({statisticsService_.resultsVersion(), minuteBucket()}, requestTarget(ctx)));
+    });
+    router.addAsyncRoute("GET", "/api/buyers", [this](auto& ctx) { handleBuyers(ctx); }, offload);
 }
 
 static std::optional<std::string> normalizeIsoToMysql(std::optional<std::string> iso) {
@@ -3,6 +3,7 @@
 #include "quickgrab/model/Buyer.hpp"
 #include "quickgrab/model/Request.hpp"
 #include "quickgrab/util/HttpClient.hpp"
+#include "quickgrab/util/DateTime.hpp"
 #include "quickgrab/util/JsonUtil.hpp"
 #include "quickgrab/util/Logging.hpp"
 
@@ -12,8 +13,6 @@
 #include <algorithm>
 #include <chrono>
 #include <cctype>
-#include <ctime>
-#include <iomanip>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
@@ -263,14 +262,8 @@ std::chrono::system_clock::time_point parseDateTime(const boost::json::object& o
             if (text.size() == 16) {
                 text += ":00";
             }
-            std::tm tm{};
-            std::istringstream iss(text);
-            iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-            if (!iss.fail()) {
-                auto time = std::mktime(&tm);
-                if (time != -1) {
-                    return std::chrono::system_clock::from_time_t(time);
-                }
+            if (auto parsed = quickgrab::util::parseDateTime(text)) {
+                return *parsed;
             } else {
                 quickgrab::util::log(quickgrab::util::LogLevel::warn,
                                      std::string{"解析日期字段失败: "} + text);
@@ -1,5 +1,7 @@
 #include "quickgrab/controller/AuthController.hpp"
+#include "quickgrab/controller/EventController.hpp"
 #include "quickgrab/controller/GrabController.hpp"
+#include "quickgrab/controller/MetricsController.hpp"
 #include "quickgrab/controller/ProxyController.hpp"
 #include "quickgrab/controller/QueryController.hpp"
 #include "quickgrab/controller/StatisticsController.hpp"
@@ -10,12 +12,14 @@
 #include "quickgrab/proxy/ProxyPool.hpp"
 #include "quickgrab/repository/BuyersRepository.hpp"
 #include "quickgrab/repository/DatabaseConfig.hpp"
+#include "quickgrab/repository/DatabaseExecutor.hpp"
 #include "quickgrab/repository/MySqlConnectionPool.hpp"
 #include "quickgrab/repository/RequestsRepository.hpp"
 #include "quickgrab/repository/ResultsRepository.hpp"
 #include "quickgrab/server/HttpServer.hpp"
 #include "quickgrab/server/Router.hpp"
 #include "quickgrab/service/AuthService.hpp"
+#include "quickgrab/service/GrabEventBus.hpp"
 #include "quickgrab/service/GrabService.hpp"
 #include "quickgrab/service/MailService.hpp"
 #include "quickgrab/service/QueryService.hpp"
@@ -76,6 +80,14 @@ namespace {
                             if (!loaded.database.empty()) config.database = loaded.database;
                             if (!loaded.charset.empty()) config.charset = loaded.charset;
                             if (loaded.poolSize != 0) config.poolSize = loaded.poolSize;
+                            config.statementCache = loaded.statementCache;
+                            config.minIdle = loaded.minIdle;
+                            config.acquireTimeout = loaded.acquireTimeout;
+                            config.validateAfterIdle = loaded.validateAfterIdle;
+                            config.keepaliveInterval = loaded.keepaliveInterval;
+                            config.maxLifetime = loaded.maxLifetime;
+                            config.executorThreads = loaded.executorThreads;
+                            config.executorQueueLimit = loaded.executorQueueLimit;
                         }
                     }
                     catch (const std::exception& ex) {
@@ -95,10 +107,57 @@ namespace {
         if (const char* value = std::getenv("QUICKGRAB_DB_POOL")) {
             config.poolSize = std::max(1u, static_cast<unsigned int>(std::strtoul(value, nullptr, 10)));
         }
+        if (const char* value = std::getenv("QUICKGRAB_DB_STATEMENT_CACHE")) {
+            config.statementCache = std::string_view{value} != "0";
+        }
+        if (const char* value = std::getenv("QUICKGRAB_DB_MIN_IDLE")) {
+            config.minIdle = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+        }
+        if (const char* value = std::getenv("QUICKGRAB_DB_ACQUIRE_TIMEOUT_MS")) {
+            config.acquireTimeout = std::chrono::milliseconds(std::strtoll(value, nullptr, 10));
+        }
+        if (const char* value = std::getenv("QUICKGRAB_DB_MAX_LIFETIME_MS")) {
+            config.maxLifetime = std::chrono::milliseconds(std::strtoll(value, nullptr, 10));
+        }
+        if (const char* value = std::getenv("QUICKGRAB_DB_EXECUTOR_THREADS")) {
+            config.executorThreads = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+        }
+        if (const char* value = std::getenv("QUICKGRAB_DB_EXECUTOR_QUEUE")) {
+            config.executorQueueLimit = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+        }
 
         return config;
     }
 
+// 日志默认写入 logs/quickgrab.log 并同步输出到控制台，可用环境变量调整
+util::LogConfig loadLogConfig() {
+    util::LogConfig config;
+    if (const char* value = std::getenv("QUICKGRAB_LOG_LEVEL")) {
+        const std::string_view level{value};
+        if (level == "trace") config.level = util::LogLevel::trace;
+        else if (level == "debug") config.level = util::LogLevel::debug;
+        else if (level == "warn") config.level = util::LogLevel::warn;
+        else if (level == "error") config.level = util::LogLevel::error;
+    }
+    if (const char* value = std::getenv("QUICKGRAB_LOG_DIR")) config.directory = value;
+    if (const char* value = std::getenv("QUICKGRAB_LOG_MAX_MB")) {
+        config.maxFileBytes = static_cast<std::size_t>(std::strtoull(value, nullptr, 10)) * 1024 * 1024;
+    }
+    if (const char* value = std::getenv("QUICKGRAB_LOG_ROTATE_MINUTES")) {
+        config.rotateInterval = std::chrono::minutes(std::strtoll(value, nullptr, 10));
+    }
+    if (const char* value = std::getenv("QUICKGRAB_LOG_MAX_FILES")) {
+        config.maxFiles = static_cast<std::size_t>(std::strtoull(value, nullptr, 10));
+    }
+    if (const char* value = std::getenv("QUICKGRAB_LOG_QUEUE")) {
+        config.queueCapacity = std::max<std::size_t>(2, std::strtoull(value, nullptr, 10));
+    }
+    if (const char* value = std::getenv("QUICKGRAB_LOG_CONSOLE")) {
+        config.console = std::string_view{value} != "0";
+    }
+    return config;
+}
+
 std::vector<ProxyEndpoint> loadProxiesFromFile(const std::filesystem::path& path) {
     std::vector<ProxyEndpoint> proxies;
     if (!std::filesystem::exists(path)) {
@@ -141,6 +200,70 @@ std::vector<ProxyEndpoint> loadProxiesFromFile(const std::filesystem::path& path
 }
 
 
+// 把上游主机指向本地模拟服务（bench/mock），仅用于联调与压测：
+// QUICKGRAB_UPSTREAM_OVERRIDE=thor.weidian.com=127.0.0.1:18443,weidian.com=127.0.0.1:18443
+// QUICKGRAB_UPSTREAM_CA=模拟服务测试 CA 的 PEM 文件
+void configureUpstreamOverrides(quickgrab::util::HttpClient& client) {
+    if (const char* value = std::getenv("QUICKGRAB_UPSTREAM_OVERRIDE")) {
+        std::string_view spec{value};
+        while (!spec.empty()) {
+            auto comma = spec.find(',');
+            auto entry = spec.substr(0, comma);
+            spec = comma == std::string_view::npos ? std::string_view{} : spec.substr(comma + 1);
+            auto eq = entry.find('=');
+            auto colon = entry.rfind(':');
+            if (eq == std::string_view::npos || colon == std::string_view::npos || colon < eq) {
+                quickgrab::util::log(quickgrab::util::LogLevel::warn, "忽略无效的上游覆盖项: " + std::string(entry));
+                continue;
+            }
+            std::string host(entry.substr(0, eq));
+            std::string address(entry.substr(eq + 1, colon - eq - 1));
+            auto port = static_cast<std::uint16_t>(std::strtoul(std::string(entry.substr(colon + 1)).c_str(), nullptr, 10));
+            quickgrab::util::log(quickgrab::util::LogLevel::warn,
+                                 "上游 " + host + " 被覆盖为 " + address + ":" + std::to_string(port));
+            client.overrideHost(std::move(host), std::move(address), port);
+        }
+    }
+    if (const char* path = std::getenv("QUICKGRAB_UPSTREAM_CA")) {
+        std::ifstream ifs(path);
+        std::string pem((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        if (pem.empty()) {
+            quickgrab::util::log(quickgrab::util::LogLevel::warn, std::string{"无法读取上游测试 CA: "} + path);
+        } else {
+            client.trustCertificateAuthority(pem);
+        }
+    }
+}
+
+// 订单参数后台刷新：QUICKGRAB_PARAM_REFRESH_MS=刷新间隔（默认 10000，0 关闭）；
+// QUICKGRAB_PARAM_REFRESH_GUARD_MS=开抢前暂停刷新的窗口（默认 500）
+void configureParameterRefresh(quickgrab::service::GrabService& grabService) {
+    quickgrab::workflow::ParameterRefreshConfig config;
+    if (const char* value = std::getenv("QUICKGRAB_PARAM_REFRESH_MS")) {
+        config.interval = std::chrono::milliseconds(std::max(0L, std::atol(value)));
+    }
+    if (const char* value = std::getenv("QUICKGRAB_PARAM_REFRESH_GUARD_MS")) {
+        config.guard = std::chrono::milliseconds(std::max(0L, std::atol(value)));
+    }
+    grabService.setParameterRefresh(config);
+}
+
+// 上游流量录制/回放：QUICKGRAB_HTTP_RECORD=磁带文件 录制真实往返；
+// QUICKGRAB_HTTP_REPLAY=磁带文件 离线回放，QUICKGRAB_HTTP_REPLAY_TIMING=recorded（默认）|immediate
+void configureHttpCassette(quickgrab::util::HttpClient& client) {
+    if (const char* path = std::getenv("QUICKGRAB_HTTP_REPLAY")) {
+        auto timing = quickgrab::util::CassetteTiming::recorded;
+        if (const char* value = std::getenv("QUICKGRAB_HTTP_REPLAY_TIMING")) {
+            if (std::string_view{value} == "immediate") timing = quickgrab::util::CassetteTiming::immediate;
+        }
+        client.startReplay(path, timing);
+        quickgrab::util::log(quickgrab::util::LogLevel::warn, std::string{"上游请求从磁带回放，不访问网络: "} + path);
+    } else if (const char* path = std::getenv("QUICKGRAB_HTTP_RECORD")) {
+        client.startRecording(path);
+        quickgrab::util::log(quickgrab::util::LogLevel::warn, std::string{"上游往返录制到: "} + path);
+    }
+}
+
 void startRequestPump(boost::asio::io_context& io, quickgrab::service::GrabService& grabService) {
     auto timer = std::make_shared<boost::asio::steady_timer>(io);
     auto handler = std::make_shared<std::function<void(const boost::system::error_code&)>>();
@@ -169,25 +292,80 @@ void startRequestPump(boost::asio::io_context& io, quickgrab::service::GrabServi
         timer->async_wait(*handler);
     }
 
+    // 连接池维护会阻塞（ping/建连），定时器只负责把任务投递到数据库执行器
+    void startDatabaseMaintenance(boost::asio::io_context& io,
+                                  quickgrab::repository::DatabaseExecutor& database,
+                                  quickgrab::repository::MySqlConnectionPool& pool) {
+        auto interval = std::max<std::chrono::milliseconds>(std::chrono::seconds(5), pool.config().keepaliveInterval / 2);
+        auto timer = std::make_shared<boost::asio::steady_timer>(io);
+        auto handler = std::make_shared<std::function<void(const boost::system::error_code&)>>();
+        *handler = [timer, &database, &pool, handler, interval](const boost::system::error_code& ec) {
+            if (!ec) {
+                database.post([&pool, &database]() {
+                    pool.maintain();
+                    auto stats = pool.stats();
+                    auto avgWait = stats.acquired == 0 ? 0 : stats.totalWait.count() / static_cast<std::int64_t>(stats.acquired);
+                    quickgrab::util::log(quickgrab::util::LogLevel::debug,
+                        "MySQL 连接池 total=" + std::to_string(stats.total) + " idle=" + std::to_string(stats.idle) +
+                        " inUse=" + std::to_string(stats.inUse) + " waiting=" + std::to_string(stats.waiting) +
+                        " avgWaitUs=" + std::to_string(avgWait) + " maxWaitUs=" + std::to_string(stats.maxWait.count()) +
+                        " timeouts=" + std::to_string(stats.timeouts) +
+                        " validationFailures=" + std::to_string(stats.validationFailures) +
+                        " dbQueued=" + std::to_string(database.queued()) +
+                        " dbRejected=" + std::to_string(database.rejected()));
+                });
+                timer->expires_after(interval);
+                timer->async_wait(*handler);
+            }
+            };
+        timer->expires_after(interval);
+        timer->async_wait(*handler);
+    }
+
 } // namespace
 
-int main(int /*argc*/, char** /*argv*/) {
+int main(int argc, char** argv) {
     using namespace quickgrab;
-    util::initLogging(util::LogLevel::info);
+    util::initLogging(loadLogConfig());
+    // --rebuild-rollups：按 results 重建统计汇总表后退出，用于其他程序直接写入 results 之后
+    const bool rebuildRollupsOnly = argc > 1 && std::string_view{argv[1]} == "--rebuild-rollups";
 
     boost::asio::io_context io;
     boost::asio::thread_pool workerPool(std::max(2u, std::thread::hardware_concurrency()));
     proxy::ProxyPool proxyPool{ std::chrono::seconds{30} };
     util::HttpClient httpClient{ io, proxyPool };
+    configureUpstreamOverrides(httpClient);
+    configureHttpCassette(httpClient);
 
     std::filesystem::create_directories("data");
     auto dbConfig = loadDatabaseConfig("../../data/database.json");
     util::log(util::LogLevel::info,
               "连接 MySQL: " + dbConfig.host + ":" + std::to_string(dbConfig.port) + "/" + dbConfig.database);
     repository::MySqlConnectionPool connectionPool{dbConfig};
+    connectionPool.warmUp();
     repository::RequestsRepository requests{connectionPool};
     repository::ResultsRepository results{connectionPool};
     repository::BuyersRepository buyers{connectionPool};
+    if (rebuildRollupsOnly) {
+        int status = 0;
+        try {
+            if (results.prepareRollups()) {
+                results.rebuildRollups();
+            } else {
+                status = 1;
+            }
+        } catch (const std::exception& ex) {
+            util::log(util::LogLevel::error, std::string{"--rebuild-rollups 未完成: "} + ex.what());
+            status = 1;
+        }
+        util::shutdownLogging();
+        return status;
+    }
+    results.prepareRollups();
+    // 阻塞的 MySQL 调用统一在独立线程池执行，不占用抢购工作线程与 I/O 线程
+    repository::DatabaseExecutor dbExecutor{
+        dbConfig.executorThreads != 0 ? dbConfig.executorThreads : dbConfig.poolSize,
+        dbConfig.executorQueueLimit};
 
     service::MailService::Config mailConfig;
     if (const char* from = std::getenv("QUICKGRAB_MAIL_FROM")) {
@@ -203,7 +381,8 @@ int main(int /*argc*/, char** /*argv*/) {
     service::MailService mailService{std::move(mailConfig)};
 
     service::AuthService authService{buyers};
-    service::GrabService grabService{io, workerPool, requests, results, httpClient, proxyPool, mailService};
+    service::GrabEventBus eventBus;
+    service::GrabService grabService{io, workerPool, dbExecutor, requests, results, httpClient, proxyPool, mailService, eventBus};
     service::QueryService queryService{requests, results, buyers};
     service::StatisticsService statisticsService{results, buyers};
 
@@ -218,6 +397,7 @@ int main(int /*argc*/, char** /*argv*/) {
                       "，每次拉取 " + std::to_string(kdlConfig->batchSize) + " 个候选");
         grabService.setProxyConfig(*kdlConfig);
     }
+    configureParameterRefresh(grabService);
 
     auto router = std::make_shared<server::Router>();
     controller::AuthController authController{authService};
@@ -229,10 +409,10 @@ int main(int /*argc*/, char** /*argv*/) {
     controller::ProxyController proxyController{ httpClient };
     proxyController.registerRoutes(*router);
 
-    controller::QueryController queryController{ queryService };
+    controller::QueryController queryController{ queryService, dbExecutor };
     queryController.registerRoutes(*router);
 
-    controller::StatisticsController statisticsController{statisticsService};
+    controller::StatisticsController statisticsController{statisticsService, dbExecutor};
     statisticsController.registerRoutes(*router);
 
     controller::SubmitController submitController{grabService, authService, httpClient};
@@ -244,11 +424,18 @@ int main(int /*argc*/, char** /*argv*/) {
     controller::UserController userController{authService};
     userController.registerRoutes(*router);
 
+    controller::EventController eventController{eventBus, authService};
+    eventController.registerRoutes(*router);
+
+    controller::MetricsController metricsController{connectionPool, proxyPool, dbExecutor};
+    metricsController.registerRoutes(*router);
+
     auto server = std::make_shared<server::HttpServer>(io, router, "0.0.0.0", 8080);
     server->start();
 
     startRequestPump(io, grabService);
     startProxyTick(io, proxyPool);
+    startDatabaseMaintenance(io, dbExecutor, connectionPool);
 
     unsigned int ioThreadsCount = std::max(2u, std::thread::hardware_concurrency());
     std::vector<std::thread> ioThreads;
@@ -268,7 +455,9 @@ int main(int /*argc*/, char** /*argv*/) {
         }
     }
 
+    dbExecutor.join();
     workerPool.join();
+    util::shutdownLogging();
     return 0;
 }
 
@@ -0,0 +1,86 @@
+#include "quickgrab/model/JsonColumn.hpp"
+#include "quickgrab/util/JsonUtil.hpp"
+#include "quickgrab/util/Logging.hpp"
+
+#include <utility>
+
+namespace quickgrab::model {
+namespace {
+
+const boost::json::value& nullValue() {
+    static const boost::json::value value;
+    return value;
+}
+
+} // namespace
+
+JsonColumn::JsonColumn(boost::json::value value)
+    : state_(std::make_shared<State>()) {
+    state_->value = std::move(value);
+    state_->parsed.store(true, std::memory_order_release);
+}
+
+JsonColumn& JsonColumn::operator=(boost::json::value value) {
+    *this = JsonColumn(std::move(value));
+    return *this;
+}
+
+JsonColumn JsonColumn::fromRaw(std::string raw, boost::json::value fallback, std::string_view column,
+                               bool trusted) {
+    JsonColumn result;
+    result.state_ = std::make_shared<State>();
+    result.state_->raw = std::move(raw);
+    result.state_->column = column;
+    result.state_->trusted = trusted;
+    // 未解析前先存放回退值，解析成功后覆盖
+    result.state_->value = std::move(fallback);
+    return result;
+}
+
+const boost::json::value& JsonColumn::get() const {
+    if (!state_) {
+        return nullValue();
+    }
+    if (!state_->parsed.load(std::memory_order_acquire)) {
+        std::call_once(state_->once, [state = state_.get()]() {
+            try {
+                state->value = util::parseJson(state->raw);
+            } catch (const std::exception& ex) {
+                state->failed = true;
+                util::log(util::LogLevel::warn,
+                          "JSON parse failed on column " + std::string(state->column) + ": " + ex.what());
+            }
+            state->parsed.store(true, std::memory_order_release);
+        });
+    }
+    return state_->value;
+}
+
+boost::json::value& JsonColumn::mutate() {
+    if (!state_) {
+        state_ = std::make_shared<State>();
+        state_->parsed.store(true, std::memory_order_release);
+    } else if (state_.use_count() > 1 || !state_->raw.empty()) {
+        *this = JsonColumn(get());
+    }
+    return state_->value;
+}
+
+bool JsonColumn::parsed() const noexcept {
+    return !state_ || state_->parsed.load(std::memory_order_acquire);
+}
+
+const std::string* JsonColumn::raw() const {
+    if (!state_ || state_->raw.empty()) {
+        return nullptr;
+    }
+    if (state_->parsed.load(std::memory_order_acquire)) {
+        return state_->failed ? nullptr : &state_->raw;
+    }
+    if (state_->trusted || util::isValidJson(state_->raw)) {
+        return &state_->raw;
+    }
+    return nullptr;
+}
+
+} // namespace quickgrab::model
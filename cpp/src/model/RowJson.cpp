@@ -0,0 +1,204 @@
+#include "quickgrab/model/RowJson.hpp"
+#include "quickgrab/util/DateTime.hpp"
+
+namespace quickgrab::model {
+namespace {
+
+std::string formatTimestamp(const std::chrono::system_clock::time_point& tp) {
+    if (tp.time_since_epoch().count() == 0) {
+        return "";
+    }
+    return util::formatDateTime(tp);
+}
+
+void writeJsonField(util::JsonWriter& writer, const JsonField& field, std::string_view fallback) {
+    if (!field.text.empty()) {
+        writer.raw(field.text);
+    } else if (field.value) {
+        writer.value(*field.value);
+    } else {
+        writer.raw(fallback);
+    }
+}
+
+} // namespace
+
+JsonField jsonField(const JsonColumn& column) {
+    JsonField field;
+    // 未修改过的合法原文直接透传，省去解析再序列化；JSON 类型列不再逐行校验
+    if (const auto* raw = column.raw()) {
+        field.text = *raw;
+    } else {
+        field.value = &column.get();
+    }
+    return field;
+}
+
+RequestColumns requestColumns(const Request& request) {
+    RequestColumns columns;
+    columns.id = request.id;
+    columns.deviceId = request.deviceId;
+    columns.buyerId = request.buyerId;
+    columns.threadId = request.threadId;
+    columns.link = request.link;
+    columns.cookies = request.cookies;
+    columns.orderInfo = jsonField(request.orderInfo);
+    columns.userInfo = jsonField(request.userInfo);
+    columns.orderTemplate = jsonField(request.orderTemplate);
+    columns.message = request.message;
+    columns.idNumber = request.idNumber;
+    columns.keyword = request.keyword;
+    columns.startTime = formatTimestamp(request.startTime);
+    columns.endTime = formatTimestamp(request.endTime);
+    columns.quantity = request.quantity;
+    columns.delay = request.delay;
+    columns.frequency = request.frequency;
+    columns.type = request.type;
+    columns.status = request.status;
+    columns.orderParametersRaw = request.orderParametersRaw;
+    columns.orderParameters = jsonField(request.orderParameters);
+    columns.actualEarnings = request.actualEarnings;
+    columns.estimatedEarnings = request.estimatedEarnings;
+    columns.extension = jsonField(request.extension);
+    return columns;
+}
+
+ResultColumns resultColumns(const Result& result) {
+    ResultColumns columns;
+    columns.id = result.id;
+    columns.requestId = result.requestId;
+    columns.deviceId = result.deviceId;
+    columns.buyerId = result.buyerId;
+    columns.threadId = result.threadId;
+    columns.link = result.link;
+    columns.cookies = result.cookies;
+    columns.orderInfo = jsonField(result.orderInfo);
+    columns.userInfo = jsonField(result.userInfo);
+    columns.orderTemplate = jsonField(result.orderTemplate);
+    columns.message = result.message;
+    columns.idNumber = result.idNumber;
+    columns.keyword = result.keyword;
+    columns.startTime = formatTimestamp(result.startTime);
+    columns.endTime = formatTimestamp(result.endTime);
+    columns.quantity = result.quantity;
+    columns.delay = result.delay;
+    columns.frequency = result.frequency;
+    columns.type = result.type;
+    columns.status = result.status;
+    columns.responseMessage = jsonField(result.responseMessage);
+    columns.actualEarnings = result.actualEarnings;
+    columns.estimatedEarnings = result.estimatedEarnings;
+    columns.extension = jsonField(result.extension);
+    columns.payload = jsonField(result.payload);
+    columns.createdAt = formatTimestamp(result.createdAt);
+    return columns;
+}
+
+void writeRequestJson(util::JsonWriter& writer, const RequestColumns& request) {
+    writer.beginObject();
+    writer.field("id", request.id);
+    writer.field("deviceId", request.deviceId);
+    writer.field("buyerId", request.buyerId);
+    writer.field("threadId", request.threadId);
+    writer.field("link", request.link);
+    writer.field("cookies", request.cookies);
+    writer.key("orderInfo");
+    writeJsonField(writer, request.orderInfo, "{}");
+    writer.key("userInfo");
+    writeJsonField(writer, request.userInfo, "{}");
+    writer.key("orderTemplate");
+    writeJsonField(writer, request.orderTemplate, "{}");
+    writer.field("message", request.message);
+    writer.field("idNumber", request.idNumber);
+    writer.field("keyword", request.keyword);
+    writer.field("startTime", request.startTime);
+    writer.field("endTime", request.endTime);
+    writer.field("quantity", request.quantity);
+    writer.field("delay", request.delay);
+    writer.field("frequency", request.frequency);
+    writer.field("type", request.type);
+    writer.field("status", request.status);
+    // 有原文时 orderParameters 以字符串形式给出原文，兼容前端既有解析
+    if (!request.orderParametersRaw.empty()) {
+        writer.field("orderParameters", request.orderParametersRaw);
+        writer.field("orderParametersRaw", request.orderParametersRaw);
+    } else {
+        writer.key("orderParameters");
+        writeJsonField(writer, request.orderParameters, "{}");
+    }
+    writer.field("actualEarnings", request.actualEarnings);
+    writer.field("estimatedEarnings", request.estimatedEarnings);
+    writer.key("extension");
+    writeJsonField(writer, request.extension, "{}");
+    writer.endObject();
+}
+
+void writeResultJson(util::JsonWriter& writer, const ResultColumns& result) {
+    writer.beginObject();
+    writer.field("id", result.id);
+    writer.field("requestId", result.requestId);
+    writer.field("deviceId", result.deviceId);
+    writer.field("buyerId", result.buyerId);
+    writer.field("threadId", result.threadId);
+    writer.field("link", result.link);
+    writer.field("cookies", result.cookies);
+    writer.key("orderInfo");
+    writeJsonField(writer, result.orderInfo, "null");
+    writer.key("userInfo");
+    writeJsonField(writer, result.userInfo, "null");
+    writer.key("orderTemplate");
+    writeJsonField(writer, result.orderTemplate, "null");
+    writer.field("message", result.message);
+    writer.field("idNumber", result.idNumber);
+    writer.field("keyword", result.keyword);
+    writer.field("startTime", result.startTime);
+    writer.field("endTime", result.endTime);
+    writer.field("quantity", result.quantity);
+    writer.field("delay", result.delay);
+    writer.field("frequency", result.frequency);
+    writer.field("type", result.type);
+    writer.field("status", result.status);
+    writer.key("responseMessage");
+    writeJsonField(writer, result.responseMessage, "null");
+    writer.field("actualEarnings", result.actualEarnings);
+    writer.field("estimatedEarnings", result.estimatedEarnings);
+    writer.key("extension");
+    writeJsonField(writer, result.extension, "null");
+    writer.key("payload");
+    writeJsonField(writer, result.payload, "null");
+    writer.field("createdAt", result.createdAt);
+    writer.endObject();
+}
+
+void writeRequestSummaryJson(util::JsonWriter& writer, const RequestColumns& request) {
+    writer.beginObject();
+    writer.field("id", request.id);
+    writer.field("buyerId", request.buyerId);
+    writer.key("userInfo");
+    writeJsonField(writer, request.userInfo, "{}");
+    writer.field("type", request.type);
+    writer.field("status", request.status);
+    writer.field("startTime", request.startTime);
+    writer.field("endTime", request.endTime);
+    writer.field("actualEarnings", request.actualEarnings);
+    writer.field("estimatedEarnings", request.estimatedEarnings);
+    writer.endObject();
+}
+
+void writeResultSummaryJson(util::JsonWriter& writer, const ResultColumns& result) {
+    writer.beginObject();
+    writer.field("id", result.id);
+    writer.field("requestId", result.requestId);
+    writer.field("buyerId", result.buyerId);
+    writer.key("userInfo");
+    writeJsonField(writer, result.userInfo, "null");
+    writer.field("type", result.type);
+    writer.field("status", result.status);
+    writer.field("startTime", result.startTime);
+    writer.field("endTime", result.endTime);
+    writer.field("actualEarnings", result.actualEarnings);
+    writer.field("estimatedEarnings", result.estimatedEarnings);
+    writer.endObject();
+}
+
+} // namespace quickgrab::model
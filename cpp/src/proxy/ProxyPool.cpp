@@ -1,4 +1,5 @@
 #include "quickgrab/proxy/ProxyPool.hpp"
+#include "quickgrab/util/Metrics.hpp"
 
 #include <algorithm>
 #include <chrono>
@@ -23,6 +24,10 @@ void sortByPreference(std::vector<ProxyEndpoint>& proxies) {
     std::stable_sort(proxies.begin(), proxies.end(), compareProxy);
 }
 
+util::Counter& reportCounter(std::string_view result) {
+    return util::metrics().counter("quickgrab_proxy_reports_total", "Proxy success/failure reports", {{"result", result}});
+}
+
 } // namespace
 
 ProxyPool::ProxyPool(std::chrono::seconds cooldown)
@@ -96,6 +101,7 @@ std::optional<ProxyEndpoint> ProxyPool::acquire(const std::string& affinityKey)
 void ProxyPool::reportSuccess(const std::string& affinityKey, ProxyEndpoint proxy) {
     proxy.failureCount = 0;
     proxy.nextAvailable = std::chrono::steady_clock::now() + cooldown_;
+    reportCounter("success").inc();
     std::scoped_lock lock(mutex_);
     auto stateIt = sticky_.find(affinityKey);
     if (stateIt != sticky_.end()) {
@@ -115,6 +121,7 @@ void ProxyPool::reportSuccess(const std::string& affinityKey, ProxyEndpoint prox
 void ProxyPool::reportFailure(const std::string& affinityKey, ProxyEndpoint proxy) {
     proxy.failureCount += 1;
     proxy.nextAvailable = std::chrono::steady_clock::now() + cooldown_ * (1 + proxy.failureCount);
+    reportCounter("failure").inc();
     std::scoped_lock lock(mutex_);
     auto stateIt = sticky_.find(affinityKey);
     if (stateIt != sticky_.end()) {
@@ -169,5 +176,23 @@ void ProxyPool::tick() {
     std::stable_sort(pool_.begin(), pool_.end(), compareProxy);
 }
 
+ProxyPool::Stats ProxyPool::stats() const {
+    const auto now = std::chrono::steady_clock::now();
+    std::scoped_lock lock(mutex_);
+    Stats snapshot;
+    for (const auto& proxy : pool_) {
+        if (proxy.nextAvailable > now) {
+            ++snapshot.coolingDown;
+        } else {
+            ++snapshot.available;
+        }
+    }
+    for (const auto& [key, state] : sticky_) {
+        snapshot.sticky += state.proxies.size();
+    }
+    snapshot.affinities = sticky_.size();
+    return snapshot;
+}
+
 } // namespace quickgrab::proxy
 
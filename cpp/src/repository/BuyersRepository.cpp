@@ -1,4 +1,5 @@
 #include "quickgrab/repository/BuyersRepository.hpp"
+#include "quickgrab/util/DateTime.hpp"
 #include "quickgrab/util/Logging.hpp"
 
 #include <mysqlx/common/value.h>
@@ -7,7 +8,6 @@
 #include <algorithm>
 #include <chrono>
 #include <exception>
-#include <iomanip>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -33,24 +33,6 @@ std::string valueToString(const mysqlx::Value& value) {
     }
 }
 
-std::string sanitizeDateTimeString(std::string text) {
-    if (text.empty()) {
-        return text;
-    }
-    if (text.front() == '\'' && text.back() == '\'' && text.size() > 1) {
-        text = text.substr(1, text.size() - 2);
-    }
-    if (text.front() == '"' && text.back() == '"' && text.size() > 1) {
-        text = text.substr(1, text.size() - 2);
-    }
-    std::replace(text.begin(), text.end(), 'T', ' ');
-    auto dot = text.find('.');
-    if (dot != std::string::npos) {
-        text = text.substr(0, dot);
-    }
-    return text;
-}
-
 std::string readString(const mysqlx::Value& value) {
     if (value.isNull()) {
         return {};
@@ -87,28 +69,20 @@ int readInt(const mysqlx::Value& value) {
     }
 }
 
-std::chrono::system_clock::time_point fromTm(const std::tm& tm) {
-    auto localTm = tm;
-    return std::chrono::system_clock::from_time_t(std::mktime(&localTm));
-}
-
 std::optional<std::chrono::system_clock::time_point> parseDateTime(const mysqlx::Value& value) {
     if (value.isNull()) {
         return std::nullopt;
     }
     try {
-        auto text = sanitizeDateTimeString(valueToString(value));
+        auto text = valueToString(value);
         if (text.empty()) {
             return std::nullopt;
         }
-        std::tm tm{};
-        std::istringstream iss(text);
-        iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-        if (iss.fail()) {
+        auto parsed = util::parseDateTime(text);
+        if (!parsed) {
             util::log(util::LogLevel::warn, std::string{"解析日期列失败: "} + text);
-            return std::nullopt;
         }
-        return fromTm(tm);
+        return parsed;
     } catch (const std::exception& ex) {
         util::log(util::LogLevel::warn, std::string{"读取日期列失败: "} + ex.what());
         return std::nullopt;
@@ -11,6 +11,14 @@ DatabaseConfig loadConfig(const boost::json::object& json) {
     if (auto it = json.if_contains("database")) cfg.database = std::string(it->as_string());
     if (auto it = json.if_contains("charset")) cfg.charset = std::string(it->as_string());
     if (auto it = json.if_contains("poolSize")) cfg.poolSize = static_cast<unsigned int>(it->as_int64());
+    if (auto it = json.if_contains("statementCache"); it && it->is_bool()) cfg.statementCache = it->as_bool();
+    if (auto it = json.if_contains("minIdle")) cfg.minIdle = static_cast<unsigned int>(it->as_int64());
+    if (auto it = json.if_contains("acquireTimeoutMs")) cfg.acquireTimeout = std::chrono::milliseconds(it->as_int64());
+    if (auto it = json.if_contains("validateAfterIdleMs")) cfg.validateAfterIdle = std::chrono::milliseconds(it->as_int64());
+    if (auto it = json.if_contains("keepaliveIntervalMs")) cfg.keepaliveInterval = std::chrono::milliseconds(it->as_int64());
+    if (auto it = json.if_contains("maxLifetimeMs")) cfg.maxLifetime = std::chrono::milliseconds(it->as_int64());
+    if (auto it = json.if_contains("executorThreads")) cfg.executorThreads = static_cast<unsigned int>(it->as_int64());
+    if (auto it = json.if_contains("executorQueueLimit")) cfg.executorQueueLimit = static_cast<unsigned int>(it->as_int64());
     return cfg;
 }
 
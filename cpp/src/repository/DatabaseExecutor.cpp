@@ -0,0 +1,37 @@
+#include "quickgrab/repository/DatabaseExecutor.hpp"
+#include "quickgrab/util/Metrics.hpp"
+
+#include <algorithm>
+
+namespace quickgrab::repository {
+
+DatabaseExecutor::DatabaseExecutor(std::size_t threads, std::size_t maxQueued)
+    : pool_(std::max<std::size_t>(1, threads))
+    , maxQueued_(std::max<std::size_t>(1, maxQueued)) {}
+
+DatabaseExecutor::~DatabaseExecutor() {
+    pool_.stop();
+    pool_.join();
+}
+
+bool DatabaseExecutor::tryReserve() {
+    auto current = queued_.load(std::memory_order_acquire);
+    do {
+        if (current >= maxQueued_) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            util::metrics().counter("quickgrab_db_executor_rejected_total", "DatabaseExecutor jobs rejected by the queue limit").inc();
+            return false;
+        }
+    } while (!queued_.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel));
+    return true;
+}
+
+DatabaseExecutor::Offload DatabaseExecutor::offloader() {
+    return [this](std::function<void()> job) { return post(std::move(job)); };
+}
+
+void DatabaseExecutor::join() {
+    pool_.join();
+}
+
+} // namespace quickgrab::repository
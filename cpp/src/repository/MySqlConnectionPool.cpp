@@ -1,10 +1,15 @@
 #include "quickgrab/repository/MySqlConnectionPool.hpp"
 #include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/Metrics.hpp"
 
 #include <mysqlx/xdevapi.h>
 
+#include <algorithm>
+#include <exception>
 #include <memory>
+#include <random>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 namespace quickgrab::repository {
@@ -26,6 +31,7 @@ MySqlConnectionPool::MySqlConnectionPool(DatabaseConfig config)
     if (config_.poolSize == 0) {
         config_.poolSize = 4;
     }
+    config_.minIdle = std::min(config_.minIdle, config_.poolSize);
 }
 
 std::unique_ptr<mysqlx::Session> MySqlConnectionPool::createSession() {
@@ -48,42 +54,280 @@ std::unique_ptr<mysqlx::Session> MySqlConnectionPool::createSession() {
     }
 }
 
-void MySqlConnectionPool::SessionDeleter::operator()(mysqlx::Session* session) const noexcept {
-    if (pool && session) {
-        pool->release(session);
+StatementCache::StatementCache(mysqlx::Session& session, std::string schemaName, bool enabled)
+    : session_(session), schemaName_(std::move(schemaName)), enabled_(enabled) {}
+
+mysqlx::Schema& StatementCache::schema() {
+    if (!schema_ || !enabled_) {
+        schema_.emplace(session_.getSchema(schemaName_));
     }
+    return *schema_;
 }
 
-std::shared_ptr<mysqlx::Session> MySqlConnectionPool::acquire() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    auto predicate = [this]() { return !idle_.empty() || currentSize_ < config_.poolSize; };
-    cv_.wait(lock, predicate);
+mysqlx::Table& StatementCache::table(const std::string& name) {
+    auto it = tables_.find(name);
+    if (it == tables_.end() || !enabled_) {
+        it = tables_.insert_or_assign(name, schema().getTable(name)).first;
+    }
+    return it->second;
+}
 
-    if (!idle_.empty()) {
-        std::unique_ptr<mysqlx::Session> session = std::move(idle_.back());
-        idle_.pop_back();
-        return std::shared_ptr<mysqlx::Session>(session.release(), SessionDeleter{this});
+PooledSession::PooledSession(std::unique_ptr<mysqlx::Session> sessionPtr,
+                             const std::string& schemaName,
+                             bool cacheStatements,
+                             std::chrono::steady_clock::time_point expiresAt)
+    : session(std::move(sessionPtr))
+    , statements(*session, schemaName, cacheStatements)
+    , expiresAt(expiresAt)
+    , lastVerified(std::chrono::steady_clock::now()) {}
+
+SessionLease::SessionLease(MySqlConnectionPool* pool, std::unique_ptr<PooledSession> pooled)
+    : pool_(pool), pooled_(std::move(pooled)), uncaughtAtAcquire_(std::uncaught_exceptions()) {}
+
+SessionLease::SessionLease(SessionLease&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr))
+    , pooled_(std::move(other.pooled_))
+    , uncaughtAtAcquire_(other.uncaughtAtAcquire_) {}
+
+SessionLease& SessionLease::operator=(SessionLease&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool_ = std::exchange(other.pool_, nullptr);
+        pooled_ = std::move(other.pooled_);
+        uncaughtAtAcquire_ = other.uncaughtAtAcquire_;
     }
+    return *this;
+}
 
-    std::unique_ptr<mysqlx::Session> session = createSession();
-    ++currentSize_;
-    return std::shared_ptr<mysqlx::Session>(session.release(), SessionDeleter{this});
+SessionLease::~SessionLease() {
+    reset();
 }
 
-void MySqlConnectionPool::release(mysqlx::Session* session) {
-    std::unique_ptr<mysqlx::Session> holder(session);
-    bool healthy = static_cast<bool>(holder);
+void SessionLease::reset() noexcept {
+    if (pool_ && pooled_) {
+        pool_->release(std::move(pooled_), std::uncaught_exceptions() > uncaughtAtAcquire_);
+    }
+    pool_ = nullptr;
+}
 
-    std::unique_lock<std::mutex> lock(mutex_);
-    if (healthy) {
-        idle_.push_back(std::move(holder));
-    } else {
+std::unique_ptr<PooledSession> MySqlConnectionPool::createPooled() {
+    auto lifetime = config_.maxLifetime;
+    if (lifetime.count() > 0) {
+        // 随机提前最多 10%，避免同一批预热的会话同时到期
+        thread_local std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<std::int64_t> jitter(0, lifetime.count() / 10);
+        lifetime -= std::chrono::milliseconds(jitter(rng));
+    }
+    auto expiresAt = lifetime.count() > 0 ? std::chrono::steady_clock::now() + lifetime
+                                          : std::chrono::steady_clock::time_point::max();
+    auto pooled = std::make_unique<PooledSession>(createSession(), config_.database, config_.statementCache, expiresAt);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++counters_.created;
+    return pooled;
+}
+
+bool MySqlConnectionPool::ping(PooledSession& pooled) {
+    try {
+        pooled.session->sql("SELECT 1").execute();
+        pooled.lastVerified = std::chrono::steady_clock::now();
+        pooled.suspect = false;
+        return true;
+    } catch (const std::exception& ex) {
+        util::log(util::LogLevel::warn, std::string{"MySQL 会话校验失败，丢弃重建: "} + ex.what());
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++counters_.validationFailures;
+        return false;
+    }
+}
+
+void MySqlConnectionPool::discard(std::unique_ptr<PooledSession> pooled) {
+    if (pooled) {
+        try {
+            pooled->session->close();
+        } catch (const std::exception&) {
+            // 连接已断开时关闭也会失败，直接释放即可
+        }
+        pooled.reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
         if (currentSize_ > 0) {
             --currentSize_;
         }
+        ++counters_.destroyed;
     }
+    cv_.notify_one();
+}
+
+SessionLease MySqlConnectionPool::acquire() {
+    static auto& waitHistogram = util::metrics().histogram(
+        "quickgrab_db_pool_wait_seconds", "Time spent in MySqlConnectionPool::acquire, including validation and connect");
+    const auto started = std::chrono::steady_clock::now();
+    const auto deadline = started + config_.acquireTimeout;
+    auto recordWait = [this, started]() {
+        auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+        waitHistogram.observe(waited);
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++counters_.acquired;
+        counters_.totalWait += waited;
+        counters_.maxWait = std::max(counters_.maxWait, waited);
+    };
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        auto available = [this]() { return !idle_.empty() || currentSize_ < config_.poolSize; };
+        if (!available()) {
+            ++waiting_;
+            bool ready = cv_.wait_until(lock, deadline, available);
+            --waiting_;
+            if (!ready) {
+                ++counters_.timeouts;
+                util::metrics().counter("quickgrab_db_pool_timeouts_total", "MySqlConnectionPool acquire timeouts").inc();
+                throw ConnectionPoolTimeout("获取数据库连接超时（" + std::to_string(config_.acquireTimeout.count()) +
+                                            "ms），连接池已满：" + std::to_string(currentSize_) + " 个会话全部在用，" +
+                                            std::to_string(waiting_) + " 个调用在排队");
+            }
+        }
+
+        if (!idle_.empty()) {
+            auto pooled = std::move(idle_.back());
+            idle_.pop_back();
+            lock.unlock();
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= pooled->expiresAt) {
+                discard(std::move(pooled));
+                lock.lock();
+                continue;
+            }
+            if ((pooled->suspect || now - pooled->lastVerified >= config_.validateAfterIdle) && !ping(*pooled)) {
+                discard(std::move(pooled));
+                lock.lock();
+                continue;
+            }
+            recordWait();
+            return SessionLease{this, std::move(pooled)};
+        }
+
+        // 占住名额后在锁外建连，避免阻塞其他借还
+        ++currentSize_;
+        lock.unlock();
+        try {
+            auto pooled = createPooled();
+            recordWait();
+            return SessionLease{this, std::move(pooled)};
+        } catch (...) {
+            lock.lock();
+            --currentSize_;
+            lock.unlock();
+            cv_.notify_one();
+            throw;
+        }
+    }
+}
+
+void MySqlConnectionPool::release(std::unique_ptr<PooledSession> pooled, bool suspect) {
+    if (!pooled || !pooled->session) {
+        discard(nullptr);
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= pooled->expiresAt) {
+        discard(std::move(pooled));
+        return;
+    }
+    pooled->suspect = pooled->suspect || suspect;
+    if (!pooled->suspect) {
+        pooled->lastVerified = now;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.push_back(std::move(pooled));
     lock.unlock();
     cv_.notify_one();
 }
 
+void MySqlConnectionPool::warmUp() {
+    refill();
+    auto snapshot = stats();
+    util::log(util::LogLevel::info,
+              "MySQL 连接池预热完成，空闲会话 " + std::to_string(snapshot.idle) + "/" + std::to_string(config_.minIdle));
+}
+
+void MySqlConnectionPool::refill() {
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            // 有调用方在排队时让出名额，由 acquire 自行建连
+            if (idle_.size() >= config_.minIdle || currentSize_ >= config_.poolSize || waiting_ > 0) {
+                return;
+            }
+            ++currentSize_;
+        }
+        try {
+            auto pooled = createPooled();
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.insert(idle_.begin(), std::move(pooled));
+        } catch (const std::exception& ex) {
+            util::log(util::LogLevel::warn, std::string{"补齐 MySQL 空闲会话失败: "} + ex.what());
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --currentSize_;
+            }
+            cv_.notify_one();
+            return;
+        }
+        cv_.notify_one();
+    }
+}
+
+void MySqlConnectionPool::maintain() {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<PooledSession>> expired;
+    std::vector<std::unique_ptr<PooledSession>> stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.begin();
+        while (it != idle_.end()) {
+            auto& pooled = *it;
+            if (now >= pooled->expiresAt) {
+                expired.push_back(std::move(pooled));
+                it = idle_.erase(it);
+            } else if (pooled->suspect || now - pooled->lastVerified >= config_.keepaliveInterval) {
+                stale.push_back(std::move(pooled));
+                it = idle_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (auto& pooled : expired) {
+        discard(std::move(pooled));
+    }
+    for (auto& pooled : stale) {
+        if (!ping(*pooled)) {
+            discard(std::move(pooled));
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.insert(idle_.begin(), std::move(pooled));
+        }
+        cv_.notify_one();
+    }
+
+    refill();
+}
+
+MySqlConnectionPool::Stats MySqlConnectionPool::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats snapshot = counters_;
+    snapshot.total = currentSize_;
+    snapshot.idle = static_cast<unsigned int>(idle_.size());
+    snapshot.inUse = currentSize_ >= snapshot.idle ? currentSize_ - snapshot.idle : 0;
+    snapshot.waiting = waiting_;
+    return snapshot;
+}
+
 } // namespace quickgrab::repository
@@ -0,0 +1,220 @@
+#include "quickgrab/repository/Pagination.hpp"
+#include "quickgrab/util/Logging.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <utility>
+
+namespace quickgrab::repository {
+namespace {
+
+bool isDateTimeText(std::string_view text) {
+    // 仅接受 DATE_FORMAT(..., '%Y-%m-%d %H:%i:%s') 的输出
+    static constexpr std::string_view kPattern = "dddd-dd-dd dd:dd:dd";
+    if (text.size() != kPattern.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const auto ch = static_cast<unsigned char>(text[i]);
+        if (kPattern[i] == 'd' ? !std::isdigit(ch) : text[i] != kPattern[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 按 UTF-8 码点计数，ngram_token_size 默认为 2，少于两个字符无法命中全文索引
+std::size_t countCodePoints(std::string_view text) {
+    return static_cast<std::size_t>(std::count_if(text.begin(), text.end(), [](char ch) {
+        return (static_cast<unsigned char>(ch) & 0xC0) != 0x80;
+    }));
+}
+
+// 布尔模式下整体作为短语匹配，去掉会破坏短语语法的双引号
+std::string toBooleanPhrase(std::string_view keyword) {
+    std::string phrase;
+    phrase.reserve(keyword.size() + 2);
+    phrase.push_back('"');
+    for (char ch : keyword) {
+        phrase.push_back(ch == '"' ? ' ' : ch);
+    }
+    phrase.push_back('"');
+    return phrase;
+}
+
+constexpr std::size_t kNgramTokenSize = 2;
+
+} // namespace
+
+std::string encodeCursor(const ListCursor& cursor) {
+    auto text = std::to_string(cursor.id);
+    if (cursor.value) {
+        text.push_back('.');
+        text += *cursor.value;
+    }
+    return text;
+}
+
+std::optional<ListCursor> decodeCursor(std::string_view text) {
+    if (text.empty()) {
+        return std::nullopt;
+    }
+    ListCursor cursor;
+    auto dot = text.find('.');
+    auto idPart = text.substr(0, dot);
+    auto [ptr, ec] = std::from_chars(idPart.data(), idPart.data() + idPart.size(), cursor.id);
+    if (ec != std::errc{} || ptr != idPart.data() + idPart.size()) {
+        return std::nullopt;
+    }
+    if (dot != std::string_view::npos) {
+        auto value = text.substr(dot + 1);
+        if (!isDateTimeText(value)) {
+            return std::nullopt;
+        }
+        cursor.value = std::string(value);
+    }
+    return cursor;
+}
+
+void appendFilterConditions(std::ostringstream& sql,
+                            std::vector<mysqlx::Value>& params,
+                            const ListFilter& filter) {
+    if (filter.keyword && !filter.keyword->empty()) {
+        const auto& keyword = *filter.keyword;
+        if (!filter.keywordIndexed) {
+            sql << " AND user_info LIKE ?";
+            params.emplace_back("%" + keyword + "%");
+        } else if (countCodePoints(keyword) < kNgramTokenSize) {
+            sql << " AND user_search LIKE ?";
+            params.emplace_back("%" + keyword + "%");
+        } else {
+            sql << " AND MATCH(user_search) AGAINST(? IN BOOLEAN MODE)";
+            params.emplace_back(toBooleanPhrase(keyword));
+        }
+    }
+    if (filter.buyerId) {
+        sql << " AND buyer_id = ?";
+        params.emplace_back(*filter.buyerId);
+    }
+    if (filter.type) {
+        sql << " AND type = ?";
+        params.emplace_back(*filter.type);
+    }
+    if (filter.status) {
+        sql << " AND status = ?";
+        params.emplace_back(*filter.status);
+    }
+}
+
+void appendKeysetCondition(std::ostringstream& sql,
+                           std::vector<mysqlx::Value>& params,
+                           std::string_view orderColumn,
+                           std::string_view orderDirection,
+                           const ListCursor& cursor) {
+    const bool descending = orderDirection == "DESC";
+    const char* cmp = descending ? "<" : ">";
+    if (orderColumn == "id") {
+        sql << " AND id " << cmp << " ?";
+        params.emplace_back(cursor.id);
+        return;
+    }
+
+    if (cursor.value) {
+        sql << " AND (" << orderColumn << ' ' << cmp << " ? OR (" << orderColumn << " = ? AND id " << cmp << " ?)";
+        params.emplace_back(*cursor.value);
+        params.emplace_back(*cursor.value);
+        params.emplace_back(cursor.id);
+        if (descending) {
+            // 降序时 NULL 排在最后，仍在游标之后
+            sql << " OR " << orderColumn << " IS NULL";
+        }
+        sql << ')';
+    } else if (descending) {
+        sql << " AND (" << orderColumn << " IS NULL AND id < ?)";
+        params.emplace_back(cursor.id);
+    } else {
+        sql << " AND (" << orderColumn << " IS NOT NULL OR id > ?)";
+        params.emplace_back(cursor.id);
+    }
+}
+
+std::string buildKeysetOrderClause(std::string_view orderColumn, std::string_view orderDirection, int limit) {
+    std::ostringstream oss;
+    oss << " ORDER BY " << orderColumn << ' ' << orderDirection;
+    if (orderColumn != "id") {
+        oss << ", id " << orderDirection;
+    }
+    oss << " LIMIT " << std::max(0, limit);
+    return oss.str();
+}
+
+std::optional<TotalCount> countRows(mysqlx::Session& session,
+                                    const std::string& schema,
+                                    std::string_view table,
+                                    const ListFilter& filter) {
+    if (filter.keyword && !filter.keyword->empty() && !filter.keywordIndexed) {
+        return std::nullopt;
+    }
+    try {
+        const bool hasKeyword = filter.keyword && !filter.keyword->empty();
+        if (!hasKeyword && !filter.buyerId && !filter.type && !filter.status) {
+            auto rows = session.sql("SELECT TABLE_ROWS FROM information_schema.TABLES WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ?")
+                            .bind(schema)
+                            .bind(std::string(table))
+                            .execute();
+            if (auto row = rows.fetchOne()) {
+                const auto& value = row[0];
+                return TotalCount{value.isNull() ? 0 : value.get<std::int64_t>(), false};
+            }
+            return std::nullopt;
+        }
+
+        std::ostringstream sql;
+        std::vector<mysqlx::Value> params;
+        sql << "SELECT COUNT(*) FROM " << table << " WHERE 1=1";
+        appendFilterConditions(sql, params, filter);
+        auto stmt = session.sql(sql.str());
+        for (const auto& param : params) {
+            stmt.bind(param);
+        }
+        auto rows = stmt.execute();
+        if (auto row = rows.fetchOne()) {
+            return TotalCount{row[0].get<std::int64_t>(), true};
+        }
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::warn, std::string{"统计列表总数失败: "} + err.what());
+    }
+    return std::nullopt;
+}
+
+KeywordIndexProbe::KeywordIndexProbe(std::string table)
+    : table_(std::move(table)) {}
+
+bool KeywordIndexProbe::available(mysqlx::Session& session, const std::string& schema) {
+    auto state = state_.load(std::memory_order_acquire);
+    if (state >= 0) {
+        return state == 1;
+    }
+    try {
+        auto rows = session.sql("SELECT COUNT(*) FROM information_schema.STATISTICS "
+                                "WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ? AND COLUMN_NAME = 'user_search' "
+                                "AND INDEX_TYPE = 'FULLTEXT'")
+                        .bind(schema)
+                        .bind(table_)
+                        .execute();
+        auto row = rows.fetchOne();
+        const bool found = row && row[0].get<std::int64_t>() > 0;
+        state_.store(found ? 1 : 0, std::memory_order_release);
+        if (!found) {
+            util::log(util::LogLevel::warn,
+                      "表 " + table_ + " 未建立关键词全文索引，关键词搜索将全表扫描，请执行 sql/002_keyword_search.sql");
+        }
+        return found;
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::warn, std::string{"探测关键词索引失败: "} + err.what());
+        return false;
+    }
+}
+
+} // namespace quickgrab::repository
@@ -1,6 +1,10 @@
 #include "quickgrab/repository/RequestsRepository.hpp"
+#include "quickgrab/model/RowJson.hpp"
 #include "quickgrab/util/JsonUtil.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
+#include "quickgrab/util/DateTime.hpp"
 #include "quickgrab/util/Logging.hpp"
+#include "quickgrab/repository/Pagination.hpp"
 #include "quickgrab/repository/SqlUtils.hpp"
 
 #include <mysqlx/common/value.h>
@@ -10,21 +14,14 @@
 #include <algorithm>
 #include <chrono>
 #include <exception>
-#include <iomanip>
 #include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <vector>
-#include <ctime>
 
 namespace quickgrab::repository {
 namespace {
-std::chrono::system_clock::time_point fromTm(const std::tm& tm) {
-    auto localTm = tm;
-    return std::chrono::system_clock::from_time_t(std::mktime(&localTm));
-}
-
 std::string valueToString(const mysqlx::Value& value) {
     if (value.isNull()) {
         return {};
@@ -43,42 +40,6 @@ std::string valueToString(const mysqlx::Value& value) {
     }
 }
 
-std::string sanitizeDateTimeString(std::string text) {
-    if (text.empty()) {
-        return text;
-    }
-    if (text.front() == '\'' && text.back() == '\'' && text.size() > 1) {
-        text = text.substr(1, text.size() - 2);
-    }
-    if (text.front() == '"' && text.back() == '"' && text.size() > 1) {
-        text = text.substr(1, text.size() - 2);
-    }
-    auto replaceChar = [&text](char from, char to) {
-        std::replace(text.begin(), text.end(), from, to);
-    };
-    replaceChar('T', ' ');
-    auto dotPos = text.find('.');
-    if (dotPos != std::string::npos) {
-        text = text.substr(0, dotPos);
-    }
-    return text;
-}
-
-std::chrono::system_clock::time_point parseDateTimeString(const std::string& input,
-                                                          const std::chrono::system_clock::time_point& fallback = {}) {
-    if (input.empty()) {
-        return fallback;
-    }
-    std::tm tm{};
-    std::istringstream iss(input);
-    iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-    if (iss.fail()) {
-        util::log(util::LogLevel::warn, std::string{"Failed to parse datetime text: "} + input);
-        return fallback;
-    }
-    return fromTm(tm);
-}
-
 std::chrono::system_clock::time_point parseDateTimeValue(
     const mysqlx::Value& value,
     const std::chrono::system_clock::time_point& fallback = std::chrono::system_clock::now()) {
@@ -86,8 +47,15 @@ std::chrono::system_clock::time_point parseDateTimeValue(
         return fallback;
     }
     try {
-        auto text = sanitizeDateTimeString(valueToString(value));
-        return parseDateTimeString(text, fallback);
+        auto text = valueToString(value);
+        if (text.empty()) {
+            return fallback;
+        }
+        if (auto parsed = util::parseDateTime(text)) {
+            return *parsed;
+        }
+        util::log(util::LogLevel::warn, std::string{"Failed to parse datetime text: "} + text);
+        return fallback;
     } catch (const std::exception& ex) {
         util::log(util::LogLevel::warn, std::string{"Failed to parse datetime column: "} + ex.what());
         return fallback;
@@ -130,29 +98,33 @@ double readDouble(const mysqlx::Value& value) {
     }
 }
 
-boost::json::value parseJsonColumn(const mysqlx::Value& value, const std::string& column) {
-    if (value.isNull()) {
-        return boost::json::object{};
-    }
+// 按列位置标记结果集中的 MySQL JSON 类型列（sql/004_json_columns.sql 迁移后），这些列的原文可直接透传；
+// 元数据读取失败时全部按 TEXT 处理，照旧校验
+std::vector<bool> jsonColumnTypes(const mysqlx::RowResult& rows) {
+    std::vector<bool> json;
     try {
-        return quickgrab::util::parseJson(valueToString(value));
+        const mysqlx::col_count_t n = rows.getColumnCount();
+        json.resize(n);
+        for (mysqlx::col_count_t pos = 0; pos < n; ++pos) {
+            json[pos] = rows.getColumn(pos).getType() == mysqlx::Type::JSON;
+        }
     } catch (const std::exception& ex) {
-        util::log(util::LogLevel::warn, "JSON parse failed on column " + column + ": " + ex.what());
-        return boost::json::object{};
+        util::log(util::LogLevel::warn, std::string{"Failed to inspect column metadata: "} + ex.what());
+        json.clear();
     }
+    return json;
+}
+
+bool isJsonColumn(const std::vector<bool>& json, std::size_t position) {
+    return position < json.size() && json[position];
 }
 
-std::string formatTimestamp(std::chrono::system_clock::time_point tp) {
-    auto tt = std::chrono::system_clock::to_time_t(tp);
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &tt);
-#else
-    localtime_r(&tt, &tm);
-#endif
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+// 只保存原文，字段第一次被读取时才解析；空值或非法内容按空对象处理
+model::JsonColumn readJsonColumn(const mysqlx::Value& value, std::string_view column, bool trusted) {
+    if (value.isNull()) {
+        return boost::json::value(boost::json::object{});
+    }
+    return model::JsonColumn::fromRaw(valueToString(value), boost::json::object{}, column, trusted);
 }
 
 mysqlx::Value makeNullValue() {
@@ -163,23 +135,168 @@ mysqlx::Value toTimestampValue(const std::chrono::system_clock::time_point& tp)
     if (tp.time_since_epoch().count() == 0) {
         return makeNullValue();
     }
-    return mysqlx::Value(formatTimestamp(tp));
+    return mysqlx::Value(util::formatDateTime(tp));
 }
 
-mysqlx::Value jsonOrNull(const boost::json::value& value) {
+// 未修改过的合法原文直接写回，省去解析再序列化的往返
+mysqlx::Value jsonOrNull(const model::JsonColumn& value) {
+    if (const auto* raw = value.raw()) {
+        return mysqlx::Value(*raw);
+    }
     if (value.is_null()) {
         return makeNullValue();
     }
-    return mysqlx::Value(quickgrab::util::stringifyJson(value));
+    return mysqlx::Value(quickgrab::util::stringifyJson(value.get()));
+}
+
+// 列顺序与 mapRow / writeRow 的位置读取一一对应
+constexpr const char* kListColumns =
+    "id, device_id, buyer_id, thread_id, link, cookies, order_info, user_info, order_template, message, "
+    "id_number, keyword, DATE_FORMAT(start_time, '%Y-%m-%d %H:%i:%s') AS start_time, DATE_FORMAT(end_time,   '%Y-%m-%d %H:%i:%s') AS end_time, quantity, delay, frequency, type, status, order_parameters, "
+    "actual_earnings, estimated_earnings, extension";
+
+// 列表卡片只需要的列，顺序与 writeSummaryRow 对应
+constexpr const char* kSummaryColumns =
+    "id, buyer_id, user_info, type, status, "
+    "DATE_FORMAT(start_time, '%Y-%m-%d %H:%i:%s') AS start_time, "
+    "DATE_FORMAT(end_time,   '%Y-%m-%d %H:%i:%s') AS end_time, "
+    "actual_earnings, estimated_earnings";
+
+// 与 mapRow 的列顺序一致，供 findPending / findById 的缓存语句使用
+mysqlx::TableSelect selectRequestColumns(mysqlx::Table& table) {
+    return table.select("id", "device_id", "buyer_id", "thread_id", "link", "cookies", "order_info", "user_info",
+                        "order_template", "message", "id_number", "keyword",
+                        "DATE_FORMAT(start_time, '%Y-%m-%d %H:%i:%s') AS start_time",
+                        "DATE_FORMAT(end_time,   '%Y-%m-%d %H:%i:%s') AS end_time", "quantity", "delay",
+                        "frequency", "type", "status", "order_parameters", "actual_earnings",
+                        "estimated_earnings", "extension");
+}
+
+mysqlx::RowResult executeFilterQuery(mysqlx::Session& session,
+                                     const ListFilter& filter,
+                                     std::string_view orderColumn,
+                                     std::string_view orderDirection,
+                                     int offset,
+                                     int limit) {
+    std::ostringstream sql;
+    sql << "SELECT " << kListColumns << " FROM requests WHERE 1=1";
+
+    std::vector<mysqlx::Value> params;
+    appendFilterConditions(sql, params, filter);
+    sql << " ORDER BY " << orderColumn << ' ' << orderDirection;
+    sql << buildLimitOffsetClause(limit, offset);
+
+    auto stmt = session.sql(sql.str());
+    for (const auto& param : params) {
+        stmt.bind(param);
+    }
+    return stmt.execute();
+}
+
+// JSON 列交给编码器原样写出，JSON 类型列直接信任，TEXT 列先校验；
+// 空值或非法内容留空，由编码器与 readJsonColumn 一致按空对象输出
+model::JsonField jsonColumnField(const mysqlx::Value& value, std::string_view column, bool trusted) {
+    model::JsonField field;
+    if (value.isNull()) {
+        return field;
+    }
+    auto text = valueToString(value);
+    if (!trusted && !util::isValidJson(text)) {
+        util::log(util::LogLevel::warn, "JSON parse failed on column " + std::string(column));
+        return field;
+    }
+    field.text = std::move(text);
+    return field;
+}
+
+// 列表接口的逐行编码：按 executeFilterQuery 的 SELECT 列顺序读出列视图，交给 model::writeRequestJson。
+// 时间列已由 SQL 端 DATE_FORMAT 格式化，直接透传
+void writeRow(util::JsonWriter& writer, const mysqlx::Row& row, const std::vector<bool>& json) {
+    std::size_t index = 0;
+    auto next = [&row, &index]() -> mysqlx::Value { return row[index++]; };
+    auto nextJson = [&](std::string_view column) {
+        const bool trusted = isJsonColumn(json, index);
+        return jsonColumnField(next(), column, trusted);
+    };
+    auto readInt = [](const mysqlx::Value& value) { return value.isNull() ? 0 : value.get<int>(); };
+
+    model::RequestColumns columns;
+    columns.id = readInt(next());
+    columns.deviceId = readInt(next());
+    columns.buyerId = readInt(next());
+    columns.threadId = readString(next());
+    columns.link = readString(next());
+    columns.cookies = readString(next());
+    columns.orderInfo = nextJson("order_info");
+    columns.userInfo = nextJson("user_info");
+    columns.orderTemplate = nextJson("order_template");
+    columns.message = readString(next());
+    columns.idNumber = readString(next());
+    columns.keyword = readString(next());
+    columns.startTime = readString(next());
+    columns.endTime = readString(next());
+    columns.quantity = readInt(next());
+    columns.delay = readInt(next());
+    columns.frequency = readInt(next());
+    columns.type = readInt(next());
+    columns.status = readInt(next());
+    auto orderParameters = next();
+    if (!orderParameters.isNull()) {
+        columns.orderParametersRaw = valueToString(orderParameters);
+    }
+    columns.actualEarnings = readDouble(next());
+    columns.estimatedEarnings = readDouble(next());
+    columns.extension = nextJson("extension");
+    model::writeRequestJson(writer, columns);
+}
+
+void writeSummaryRow(util::JsonWriter& writer, const mysqlx::Row& row, const std::vector<bool>& json) {
+    std::size_t index = 0;
+    auto next = [&row, &index]() -> mysqlx::Value { return row[index++]; };
+    auto nextJson = [&](std::string_view column) {
+        const bool trusted = isJsonColumn(json, index);
+        return jsonColumnField(next(), column, trusted);
+    };
+    auto readInt = [](const mysqlx::Value& value) { return value.isNull() ? 0 : value.get<int>(); };
+
+    model::RequestColumns columns;
+    columns.id = readInt(next());
+    columns.buyerId = readInt(next());
+    columns.userInfo = nextJson("user_info");
+    columns.type = readInt(next());
+    columns.status = readInt(next());
+    columns.startTime = readString(next());
+    columns.endTime = readString(next());
+    columns.actualEarnings = readDouble(next());
+    columns.estimatedEarnings = readDouble(next());
+    model::writeRequestSummaryJson(writer, columns);
+}
+
+ListCursor cursorFromRow(const mysqlx::Row& row, std::string_view orderColumn, bool summary) {
+    ListCursor cursor;
+    cursor.id = row[0].get<int>();
+    if (orderColumn == "start_time" || orderColumn == "end_time") {
+        std::size_t position = summary ? 5 : 12;
+        if (orderColumn == "end_time") {
+            ++position;
+        }
+        const auto& value = row[position];
+        if (!value.isNull()) {
+            cursor.value = readString(value);
+        }
+    }
+    return cursor;
 }
 } // namespace
 
 RequestsRepository::RequestsRepository(MySqlConnectionPool& pool)
-    : pool_(pool) {}
+    : pool_(pool), keywordIndex_("requests") {}
 
-model::Request RequestsRepository::mapRow(mysqlx::Row row) {
+model::Request RequestsRepository::mapRow(mysqlx::Row row, const std::vector<bool>& json) {
     std::size_t index = 0;
     auto next = [&row, &index]() -> mysqlx::Value { return row[index++]; };
+    // 在 next() 之后调用，index 已指向下一列
+    auto trusted = [&json, &index]() { return isJsonColumn(json, index - 1); };
 
     model::Request request{};
     request.id = next().get<int>();
@@ -192,11 +309,11 @@ model::Request RequestsRepository::mapRow(mysqlx::Row row) {
     value = next();
     request.cookies = readString(value);
     value = next();
-    request.orderInfo = parseJsonColumn(value, "order_info");
+    request.orderInfo = readJsonColumn(value, "order_info", trusted());
     value = next();
-    request.userInfo = parseJsonColumn(value, "user_info");
+    request.userInfo = readJsonColumn(value, "user_info", trusted());
     value = next();
-    request.orderTemplate = parseJsonColumn(value, "order_template");
+    request.orderTemplate = readJsonColumn(value, "order_template", trusted());
     value = next();
     request.message = readString(value);
     value = next();
@@ -218,13 +335,13 @@ model::Request RequestsRepository::mapRow(mysqlx::Row row) {
     } else {
         request.orderParametersRaw.clear();
     }
-    request.orderParameters = parseJsonColumn(value, "order_parameters");
+    request.orderParameters = readJsonColumn(value, "order_parameters", trusted());
     value = next();
     request.actualEarnings = readDouble(value);
     value = next();
     request.estimatedEarnings = readDouble(value);
     value = next();
-    request.extension = parseJsonColumn(value, "extension");
+    request.extension = readJsonColumn(value, "extension", trusted());
     return request;
 }
 
@@ -232,16 +349,13 @@ std::vector<model::Request> RequestsRepository::findPending(int limit) {
     std::vector<model::Request> requests;
     auto session = pool_.acquire();
     try {
-        mysqlx::Schema schema = session->getSchema(pool_.schemaName());
-        mysqlx::Table table = schema.getTable("requests");
-
-        mysqlx::TableSelect select = table
-            .select("id", "device_id", "buyer_id", "thread_id", "link", "cookies", "order_info", "user_info",
-                    "order_template", "message", "id_number", "keyword", "DATE_FORMAT(start_time, '%Y-%m-%d %H:%i:%s') AS start_time", "DATE_FORMAT(end_time,   '%Y-%m-%d %H:%i:%s') AS end_time", "quantity",
-                    "delay", "frequency", "type", "status", "order_parameters", "actual_earnings",
-                    "estimated_earnings", "extension")
-            .where("status = :status")
-            .orderBy("start_time ASC");
+        auto& select = session.statements().get<mysqlx::TableSelect>(
+            limit > 0 ? "requests.findPending.limit" : "requests.findPending",
+            [](StatementCache& cache) -> mysqlx::TableSelect {
+                return selectRequestColumns(cache.table("requests"))
+                    .where("status = :status")
+                    .orderBy("start_time ASC");
+            });
 
         if (limit > 0) {
             select.limit(static_cast<std::size_t>(limit));
@@ -249,8 +363,9 @@ std::vector<model::Request> RequestsRepository::findPending(int limit) {
 
         mysqlx::RowResult rows = select.bind("status", 0).execute();
 
+        const auto json = jsonColumnTypes(rows);
         for (mysqlx::Row row : rows) {
-            requests.emplace_back(mapRow(row));
+            requests.emplace_back(mapRow(row, json));
         }
     } catch (const mysqlx::Error& err) {
         util::log(util::LogLevel::error, std::string{"Query pending requests failed: "} + err.what());
@@ -262,14 +377,15 @@ std::vector<model::Request> RequestsRepository::findPending(int limit) {
 void RequestsRepository::updateStatus(int requestId, int status) {
     auto session = pool_.acquire();
     try {
-        mysqlx::Schema schema = session->getSchema(pool_.schemaName());
-        mysqlx::Table table = schema.getTable("requests");
-        table.update()
-            .set("status", status)
-            //.set("updated_at", formatTimestamp(std::chrono::system_clock::now()))
-            .where("id = :id")
-            .bind("id", requestId)
-            .execute();
+        auto& update = session.statements().get<mysqlx::TableUpdate>(
+            "requests.updateStatus", [](StatementCache& cache) -> mysqlx::TableUpdate {
+                return cache.table("requests")
+                    .update()
+                    .set("status", mysqlx::expr(":status"))
+                    .where("id = :id");
+            });
+        update.bind("status", status).bind("id", requestId).execute();
+        bumpVersion();
     } catch (const mysqlx::Error& err) {
         util::log(util::LogLevel::error, std::string{"Update request status failed: "} + err.what());
         throw;
@@ -279,14 +395,15 @@ void RequestsRepository::updateStatus(int requestId, int status) {
 void RequestsRepository::updateThreadId(int requestId, const std::string& threadId) {
     auto session = pool_.acquire();
     try {
-        mysqlx::Schema schema = session->getSchema(pool_.schemaName());
-        mysqlx::Table table = schema.getTable("requests");
-        table.update()
-            .set("thread_id", threadId)
-            //.set("updated_at", formatTimestamp(std::chrono::system_clock::now()))
-            .where("id = :id")
-            .bind("id", requestId)
-            .execute();
+        auto& update = session.statements().get<mysqlx::TableUpdate>(
+            "requests.updateThreadId", [](StatementCache& cache) -> mysqlx::TableUpdate {
+                return cache.table("requests")
+                    .update()
+                    .set("thread_id", mysqlx::expr(":threadId"))
+                    .where("id = :id");
+            });
+        update.bind("threadId", threadId).bind("id", requestId).execute();
+        bumpVersion();
     } catch (const mysqlx::Error& err) {
         util::log(util::LogLevel::error, std::string{"Update request thread failed: "} + err.what());
         throw;
@@ -296,12 +413,12 @@ void RequestsRepository::updateThreadId(int requestId, const std::string& thread
 void RequestsRepository::deleteById(int requestId) {
     auto session = pool_.acquire();
     try {
-        mysqlx::Schema schema = session->getSchema(pool_.schemaName());
-        mysqlx::Table table = schema.getTable("requests");
-        table.remove()
-            .where("id = :id")
-            .bind("id", requestId)
-            .execute();
+        auto& remove = session.statements().get<mysqlx::TableRemove>(
+            "requests.deleteById", [](StatementCache& cache) -> mysqlx::TableRemove {
+                return cache.table("requests").remove().where("id = :id");
+            });
+        remove.bind("id", requestId).execute();
+        bumpVersion();
     } catch (const mysqlx::Error& err) {
         util::log(util::LogLevel::error, std::string{"Delete request failed: "} + err.what());
         throw;
@@ -319,58 +436,126 @@ std::vector<model::Request> RequestsRepository::findByFilters(const std::optiona
     std::vector<model::Request> requests;
     auto session = pool_.acquire();
     try {
-        std::ostringstream sql;
-        sql << "SELECT id, device_id, buyer_id, thread_id, link, cookies, order_info, user_info, order_template, message, "
-               "id_number, keyword, DATE_FORMAT(start_time, '%Y-%m-%d %H:%i:%s') AS start_time, DATE_FORMAT(end_time,   '%Y-%m-%d %H:%i:%s') AS end_time, quantity, delay, frequency, type, status, order_parameters, "
-               "actual_earnings, estimated_earnings, extension FROM requests WHERE 1=1";
-
-        std::vector<mysqlx::Value> params;
-        if (keyword && !keyword->empty()) {
-            sql << " AND user_info LIKE ?";
-            params.emplace_back("%" + *keyword + "%");
-        }
-        if (buyerId) {
-            sql << " AND buyer_id = ?";
-            params.emplace_back(*buyerId);
-        }
-        if (type) {
-            sql << " AND type = ?";
-            params.emplace_back(*type);
+        ListFilter filter{keyword, buyerId, type, status, keywordIndex_.available(*session, pool_.schemaName())};
+        auto rows = executeFilterQuery(*session, filter, orderColumn, orderDirection, offset, limit);
+        const auto json = jsonColumnTypes(rows);
+        for (mysqlx::Row row : rows) {
+            requests.emplace_back(mapRow(row, json));
         }
-        if (status) {
-            sql << " AND status = ?";
-            params.emplace_back(*status);
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{"按条件查询抢购请求失败: "} + err.what());
+        throw;
+    }
+    return requests;
+}
+
+std::size_t RequestsRepository::writeByFilters(const std::optional<std::string>& keyword,
+                                               const std::optional<int>& buyerId,
+                                               const std::optional<int>& type,
+                                               const std::optional<int>& status,
+                                               std::string_view orderColumn,
+                                               std::string_view orderDirection,
+                                               int offset,
+                                               int limit,
+                                               util::JsonWriter& writer) {
+    std::size_t count = 0;
+    auto session = pool_.acquire();
+    try {
+        ListFilter filter{keyword, buyerId, type, status, keywordIndex_.available(*session, pool_.schemaName())};
+        auto rows = executeFilterQuery(*session, filter, orderColumn, orderDirection, offset, limit);
+        writer.beginArray();
+        const auto json = jsonColumnTypes(rows);
+        for (mysqlx::Row row : rows) {
+            writeRow(writer, row, json);
+            ++count;
         }
+        writer.endArray();
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{"按条件输出抢购请求失败: "} + err.what());
+        throw;
+    }
+    return count;
+}
 
-        sql << " ORDER BY " << orderColumn << ' ' << orderDirection;
-        sql << buildLimitOffsetClause(limit, offset);
+ListPageResult RequestsRepository::writePage(const ListPageRequest& page, util::JsonWriter& writer) {
+    ListPageResult outcome;
+    auto session = pool_.acquire();
+    try {
+        std::ostringstream sql;
+        std::vector<mysqlx::Value> params;
+        sql << "SELECT " << (page.summary ? kSummaryColumns : kListColumns) << " FROM requests WHERE 1=1";
+        auto filter = page.filter;
+        filter.keywordIndexed = keywordIndex_.available(*session, pool_.schemaName());
+        appendFilterConditions(sql, params, filter);
+        if (page.after) {
+            appendKeysetCondition(sql, params, page.orderColumn, page.orderDirection, *page.after);
+        }
+        sql << buildKeysetOrderClause(page.orderColumn, page.orderDirection, page.limit);
 
         auto stmt = session->sql(sql.str());
         for (const auto& param : params) {
             stmt.bind(param);
         }
-
         auto rows = stmt.execute();
+        writer.beginArray();
+        const auto json = jsonColumnTypes(rows);
         for (mysqlx::Row row : rows) {
-            requests.emplace_back(mapRow(row));
+            if (page.summary) {
+                writeSummaryRow(writer, row, json);
+            } else {
+                writeRow(writer, row, json);
+            }
+            outcome.next = cursorFromRow(row, page.orderColumn, page.summary);
+            ++outcome.count;
+        }
+        writer.endArray();
+        // 不足一页说明已经到底
+        if (outcome.count < static_cast<std::size_t>(std::max(0, page.limit))) {
+            outcome.next.reset();
         }
     } catch (const mysqlx::Error& err) {
-        util::log(util::LogLevel::error, std::string{"按条件查询抢购请求失败: "} + err.what());
+        util::log(util::LogLevel::error, std::string{"分页查询抢购请求失败: "} + err.what());
+        throw;
+    }
+    return outcome;
+}
+
+std::optional<TotalCount> RequestsRepository::countByFilters(const ListFilter& filter) {
+    auto session = pool_.acquire();
+    auto indexed = filter;
+    indexed.keywordIndexed = keywordIndex_.available(*session, pool_.schemaName());
+    return countRows(*session, pool_.schemaName(), "requests", indexed);
+}
+
+std::optional<model::Request> RequestsRepository::findById(int requestId) {
+    auto session = pool_.acquire();
+    try {
+        auto& select = session.statements().get<mysqlx::TableSelect>(
+            "requests.findById", [](StatementCache& cache) -> mysqlx::TableSelect {
+                return selectRequestColumns(cache.table("requests")).where("id = :id");
+            });
+        mysqlx::RowResult rows = select.bind("id", requestId).execute();
+        const auto json = jsonColumnTypes(rows);
+        for (mysqlx::Row row : rows) {
+            return mapRow(row, json);
+        }
+        return std::nullopt;
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{"Find request failed: "} + err.what());
         throw;
     }
-    return requests;
 }
 
 int RequestsRepository::insert(const model::Request& request) {
     auto session = pool_.acquire();
     try {
-        mysqlx::Schema schema = session->getSchema(pool_.schemaName());
-        mysqlx::Table table = schema.getTable("requests");
+        // 插入的值不是占位符，X DevAPI 不会为其预处理，这里只复用表句柄
+        mysqlx::Table& table = session.statements().table("requests");
         mysqlx::Value orderParamValue = makeNullValue();
         if (!request.orderParametersRaw.empty()) {
             orderParamValue = mysqlx::Value(request.orderParametersRaw);
         } else if (request.orderParameters.is_object() || request.orderParameters.is_array()) {
-            orderParamValue = mysqlx::Value(quickgrab::util::stringifyJson(request.orderParameters));
+            orderParamValue = jsonOrNull(request.orderParameters);
         }
 
         auto result = table
@@ -424,6 +609,7 @@ int RequestsRepository::insert(const model::Request& request) {
             )
             .execute();
 
+        bumpVersion();
         return static_cast<int>(result.getAutoIncrementValue());
     } catch (const mysqlx::Error& err) {
         util::log(util::LogLevel::error, std::string{"Insert request failed: "} + err.what());
@@ -1,6 +1,10 @@
 #include "quickgrab/repository/ResultsRepository.hpp"
+#include "quickgrab/model/RowJson.hpp"
+#include "quickgrab/repository/Pagination.hpp"
 #include "quickgrab/repository/SqlUtils.hpp"
 #include "quickgrab/util/JsonUtil.hpp"
+#include "quickgrab/util/JsonWriter.hpp"
+#include "quickgrab/util/DateTime.hpp"
 #include "quickgrab/util/Logging.hpp"
 
 #include <mysqlx/common/value.h>
@@ -9,14 +13,12 @@
 #include <algorithm>
 #include <chrono>
 #include <exception>
-#include <iomanip>
 #include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
-#include <ctime>
 #include <unordered_map>
 
 namespace quickgrab::repository {
@@ -39,51 +41,24 @@ std::string valueToString(const mysqlx::Value& value) {
     }
 }
 
-std::string sanitizeDateTimeString(std::string text) {
-    if (text.empty()) {
-        return text;
-    }
-    if (text.front() == '\'' && text.back() == '\'' && text.size() > 1) {
-        text = text.substr(1, text.size() - 2);
-    }
-    if (text.front() == '"' && text.back() == '"' && text.size() > 1) {
-        text = text.substr(1, text.size() - 2);
-    }
-    std::replace(text.begin(), text.end(), 'T', ' ');
-    auto dotPos = text.find('.');
-    if (dotPos != std::string::npos) {
-        text = text.substr(0, dotPos);
-    }
-    return text;
-}
-
-std::string formatTimestamp(std::chrono::system_clock::time_point tp) {
-    auto tt = std::chrono::system_clock::to_time_t(tp);
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &tt);
-#else
-    localtime_r(&tt, &tm);
-#endif
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
-}
-
 mysqlx::Value makeNullValue() { return mysqlx::Value(); }
 
 mysqlx::Value toTimestampValue(const std::chrono::system_clock::time_point& tp) {
     if (tp.time_since_epoch().count() == 0) {
         return makeNullValue();
     }
-    return mysqlx::Value(formatTimestamp(tp));
+    return mysqlx::Value(util::formatDateTime(tp));
 }
 
-mysqlx::Value jsonOrNull(const boost::json::value& value) {
+// 未修改过的合法原文直接写回，省去解析再序列化的往返
+mysqlx::Value jsonOrNull(const model::JsonColumn& value) {
+    if (const auto* raw = value.raw()) {
+        return mysqlx::Value(*raw);
+    }
     if (value.is_null()) {
         return makeNullValue();
     }
-    return mysqlx::Value(quickgrab::util::stringifyJson(value));
+    return mysqlx::Value(quickgrab::util::stringifyJson(value.get()));
 }
 
 std::string readString(const mysqlx::Value& value) {
@@ -141,21 +116,12 @@ double readDouble(const mysqlx::Value& value) {
     }
 }
 
-boost::json::value parseJsonColumn(const mysqlx::Value& value, const std::string& column) {
+// 只保存原文，字段第一次被读取时才解析；空值或非法内容按 null 处理
+model::JsonColumn readJsonColumn(const mysqlx::Value& value, std::string_view column, bool trusted) {
     if (value.isNull()) {
         return boost::json::value();
     }
-    try {
-        return quickgrab::util::parseJson(valueToString(value));
-    } catch (const std::exception& ex) {
-        util::log(util::LogLevel::warn, "JSON parse failed on column " + column + ": " + ex.what());
-        return boost::json::value();
-    }
-}
-
-std::chrono::system_clock::time_point fromTm(const std::tm& tm) {
-    auto localTm = tm;
-    return std::chrono::system_clock::from_time_t(std::mktime(&localTm));
+    return model::JsonColumn::fromRaw(valueToString(value), boost::json::value(), column, trusted);
 }
 
 std::chrono::system_clock::time_point parseDateTimeValue(
@@ -165,18 +131,15 @@ std::chrono::system_clock::time_point parseDateTimeValue(
         return fallback;
     }
     try {
-        auto text = sanitizeDateTimeString(valueToString(value));
+        auto text = valueToString(value);
         if (text.empty()) {
             return fallback;
         }
-        std::tm tm{};
-        std::istringstream iss(text);
-        iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-        if (iss.fail()) {
-            util::log(util::LogLevel::warn, "Failed to parse datetime text value");
-            return fallback;
+        if (auto parsed = util::parseDateTime(text)) {
+            return *parsed;
         }
-        return fromTm(tm);
+        util::log(util::LogLevel::warn, "Failed to parse datetime text value");
+        return fallback;
     } catch (const std::exception& ex) {
         util::log(util::LogLevel::warn, std::string{"Failed to parse datetime column: "} + ex.what());
         return fallback;
@@ -204,16 +167,22 @@ int readInt(const mysqlx::Value& value, const std::string& column, int defaultVa
     }
 }
 
-using ColumnIndex = std::unordered_map<std::string, std::size_t>;
+// 列名到位置的映射；json 按位置标记 MySQL JSON 类型列（sql/004_json_columns.sql 迁移后），其原文可直接透传
+struct ColumnIndex {
+    std::unordered_map<std::string, std::size_t> positions;
+    std::vector<bool> json;
+};
 
 ColumnIndex buildColumnIndex(const mysqlx::RowResult& rows) {
     ColumnIndex index;
     try {
         const mysqlx::col_count_t n = rows.getColumnCount(); 
+        index.json.resize(n);
         for (mysqlx::col_count_t pos = 0; pos < n; ++pos) {
             const auto& column = rows.getColumn(pos);        
 
             try {
+                index.json[pos] = column.getType() == mysqlx::Type::JSON;
                 std::string name;
                 try { name = column.getColumnLabel(); }       
                 catch (...) { name.clear(); }
@@ -224,7 +193,7 @@ ColumnIndex buildColumnIndex(const mysqlx::RowResult& rows) {
                 }
 
                 if (!name.empty()) {
-                    index.emplace(std::move(name),
+                    index.positions.emplace(std::move(name),
                         static_cast<std::size_t>(pos));
                 }
             }
@@ -243,25 +212,20 @@ ColumnIndex buildColumnIndex(const mysqlx::RowResult& rows) {
 
 
 const mysqlx::Value* findValue(const mysqlx::Row& row, const ColumnIndex& index, std::string_view column) {
-    auto it = index.find(std::string(column));
-    if (it == index.end()) {
+    auto it = index.positions.find(std::string(column));
+    if (it == index.positions.end()) {
         return nullptr;
     }
     return &row[it->second];
 }
+
+bool isJsonColumn(const ColumnIndex& index, std::string_view column) {
+    auto it = index.positions.find(std::string(column));
+    return it != index.positions.end() && it->second < index.json.size() && index.json[it->second];
+}
  
 std::chrono::system_clock::time_point parseTimestamp(const std::string& value) {
-    if (value.empty()) {
-        return std::chrono::system_clock::now();
-    }
-    std::tm tm{};
-    std::istringstream iss(sanitizeDateTimeString(value));
-    iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-    if (iss.fail()) {
-        return std::chrono::system_clock::now();
-    }
-    auto localTm = tm;
-    return std::chrono::system_clock::from_time_t(std::mktime(&localTm));
+    return util::parseDateTime(value).value_or(std::chrono::system_clock::now());
 }
 
 model::Result mapDetailedRow(const mysqlx::Row& row, const ColumnIndex& index) {
@@ -292,13 +256,13 @@ model::Result mapDetailedRow(const mysqlx::Row& row, const ColumnIndex& index) {
         result.cookies = readString(*value);
     }
     if (const auto* value = findValue(row, index, "order_info")) {
-        result.orderInfo = parseJsonColumn(*value, "order_info");
+        result.orderInfo = readJsonColumn(*value, "order_info", isJsonColumn(index, "order_info"));
     }
     if (const auto* value = findValue(row, index, "user_info")) {
-        result.userInfo = parseJsonColumn(*value, "user_info");
+        result.userInfo = readJsonColumn(*value, "user_info", isJsonColumn(index, "user_info"));
     }
     if (const auto* value = findValue(row, index, "order_template")) {
-        result.orderTemplate = parseJsonColumn(*value, "order_template");
+        result.orderTemplate = readJsonColumn(*value, "order_template", isJsonColumn(index, "order_template"));
     }
     if (const auto* value = findValue(row, index, "message")) {
         result.message = readString(*value);
@@ -331,7 +295,7 @@ model::Result mapDetailedRow(const mysqlx::Row& row, const ColumnIndex& index) {
         result.status = readInt(*value, "status");
     }
     if (const auto* value = findValue(row, index, "response_message")) {
-        result.responseMessage = parseJsonColumn(*value, "response_message");
+        result.responseMessage = readJsonColumn(*value, "response_message", isJsonColumn(index, "response_message"));
         if (result.payload.is_null()) {
             result.payload = result.responseMessage;
         }
@@ -343,12 +307,12 @@ model::Result mapDetailedRow(const mysqlx::Row& row, const ColumnIndex& index) {
         result.estimatedEarnings = readDouble(*value);
     }
     if (const auto* value = findValue(row, index, "extension")) {
-        result.extension = parseJsonColumn(*value, "extension");
+        result.extension = readJsonColumn(*value, "extension", isJsonColumn(index, "extension"));
     }
     if (const auto* value = findValue(row, index, "payload")) {
-        auto payload = parseJsonColumn(*value, "payload");
-        if (!payload.is_null()) {
-            result.payload = std::move(payload);
+        // 只按 SQL NULL 判断是否回退到 response_message，避免为此提前解析 payload
+        if (!value->isNull()) {
+            result.payload = readJsonColumn(*value, "payload", isJsonColumn(index, "payload"));
         }
     }
     if (const auto* value = findValue(row, index, "created_at")) {
@@ -361,19 +325,253 @@ model::Result mapDetailedRow(const mysqlx::Row& row, const ColumnIndex& index) {
     return result;
 }
 
+constexpr const char* kListColumns =
+    "id, request_id, device_id, buyer_id, thread_id, link, cookies, order_info, user_info, order_template, "
+    "message, id_number, keyword, "
+    "DATE_FORMAT(start_time, '%Y-%m-%d %H:%i:%s') AS start_time, "
+    "DATE_FORMAT(end_time,   '%Y-%m-%d %H:%i:%s') AS end_time, "
+    "quantity, delay, frequency, type, status, response_message, "
+    "actual_earnings, estimated_earnings, extension";
+
+// 列表卡片只展示昵称/电话/状态/类型/时间，不读取 cookies、response_message 等大字段
+constexpr const char* kSummaryColumns =
+    "id, request_id, buyer_id, user_info, type, status, "
+    "DATE_FORMAT(start_time, '%Y-%m-%d %H:%i:%s') AS start_time, "
+    "DATE_FORMAT(end_time,   '%Y-%m-%d %H:%i:%s') AS end_time, "
+    "actual_earnings, estimated_earnings";
+
+mysqlx::RowResult executeFilterQuery(mysqlx::Session& session,
+                                     const ListFilter& filter,
+                                     std::string_view orderColumn,
+                                     std::string_view orderDirection,
+                                     int offset,
+                                     int limit) {
+    std::ostringstream sql;
+    sql << "SELECT " << kListColumns << " FROM results WHERE 1=1";
+
+    std::vector<mysqlx::Value> params;
+    appendFilterConditions(sql, params, filter);
+    sql << " ORDER BY " << orderColumn << ' ' << orderDirection;
+    sql << buildLimitOffsetClause(limit, offset);
+
+    auto stmt = session.sql(sql.str());
+    for (const auto& param : params) {
+        stmt.bind(param);
+    }
+    return stmt.execute();
+}
+
+// JSON 列交给编码器原样写出，JSON 类型列直接信任，TEXT 列先校验；
+// 缺列、空值或非法内容留空，由编码器与 mapDetailedRow 一致按 null 输出
+model::JsonField jsonColumnField(const mysqlx::Row& row, const ColumnIndex& index, std::string_view column) {
+    model::JsonField field;
+    const auto* value = findValue(row, index, column);
+    if (!value || value->isNull()) {
+        return field;
+    }
+    auto text = valueToString(*value);
+    if (!isJsonColumn(index, column) && !util::isValidJson(text)) {
+        util::log(util::LogLevel::warn, "JSON parse failed on column " + std::string(column));
+        return field;
+    }
+    field.text = std::move(text);
+    return field;
+}
+
+int intColumn(const mysqlx::Row& row, const ColumnIndex& index, std::string_view column) {
+    const auto* value = findValue(row, index, column);
+    return value ? readInt(*value, std::string(column)) : 0;
+}
+
+std::string stringColumn(const mysqlx::Row& row, const ColumnIndex& index, std::string_view column) {
+    const auto* value = findValue(row, index, column);
+    return value ? readString(*value) : std::string{};
+}
+
+double doubleColumn(const mysqlx::Row& row, const ColumnIndex& index, std::string_view column) {
+    const auto* value = findValue(row, index, column);
+    return value ? readDouble(*value) : 0.0;
+}
+
+// 列表接口的逐行编码：读出列视图交给 model::writeResultJson，时间列已由 SQL 端 DATE_FORMAT 格式化，直接透传
+void writeListRow(util::JsonWriter& writer, const mysqlx::Row& row, const ColumnIndex& index) {
+    model::ResultColumns columns;
+    columns.id = intColumn(row, index, "id");
+    columns.requestId = intColumn(row, index, "request_id");
+    columns.deviceId = intColumn(row, index, "device_id");
+    columns.buyerId = intColumn(row, index, "buyer_id");
+    columns.threadId = stringColumn(row, index, "thread_id");
+    columns.link = stringColumn(row, index, "link");
+    columns.cookies = stringColumn(row, index, "cookies");
+    columns.orderInfo = jsonColumnField(row, index, "order_info");
+    columns.userInfo = jsonColumnField(row, index, "user_info");
+    columns.orderTemplate = jsonColumnField(row, index, "order_template");
+    columns.message = stringColumn(row, index, "message");
+    columns.idNumber = stringColumn(row, index, "id_number");
+    columns.keyword = stringColumn(row, index, "keyword");
+    columns.startTime = stringColumn(row, index, "start_time");
+    columns.endTime = stringColumn(row, index, "end_time");
+    columns.quantity = intColumn(row, index, "quantity");
+    columns.delay = intColumn(row, index, "delay");
+    columns.frequency = intColumn(row, index, "frequency");
+    columns.type = intColumn(row, index, "type");
+    columns.status = intColumn(row, index, "status");
+    columns.responseMessage = jsonColumnField(row, index, "response_message");
+    columns.actualEarnings = doubleColumn(row, index, "actual_earnings");
+    columns.estimatedEarnings = doubleColumn(row, index, "estimated_earnings");
+    columns.extension = jsonColumnField(row, index, "extension");
+    // 列表查询不含 payload/created_at 列，沿用 mapDetailedRow 的回退：payload 取 response_message
+    columns.payload = columns.responseMessage;
+    model::writeResultJson(writer, columns);
+}
+
+void writeSummaryRow(util::JsonWriter& writer, const mysqlx::Row& row, const ColumnIndex& index) {
+    model::ResultColumns columns;
+    columns.id = intColumn(row, index, "id");
+    columns.requestId = intColumn(row, index, "request_id");
+    columns.buyerId = intColumn(row, index, "buyer_id");
+    columns.userInfo = jsonColumnField(row, index, "user_info");
+    columns.type = intColumn(row, index, "type");
+    columns.status = intColumn(row, index, "status");
+    columns.startTime = stringColumn(row, index, "start_time");
+    columns.endTime = stringColumn(row, index, "end_time");
+    columns.actualEarnings = doubleColumn(row, index, "actual_earnings");
+    columns.estimatedEarnings = doubleColumn(row, index, "estimated_earnings");
+    model::writeResultSummaryJson(writer, columns);
+}
+
+ListCursor cursorFromRow(const mysqlx::Row& row, const ColumnIndex& index, std::string_view orderColumn) {
+    ListCursor cursor;
+    if (const auto* id = findValue(row, index, "id")) {
+        cursor.id = readInt(*id, "id");
+    }
+    if (orderColumn != "id") {
+        if (const auto* value = findValue(row, index, orderColumn); value && !value->isNull()) {
+            cursor.value = readString(*value);
+        }
+    }
+    return cursor;
+}
+
+// start_time 为 NULL 的结果记入的占位桶，带时间条件的统计需排除
+constexpr const char* kNullBucket = "'1000-01-01 00:00:00'";
+// 时间窗口内被整点桶完整覆盖的区间为 [第一个整点桶, 覆盖终点)，两端剩余部分回表补齐
+constexpr const char* kFirstFullBucket = "DATE_FORMAT(CAST(? AS DATETIME) + INTERVAL 3599 SECOND, '%Y-%m-%d %H:00:00')";
+constexpr const char* kCoveredEnd = "DATE_FORMAT(CAST(? AS DATETIME) + INTERVAL 1 SECOND, '%Y-%m-%d %H:00:00')";
+constexpr const char* kLastDayFirstFullBucket =
+    "DATE_FORMAT(NOW() - INTERVAL 1 DAY + INTERVAL 3599 SECOND, '%Y-%m-%d %H:00:00')";
+
+// 一行结果计入汇总表的维度与金额；startTime 可以是原始时间或已截断的小时桶，写入时统一按小时截断
+struct RollupEntry {
+    mysqlx::Value buyerId;
+    mysqlx::Value type;
+    mysqlx::Value status;
+    mysqlx::Value startTime;
+    mysqlx::Value earnings;
+};
+
+// 按给定的值更新小时桶，不回读 results，避免在结果行上再加锁；sign 为 1 表示新增，-1 表示删除
+void applyRollupDelta(mysqlx::Session& session, const RollupEntry& entry, int sign) {
+    session.sql("INSERT INTO result_rollups (buyer_id, type, status, bucket_start, total_count, earnings) "
+                "VALUES (?, IFNULL(?, -1), IFNULL(?, -1), "
+                "IFNULL(DATE_FORMAT(?, '%Y-%m-%d %H:00:00'), '1000-01-01 00:00:00'), ?, ? * IFNULL(?, 0)) "
+                "ON DUPLICATE KEY UPDATE total_count = total_count + VALUES(total_count), "
+                "earnings = earnings + VALUES(earnings)")
+        .bind(entry.buyerId)
+        .bind(entry.type)
+        .bind(entry.status)
+        .bind(entry.startTime)
+        .bind(sign)
+        .bind(sign)
+        .bind(entry.earnings)
+        .execute();
+}
+
+// 锁定并读出待删除行的汇总维度；行已不存在（如被并发删除）时返回空。
+// 并发删除同一行时后到者在此等待先到者提交，随后读到行已不存在，不会重复扣减
+std::optional<RollupEntry> lockRollupEntry(mysqlx::Session& session, int resultId) {
+    auto rows = session
+                    .sql("SELECT buyer_id, type, status, DATE_FORMAT(start_time, '%Y-%m-%d %H:00:00'), "
+                         "CAST(actual_earnings AS CHAR) FROM results WHERE id = ? FOR UPDATE")
+                    .bind(resultId)
+                    .execute();
+    mysqlx::Row row = rows.fetchOne();
+    if (!row) {
+        return std::nullopt;
+    }
+    return RollupEntry{row[0], row[1], row[2], row[3], row[4]};
+}
+
+// 全量重建汇总表。results 加读锁、result_rollups 加写锁后再 DELETE + INSERT … SELECT：
+// 重建期间其他连接（含其他服务实例）的 insertResult/deleteById 在 results 上等待，
+// 加锁前已开始的写事务会先提交，其增量要么已计入 results 的快照、要么在重建之后才写入，不会丢失或重复。
+// LOCK TABLES 会隐式提交当前事务，START TRANSACTION 又会释放表锁，因此按 MySQL 文档关闭 autocommit 后加锁
+void backfillRollups(mysqlx::Session& session) {
+    session.sql("SET autocommit = 0").execute();
+    try {
+        session.sql("LOCK TABLES result_rollups WRITE, results READ").execute();
+        session.sql("DELETE FROM result_rollups").execute();
+        session.sql("INSERT INTO result_rollups (buyer_id, type, status, bucket_start, total_count, earnings) "
+                    "SELECT buyer_id, IFNULL(type, -1), IFNULL(status, -1), "
+                    "IFNULL(DATE_FORMAT(start_time, '%Y-%m-%d %H:00:00'), '1000-01-01 00:00:00') AS bucket_start, "
+                    "COUNT(*), IFNULL(SUM(actual_earnings), 0) FROM results "
+                    "GROUP BY buyer_id, IFNULL(type, -1), IFNULL(status, -1), bucket_start")
+            .execute();
+        session.sql("COMMIT").execute();
+        session.sql("UNLOCK TABLES").execute();
+        session.sql("SET autocommit = 1").execute();
+    } catch (const mysqlx::Error&) {
+        // 会话归还连接池前恢复原状态；恢复失败时租约在异常中析构，会话被标记为可疑
+        try {
+            session.sql("ROLLBACK").execute();
+            session.sql("UNLOCK TABLES").execute();
+            session.sql("SET autocommit = 1").execute();
+        } catch (const mysqlx::Error& err) {
+            util::log(util::LogLevel::warn, std::string{"重建统计汇总后恢复会话失败: "} + err.what());
+        }
+        throw;
+    }
+}
+
+void rollbackQuietly(mysqlx::Session& session) {
+    try {
+        session.rollback();
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::warn, std::string{"回滚结果写入失败: "} + err.what());
+    }
+}
+
+ResultsRepository::AggregatedStats readAggregatedRow(const mysqlx::Row& row) {
+    ResultsRepository::AggregatedStats entry{};
+    entry.type = readString(row[0]);
+    entry.successCount = asInt64(row[1], "successCount");
+    entry.failureCount = asInt64(row[2], "failureCount");
+    entry.exceptionCount = asInt64(row[3], "exceptionCount");
+    entry.totalCount = asInt64(row[4], "totalCount");
+    entry.successEarnings = readDouble(row[5]);
+    entry.failureEarnings = readDouble(row[6]);
+    entry.exceptionEarnings = readDouble(row[7]);
+    entry.totalEarnings = readDouble(row[8]);
+    return entry;
+}
+
 } // namespace
 
 ResultsRepository::ResultsRepository(MySqlConnectionPool& pool)
-    : pool_(pool) {}
+    : pool_(pool), keywordIndex_("results") {}
 
-void ResultsRepository::insertResult(const model::Result& result) {
+int ResultsRepository::insertResult(const model::Result& result) {
 
     auto session = pool_.acquire();
+    const bool rollups = rollupsEnabled_.load(std::memory_order_acquire);
     try {
-        mysqlx::Schema schema = session->getSchema(pool_.schemaName());
-        mysqlx::Table table = schema.getTable("results");
+        if (rollups) {
+            session->startTransaction();
+        }
+        // 插入的值不是占位符，X DevAPI 不会为其预处理，这里只复用表句柄
+        mysqlx::Table& table = session.statements().table("results");
         auto responsePayload = result.responseMessage.is_null() ? result.payload : result.responseMessage;
-        table.insert(
+        auto inserted = table.insert(
             //"request_id",
                     "device_id",
                     "buyer_id",
@@ -425,7 +623,20 @@ void ResultsRepository::insertResult(const model::Result& result) {
                     //toTimestampValue(result.createdAt)
             )
             .execute();
+        auto resultId = static_cast<int>(inserted.getAutoIncrementValue());
+        if (rollups) {
+            applyRollupDelta(*session,
+                             RollupEntry{result.buyerId, result.type, result.status, toTimestampValue(result.startTime),
+                                         result.actualEarnings},
+                             1);
+            session->commit();
+        }
+        bumpVersion();
+        return resultId;
     } catch (const mysqlx::Error& err) {
+        if (rollups) {
+            rollbackQuietly(*session);
+        }
         util::log(util::LogLevel::error, std::string{"Insert result failed: "} + err.what());
         throw;
     }
@@ -434,11 +645,16 @@ void ResultsRepository::insertResult(const model::Result& result) {
 std::optional<model::Result> ResultsRepository::findById(int resultId) {
     auto session = pool_.acquire();
     try {
-        std::ostringstream sql;
-        sql << "SELECT id, request_id, device_id, buyer_id, thread_id, link, cookies, order_info, user_info, order_template, "
-               "message, id_number, keyword, start_time, end_time, quantity, delay, frequency, type, status, response_message, "
-               "actual_earnings, estimated_earnings, extension, created_at FROM results WHERE id = :id";
-        auto rows = session->sql(sql.str()).bind("id", resultId).execute();
+        auto& select = session.statements().get<mysqlx::TableSelect>(
+            "results.findById", [](StatementCache& cache) -> mysqlx::TableSelect {
+                return cache.table("results")
+                    .select("id", "request_id", "device_id", "buyer_id", "thread_id", "link", "cookies", "order_info",
+                            "user_info", "order_template", "message", "id_number", "keyword", "start_time", "end_time",
+                            "quantity", "delay", "frequency", "type", "status", "response_message", "actual_earnings",
+                            "estimated_earnings", "extension")
+                    .where("id = :id");
+            });
+        mysqlx::RowResult rows = select.bind("id", resultId).execute();
         auto index = buildColumnIndex(rows);
         for (mysqlx::Row row : rows) {
             return mapDetailedRow(row, index);
@@ -452,14 +668,30 @@ std::optional<model::Result> ResultsRepository::findById(int resultId) {
 
 void ResultsRepository::deleteById(int resultId) {
     auto session = pool_.acquire();
+    const bool rollups = rollupsEnabled_.load(std::memory_order_acquire);
     try {
-        mysqlx::Schema schema = session->getSchema(pool_.schemaName());
-        mysqlx::Table table = schema.getTable("results");
-        table.remove()
-            .where("id = :id")
-            .bind("id", resultId)
-            .execute();
+        std::optional<RollupEntry> entry;
+        if (rollups) {
+            session->startTransaction();
+            entry = lockRollupEntry(*session, resultId);
+        }
+        auto& remove = session.statements().get<mysqlx::TableRemove>(
+            "results.deleteById", [](StatementCache& cache) -> mysqlx::TableRemove {
+                return cache.table("results").remove().where("id = :id");
+            });
+        const auto removed = remove.bind("id", resultId).execute().getAffectedItemsCount();
+        if (rollups) {
+            // 只有确实删掉了这一行才扣减汇总
+            if (entry && removed == 1) {
+                applyRollupDelta(*session, *entry, -1);
+            }
+            session->commit();
+        }
+        bumpVersion();
     } catch (const mysqlx::Error& err) {
+        if (rollups) {
+            rollbackQuietly(*session);
+        }
         util::log(util::LogLevel::error, std::string{"Delete result failed: "} + err.what());
         throw;
     }
@@ -477,57 +709,106 @@ std::vector<model::Result> ResultsRepository::findByFilters(
     std::vector<model::Result> results;
     auto session = pool_.acquire();
     try {
-        std::ostringstream sql;
-        sql << "SELECT id, request_id, device_id, buyer_id, thread_id, link, cookies, order_info, user_info, order_template, "
-            "message, id_number, keyword, "
-            "DATE_FORMAT(start_time, '%Y-%m-%d %H:%i:%s') AS start_time, "
-            "DATE_FORMAT(end_time,   '%Y-%m-%d %H:%i:%s') AS end_time, "
-            "quantity, delay, frequency, type, status, response_message, "
-            "actual_earnings, estimated_earnings, extension "
-            "FROM results WHERE 1=1";
-
-        std::vector<mysqlx::Value> params;
-        if (keyword && !keyword->empty()) {
-            sql << " AND (user_info LIKE ?)";
-            params.emplace_back("%" + *keyword + "%");
-        }
-        if (buyerId) {
-            sql << " AND buyer_id = ?";
-            params.emplace_back(*buyerId);
+        ListFilter filter{keyword, buyerId, type, status, keywordIndex_.available(*session, pool_.schemaName())};
+        auto rows = executeFilterQuery(*session, filter, orderColumn, orderDirection, offset, limit);
+        auto index = buildColumnIndex(rows);
+        for (mysqlx::Row row : rows) {
+            results.emplace_back(mapDetailedRow(row, index));
         }
-        if (type) {
-            sql << " AND type = ?";
-            params.emplace_back(*type);
+    }
+    catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{ "按条件查询抢购结果失败: " } + err.what());
+        throw;
+    }
+    return results;
+}
+
+std::size_t ResultsRepository::writeByFilters(const std::optional<std::string>& keyword,
+                                              const std::optional<int>& buyerId,
+                                              const std::optional<int>& type,
+                                              const std::optional<int>& status,
+                                              std::string_view orderColumn,
+                                              std::string_view orderDirection,
+                                              int offset,
+                                              int limit,
+                                              util::JsonWriter& writer) {
+    std::size_t count = 0;
+    auto session = pool_.acquire();
+    try {
+        ListFilter filter{keyword, buyerId, type, status, keywordIndex_.available(*session, pool_.schemaName())};
+        auto rows = executeFilterQuery(*session, filter, orderColumn, orderDirection, offset, limit);
+        auto index = buildColumnIndex(rows);
+        writer.beginArray();
+        for (mysqlx::Row row : rows) {
+            writeListRow(writer, row, index);
+            ++count;
         }
-        if (status) {
-            sql << " AND status = ?";
-            params.emplace_back(*status);
+        writer.endArray();
+    }
+    catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{ "按条件输出抢购结果失败: " } + err.what());
+        throw;
+    }
+    return count;
+}
+
+
+ListPageResult ResultsRepository::writePage(const ListPageRequest& page, util::JsonWriter& writer) {
+    ListPageResult outcome;
+    auto session = pool_.acquire();
+    try {
+        std::ostringstream sql;
+        std::vector<mysqlx::Value> params;
+        sql << "SELECT " << (page.summary ? kSummaryColumns : kListColumns) << " FROM results WHERE 1=1";
+        auto filter = page.filter;
+        filter.keywordIndexed = keywordIndex_.available(*session, pool_.schemaName());
+        appendFilterConditions(sql, params, filter);
+        if (page.after) {
+            appendKeysetCondition(sql, params, page.orderColumn, page.orderDirection, *page.after);
         }
-        sql << " ORDER BY " << orderColumn << ' ' << orderDirection;
-        sql << buildLimitOffsetClause(limit, offset);
+        sql << buildKeysetOrderClause(page.orderColumn, page.orderDirection, page.limit);
 
         auto stmt = session->sql(sql.str());
         for (const auto& param : params) {
             stmt.bind(param);
         }
-
         auto rows = stmt.execute();
         auto index = buildColumnIndex(rows);
+        writer.beginArray();
         for (mysqlx::Row row : rows) {
-            results.emplace_back(mapDetailedRow(row, index));
+            if (page.summary) {
+                writeSummaryRow(writer, row, index);
+            } else {
+                writeListRow(writer, row, index);
+            }
+            outcome.next = cursorFromRow(row, index, page.orderColumn);
+            ++outcome.count;
         }
-    }
-    catch (const mysqlx::Error& err) {
-        util::log(util::LogLevel::error, std::string{ "按条件查询抢购结果失败: " } + err.what());
+        writer.endArray();
+        // 不足一页说明已经到底
+        if (outcome.count < static_cast<std::size_t>(std::max(0, page.limit))) {
+            outcome.next.reset();
+        }
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{"分页查询抢购结果失败: "} + err.what());
         throw;
     }
-    return results;
+    return outcome;
 }
 
+std::optional<TotalCount> ResultsRepository::countByFilters(const ListFilter& filter) {
+    auto session = pool_.acquire();
+    auto indexed = filter;
+    indexed.keywordIndexed = keywordIndex_.available(*session, pool_.schemaName());
+    return countRows(*session, pool_.schemaName(), "results", indexed);
+}
 
 std::vector<ResultsRepository::AggregatedStats> ResultsRepository::getStatistics(const std::optional<int>& buyerId,
                                                                                 const std::optional<std::string>& startTime,
                                                                                 const std::optional<std::string>& endTime) {
+    if (rollupsEnabled_.load(std::memory_order_acquire)) {
+        return getStatisticsFromRollups(buyerId, startTime, endTime);
+    }
     std::vector<AggregatedStats> stats;
     auto session = pool_.acquire();
     try {
@@ -567,17 +848,7 @@ std::vector<ResultsRepository::AggregatedStats> ResultsRepository::getStatistics
             stmt.bind(*endTime);
         auto rows = stmt.execute();
         for (mysqlx::Row row : rows) {
-            AggregatedStats entry{};
-            entry.type = readString(row[0]);
-            entry.successCount = asInt64(row[1], "successCount");
-            entry.failureCount = asInt64(row[2], "failureCount");
-            entry.exceptionCount = asInt64(row[3], "exceptionCount");
-            entry.totalCount = asInt64(row[4], "totalCount");
-            entry.successEarnings = readDouble(row[5]);
-            entry.failureEarnings = readDouble(row[6]);
-            entry.exceptionEarnings = readDouble(row[7]);
-            entry.totalEarnings = readDouble(row[8]);
-            stats.emplace_back(std::move(entry));
+            stats.emplace_back(readAggregatedRow(row));
         }
     } catch (const mysqlx::Error& err) {
         util::log(util::LogLevel::error, std::string{"查询统计数据失败: "} + err.what());
@@ -589,6 +860,9 @@ std::vector<ResultsRepository::AggregatedStats> ResultsRepository::getStatistics
 std::vector<ResultsRepository::DailyStat>
 ResultsRepository::getDailyStats(const std::optional<int>& buyerId,
     const std::optional<int>& status) {
+    if (rollupsEnabled_.load(std::memory_order_acquire)) {
+        return getDailyStatsFromRollups(buyerId, status);
+    }
     std::vector<DailyStat> items;
     auto session = pool_.acquire();
     try {
@@ -633,6 +907,9 @@ ResultsRepository::getDailyStats(const std::optional<int>& buyerId,
 std::vector<ResultsRepository::HourlyStat>
 ResultsRepository::getHourlyStats(const std::optional<int>& buyerId,
     const std::optional<int>& status) {
+    if (rollupsEnabled_.load(std::memory_order_acquire)) {
+        return getHourlyStatsFromRollups(buyerId, status);
+    }
     std::vector<HourlyStat> items;
     auto session = pool_.acquire();
     try {
@@ -679,5 +956,215 @@ ResultsRepository::getHourlyStats(const std::optional<int>& buyerId,
     return items;
 }
 
+bool ResultsRepository::prepareRollups() {
+    auto session = pool_.acquire();
+    try {
+        auto tables = session->sql("SELECT COUNT(*) FROM information_schema.TABLES "
+                                   "WHERE TABLE_SCHEMA = ? AND TABLE_NAME = 'result_rollups'")
+                          .bind(pool_.schemaName())
+                          .execute();
+        auto tableRow = tables.fetchOne();
+        if (!tableRow || asInt64(tableRow[0], "tables") == 0) {
+            util::log(util::LogLevel::warn,
+                      "未找到 result_rollups 汇总表，统计接口继续实时聚合 results，请执行 sql/003_result_rollups.sql");
+            rollupsEnabled_.store(false, std::memory_order_release);
+            return false;
+        }
+
+        auto state = session->sql("SELECT EXISTS(SELECT 1 FROM result_rollups), EXISTS(SELECT 1 FROM results)").execute();
+        auto stateRow = state.fetchOne();
+        if (stateRow && asInt64(stateRow[0], "rollups") == 0 && asInt64(stateRow[1], "results") != 0) {
+            util::log(util::LogLevel::info, "result_rollups 为空，开始从 results 回填统计汇总");
+            auto started = std::chrono::steady_clock::now();
+            backfillRollups(*session);
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+            util::log(util::LogLevel::info, "统计汇总回填完成，耗时 " + std::to_string(elapsed.count()) + "ms");
+        }
+        rollupsEnabled_.store(true, std::memory_order_release);
+        return true;
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{"初始化统计汇总失败，统计接口将实时聚合: "} + err.what());
+        rollupsEnabled_.store(false, std::memory_order_release);
+        return false;
+    }
+}
+
+void ResultsRepository::rebuildRollups() {
+    auto session = pool_.acquire();
+    try {
+        const auto started = std::chrono::steady_clock::now();
+        backfillRollups(*session);
+        bumpVersion();
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        util::log(util::LogLevel::info, "统计汇总重建完成，耗时 " + std::to_string(elapsed.count()) + "ms");
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{"重建统计汇总失败: "} + err.what());
+        throw;
+    }
+}
+
+std::vector<ResultsRepository::AggregatedStats>
+ResultsRepository::getStatisticsFromRollups(const std::optional<int>& buyerId,
+                                            const std::optional<std::string>& startTime,
+                                            const std::optional<std::string>& endTime) {
+    std::vector<AggregatedStats> stats;
+    auto session = pool_.acquire();
+    try {
+        const bool windowed = startTime || endTime;
+        std::vector<mysqlx::Value> params;
+        std::ostringstream source;
+        source << "SELECT NULLIF(type, -1) AS type, NULLIF(status, -1) AS status, total_count AS cnt, earnings "
+                  "FROM result_rollups WHERE 1=1";
+        if (buyerId) {
+            source << " AND buyer_id = ?";
+            params.emplace_back(*buyerId);
+        }
+        if (windowed) {
+            source << " AND bucket_start <> " << kNullBucket;
+        }
+        if (startTime) {
+            source << " AND bucket_start >= " << kFirstFullBucket;
+            params.emplace_back(*startTime);
+        }
+        if (endTime) {
+            source << " AND bucket_start < " << kCoveredEnd;
+            params.emplace_back(*endTime);
+        }
+        if (windowed) {
+            // 窗口两端未被整点桶覆盖的部分直接从 results 补齐
+            source << " UNION ALL SELECT type, status, 1, IFNULL(actual_earnings, 0) FROM results WHERE 1=1";
+            if (buyerId) {
+                source << " AND buyer_id = ?";
+                params.emplace_back(*buyerId);
+            }
+            if (startTime) {
+                source << " AND start_time >= ?";
+                params.emplace_back(*startTime);
+            }
+            if (endTime) {
+                source << " AND start_time <= ?";
+                params.emplace_back(*endTime);
+            }
+            source << " AND NOT (1=1";
+            if (startTime) {
+                source << " AND start_time >= " << kFirstFullBucket;
+                params.emplace_back(*startTime);
+            }
+            if (endTime) {
+                source << " AND start_time < " << kCoveredEnd;
+                params.emplace_back(*endTime);
+            }
+            source << ')';
+        }
+
+        // 外层结构与实时聚合版本一致，保证 type 为 NULL 与 WITH ROLLUP 的输出不变
+        std::ostringstream sql;
+        sql << "SELECT type, IFNULL(SUM(successCount), 0) AS successCount, IFNULL(SUM(failureCount), 0) AS failureCount, "
+               "IFNULL(SUM(exceptionCount), 0) AS exceptionCount, IFNULL(SUM(totalCount), 0) AS totalCount, "
+               "IFNULL(SUM(successEarnings), 0) AS successEarnings, IFNULL(SUM(failureEarnings), 0) AS failureEarnings, "
+               "IFNULL(SUM(exceptionEarnings), 0) AS exceptionEarnings, IFNULL(SUM(totalEarnings), 0) AS totalEarnings "
+               "FROM ( SELECT CASE WHEN type IS NULL THEN 'total' ELSE CAST(type AS CHAR) END AS type, "
+               "SUM(CASE WHEN status = 1 THEN cnt ELSE 0 END) AS successCount, "
+               "SUM(CASE WHEN status = 2 THEN cnt ELSE 0 END) AS failureCount, "
+               "SUM(CASE WHEN status = 3 THEN cnt ELSE 0 END) AS exceptionCount, SUM(cnt) AS totalCount, "
+               "SUM(CASE WHEN status = 1 THEN earnings ELSE 0 END) AS successEarnings, "
+               "SUM(CASE WHEN status = 2 THEN earnings ELSE 0 END) AS failureEarnings, "
+               "SUM(CASE WHEN status = 3 THEN earnings ELSE 0 END) AS exceptionEarnings, SUM(earnings) AS totalEarnings "
+               "FROM (" << source.str() << ") AS src"
+               " GROUP BY type WITH ROLLUP UNION ALL SELECT '1' AS type, 0, 0, 0, 0, 0, 0, 0, 0 UNION ALL SELECT '2' AS type, 0, 0, 0, 0, 0, 0, 0, 0 UNION ALL SELECT '3' AS type, 0, 0, 0, 0, 0, 0, 0, 0 UNION ALL SELECT 'total' AS type, 0, 0, 0, 0, 0, 0, 0, 0 ) AS stats GROUP BY type";
+
+        auto stmt = session->sql(sql.str());
+        for (const auto& param : params) {
+            stmt.bind(param);
+        }
+        auto rows = stmt.execute();
+        for (mysqlx::Row row : rows) {
+            stats.emplace_back(readAggregatedRow(row));
+        }
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{"查询统计汇总失败: "} + err.what());
+        throw;
+    }
+    return stats;
+}
+
+std::vector<ResultsRepository::DailyStat>
+ResultsRepository::getDailyStatsFromRollups(const std::optional<int>& buyerId, const std::optional<int>& status) {
+    std::vector<DailyStat> items;
+    auto session = pool_.acquire();
+    try {
+        std::ostringstream sql;
+        sql << "SELECT dates.date AS date, IFNULL(SUM(r.total_count), 0) AS total, IFNULL(SUM(r.earnings), 0) AS earnings "
+               "FROM (SELECT DATE_SUB(CURDATE(), INTERVAL seq DAY) AS date FROM seq_0_to_14) dates "
+               "LEFT JOIN result_rollups r ON r.bucket_start >= dates.date AND r.bucket_start < dates.date + INTERVAL 1 DAY";
+        if (buyerId) sql << " AND r.buyer_id = ?";
+        if (status)  sql << " AND r.status   = ?";
+        sql << " GROUP BY dates.date ORDER BY dates.date";
+
+        auto stmt = session->sql(sql.str());
+        if (buyerId) stmt.bind(*buyerId);
+        if (status)  stmt.bind(*status);
+
+        auto rows = stmt.execute();
+        for (mysqlx::Row row : rows) {
+            DailyStat stat{};
+            stat.date = readString(row[0]);
+            stat.total = asInt64(row[1], "total");
+            stat.earnings = readDouble(row[2]);
+            items.emplace_back(std::move(stat));
+        }
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{"查询每日统计汇总失败: "} + err.what());
+        throw;
+    }
+    return items;
+}
+
+std::vector<ResultsRepository::HourlyStat>
+ResultsRepository::getHourlyStatsFromRollups(const std::optional<int>& buyerId, const std::optional<int>& status) {
+    std::vector<HourlyStat> items(24);
+    for (int hour = 0; hour < 24; ++hour) {
+        items[hour].hour = hour;
+    }
+    auto session = pool_.acquire();
+    try {
+        // 最近 24 小时：整点桶取自汇总表，窗口起点所在的不完整小时回表补齐
+        std::ostringstream filters;
+        if (buyerId) filters << " AND buyer_id = ?";
+        if (status)  filters << " AND status = ?";
+
+        std::ostringstream sql;
+        sql << "SELECT HOUR(bucket_start) AS hour, SUM(cnt) AS total, SUM(earnings) AS earnings FROM ("
+               "SELECT bucket_start, total_count AS cnt, earnings FROM result_rollups WHERE bucket_start >= "
+            << kLastDayFirstFullBucket << filters.str()
+            << " UNION ALL SELECT start_time, 1, IFNULL(actual_earnings, 0) FROM results "
+               "WHERE start_time >= NOW() - INTERVAL 1 DAY AND start_time < "
+            << kLastDayFirstFullBucket << filters.str() << ") AS src GROUP BY HOUR(bucket_start)";
+
+        auto stmt = session->sql(sql.str());
+        for (int pass = 0; pass < 2; ++pass) {
+            if (buyerId) stmt.bind(*buyerId);
+            if (status)  stmt.bind(*status);
+        }
+
+        auto rows = stmt.execute();
+        for (mysqlx::Row row : rows) {
+            if (row[0].isNull()) {
+                continue;
+            }
+            auto hour = row[0].get<int>();
+            if (hour < 0 || hour >= 24) {
+                continue;
+            }
+            items[hour].total = asInt64(row[1], "total");
+            items[hour].earnings = readDouble(row[2]);
+        }
+    } catch (const mysqlx::Error& err) {
+        util::log(util::LogLevel::error, std::string{"查询每小时统计汇总失败: "} + err.what());
+        throw;
+    }
+    return items;
+}
 
 } // namespace quickgrab::repository
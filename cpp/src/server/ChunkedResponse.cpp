@@ -0,0 +1,62 @@
+#include "quickgrab/server/ChunkedResponse.hpp"
+#include "quickgrab/util/Logging.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/http/chunk_encode.hpp>
+
+#include <utility>
+
+namespace quickgrab::server {
+
+ChunkedResponse::ChunkedResponse(boost::beast::tcp_stream stream,
+                                 std::vector<std::string> chunks,
+                                 std::chrono::seconds writeTimeout)
+    : stream_(std::move(stream))
+    , chunks_(std::make_move_iterator(chunks.begin()), std::make_move_iterator(chunks.end()))
+    , writeTimeout_(writeTimeout) {}
+
+void ChunkedResponse::start() {
+    boost::asio::dispatch(stream_.get_executor(), [self = shared_from_this()]() { self->doWrite(); });
+}
+
+void ChunkedResponse::doWrite() {
+    auto onWritten = boost::asio::bind_executor(stream_.get_executor(),
+        [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+            if (ec) {
+                util::log(util::LogLevel::warn, "分块输出中断: " + ec.message());
+                self->shutdown();
+                return;
+            }
+            if (!self->chunks_.empty()) {
+                self->chunks_.pop_front();
+            }
+            self->doWrite();
+        });
+
+    // 超时只对 tcp_stream 的异步操作生效，每次写出前重新计时
+    stream_.expires_after(writeTimeout_);
+    while (!chunks_.empty() && chunks_.front().empty()) {
+        chunks_.pop_front();
+    }
+    if (!chunks_.empty()) {
+        boost::asio::async_write(stream_, boost::beast::http::make_chunk(boost::asio::buffer(chunks_.front())),
+                                 std::move(onWritten));
+        return;
+    }
+    if (!lastSent_) {
+        lastSent_ = true;
+        boost::asio::async_write(stream_, boost::beast::http::make_chunk_last(), std::move(onWritten));
+        return;
+    }
+    shutdown();
+}
+
+void ChunkedResponse::shutdown() {
+    boost::system::error_code ec;
+    stream_.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    stream_.socket().close(ec);
+}
+
+} // namespace quickgrab::server
@@ -0,0 +1,97 @@
+#include "quickgrab/server/ETag.hpp"
+
+#include <boost/beast/http.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace quickgrab::server {
+namespace {
+
+constexpr std::uint64_t kFnvOffset = 1469598103934665603ULL;
+constexpr std::uint64_t kFnvPrime = 1099511628211ULL;
+
+std::uint64_t processSalt() {
+    static const std::uint64_t salt = [] {
+        std::random_device rd;
+        return (static_cast<std::uint64_t>(rd()) << 32) ^ rd() ^
+               static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }();
+    return salt;
+}
+
+void mix(std::uint64_t& hash, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+}
+
+std::string_view trim(std::string_view view) {
+    while (!view.empty() && (view.front() == ' ' || view.front() == '\t')) {
+        view.remove_prefix(1);
+    }
+    while (!view.empty() && (view.back() == ' ' || view.back() == '\t')) {
+        view.remove_suffix(1);
+    }
+    return view;
+}
+
+bool matchesAny(std::string_view header, std::string_view etag) {
+    std::size_t start = 0;
+    while (start <= header.size()) {
+        auto end = header.find(',', start);
+        if (end == std::string_view::npos) {
+            end = header.size();
+        }
+        auto candidate = trim(header.substr(start, end - start));
+        // If-None-Match 使用弱比较，忽略 W/ 前缀
+        if (candidate.size() > 2 && candidate.substr(0, 2) == "W/") {
+            candidate.remove_prefix(2);
+        }
+        if (candidate == "*" || candidate == etag) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+std::string makeETag(std::initializer_list<std::uint64_t> versions, std::string_view target) {
+    std::uint64_t hash = kFnvOffset;
+    const auto salt = processSalt();
+    mix(hash, &salt, sizeof(salt));
+    for (auto version : versions) {
+        mix(hash, &version, sizeof(version));
+    }
+    mix(hash, target.data(), target.size());
+
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "\"%016llx\"", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+bool handleConditionalGet(RequestContext& ctx, const std::string& etag) {
+    ctx.response.set(boost::beast::http::field::etag, etag);
+    // 允许浏览器缓存，但每次都带 If-None-Match 回源校验
+    ctx.response.set(boost::beast::http::field::cache_control, "no-cache");
+
+    auto header = ctx.request.find(boost::beast::http::field::if_none_match);
+    if (header == ctx.request.end()) {
+        return false;
+    }
+    auto value = header->value();
+    if (!matchesAny(std::string_view(value.data(), value.size()), etag)) {
+        return false;
+    }
+    ctx.response.result(boost::beast::http::status::not_modified);
+    ctx.response.body().clear();
+    ctx.response.content_length(boost::none);
+    return true;
+}
+
+} // namespace quickgrab::server
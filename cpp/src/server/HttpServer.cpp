@@ -1,14 +1,18 @@
 #include "quickgrab/server/HttpServer.hpp"
 #include "quickgrab/server/Router.hpp"
 #include "quickgrab/server/RequestContext.hpp"
+#include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/Metrics.hpp"
 
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/beast/version.hpp>
 #include <chrono>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <utility>
 
@@ -41,30 +45,104 @@ private:
     }
 
     void dispatch() {
-        RequestContext ctx;
-        ctx.startedAt = std::chrono::steady_clock::now();
-        ctx.request = std::move(request_);
-        ctx.response.version(ctx.request.version());
-        ctx.response.keep_alive(ctx.request.keep_alive());
+        auto ctx = std::make_shared<RequestContext>();
+        ctx->startedAt = std::chrono::steady_clock::now();
+        ctx->request = std::move(request_);
+        ctx->response.version(ctx->request.version());
+        ctx->response.keep_alive(ctx->request.keep_alive());
 
         std::unordered_map<std::string, std::string> params;
-        auto handler = router_->resolve(ctx.request.method_string(), ctx.request.target(), params);
-        ctx.pathParameters = std::move(params);
-
-        if (!handler) {
-            ctx.response.result(boost::beast::http::status::not_found);
-            ctx.response.set(boost::beast::http::field::content_type, "application/json");
-            ctx.response.body() = "{\\\"error\\\":\\\"not_found\\\"}";
-            ctx.response.prepare_payload();
-        } else {
-            handler(ctx);
-            if (ctx.response.body().empty() && ctx.response.result() == boost::beast::http::status::unknown) {
-                ctx.response.result(boost::beast::http::status::no_content);
-                ctx.response.prepare_payload();
+        auto route = router_->resolve(ctx->request.method_string(), ctx->request.target(), params);
+        ctx->pathParameters = std::move(params);
+        ctx->route = route.path;
+
+        if (!route) {
+            ctx->response.result(boost::beast::http::status::not_found);
+            ctx->response.set(boost::beast::http::field::content_type, "application/json");
+            ctx->response.body() = "{\\\"error\\\":\\\"not_found\\\"}";
+            ctx->response.prepare_payload();
+            complete(std::move(ctx));
+            return;
+        }
+
+        if (!route.offload) {
+            route.handler(*ctx);
+            complete(std::move(ctx));
+            return;
+        }
+
+        // 预检命中（如 304）时直接在本线程写响应，不占用执行器队列，也不会因队列已满得到 503
+        if (route.precheck && route.precheck(*ctx)) {
+            complete(std::move(ctx));
+            return;
+        }
+
+        // 处理器在 offload 指定的执行器上运行，完成后回到本连接的 strand 写响应
+        auto self = shared_from_this();
+        auto offload = route.offload;
+        bool accepted = offload([self, ctx, handler = route.handler]() {
+            try {
+                handler(*ctx);
+            } catch (const std::exception& ex) {
+                util::log(util::LogLevel::error, std::string{"异步请求处理异常: "} + ex.what());
+                ctx->streamHandler = nullptr;
+                respondError(*ctx, boost::beast::http::status::internal_server_error, "internal_error");
             }
+            boost::asio::post(self->stream_.get_executor(), [self, ctx]() { self->complete(ctx); });
+        });
+        if (!accepted) {
+            util::log(util::LogLevel::warn, "执行器队列已满，拒绝请求 " + std::string(ctx->request.target()));
+            respondError(*ctx, boost::beast::http::status::service_unavailable, "server_busy");
+            complete(std::move(ctx));
         }
+    }
 
-        auto response = std::make_shared<RequestContext::HttpResponse>(std::move(ctx.response));
+    // 耗时从读完请求算到开始写响应（流式响应算到移交连接），不含网络写出
+    static void recordMetrics(const RequestContext& ctx) {
+        const std::string_view route = ctx.route.empty() ? std::string_view{"unmatched"} : ctx.route;
+        const auto method = ctx.request.method_string();
+        const std::string_view methodView{method.data(), method.size()};
+        char status[3];
+        const auto code = ctx.response.result_int();
+        status[0] = static_cast<char>('0' + code / 100 % 10);
+        status[1] = static_cast<char>('0' + code / 10 % 10);
+        status[2] = static_cast<char>('0' + code % 10);
+        auto& registry = util::metrics();
+        registry
+            .counter("quickgrab_http_requests_total", "HTTP requests by route, method and status",
+                     {{"route", route}, {"method", methodView}, {"status", std::string_view(status, 3)}})
+            .inc();
+        registry
+            .histogram("quickgrab_http_request_duration_seconds", "HTTP handler latency by route",
+                       {{"route", route}, {"method", methodView}})
+            .observe(std::chrono::steady_clock::now() - ctx.startedAt);
+    }
+
+    // 重建响应：处理器中途抛出时可能已设置 ETag/Cache-Control/分块或流式移交，错误体不能沿用
+    static void respondError(RequestContext& ctx, boost::beast::http::status status, const char* error) {
+        ctx.response = {};
+        ctx.response.version(ctx.request.version());
+        ctx.response.keep_alive(ctx.request.keep_alive());
+        ctx.streamHandler = nullptr;
+        ctx.response.result(status);
+        ctx.response.set(boost::beast::http::field::content_type, "application/json; charset=utf-8");
+        ctx.response.body() = std::string{"{\"error\":\""} + error + "\"}";
+        ctx.response.prepare_payload();
+    }
+
+    void complete(std::shared_ptr<RequestContext> ctx) {
+        if (ctx->response.body().empty() && ctx->response.result() == boost::beast::http::status::unknown) {
+            ctx->response.result(boost::beast::http::status::no_content);
+            ctx->response.prepare_payload();
+        }
+        recordMetrics(*ctx);
+
+        if (ctx->streamHandler) {
+            handOver(std::move(*ctx));
+            return;
+        }
+
+        auto response = std::make_shared<RequestContext::HttpResponse>(std::move(ctx->response));
         boost::beast::http::async_write(stream_, *response,
             boost::asio::bind_executor(stream_.get_executor(),
             [self = shared_from_this(), response](boost::system::error_code ec, std::size_t) {
@@ -80,6 +158,24 @@ private:
             }));
     }
 
+    // 先写出响应头，再把底层连接交给流式处理器（SSE / 分块输出）。
+    // 处理器始终在连接的 strand 上调用，只能发起异步操作：阻塞的查询须在异步路由的处理器里做完，
+    // 网络写出不得占用数据库执行器的线程，否则几个慢客户端就能堵住结果落库、邮件等后台任务
+    void handOver(RequestContext ctx) {
+        auto response = std::make_shared<RequestContext::HttpResponse>(std::move(ctx.response));
+        auto serializer = std::make_shared<boost::beast::http::response_serializer<boost::beast::http::string_body>>(*response);
+        boost::beast::http::async_write_header(stream_, *serializer,
+            boost::asio::bind_executor(stream_.get_executor(),
+            [self = shared_from_this(), response, serializer, handler = std::move(ctx.streamHandler)](
+                boost::system::error_code ec, std::size_t) {
+                if (ec) {
+                    self->doClose();
+                    return;
+                }
+                handler(std::move(self->stream_));
+            }));
+    }
+
     void doClose() {
         boost::system::error_code ec;
         stream_.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
@@ -46,9 +46,16 @@ void Router::addRoute(std::string method, std::string path, Handler handler) {
     routes_.push_back(std::move(entry));
 }
 
-Router::Handler Router::resolve(const std::string& method,
-                                const std::string& path,
-                                std::unordered_map<std::string, std::string>& params) const {
+void Router::addAsyncRoute(std::string method, std::string path, Handler handler, Offload offload,
+                           Precheck precheck) {
+    addRoute(std::move(method), std::move(path), std::move(handler));
+    routes_.back().offload = std::move(offload);
+    routes_.back().precheck = std::move(precheck);
+}
+
+Router::Route Router::resolve(const std::string& method,
+                              const std::string& path,
+                              std::unordered_map<std::string, std::string>& params) const {
     auto normalized = normalizeMethod(method);
     const std::string* pathToMatch = &path;
     std::string strippedPath;
@@ -72,11 +79,11 @@ Router::Handler Router::resolve(const std::string& method,
                     params.emplace(entry.tokens[i], match[i + 1].str());
                 }
             }
-            return entry.handler;
+            return Route{entry.handler, entry.offload, entry.precheck, entry.path};
         }
     }
 
-    return nullptr;
+    return {};
 }
 
 } // namespace quickgrab::server
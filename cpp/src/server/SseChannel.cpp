@@ -0,0 +1,145 @@
+#include "quickgrab/server/SseChannel.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/write.hpp>
+
+#include <utility>
+
+namespace quickgrab::server {
+namespace {
+
+std::string buildFrame(const std::string& event, const std::string& data) {
+    std::string frame;
+    frame.reserve(event.size() + data.size() + 16);
+    if (!event.empty()) {
+        frame += "event: ";
+        frame += event;
+        frame += '\n';
+    }
+    std::size_t start = 0;
+    while (start <= data.size()) {
+        auto end = data.find('\n', start);
+        if (end == std::string::npos) {
+            end = data.size();
+        }
+        frame += "data: ";
+        frame.append(data, start, end - start);
+        frame += '\n';
+        start = end + 1;
+    }
+    frame += '\n';
+    return frame;
+}
+
+} // namespace
+
+SseChannel::SseChannel(boost::beast::tcp_stream stream,
+                       std::chrono::seconds heartbeat,
+                       std::size_t maxPending)
+    : stream_(std::move(stream))
+    , heartbeatTimer_(stream_.get_executor())
+    , heartbeat_(heartbeat)
+    , maxPending_(maxPending) {}
+
+void SseChannel::start(std::function<void()> onClosed) {
+    boost::asio::dispatch(stream_.get_executor(),
+        [self = shared_from_this(), onClosed = std::move(onClosed)]() mutable {
+            self->onClosed_ = std::move(onClosed);
+            // 告知浏览器断线后的重连间隔
+            self->enqueue("retry: 3000\n\n");
+            self->scheduleHeartbeat();
+            self->watchPeer();
+        });
+}
+
+void SseChannel::send(std::string event, std::string data) {
+    boost::asio::dispatch(stream_.get_executor(),
+        [self = shared_from_this(), event = std::move(event), data = std::move(data)]() {
+            self->enqueue(buildFrame(event, data));
+        });
+}
+
+void SseChannel::close() {
+    boost::asio::dispatch(stream_.get_executor(), [self = shared_from_this()]() { self->shutdown(); });
+}
+
+void SseChannel::enqueue(std::string frame) {
+    if (closed_) {
+        return;
+    }
+    if (pending_.size() >= maxPending_) {
+        // 客户端消费过慢，直接断开，由浏览器重连后重新拉取列表
+        shutdown();
+        return;
+    }
+    pending_.push_back(std::move(frame));
+    if (!writing_) {
+        doWrite();
+    }
+}
+
+void SseChannel::doWrite() {
+    if (closed_ || pending_.empty()) {
+        writing_ = false;
+        return;
+    }
+    writing_ = true;
+    boost::asio::async_write(stream_, boost::asio::buffer(pending_.front()),
+        boost::asio::bind_executor(stream_.get_executor(),
+        [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+            if (ec || self->closed_) {
+                self->shutdown();
+                return;
+            }
+            self->pending_.pop_front();
+            self->doWrite();
+        }));
+}
+
+void SseChannel::scheduleHeartbeat() {
+    heartbeatTimer_.expires_after(heartbeat_);
+    heartbeatTimer_.async_wait(
+        boost::asio::bind_executor(stream_.get_executor(),
+        [self = shared_from_this()](const boost::system::error_code& ec) {
+            if (ec || self->closed_) {
+                return;
+            }
+            self->enqueue(": ping\n\n");
+            self->scheduleHeartbeat();
+        }));
+}
+
+void SseChannel::watchPeer() {
+    // SSE 为单向推送，客户端不会再发送数据；读到 EOF 或错误即视为断开。
+    stream_.async_read_some(readBuffer_.prepare(512),
+        boost::asio::bind_executor(stream_.get_executor(),
+        [self = shared_from_this()](boost::system::error_code ec, std::size_t bytes) {
+            if (ec) {
+                self->shutdown();
+                return;
+            }
+            self->readBuffer_.commit(bytes);
+            self->readBuffer_.consume(bytes);
+            self->watchPeer();
+        }));
+}
+
+void SseChannel::shutdown() {
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    // 正在写出的帧仍被 async_write 引用，队列随对象一起释放
+    heartbeatTimer_.cancel();
+    boost::system::error_code ec;
+    stream_.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    stream_.socket().close(ec);
+    if (onClosed_) {
+        auto callback = std::move(onClosed_);
+        onClosed_ = nullptr;
+        callback();
+    }
+}
+
+} // namespace quickgrab::server
@@ -75,6 +75,13 @@ AuthService::AuthResult AuthService::authenticate(const std::string& username,
         return result;
     }
 
+    result.success = true;
+    result.message = "Login successful";
+    result.session = issueSession(*buyer, rememberMe);
+    return result;
+}
+
+AuthService::SessionInfo AuthService::issueSession(const model::Buyer& buyer, bool rememberMe) {
     const auto now = std::chrono::system_clock::now();
     const auto ttl = rememberMe ? rememberTtl_ : defaultTtl_;
     const auto expiresAt = now + ttl;
@@ -82,7 +89,7 @@ AuthService::AuthResult AuthService::authenticate(const std::string& username,
     SessionInfo sessionInfo;
     sessionInfo.rememberMe = rememberMe;
     sessionInfo.expiresAt = expiresAt;
-    sessionInfo.buyer = sanitizeBuyer(*buyer);
+    sessionInfo.buyer = sanitizeBuyer(buyer);
 
     std::unique_lock<std::mutex> lock(mutex_);
     purgeExpiredLocked(now);
@@ -91,13 +98,8 @@ AuthService::AuthResult AuthService::authenticate(const std::string& username,
         sessionInfo.token = generateToken();
     } while (sessions_.find(sessionInfo.token) != sessions_.end());
 
-    sessions_.emplace(sessionInfo.token,
-                      StoredSession{sanitizeBuyer(*buyer), expiresAt, rememberMe});
-
-    result.success = true;
-    result.message = "Login successful";
-    result.session = sessionInfo;
-    return result;
+    sessions_.emplace(sessionInfo.token, StoredSession{sessionInfo.buyer, expiresAt, rememberMe});
+    return sessionInfo;
 }
 
 void AuthService::logout(const std::string& token) {
@@ -0,0 +1,77 @@
+#include "quickgrab/service/GrabEventBus.hpp"
+#include "quickgrab/util/Logging.hpp"
+
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace quickgrab::service {
+
+GrabEventBus::SubscriptionId GrabEventBus::subscribe(std::optional<int> buyerId, Subscriber subscriber) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto id = nextId_++;
+    subscribers_.emplace(id, Entry{buyerId, std::move(subscriber)});
+    return id;
+}
+
+void GrabEventBus::unsubscribe(SubscriptionId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.erase(id);
+}
+
+void GrabEventBus::publish(const GrabEvent& event) {
+    std::vector<Subscriber> targets;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        targets.reserve(subscribers_.size());
+        for (const auto& [id, entry] : subscribers_) {
+            if (!entry.buyerId || *entry.buyerId == event.buyerId) {
+                targets.push_back(entry.subscriber);
+            }
+        }
+    }
+
+    for (auto& subscriber : targets) {
+        try {
+            subscriber(event);
+        } catch (const std::exception& ex) {
+            util::log(util::LogLevel::warn, std::string{"抢购事件分发失败: "} + ex.what());
+        }
+    }
+}
+
+std::size_t GrabEventBus::subscriberCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_.size();
+}
+
+const char* toString(GrabEvent::Kind kind) {
+    switch (kind) {
+    case GrabEvent::Kind::request_status: return "request";
+    case GrabEvent::Kind::request_removed: return "request_removed";
+    case GrabEvent::Kind::result_created: return "result";
+    }
+    return "request";
+}
+
+boost::json::object toJson(const GrabEvent& event) {
+    boost::json::object obj;
+    obj["kind"] = toString(event.kind);
+    obj["buyerId"] = event.buyerId;
+    obj["requestId"] = event.requestId;
+    if (event.resultId != 0) {
+        obj["resultId"] = event.resultId;
+    }
+    obj["type"] = event.type;
+    obj["status"] = event.status;
+    if (!event.message.empty()) {
+        obj["message"] = event.message;
+    }
+    if (!event.detail.is_null()) {
+        obj["detail"] = event.detail;
+    }
+    obj["at"] = std::chrono::duration_cast<std::chrono::milliseconds>(event.at.time_since_epoch()).count();
+    return obj;
+}
+
+} // namespace quickgrab::service
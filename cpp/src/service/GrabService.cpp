@@ -1,5 +1,6 @@
 #include "quickgrab/service/GrabService.hpp"
 #include "quickgrab/model/Result.hpp"
+#include "quickgrab/util/ClockSync.hpp"
 #include "quickgrab/util/Logging.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
@@ -11,12 +12,14 @@
 #include <array>
 #include <chrono>
 #include <cstdint>
+#include <exception>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <vector>
 #include <boost/asio/connect.hpp>
 
 namespace {
@@ -167,18 +170,22 @@ std::chrono::milliseconds measureProxyLatency(const proxy::ProxyEndpoint& endpoi
 
 GrabService::GrabService(boost::asio::io_context& io,
                          boost::asio::thread_pool& worker,
+                         repository::DatabaseExecutor& database,
                          repository::RequestsRepository& requests,
                          repository::ResultsRepository& results,
                          util::HttpClient& client,
                          proxy::ProxyPool& proxies,
-                         MailService& mailService)
+                         MailService& mailService,
+                         GrabEventBus& eventBus)
     : io_(io)
     , worker_(worker)
+    , database_(database)
     , requests_(requests)
     , results_(results)
     , httpClient_(client)
     , proxyPool_(proxies)
     , mailService_(mailService)
+    , eventBus_(eventBus)
     , workflow_(std::make_unique<workflow::GrabWorkflow>(io_, worker_, httpClient_, proxyPool_))
     , adjustedFactor_(10)
     , processingTime_(19)
@@ -191,6 +198,10 @@ void GrabService::setProxyConfig(proxy::KdlProxyConfig config) {
     proxyConfig_ = std::move(config);
 }
 
+void GrabService::setParameterRefresh(workflow::ParameterRefreshConfig config) {
+    workflow_->setParameterRefresh(config);
+}
+
 bool GrabService::requestWantsProxy(const boost::json::object& extension) const {
     return extensionRequestsProxy(extension);
 }
@@ -224,35 +235,33 @@ std::optional<proxy::ProxyEndpoint> GrabService::fetchProxyForRequest(const mode
         });
 
         auto best = proxies.front();
-        util::log(util::LogLevel::info,
-                  "请求 id=" + std::to_string(request.id) +
-                      " 分配代理 " + best.host + ':' + std::to_string(best.port) +
-                      " (" + std::to_string(best.latency.count()) + "ms)");
+        QG_LOG_INFO("请求 id={} 分配代理 {}:{} ({}ms)", request.id, best.host, best.port, best.latency.count());
         return best;
     } catch (const std::exception& ex) {
-        util::log(util::LogLevel::warn,
-                  std::string{"请求 id="} + std::to_string(request.id) +
-                      " 拉取代理失败: " + ex.what());
+        QG_LOG_WARN("请求 id={} 拉取代理失败: {}", request.id, ex.what());
     }
     return std::nullopt;
 }
 
 void GrabService::processPending() {
     if (pendingDrainInFlight_.exchange(true)) {
-        util::log(util::LogLevel::debug, "Skipping pending drain; another drain is already in flight");
+        QG_LOG_DEBUG("Skipping pending drain; another drain is already in flight");
         return;
     }
     auto guard = std::make_shared<DrainCompletionGuard>(pendingDrainInFlight_);
 
-    // 在 worker_ 上做数据库 I/O，避免阻塞 io_
-    boost::asio::post(worker_, [this, guard]() mutable {
-        try {
+    // 查询与标记“执行中”在数据库执行器上完成，抢购调度再切回 worker_，
+    // 慢查询不会占用下单所需的 worker 线程
+    bool accepted = database_.dispatch(
+        [this]() {
+            std::vector<model::Request> scheduled;
             auto pending = requests_.findPending(0);
             const auto now = std::chrono::system_clock::now();
 
             for (auto& request : pending) {
                 // 只触发“即将开始”的任务
-                const auto timeUntilStart = request.startTime - now;
+                const auto timeUntilStart =
+                    util::clockSync().toLocal(workflow::GrabWorkflow::fireDomain(), request.startTime) - now;
                 if (timeUntilStart > kPendingTriggerWindow) {
                     continue;
                 }
@@ -262,34 +271,49 @@ void GrabService::processPending() {
                     requests_.updateStatus(request.id, 2);
                 }
                 catch (const std::exception& ex) {
-                    util::log(util::LogLevel::warn,
-                        "更新请求状态失败 id=" + std::to_string(request.id) + " error=" + ex.what());
+                    QG_LOG_WARN("更新请求状态失败 id={} error={}", request.id, ex.what());
                     continue;
                 }
-
-
-                auto scheduled = std::make_shared<model::Request>(std::move(request));
+                publishStatus(request, 2);
+                scheduled.push_back(std::move(request));
+            }
+            return scheduled;
+        },
+        worker_.get_executor(),
+        [this, guard](std::exception_ptr error, std::vector<model::Request> scheduled) {
+            if (error) {
                 try {
-                    executeRequest(std::move(*scheduled));
+                    std::rethrow_exception(error);
                 }
                 catch (const std::exception& ex) {
-                    util::log(util::LogLevel::error,
-                        "处理待抢购请求时异常 id=" + std::to_string(scheduled->id) + " error=" + ex.what());
+                    QG_LOG_ERROR("查找待抢购请求时发生异常: {}", ex.what());
+                }
+                return;
+            }
+            for (auto& request : scheduled) {
+                const int id = request.id;
+                try {
+                    executeRequest(std::move(request));
+                }
+                catch (const std::exception& ex) {
+                    QG_LOG_ERROR("处理待抢购请求时异常 id={} error={}", id, ex.what());
                 }
             }
-        }
-        catch (const std::exception& ex) {
-            util::log(util::LogLevel::error, std::string{ "查找待抢购请求时发生异常: " } + ex.what());
-        }
         });
+    if (!accepted) {
+        QG_LOG_WARN("数据库执行器队列已满，本轮跳过待抢购请求扫描");
+    }
 }
 
 std::optional<int> GrabService::handleRequest(const model::Request& request) {
     try {
-        return requests_.insert(request);
+        auto id = requests_.insert(request);
+        model::Request inserted = request;
+        inserted.id = id;
+        publishStatus(inserted, inserted.status);
+        return id;
     } catch (const std::exception& ex) {
-        util::log(util::LogLevel::error,
-                  std::string{"插入抢购请求失败: "} + ex.what());
+        QG_LOG_ERROR("插入抢购请求失败: {}", ex.what());
         return std::nullopt;
     }
 }
@@ -299,15 +323,20 @@ void GrabService::executeRequest(model::Request request) {
 }
 
 void GrabService::executeGrab(model::Request request) {
-    util::log(util::LogLevel::info, "开始处理抢购请求 id=" + std::to_string(request.id));
+    QG_LOG_INFO("开始处理抢购请求 id={}", request.id);
 
     const auto threadId = std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
-    try {
-        requests_.updateThreadId(request.id, threadId);
-        request.threadId = threadId;
-    } catch (const std::exception& ex) {
-        util::log(util::LogLevel::warn,
-                  "更新请求线程信息失败 id=" + std::to_string(request.id) + " error=" + ex.what());
+    request.threadId = threadId;
+    // 线程信息只用于展示，异步写入，不推迟计时与下单
+    const bool queued = database_.post([this, id = request.id, threadId]() {
+        try {
+            requests_.updateThreadId(id, threadId);
+        } catch (const std::exception& ex) {
+            QG_LOG_WARN("更新请求线程信息失败 id={} error={}", id, ex.what());
+        }
+    });
+    if (!queued) {
+        QG_LOG_WARN("数据库执行器繁忙，跳过线程信息更新 id={}", request.id);
     }
 
     const auto now = std::chrono::system_clock::now();
@@ -331,9 +360,11 @@ void GrabService::executeGrab(model::Request request) {
 
     const int requestedThreads = readRequestedThreadCount(extension);
 
+    std::optional<proxy::ProxyEndpoint> assignedProxy;
     if (requestWantsProxy(extension)) {
         auto proxy = fetchProxyForRequest(request);
         if (proxy) {
+            assignedProxy = proxy;
             extension["__proxyHost"] = proxy->host;
             extension["__proxyPort"] = static_cast<std::int64_t>(proxy->port);
             extension["__proxyLatency"] = static_cast<std::int64_t>(proxy->latency.count());
@@ -359,22 +390,24 @@ void GrabService::executeGrab(model::Request request) {
     const bool finalProxyState = requestWantsProxy(extension);
     extension["proxyThreadCount"] = clampThreadCount(requestedThreads, finalProxyState);
 
-    extension["__adjustedFactor"] = adjustedFactor_.load();
+    request.extension = extension;
+    // 有实测时延时以其为准，客户端上报的 networkDelay 与默认值只作回退；
+    // __adjustedFactor 保存上报值，GrabWorkflow 定时以同样的输入调用 fireLead，得到同一提前量
+    const long reportedLatency = adjustedFactor_.load();
+    const auto lead = workflow::GrabWorkflow::fireLead(finalProxyState, assignedProxy, reportedLatency);
+
+    extension["__adjustedFactor"] = reportedLatency;
+    extension["__fireLeadMs"] = static_cast<std::int64_t>(lead.lead.count());
+    extension["__latencySource"] = lead.measured ? "measured" : "reported";
     extension["__processingTime"] = processingTime_;
     extension["__schedulingTime"] = schedulingTime_;
     extension["__updatedAt"] = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
     request.extension = extension;
 
-    const auto start = request.startTime;
-    const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(start - now).count();
-    const auto delayHint = request.delay;
-    const long waitMillis = std::max<long>(
-        0, static_cast<long>(delta) + (delayHint - adjustedFactor_.load() - processingTime_));
-    util::log(util::LogLevel::info,
-              "请求 id=" + std::to_string(request.id) + " 将在 " + std::to_string(waitMillis) +
-                  "ms 后执行 (delay=" + std::to_string(delayHint) +
-                  ", latency=" + std::to_string(adjustedFactor_.load()) +
-                  ", processing=" + std::to_string(processingTime_) + ")");
+    // 与 GrabWorkflow 定时同一算法；首单已预先序列化，本地处理时间不再从等待时长中扣除
+    const auto waitMillis = workflow::GrabWorkflow::fireDelay(request, lead.lead, now).count();
+    QG_LOG_INFO("请求 id={} 将在 {}ms 后执行 (delay={}, lead={}ms {})",
+                request.id, waitMillis, request.delay, lead.lead.count(), lead.measured ? "实测" : "上报");
 
     // GrabWorkflow::run() 只会在当前线程上准备上下文并把任务交给 workflow 的 worker_
     // 池。延时和后续的同步 I/O 都在单个 worker 线程上串行执行，完成后再切回
@@ -408,6 +441,15 @@ void GrabService::handleResult(const model::Request& request, const workflow::Gr
     stored.actualEarnings = request.actualEarnings;
     stored.estimatedEarnings = request.estimatedEarnings;
     stored.extension = request.extension;
+    if (result.timeline) {
+        // 时间线随结果落库，便于事后按单条请求排查各阶段耗时
+        auto& extension = stored.extension.mutate();
+        if (!extension.is_object()) {
+            extension = boost::json::object{};
+        }
+        extension.as_object()["timeline"] = result.timeline->toJson();
+        util::recordTimeline(result.timeline);
+    }
     stored.createdAt = std::chrono::system_clock::now();
     boost::json::object payload;
     payload["success"] = result.success;
@@ -425,41 +467,98 @@ void GrabService::handleResult(const model::Request& request, const workflow::Gr
     stored.payload = std::move(payload);
     stored.responseMessage = stored.payload;
 
+    // 结果落库、邮件与事件推送都可能阻塞，交给数据库执行器，不占用 I/O 线程；
+    // 结果必须写入，因此不受排队上限约束
+    database_.enqueue([this, request, result, stored = std::move(stored)]() mutable {
+        try {
+            persistResult(request, result, stored);
+        } catch (const std::exception& ex) {
+            QG_LOG_ERROR("保存抢购结果失败 id={} error={}", request.id, ex.what());
+        }
+    });
+}
+
+void GrabService::persistResult(const model::Request& request,
+                                const workflow::GrabResult& result,
+                                model::Result& stored) {
     if (result.success) {
-        util::log(util::LogLevel::info, "抢购完成 id=" + std::to_string(request.id));
+        QG_LOG_INFO("抢购完成 id={}", request.id);
         requests_.updateStatus(request.id, 1);
-        results_.insertResult(stored);
+        publishStatus(request, 1, result.message);
+        publishResult(stored, results_.insertResult(stored));
         mailService_.sendSuccessEmail(request, result);
         try {
             requests_.deleteById(request.id);
+            publishRemoved(request);
         } catch (const std::exception& ex) {
-            util::log(util::LogLevel::warn,
-                      "删除请求失败 id=" + std::to_string(request.id) + " error=" + ex.what());
+            QG_LOG_WARN("删除请求失败 id={} error={}", request.id, ex.what());
         }
         return;
     }
 
     if (result.shouldContinue && result.shouldUpdate) {
-        util::log(util::LogLevel::warn, "抢购请求需继续 id=" + std::to_string(request.id));
+        QG_LOG_WARN("抢购请求需继续 id={}", request.id);
         requests_.updateStatus(request.id, 4);
+        publishStatus(request, 4, result.message);
     } else {
-        util::log(util::LogLevel::error,
-                  "抢购失败 id=" + std::to_string(request.id) + " 原因=" + (!result.message.empty() ? result.message : result.error));
+        QG_LOG_ERROR("抢购失败 id={} 原因={}", request.id, !result.message.empty() ? result.message : result.error);
         requests_.updateStatus(request.id, 3);
+        publishStatus(request, 3, !result.message.empty() ? result.message : result.error);
     }
 
-    results_.insertResult(stored);
+    publishResult(stored, results_.insertResult(stored));
     mailService_.sendFailureEmail(request, result);
     if (!result.shouldContinue && !result.shouldUpdate) {
         try {
             requests_.deleteById(request.id);
+            publishRemoved(request);
         } catch (const std::exception& ex) {
-            util::log(util::LogLevel::warn,
-                      "删除请求失败 id=" + std::to_string(request.id) + " error=" + ex.what());
+            QG_LOG_WARN("删除请求失败 id={} error={}", request.id, ex.what());
         }
     }
 }
 
+void GrabService::publishStatus(const model::Request& request, int status, std::string message) {
+    GrabEvent event;
+    event.kind = GrabEvent::Kind::request_status;
+    event.buyerId = request.buyerId;
+    event.requestId = request.id;
+    event.type = request.type;
+    event.status = status;
+    event.message = std::move(message);
+    event.at = std::chrono::system_clock::now();
+    eventBus_.publish(event);
+}
+
+void GrabService::publishRemoved(const model::Request& request) {
+    GrabEvent event;
+    event.kind = GrabEvent::Kind::request_removed;
+    event.buyerId = request.buyerId;
+    event.requestId = request.id;
+    event.type = request.type;
+    event.status = request.status;
+    event.at = std::chrono::system_clock::now();
+    eventBus_.publish(event);
+}
+
+void GrabService::publishResult(const model::Result& result, int resultId) {
+    GrabEvent event;
+    event.kind = GrabEvent::Kind::result_created;
+    event.buyerId = result.buyerId;
+    event.requestId = result.requestId;
+    event.resultId = resultId;
+    event.type = result.type;
+    event.status = result.status;
+    // 只附带列表渲染所需的摘要，完整记录仍走查询接口
+    boost::json::object detail;
+    detail["userInfo"] = result.userInfo.get();
+    detail["endTime"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        result.endTime.time_since_epoch()).count();
+    event.detail = std::move(detail);
+    event.at = result.createdAt;
+    eventBus_.publish(event);
+}
+
 long GrabService::computeAdjustedLatency(const model::Request& request) const {
     auto readLatency = [](const boost::json::value* value) -> std::optional<long> {
         if (!value) {
@@ -1,11 +1,11 @@
 #include "quickgrab/service/MailService.hpp"
+#include "quickgrab/util/DateTime.hpp"
 #include "quickgrab/util/JsonUtil.hpp"
 #include "quickgrab/util/Logging.hpp"
 
 #include <chrono>
 #include <cctype>
 #include <fstream>
-#include <iomanip>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -31,17 +31,7 @@ std::string joinStrings(const std::vector<std::string>& parts, std::string_view
 }
 
 std::string timestampString() {
-    auto now = std::chrono::system_clock::now();
-    auto tt = std::chrono::system_clock::to_time_t(now);
-    std::tm tm{};
-#if defined(_WIN32)
-    localtime_s(&tm, &tt);
-#else
-    localtime_r(&tt, &tm);
-#endif
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y%m%d-%H%M%S");
-    return oss.str();
+    return util::formatCompactDateTime(std::chrono::system_clock::now());
 }
 
 std::string extractOrderLink(const boost::json::object& response) {
@@ -90,7 +80,7 @@ MailService::MailService(Config config)
 
 bool MailService::sendSuccessEmail(const model::Request& request,
                                    const workflow::GrabResult& result) {
-    auto extension = toObject(request.extension);
+    auto extension = toObject(request.extension.get());
     if (!shouldNotify(extension)) {
         return false;
     }
@@ -106,7 +96,7 @@ bool MailService::sendSuccessEmail(const model::Request& request,
         return false;
     }
 
-    auto userInfo = toObject(request.userInfo);
+    auto userInfo = toObject(request.userInfo.get());
     auto phone = getString(userInfo, "telephone").value_or("");
     auto nick = getString(userInfo, "nickName").value_or("");
     std::string phoneDisplay = phone;
@@ -134,7 +124,7 @@ bool MailService::sendSuccessEmail(const model::Request& request,
 
 bool MailService::sendFailureEmail(const model::Request& request,
                                    const workflow::GrabResult& result) {
-    auto extension = toObject(request.extension);
+    auto extension = toObject(request.extension.get());
     if (!shouldNotify(extension)) {
         return false;
     }
@@ -153,7 +143,7 @@ bool MailService::sendFailureEmail(const model::Request& request,
         reason = "抢购失败，请检查商品状态";
     }
 
-    auto userInfo = toObject(request.userInfo);
+    auto userInfo = toObject(request.userInfo.get());
     auto phone = getString(userInfo, "telephone").value_or("");
     auto nick = getString(userInfo, "nickName").value_or("");
     std::string phoneDisplay = phone;
@@ -180,7 +170,7 @@ bool MailService::sendFailureEmail(const model::Request& request,
 
 bool MailService::sendFoundItemEmail(const model::Request& request,
                                      const std::string& link) {
-    auto extension = toObject(request.extension);
+    auto extension = toObject(request.extension.get());
     if (!shouldNotify(extension)) {
         return false;
     }
@@ -190,7 +180,7 @@ bool MailService::sendFoundItemEmail(const model::Request& request,
         return false;
     }
 
-    auto userInfo = toObject(request.userInfo);
+    auto userInfo = toObject(request.userInfo.get());
     auto phone = getString(userInfo, "telephone").value_or("");
     auto nick = getString(userInfo, "nickName").value_or("");
     std::string phoneDisplay = phone;
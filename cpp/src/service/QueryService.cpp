@@ -60,6 +60,92 @@ std::vector<model::Result> QueryService::getResultsByFilters(const std::optional
                                   std::max(0, limit));
 }
 
+std::size_t QueryService::writeRequestsByFilters(const std::optional<std::string>& keyword,
+                                                 const std::optional<int>& buyerId,
+                                                 const std::optional<int>& type,
+                                                 const std::optional<int>& status,
+                                                 std::string_view order,
+                                                 int offset,
+                                                 int limit,
+                                                 util::JsonWriter& writer) {
+    auto [column, direction] = resolveRequestOrder(order);
+    return requests_.writeByFilters(keyword,
+                                    buyerId,
+                                    type,
+                                    status,
+                                    column,
+                                    direction,
+                                    std::max(0, offset),
+                                    std::max(0, limit),
+                                    writer);
+}
+
+std::size_t QueryService::writeResultsByFilters(const std::optional<std::string>& keyword,
+                                                const std::optional<int>& buyerId,
+                                                const std::optional<int>& type,
+                                                const std::optional<int>& status,
+                                                std::string_view order,
+                                                int offset,
+                                                int limit,
+                                                util::JsonWriter& writer) {
+    auto [column, direction] = resolveResultOrder(order);
+    return results_.writeByFilters(keyword,
+                                   buyerId,
+                                   type,
+                                   status,
+                                   column,
+                                   direction,
+                                   std::max(0, offset),
+                                   std::max(0, limit),
+                                   writer);
+}
+
+repository::ListPageResult QueryService::writeRequestsPage(const repository::ListFilter& filter,
+                                                          std::string_view order,
+                                                          const std::optional<repository::ListCursor>& after,
+                                                          int limit,
+                                                          bool summary,
+                                                          util::JsonWriter& writer) {
+    auto [column, direction] = resolveRequestOrder(order);
+    repository::ListPageRequest page;
+    page.filter = filter;
+    page.orderColumn = column;
+    page.orderDirection = direction;
+    page.after = after;
+    page.limit = std::max(0, limit);
+    page.summary = summary;
+    return requests_.writePage(page, writer);
+}
+
+repository::ListPageResult QueryService::writeResultsPage(const repository::ListFilter& filter,
+                                                         std::string_view order,
+                                                         const std::optional<repository::ListCursor>& after,
+                                                         int limit,
+                                                         bool summary,
+                                                         util::JsonWriter& writer) {
+    auto [column, direction] = resolveResultOrder(order);
+    repository::ListPageRequest page;
+    page.filter = filter;
+    page.orderColumn = column;
+    page.orderDirection = direction;
+    page.after = after;
+    page.limit = std::max(0, limit);
+    page.summary = summary;
+    return results_.writePage(page, writer);
+}
+
+std::optional<repository::TotalCount> QueryService::countRequests(const repository::ListFilter& filter) {
+    return requests_.countByFilters(filter);
+}
+
+std::optional<repository::TotalCount> QueryService::countResults(const repository::ListFilter& filter) {
+    return results_.countByFilters(filter);
+}
+
+std::optional<model::Request> QueryService::getRequestById(int requestId) {
+    return requests_.findById(requestId);
+}
+
 bool QueryService::deleteRequestById(int requestId) {
     try {
         requests_.deleteById(requestId);
@@ -95,6 +181,14 @@ std::vector<model::Buyer> QueryService::getAllBuyers() {
     return buyers_.findAll();
 }
 
+std::uint64_t QueryService::requestsVersion() const {
+    return requests_.version();
+}
+
+std::uint64_t QueryService::resultsVersion() const {
+    return results_.version();
+}
+
 std::pair<std::string_view, std::string_view> QueryService::resolveRequestOrder(std::string_view order) {
     if (order == "start_time_asc") {
         return {"start_time", "ASC"};
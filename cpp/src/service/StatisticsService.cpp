@@ -30,5 +30,8 @@ std::vector<model::Buyer> StatisticsService::getAllBuyers() {
     return buyers_.findAll();
 }
 
-} // namespace quickgrab::service
+std::uint64_t StatisticsService::resultsVersion() const {
+    return results_.version();
+}
 
+} // namespace quickgrab::service
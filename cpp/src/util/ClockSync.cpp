@@ -0,0 +1,139 @@
+#include "quickgrab/util/ClockSync.hpp"
+
+#include "quickgrab/util/Metrics.hpp"
+
+#include <algorithm>
+
+namespace quickgrab::util {
+
+std::chrono::microseconds ClockEstimate::correction() const noexcept {
+    if (low > std::chrono::microseconds::zero()) {
+        return low;
+    }
+    if (high < std::chrono::microseconds::zero()) {
+        return high;
+    }
+    return std::chrono::microseconds::zero();
+}
+
+void ClockSync::observe(std::string_view host,
+                        std::chrono::system_clock::time_point sent,
+                        std::chrono::system_clock::time_point received,
+                        std::chrono::system_clock::time_point serverTime,
+                        std::chrono::microseconds resolution,
+                        std::string_view source) {
+    if (host.empty() || received < sent) {
+        return;
+    }
+    Sample sample{received,
+                  std::chrono::duration_cast<std::chrono::microseconds>(serverTime - received),
+                  std::chrono::duration_cast<std::chrono::microseconds>(serverTime + resolution - sent)};
+
+    std::optional<ClockEstimate> current;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& samples = hosts_[std::string(host)];
+        samples.push_back(sample);
+        while (samples.size() > kMaxSamples || samples.front().at + kMaxSampleAge < received) {
+            samples.pop_front();
+        }
+        current = filter(samples, received);
+    }
+
+    auto& registry = metrics();
+    registry.counter("quickgrab_clock_samples_total", "Upstream clock samples by host and source",
+                     {{"host", host}, {"source", source}})
+        .inc();
+    if (current) {
+        registry.gauge("quickgrab_clock_offset_microseconds", "Estimated upstream clock offset (upstream - local) by host",
+                       {{"host", host}})
+            .set(current->offset().count());
+        registry.gauge("quickgrab_clock_uncertainty_microseconds", "Half width of the upstream clock offset interval by host",
+                       {{"host", host}})
+            .set(current->uncertainty().count());
+        registry.gauge("quickgrab_clock_correction_microseconds", "Clock correction applied when firing by host",
+                       {{"host", host}})
+            .set(current->correction().count());
+    }
+}
+
+std::optional<ClockEstimate> ClockSync::filter(const std::deque<Sample>& samples,
+                                               std::chrono::system_clock::time_point now) {
+    // observe() 只在收到新样本时淘汰旧样本，这里按读取时刻再过滤一次；最新样本也过期时不给估计
+    if (samples.empty() || samples.back().at + kMaxSampleAge < now) {
+        return std::nullopt;
+    }
+    ClockEstimate estimate{samples.back().low, samples.back().high, 0};
+    for (auto it = samples.rbegin(); it != samples.rend(); ++it) {
+        if (it->at + kMaxSampleAge < now) {
+            break;
+        }
+        const auto low = std::max(estimate.low, it->low);
+        const auto high = std::min(estimate.high, it->high);
+        if (low > high) {
+            break;
+        }
+        estimate.low = low;
+        estimate.high = high;
+        ++estimate.samples;
+    }
+    return estimate;
+}
+
+std::optional<ClockEstimate> ClockSync::estimate(std::string_view host) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = hosts_.find(std::string(host));
+    if (it == hosts_.end()) {
+        return std::nullopt;
+    }
+    return filter(it->second, std::chrono::system_clock::now());
+}
+
+std::optional<ClockEstimate> ClockSync::bestEstimate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bestLocked(std::chrono::system_clock::now());
+}
+
+std::optional<ClockEstimate> ClockSync::bestLocked(std::chrono::system_clock::time_point now) const {
+    std::optional<ClockEstimate> best;
+    for (const auto& [host, samples] : hosts_) {
+        auto candidate = filter(samples, now);
+        if (candidate && (!best || candidate->high - candidate->low < best->high - best->low)) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+std::chrono::system_clock::time_point ClockSync::toLocal(std::string_view host,
+                                                         std::chrono::system_clock::time_point upstream) const {
+    const auto now = std::chrono::system_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::optional<ClockEstimate> current;
+    if (auto it = hosts_.find(std::string(host)); it != hosts_.end()) {
+        current = filter(it->second, now);
+    }
+    if (!current) {
+        current = bestLocked(now);
+    }
+    return current ? upstream - current->correction() : upstream;
+}
+
+std::chrono::system_clock::time_point ClockSync::toLocal(std::chrono::system_clock::time_point upstream) const {
+    const auto now = std::chrono::system_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto current = bestLocked(now);
+    return current ? upstream - current->correction() : upstream;
+}
+
+void ClockSync::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hosts_.clear();
+}
+
+ClockSync& clockSync() {
+    static ClockSync instance;
+    return instance;
+}
+
+} // namespace quickgrab::util
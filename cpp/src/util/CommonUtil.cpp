@@ -6,6 +6,7 @@
 #include <boost/json.hpp>
 
 #include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <iomanip>
 #include <optional>
@@ -247,7 +248,7 @@ std::optional<boost::json::object> generateOrderParameters(const model::Request&
     }
 
     auto calendarDates = buildCalendarMap(dataObj);
-    auto extension = parseObjectValue(request.extension);
+    auto extension = parseObjectValue(request.extension.get());
 
     bool manualShipping = false;
     double manualShippingFee = 0.0;
@@ -422,7 +423,7 @@ std::optional<boost::json::object> generateOrderParameters(const model::Request&
     params["shop_list"] = shopListArray;
 
     if (!request.orderTemplate.is_null()) {
-        auto customInfo = parseObjectValue(request.orderTemplate);
+        auto customInfo = parseObjectValue(request.orderTemplate.get());
         if (!customInfo.empty()) {
             params["custom_info"] = std::move(customInfo);
         }
@@ -517,5 +518,21 @@ std::optional<boost::json::object> generateOrderParameters(const model::Request&
     return params;
 }
 
-} // namespace quickgrab::util
+std::string toQuery(std::string_view payload) {
+    static constexpr char hex[] = "0123456789ABCDEF";
+    std::string encoded;
+    encoded.reserve(6 + payload.size() * 3);
+    encoded.append("param=");
+    for (unsigned char c : payload) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            encoded.push_back(static_cast<char>(c));
+        } else {
+            encoded.push_back('%');
+            encoded.push_back(hex[c >> 4]);
+            encoded.push_back(hex[c & 0x0F]);
+        }
+    }
+    return encoded;
+}
 
+} // namespace quickgrab::util
@@ -0,0 +1,246 @@
+#include "quickgrab/util/DateTime.hpp"
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+namespace quickgrab::util {
+namespace {
+
+constexpr std::int64_t kSecondsPerDay = 86400;
+constexpr std::int64_t kOffsetWindow = 900;
+
+// 公历日期与 1970-01-01 起天数的互换（Howard Hinnant 算法）
+constexpr std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+constexpr std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+    const auto quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+
+struct CivilTime {
+    std::int64_t year;
+    unsigned month;
+    unsigned day;
+    unsigned hour;
+    unsigned minute;
+    unsigned second;
+};
+
+constexpr CivilTime civilFromSeconds(std::int64_t seconds) {
+    std::int64_t days = seconds / kSecondsPerDay;
+    std::int64_t rem = seconds % kSecondsPerDay;
+    if (rem < 0) {
+        rem += kSecondsPerDay;
+        --days;
+    }
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const std::int64_t y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2);
+    return CivilTime{y, m, d, static_cast<unsigned>(rem / 3600), static_cast<unsigned>(rem / 60 % 60),
+                     static_cast<unsigned>(rem % 60)};
+}
+
+std::int64_t computeOffset(std::int64_t utcSeconds) {
+    const auto tt = static_cast<std::time_t>(utcSeconds);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &tt);
+#else
+    localtime_r(&tt, &tm);
+#endif
+    const auto local = daysFromCivil(tm.tm_year + 1900, static_cast<unsigned>(tm.tm_mon + 1),
+                                     static_cast<unsigned>(tm.tm_mday)) * kSecondsPerDay +
+                       tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    return local - utcSeconds;
+}
+
+// 按 UTC 日缓存偏移：一天首尾偏移相同时整天共用（实际时区一天内至多切换一次），
+// 当天有切换时退化为按 15 分钟窗口计算（切换只发生在整 15 分钟的 UTC 时刻）
+std::int64_t cachedOffset(std::int64_t utcSeconds) {
+    struct DayEntry {
+        std::int64_t day{INT64_MIN};
+        std::int64_t offset{0};
+        bool uniform{false};
+    };
+    struct Window {
+        std::int64_t begin{1};
+        std::int64_t end{0};
+        std::int64_t offset{0};
+    };
+    thread_local std::array<DayEntry, 512> days;
+    thread_local Window window;
+
+    const auto day = floorDiv(utcSeconds, kSecondsPerDay);
+    auto& entry = days[static_cast<std::size_t>(day) & (days.size() - 1)];
+    if (entry.day != day) {
+        const auto begin = day * kSecondsPerDay;
+        const auto first = computeOffset(begin);
+        entry.day = day;
+        entry.offset = first;
+        entry.uniform = first == computeOffset(begin + kSecondsPerDay - 1);
+    }
+    if (entry.uniform) {
+        return entry.offset;
+    }
+    if (utcSeconds < window.begin || utcSeconds >= window.end) {
+        window.begin = floorDiv(utcSeconds, kOffsetWindow) * kOffsetWindow;
+        window.end = window.begin + kOffsetWindow;
+        window.offset = computeOffset(window.begin);
+    }
+    return window.offset;
+}
+
+std::int64_t toUnixSeconds(std::chrono::system_clock::time_point tp) {
+    return std::chrono::floor<std::chrono::seconds>(tp.time_since_epoch()).count();
+}
+
+void writeDigits(char* out, unsigned value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+bool readDigits(std::string_view text, std::size_t pos, int width, unsigned& value) {
+    value = 0;
+    for (int i = 0; i < width; ++i) {
+        const char ch = text[pos + static_cast<std::size_t>(i)];
+        if (ch < '0' || ch > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<unsigned>(ch - '0');
+    }
+    return true;
+}
+
+std::size_t writeCivil(const CivilTime& civil, char* out) {
+    writeDigits(out, static_cast<unsigned>(civil.year), 4);
+    out[4] = '-';
+    writeDigits(out + 5, civil.month, 2);
+    out[7] = '-';
+    writeDigits(out + 8, civil.day, 2);
+    out[10] = ' ';
+    writeDigits(out + 11, civil.hour, 2);
+    out[13] = ':';
+    writeDigits(out + 14, civil.minute, 2);
+    out[16] = ':';
+    writeDigits(out + 17, civil.second, 2);
+    return kDateTimeLength;
+}
+
+} // namespace
+
+std::chrono::seconds localUtcOffset(std::chrono::system_clock::time_point tp) {
+    return std::chrono::seconds(cachedOffset(toUnixSeconds(tp)));
+}
+
+std::optional<std::chrono::system_clock::time_point> parseDateTime(std::string_view text) {
+    if (text.size() >= 2 && (text.front() == '\'' || text.front() == '"') && text.back() == text.front()) {
+        text = text.substr(1, text.size() - 2);
+    }
+    if (text.size() < kDateTimeLength || text[4] != '-' || text[7] != '-' ||
+        (text[10] != ' ' && text[10] != 'T') || text[13] != ':' || text[16] != ':') {
+        return std::nullopt;
+    }
+    if (text.size() > kDateTimeLength && text[kDateTimeLength] != '.') {
+        return std::nullopt;
+    }
+    unsigned year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    unsigned hour = 0;
+    unsigned minute = 0;
+    unsigned second = 0;
+    if (!readDigits(text, 0, 4, year) || !readDigits(text, 5, 2, month) || !readDigits(text, 8, 2, day) ||
+        !readDigits(text, 11, 2, hour) || !readDigits(text, 14, 2, minute) || !readDigits(text, 17, 2, second)) {
+        return std::nullopt;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return std::nullopt;
+    }
+
+    const std::int64_t local = daysFromCivil(year, month, day) * kSecondsPerDay + hour * 3600 + minute * 60 + second;
+    // 先按猜测的 UTC 时刻取偏移，再用修正后的时刻复核一次，处理跨越时区切换的情况
+    std::int64_t utc = local - cachedOffset(local);
+    utc = local - cachedOffset(utc);
+    return std::chrono::system_clock::time_point{std::chrono::seconds(utc)};
+}
+
+std::optional<std::chrono::system_clock::time_point> parseHttpDate(std::string_view text) {
+    static constexpr std::string_view kMonths = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    // "Sun, 06 Nov 1994 08:49:37 GMT"
+    if (text.size() != 29 || text[3] != ',' || text[4] != ' ' || text[7] != ' ' || text[11] != ' ' ||
+        text[16] != ' ' || text[19] != ':' || text[22] != ':' || text.substr(25) != " GMT") {
+        return std::nullopt;
+    }
+    const auto monthAt = kMonths.find(text.substr(8, 3));
+    if (monthAt == std::string_view::npos || monthAt % 3 != 0) {
+        return std::nullopt;
+    }
+    const auto month = static_cast<unsigned>(monthAt / 3 + 1);
+    unsigned year = 0;
+    unsigned day = 0;
+    unsigned hour = 0;
+    unsigned minute = 0;
+    unsigned second = 0;
+    if (!readDigits(text, 5, 2, day) || !readDigits(text, 12, 4, year) || !readDigits(text, 17, 2, hour) ||
+        !readDigits(text, 20, 2, minute) || !readDigits(text, 23, 2, second)) {
+        return std::nullopt;
+    }
+    if (day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return std::nullopt;
+    }
+    const std::int64_t utc = daysFromCivil(year, month, day) * kSecondsPerDay + hour * 3600 + minute * 60 + second;
+    return std::chrono::system_clock::time_point{std::chrono::seconds(utc)};
+}
+
+std::size_t formatDateTime(std::chrono::system_clock::time_point tp, char* out) {
+    const auto seconds = toUnixSeconds(tp);
+    return writeCivil(civilFromSeconds(seconds + cachedOffset(seconds)), out);
+}
+
+std::size_t formatDateTimeMillis(std::chrono::system_clock::time_point tp, char* out) {
+    const auto ms = std::chrono::floor<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+    auto written = formatDateTime(tp, out);
+    out[written] = '.';
+    writeDigits(out + written + 1, static_cast<unsigned>(((ms % 1000) + 1000) % 1000), 3);
+    return kDateTimeMillisLength;
+}
+
+std::string formatDateTime(std::chrono::system_clock::time_point tp) {
+    std::string text(kDateTimeLength, '\0');
+    formatDateTime(tp, text.data());
+    return text;
+}
+
+std::string formatDateTimeMillis(std::chrono::system_clock::time_point tp) {
+    std::string text(kDateTimeMillisLength, '\0');
+    formatDateTimeMillis(tp, text.data());
+    return text;
+}
+
+std::string formatCompactDateTime(std::chrono::system_clock::time_point tp) {
+    char buffer[kDateTimeLength];
+    formatDateTime(tp, buffer);
+    // YYYY-MM-DD HH:MM:SS -> YYYYMMDD-HHMMSS
+    const char compact[] = {buffer[0], buffer[1], buffer[2], buffer[3], buffer[5], buffer[6], buffer[8], buffer[9], '-',
+                            buffer[11], buffer[12], buffer[14], buffer[15], buffer[17], buffer[18]};
+    return std::string(compact, sizeof(compact));
+}
+
+} // namespace quickgrab::util
@@ -0,0 +1,132 @@
+#include "quickgrab/util/DomainScoreboard.hpp"
+
+#include <algorithm>
+
+namespace quickgrab::util {
+
+DomainScoreboard::Score& DomainScoreboard::scoreLocked(std::string_view host) {
+    auto it = scores_.find(std::string(host));
+    if (it == scores_.end()) {
+        Score score;
+        score.host = std::string(host);
+        it = scores_.emplace(score.host, std::move(score)).first;
+    }
+    return it->second;
+}
+
+void DomainScoreboard::recordRequest(std::string_view host, std::chrono::steady_clock::duration firstByte, bool failed) {
+    const auto micros = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(firstByte).count());
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& score = scoreLocked(host);
+    // 过期的旧水平直接以新样本重新起算
+    const bool fresh = score.requests == 0 || now - score.updated > kStaleAfter;
+    // 失败请求多半没有首字节或是超时，不计入时延
+    if (!failed && micros > 0.0) {
+        score.latencyMicros = fresh || score.latencyMicros == 0.0
+                                  ? micros
+                                  : score.latencyMicros + kLatencyAlpha * (micros - score.latencyMicros);
+    }
+    const double failure = failed ? 1.0 : 0.0;
+    score.errorRate = fresh ? failure : score.errorRate + kRateAlpha * (failure - score.errorRate);
+    if (fresh) {
+        score.busyRate = 0.0;
+    }
+    ++score.requests;
+    score.updated = now;
+}
+
+void DomainScoreboard::recordBusy(std::string_view host, bool busy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& score = scoreLocked(host);
+    score.busyRate += kRateAlpha * ((busy ? 1.0 : 0.0) - score.busyRate);
+}
+
+double DomainScoreboard::costLocked(std::string_view host, std::chrono::steady_clock::time_point now,
+                                   double failureLatencyMicros) const {
+    auto it = scores_.find(std::string(host));
+    if (it == scores_.end()) {
+        return -1.0;
+    }
+    const auto& score = it->second;
+    if (now - score.updated > kStaleAfter) {
+        return -1.0;
+    }
+    const double penalty = 1.0 + kErrorPenalty * score.errorRate + kBusyPenalty * score.busyRate;
+    if (score.latencyMicros > 0.0) {
+        return score.latencyMicros * penalty;
+    }
+    // 失败请求不计时延，只失败过的域名没有耗时样本；按悲观耗时计价，不能当作未知域名按最优对待
+    if (score.errorRate > 0.0) {
+        return failureLatencyMicros * penalty;
+    }
+    return -1.0;
+}
+
+std::size_t DomainScoreboard::pick(const std::vector<std::string_view>& candidates) {
+    if (candidates.size() <= 1) {
+        return 0;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    if (unit(rng_) < kExploration) {
+        return std::uniform_int_distribution<std::size_t>(0, candidates.size() - 1)(rng_);
+    }
+
+    double failureLatency = kFailureLatencyMicros;
+    for (auto candidate : candidates) {
+        if (auto it = scores_.find(std::string(candidate));
+            it != scores_.end() && now - it->second.updated <= kStaleAfter) {
+            failureLatency = std::max(failureLatency, it->second.latencyMicros);
+        }
+    }
+
+    std::vector<double> costs;
+    costs.reserve(candidates.size());
+    double best = -1.0;
+    for (auto candidate : candidates) {
+        const double cost = costLocked(candidate, now, failureLatency);
+        costs.push_back(cost);
+        if (cost > 0.0 && (best < 0.0 || cost < best)) {
+            best = cost;
+        }
+    }
+    if (best < 0.0) {
+        return std::uniform_int_distribution<std::size_t>(0, candidates.size() - 1)(rng_);
+    }
+    // 基准不高于悲观耗时：候选里只有失败过的域名时，它们仍排在没有样本的域名之后
+    best = std::min(best, failureLatency);
+
+    // 权重与代价的平方成反比：慢一倍的域名约四分之一的机会；没有样本的按最优对待
+    std::vector<double> weights;
+    weights.reserve(costs.size());
+    for (double cost : costs) {
+        const double ratio = cost > 0.0 ? best / cost : 1.0;
+        weights.push_back(ratio * ratio);
+    }
+    return std::discrete_distribution<std::size_t>(weights.begin(), weights.end())(rng_);
+}
+
+std::vector<DomainScoreboard::Score> DomainScoreboard::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Score> scores;
+    scores.reserve(scores_.size());
+    for (const auto& [host, score] : scores_) {
+        scores.push_back(score);
+    }
+    std::sort(scores.begin(), scores.end(), [](const Score& a, const Score& b) { return a.host < b.host; });
+    return scores;
+}
+
+void DomainScoreboard::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    scores_.clear();
+}
+
+DomainScoreboard& domainScoreboard() {
+    static DomainScoreboard instance;
+    return instance;
+}
+
+} // namespace quickgrab::util
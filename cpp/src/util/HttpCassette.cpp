@@ -0,0 +1,201 @@
+#include "quickgrab/util/HttpCassette.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+
+namespace quickgrab::util {
+namespace {
+
+constexpr std::string_view kMagic = "QGCASSETTE1\n";
+
+void writeU32(std::string& out, std::uint32_t value) {
+    std::array<char, 4> bytes{};
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+    out.append(bytes.data(), bytes.size());
+}
+
+void writeU64(std::string& out, std::uint64_t value) {
+    writeU32(out, static_cast<std::uint32_t>(value & 0xFFFFFFFFu));
+    writeU32(out, static_cast<std::uint32_t>(value >> 32));
+}
+
+void writeString(std::string& out, std::string_view value) {
+    writeU32(out, static_cast<std::uint32_t>(value.size()));
+    out.append(value);
+}
+
+class Reader {
+public:
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    bool done() const noexcept { return offset_ == data_.size(); }
+
+    std::uint32_t u32() {
+        need(4);
+        std::uint32_t value = 0;
+        for (std::size_t i = 0; i < 4; ++i) {
+            value |= static_cast<std::uint32_t>(static_cast<unsigned char>(data_[offset_ + i])) << (8 * i);
+        }
+        offset_ += 4;
+        return value;
+    }
+
+    std::uint64_t u64() {
+        const std::uint64_t low = u32();
+        const std::uint64_t high = u32();
+        return low | (high << 32);
+    }
+
+    std::string string() {
+        const auto size = u32();
+        need(size);
+        std::string value(data_.substr(offset_, size));
+        offset_ += size;
+        return value;
+    }
+
+private:
+    void need(std::size_t size) const {
+        if (data_.size() - offset_ < size) {
+            throw std::runtime_error("磁带文件被截断");
+        }
+    }
+
+    std::string_view data_;
+    std::size_t offset_{0};
+};
+
+// 只取路径部分：查询串里常带时间戳、随机数
+std::string_view pathOf(std::string_view target) {
+    return target.substr(0, target.find('?'));
+}
+
+} // namespace
+
+CassetteRecorder::CassetteRecorder(const std::filesystem::path& path)
+    : out_(path, std::ios::binary | std::ios::trunc) {
+    if (!out_) {
+        throw std::runtime_error("无法创建磁带文件: " + path.string());
+    }
+    out_.write(kMagic.data(), static_cast<std::streamsize>(kMagic.size()));
+    out_.flush();
+}
+
+void CassetteRecorder::append(const CassetteEntry& entry) {
+    std::string record;
+    record.reserve(64 + entry.target.size() + entry.requestBody.size() + entry.body.size());
+    writeString(record, entry.method);
+    writeString(record, entry.host);
+    writeString(record, entry.target);
+    writeString(record, entry.requestBody);
+    writeU32(record, entry.status);
+    writeU32(record, static_cast<std::uint32_t>(entry.headers.size()));
+    for (const auto& [name, value] : entry.headers) {
+        writeString(record, name);
+        writeString(record, value);
+    }
+    writeString(record, entry.body);
+    writeU64(record, static_cast<std::uint64_t>(entry.elapsed.count()));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_.write(record.data(), static_cast<std::streamsize>(record.size()));
+    out_.flush();
+    ++count_;
+}
+
+std::size_t CassetteRecorder::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+std::vector<CassetteEntry> loadCassette(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("无法读取磁带文件: " + path.string());
+    }
+    const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.compare(0, kMagic.size(), kMagic) != 0) {
+        throw std::runtime_error("不是有效的磁带文件: " + path.string());
+    }
+
+    std::vector<CassetteEntry> entries;
+    Reader reader(std::string_view(data).substr(kMagic.size()));
+    while (!reader.done()) {
+        CassetteEntry entry;
+        entry.method = reader.string();
+        entry.host = reader.string();
+        entry.target = reader.string();
+        entry.requestBody = reader.string();
+        entry.status = reader.u32();
+        const auto headerCount = reader.u32();
+        entry.headers.reserve(headerCount);
+        for (std::uint32_t i = 0; i < headerCount; ++i) {
+            auto name = reader.string();
+            auto value = reader.string();
+            entry.headers.emplace_back(std::move(name), std::move(value));
+        }
+        entry.body = reader.string();
+        entry.elapsed = std::chrono::microseconds(static_cast<std::int64_t>(reader.u64()));
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+CassettePlayer::CassettePlayer(const std::filesystem::path& path, CassetteTiming timing)
+    : CassettePlayer(loadCassette(path), timing) {}
+
+CassettePlayer::CassettePlayer(std::vector<CassetteEntry> entries, CassetteTiming timing)
+    : entries_(std::move(entries))
+    , timing_(timing) {
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        const auto& entry = entries_[i];
+        tracks_[keyFor(entry.method, entry.host, entry.target)].entries.push_back(i);
+    }
+}
+
+std::string CassettePlayer::keyFor(std::string_view method, std::string_view host, std::string_view target) {
+    const auto path = pathOf(target);
+    std::string key;
+    key.reserve(method.size() + host.size() + path.size() + 2);
+    key.append(method).append(" ").append(host).append(" ").append(path);
+    return key;
+}
+
+CassettePlayer::Response CassettePlayer::play(std::string_view method, std::string_view host, std::string_view target) {
+    const CassetteEntry* entry = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tracks_.find(keyFor(method, host, target));
+        if (it == tracks_.end()) {
+            throw std::runtime_error("磁带中没有匹配的响应: " + keyFor(method, host, target));
+        }
+        auto& track = it->second;
+        entry = &entries_[track.entries[std::min(track.next, track.entries.size() - 1)]];
+        ++track.next;
+    }
+
+    if (timing_ == CassetteTiming::recorded && entry->elapsed.count() > 0) {
+        std::this_thread::sleep_for(entry->elapsed);
+    }
+
+    Response response{static_cast<boost::beast::http::status>(entry->status), 11};
+    for (const auto& [name, value] : entry->headers) {
+        response.insert(name, value);
+    }
+    response.body() = entry->body;
+    return response;
+}
+
+void CassettePlayer::rewind() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [key, track] : tracks_) {
+        track.next = 0;
+    }
+}
+
+} // namespace quickgrab::util
@@ -1,15 +1,24 @@
 #include "quickgrab/util/HttpClient.hpp"
+#include "quickgrab/util/ClockSync.hpp"
+#include "quickgrab/util/DateTime.hpp"
+#include "quickgrab/util/DomainScoreboard.hpp"
+#include "quickgrab/util/LatencyEstimator.hpp"
 #include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/Metrics.hpp"
+#include "quickgrab/util/Timeline.hpp"
 
 #include <boost/asio/connect.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl/host_name_verification.hpp>
+#include <boost/asio/ssl/stream.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/beast/ssl.hpp>
 #include <boost/beast/version.hpp>
 #include <openssl/err.h>
 #include <openssl/ssl.h>
+#include <poll.h>
 #include <algorithm>
 #include <cctype>
 #include <cstdint>
@@ -221,19 +230,288 @@ std::string connectAuthorityFrom(const ParsedUrl& parsed) {
     return parsed.host + ":" + parsed.port;
 }
 
+// 按 (目标主机, 代理) 记录一次请求的各阶段耗时：resolve/connect/proxy_connect/tls/write/first_byte/body；
+// 当前线程有抢购时间线时同时写入时间线。建连总耗时与写出到首字节的耗时同时交给 latencyEstimator；
+// 直连请求的首字节耗时与成败交给 domainScoreboard（经代理的样本反映的是代理而非域名）
+class PhaseTimer {
+public:
+    PhaseTimer(std::string_view host, const proxy::ProxyEndpoint* proxy)
+        : host_(host)
+        , proxy_(proxy ? proxy->host + ":" + std::to_string(proxy->port) : std::string{"direct"})
+        , direct_(proxy == nullptr)
+        , timeline_(currentTimeline())
+        , started_(std::chrono::steady_clock::now())
+        , last_(started_) {}
+
+    void mark(const char* phase) {
+        const std::string_view name{phase};
+        if (name == "write") {
+            setupDone();
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (name == "first_byte") {
+            firstByte_ = now - last_;
+            latencyEstimator().observe(host_, proxy_, LatencyKind::first_byte, firstByte_);
+        }
+        metrics()
+            .histogram("quickgrab_upstream_phase_seconds", "Upstream HTTP phase latency by host and proxy",
+                       {{"host", host_}, {"proxy", proxy_}, {"phase", phase}})
+            .observe(now - last_);
+        if (timeline_) {
+            timeline_->span(phase, last_, now);
+        }
+        last_ = now;
+    }
+
+    std::string_view host() const noexcept { return host_; }
+
+    // 建连结束（预热连接在握手后、普通请求在写出前）
+    void setupDone() { latencyEstimator().observe(host_, proxy_, LatencyKind::setup, last_ - started_); }
+
+    void responseStatus(unsigned status) noexcept { status_ = status; }
+
+    void finish(std::string_view outcome) {
+        const auto now = std::chrono::steady_clock::now();
+        if (direct_ && outcome != "replay") {
+            domainScoreboard().recordRequest(host_, firstByte_, outcome != "ok" || status_ >= 500);
+        }
+        auto& registry = metrics();
+        registry
+            .counter("quickgrab_upstream_requests_total", "Upstream HTTP requests by host, proxy and outcome",
+                     {{"host", host_}, {"proxy", proxy_}, {"outcome", outcome}})
+            .inc();
+        registry
+            .histogram("quickgrab_upstream_phase_seconds", "Upstream HTTP phase latency by host and proxy",
+                       {{"host", host_}, {"proxy", proxy_}, {"phase", "total"}})
+            .observe(now - started_);
+        if (timeline_) {
+            std::string detail;
+            detail.reserve(host_.size() + proxy_.size() + outcome.size() + 8);
+            detail.append(host_).append(" via ").append(proxy_).append(" ").append(outcome);
+            timeline_->span("upstream", started_, now, std::move(detail));
+        }
+    }
+
+private:
+    std::string_view host_;
+    std::string proxy_;
+    bool direct_;
+    GrabTimeline* timeline_;
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::steady_clock::time_point last_;
+    unsigned status_{0};
+    std::chrono::steady_clock::duration firstByte_{};
+};
+
+// 先读响应头（近似首字节时刻）再读正文，分别计入 first_byte 与 body 阶段。
+// 请求写出后到响应头到达之间上游生成了 Date，作为一个时钟样本交给 clockSync
+template <typename Stream>
+HttpClient::HttpResponse readResponse(Stream& stream, boost::beast::flat_buffer& buffer, PhaseTimer& phases) {
+    const auto sent = std::chrono::system_clock::now();
+    boost::beast::http::response_parser<boost::beast::http::string_body> parser;
+    boost::beast::http::read_header(stream, buffer, parser);
+    const auto received = std::chrono::system_clock::now();
+    phases.mark("first_byte");
+    phases.responseStatus(parser.get().result_int());
+    if (const auto date = parser.get().find(boost::beast::http::field::date); date != parser.get().end()) {
+        const auto value = date->value();
+        if (auto serverTime = parseHttpDate(std::string_view(value.data(), value.size()))) {
+            clockSync().observe(phases.host(), sent, received, *serverTime, std::chrono::seconds{1}, "date");
+        }
+    }
+    boost::beast::http::read(stream, buffer, parser);
+    phases.mark("body");
+    return parser.release();
+}
+
 } // namespace
 
+PreparedRequest::PreparedRequest(HttpRequest request)
+    : request_(std::move(request)) {
+    request_.version(kHttpVersion);
+    const auto method = request_.method_string();
+    const auto target = request_.target();
+    head_.append(method.data(), method.size()).append(" ").append(target.data(), target.size());
+    head_.append(" HTTP/1.1\r\nHost: ");
+    for (const auto& field : request_.base()) {
+        if (field.name() == boost::beast::http::field::host ||
+            boost::beast::iequals(field.name_string(), "X-Quick-Scheme")) {
+            continue;
+        }
+        const auto name = field.name_string();
+        const auto value = field.value();
+        tail_.append("\r\n").append(name.data(), name.size()).append(": ").append(value.data(), value.size());
+    }
+    tail_.append("\r\n\r\n").append(request_.body());
+}
+
+PreparedRequest::HttpRequest PreparedRequest::toRequest(std::string_view host) const {
+    HttpRequest request = request_;
+    request.set(boost::beast::http::field::host, boost::beast::string_view(host.data(), host.size()));
+    return request;
+}
+
+std::array<boost::asio::const_buffer, 3> PreparedRequest::buffers(std::string_view host) const noexcept {
+    return {boost::asio::buffer(head_), boost::asio::buffer(host.data(), host.size()), boost::asio::buffer(tail_)};
+}
+
+// beast::ssl_stream 会把多段缓冲拷贝进按需增长的内部缓冲区，这里直接用 asio 的 ssl::stream，
+// 请求在 scratch 中拼成一段后一次写出
+class HttpClient::WarmConnection {
+public:
+    static constexpr std::size_t kScratchBytes = 16 * 1024;
+
+    WarmConnection(boost::asio::io_context& io, boost::asio::ssl::context& ssl, std::string host)
+        : stream(io, ssl)
+        , host(std::move(host)) {
+        scratch.reserve(kScratchBytes);
+    }
+
+    boost::asio::ssl::stream<boost::beast::tcp_stream> stream;
+    boost::beast::flat_buffer buffer;
+    std::string host;
+    std::string scratch;
+};
+
 HttpClient::HttpClient(boost::asio::io_context& io, proxy::ProxyPool& pool)
     : io_(io)
     , proxyPool_(pool)
     , sslContext_(boost::asio::ssl::context::tls_client)
     , verifyCertificates_(configureSslTrustStore(sslContext_)) {}
 
+void HttpClient::overrideHost(std::string host, std::string address, std::uint16_t port) {
+    hostOverrides_.insert_or_assign(std::move(host), HostOverride{std::move(address), std::to_string(port)});
+}
+
+void HttpClient::trustCertificateAuthority(std::string_view pem) {
+    sslContext_.add_certificate_authority(boost::asio::buffer(pem.data(), pem.size()));
+}
+
+void HttpClient::startRecording(const std::filesystem::path& path) {
+    player_.reset();
+    recorder_ = std::make_unique<CassetteRecorder>(path);
+}
+
+void HttpClient::startReplay(const std::filesystem::path& path, CassetteTiming timing) {
+    recorder_.reset();
+    player_ = std::make_unique<CassettePlayer>(path, timing);
+    QG_LOG_INFO("HttpClient 回放模式：已载入 {} 条录制响应", player_->size());
+}
+
+boost::asio::ip::tcp::resolver::results_type HttpClient::resolveDirect(const std::string& host, const std::string& port) {
+    boost::asio::ip::tcp::resolver resolver(io_);
+    if (auto it = hostOverrides_.find(host); it != hostOverrides_.end()) {
+        return resolver.resolve(it->second.address, it->second.port);
+    }
+    return resolver.resolve(host, port);
+}
+
+std::shared_ptr<HttpClient::WarmConnection> HttpClient::warmUp(const std::string& host, std::chrono::seconds timeout) {
+    if (player_ || recorder_) {
+        return nullptr;
+    }
+    auto connection = std::make_shared<WarmConnection>(io_, sslContext_, host);
+    PhaseTimer phases{connection->host, nullptr};
+    auto results = resolveDirect(host, "443");
+    phases.mark("resolve");
+
+    auto& lowest = connection->stream.next_layer();
+    lowest.expires_after(timeout);
+    lowest.connect(results);
+    // 请求只有一段，关闭 Nagle 避免尾部小包等待 ACK
+    lowest.socket().set_option(boost::asio::ip::tcp::no_delay(true));
+    phases.mark("connect");
+
+    configureTlsStream(connection->stream, host, verifyCertificates_);
+    connection->stream.handshake(boost::asio::ssl::stream_base::client);
+    lowest.expires_never();
+    phases.mark("tls");
+    phases.setupDone();
+    return connection;
+}
+
+bool HttpClient::writePrepared(WarmConnection& connection, const PreparedRequest& request, std::string_view host) noexcept {
+    if (host != connection.host) {
+        return false;
+    }
+    // 等待期间对端可能已按空闲超时关闭连接。TLS 1.3 握手后服务端还会推送会话票据，
+    // 不能以“有可读数据”判断，只看对端是否已关闭写方向
+    pollfd probe{connection.stream.next_layer().socket().native_handle(), POLLRDHUP, 0};
+    if (::poll(&probe, 1, 0) < 0 || (probe.revents & (POLLRDHUP | POLLHUP | POLLERR | POLLNVAL)) != 0) {
+        return false;
+    }
+
+    const auto buffers = request.buffers(host);
+    boost::system::error_code ec;
+    if (boost::asio::buffer_size(buffers) <= connection.scratch.capacity()) {
+        connection.scratch.clear();
+        for (const auto& buffer : buffers) {
+            connection.scratch.append(static_cast<const char*>(buffer.data()), buffer.size());
+        }
+        boost::asio::write(connection.stream, boost::asio::buffer(connection.scratch), ec);
+    } else {
+        boost::asio::write(connection.stream, buffers, ec);
+    }
+    return !ec;
+}
+
+HttpClient::HttpResponse HttpClient::readPrepared(WarmConnection& connection) {
+    PhaseTimer phases{connection.host, nullptr};
+    try {
+        auto response = readResponse(connection.stream, connection.buffer, phases);
+        boost::system::error_code ec;
+        connection.stream.shutdown(ec);
+        connection.stream.next_layer().socket().close(ec);
+        phases.finish("ok");
+        return response;
+    } catch (const std::exception&) {
+        phases.finish("error");
+        throw;
+    }
+}
+
 HttpClient::HttpResponse HttpClient::fetch(HttpRequest request,
                                            const std::string& affinityKey,
                                            std::chrono::seconds timeout,
                                            bool useProxy,
                                            const proxy::ProxyEndpoint* overrideProxy)
+{
+    if (!player_ && !recorder_) {
+        return send(std::move(request), affinityKey, timeout, useProxy, overrideProxy);
+    }
+
+    const std::string method(request.method_string());
+    const std::string host(request[boost::beast::http::field::host]);
+    const std::string target(request.target());
+    if (player_) {
+        PhaseTimer phases{host, nullptr};
+        auto response = player_->play(method, host, target);
+        phases.finish("replay");
+        return response;
+    }
+
+    CassetteEntry entry;
+    entry.method = method;
+    entry.host = host;
+    entry.target = target;
+    entry.requestBody = request.body();
+    const auto started = std::chrono::steady_clock::now();
+    auto response = send(std::move(request), affinityKey, timeout, useProxy, overrideProxy);
+    entry.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    entry.status = response.result_int();
+    for (const auto& field : response.base()) {
+        entry.headers.emplace_back(std::string(field.name_string()), std::string(field.value()));
+    }
+    entry.body = response.body();
+    recorder_->append(entry);
+    return response;
+}
+
+HttpClient::HttpResponse HttpClient::send(HttpRequest request,
+                                          const std::string& affinityKey,
+                                          std::chrono::seconds timeout,
+                                          bool useProxy,
+                                          const proxy::ProxyEndpoint* overrideProxy)
 {
     request.version(kHttpVersion);
     if (request.find(boost::beast::http::field::host) == request.end()) {
@@ -283,21 +561,18 @@ HttpClient::HttpResponse HttpClient::fetch(HttpRequest request,
             proxyPtr = overrideProxy;
         } else if (useProxy && attempt < proxyAttemptLimit) {
             if (affinityKey.empty()) {
-                util::log(util::LogLevel::warn,
-                          "Proxy requested but affinity key is empty; sending directly");
+                QG_LOG_WARN("Proxy requested but affinity key is empty; sending directly");
             } else {
                 acquired = proxyPool_.acquire(affinityKey);
                 if (!acquired) {
-                    util::log(util::LogLevel::warn,
-                              "No proxy available for affinity key " + affinityKey);
+                    QG_LOG_WARN("No proxy available for affinity key {}", affinityKey);
                 } else {
                     proxyPtr = &*acquired;
                     shouldUseProxy = true;
                 }
             }
         } else if (allowDirectFallback && attempt == proxyAttemptLimit) {
-            util::log(util::LogLevel::info,
-                      "All proxy attempts failed, falling back to direct connection");
+            QG_LOG_INFO("All proxy attempts failed, falling back to direct connection");
         }
 
         auto reportSuccess = [&]() {
@@ -311,15 +586,18 @@ HttpClient::HttpResponse HttpClient::fetch(HttpRequest request,
             }
         };
 
+        PhaseTimer phases{parsed.host, shouldUseProxy ? proxyPtr : nullptr};
         try {
             if (shouldUseProxy && proxyPtr) {
                 boost::asio::ip::tcp::resolver resolver(io_);
                 auto proxyResults = resolver.resolve(proxyPtr->host, std::to_string(proxyPtr->port));
+                phases.mark("resolve");
 
                 if (parsed.scheme == "https") {
                     boost::beast::tcp_stream proxyStream(io_);
                     proxyStream.expires_after(timeout);
                     proxyStream.connect(proxyResults);
+                    phases.mark("connect");
 
                     const auto connectAuthority = connectAuthorityFrom(parsed);
                     boost::beast::http::request<boost::beast::http::empty_body> connectRequest{
@@ -338,14 +616,15 @@ HttpClient::HttpResponse HttpClient::fetch(HttpRequest request,
                     connectParser.body_limit(64 * 1024);
                     connectParser.skip(true);
                     boost::beast::http::read(proxyStream, connectBuffer, connectParser);
+                    phases.mark("proxy_connect");
 
                     const auto& connectResponse = connectParser.get();
                     if (connectResponse.result() != boost::beast::http::status::ok &&
                         connectResponse.result() != boost::beast::http::status::no_content) {
-                        util::log(util::LogLevel::warn,
-                                  "Proxy CONNECT to " + connectAuthority + " failed: " +
-                                      std::to_string(connectResponse.result_int()) + " " +
-                                      std::string(connectResponse.reason()));
+                        QG_LOG_WARN("Proxy CONNECT to {} failed: {} {}",
+                                    connectAuthority,
+                                    connectResponse.result_int(),
+                                    std::string_view(connectResponse.reason().data(), connectResponse.reason().size()));
                         throw ProxyError(ProxyError::Type::connect_failed,
                                          connectResponse.result_int(),
                                          "Proxy CONNECT failed with status " +
@@ -357,12 +636,13 @@ HttpClient::HttpResponse HttpClient::fetch(HttpRequest request,
 
                     proxyStream.expires_after(timeout);
                     tlsStream.handshake(boost::asio::ssl::stream_base::client);
+                    phases.mark("tls");
 
                     request.set(boost::beast::http::field::connection, "close");
                     boost::beast::http::write(tlsStream, request);
+                    phases.mark("write");
                     boost::beast::flat_buffer buffer;
-                    HttpResponse response;
-                    boost::beast::http::read(tlsStream, buffer, response);
+                    auto response = readResponse(tlsStream, buffer, phases);
 
                     boost::system::error_code ec;
                     tlsStream.shutdown(ec);
@@ -379,12 +659,14 @@ HttpClient::HttpResponse HttpClient::fetch(HttpRequest request,
                     }
 
                     reportSuccess();
+                    phases.finish("ok");
                     return response;
                 }
 
                 boost::beast::tcp_stream stream(io_);
                 stream.expires_after(timeout);
                 stream.connect(proxyResults);
+                phases.mark("connect");
 
                 HttpRequest proxiedRequest = request;
                 proxiedRequest.set(boost::beast::http::field::connection, "close");
@@ -394,9 +676,9 @@ HttpClient::HttpResponse HttpClient::fetch(HttpRequest request,
                 }
 
                 boost::beast::http::write(stream, proxiedRequest);
+                phases.mark("write");
                 boost::beast::flat_buffer buffer;
-                HttpResponse response;
-                boost::beast::http::read(stream, buffer, response);
+                auto response = readResponse(stream, buffer, phases);
                 boost::system::error_code ec;
                 stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
                 if (ec && ec != boost::asio::error::not_connected) {
@@ -410,26 +692,29 @@ HttpClient::HttpResponse HttpClient::fetch(HttpRequest request,
                 }
 
                 reportSuccess();
+                phases.finish("ok");
                 return response;
             }
 
-            boost::asio::ip::tcp::resolver resolver(io_);
-            auto results = resolver.resolve(parsed.host, parsed.port);
+            auto results = resolveDirect(parsed.host, parsed.port);
+            phases.mark("resolve");
 
             if (parsed.scheme == "https") {
                 boost::beast::ssl_stream<boost::beast::tcp_stream> stream(io_, sslContext_);
                 auto& lowest = boost::beast::get_lowest_layer(stream);
                 lowest.expires_after(timeout);
                 lowest.connect(results);
+                phases.mark("connect");
 
                 configureTlsStream(stream, parsed.host, verifyCertificates_);
 
                 stream.handshake(boost::asio::ssl::stream_base::client);
+                phases.mark("tls");
 
                 boost::beast::http::write(stream, request);
+                phases.mark("write");
                 boost::beast::flat_buffer buffer;
-                HttpResponse response;
-                boost::beast::http::read(stream, buffer, response);
+                auto response = readResponse(stream, buffer, phases);
 
                 boost::system::error_code ec;
                 stream.shutdown(ec);
@@ -439,43 +724,42 @@ HttpClient::HttpResponse HttpClient::fetch(HttpRequest request,
                 if (ec) {
                     throw boost::system::system_error(ec);
                 }
+                phases.finish("ok");
                 return response;
             }
 
             boost::beast::tcp_stream stream(io_);
             stream.expires_after(timeout);
             stream.connect(results);
+            phases.mark("connect");
             boost::beast::http::write(stream, request);
+            phases.mark("write");
             boost::beast::flat_buffer buffer;
-            HttpResponse response;
-            boost::beast::http::read(stream, buffer, response);
+            auto response = readResponse(stream, buffer, phases);
             boost::system::error_code ec;
             stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
             if (ec && ec != boost::asio::error::not_connected) {
                 throw boost::system::system_error(ec);
             }
+            phases.finish("ok");
             return response;
         } catch (const ProxyError& ex) {
+            phases.finish("proxy_error");
             reportFailure();
             if (!allowProxyRetries || !acquired) {
                 throw;
             }
-            util::log(util::LogLevel::warn,
-                      "Proxy attempt " + std::to_string(attempt + 1) + "/" +
-                          std::to_string(std::max(1u, proxyAttemptLimit)) +
-                          " failed with status " + std::to_string(ex.status()) +
-                          ": " + ex.what());
+            QG_LOG_WARN("Proxy attempt {}/{} failed with status {}: {}",
+                        attempt + 1, std::max(1u, proxyAttemptLimit), ex.status(), ex.what());
             lastException = std::current_exception();
             continue;
         } catch (const std::exception& ex) {
+            phases.finish("error");
             reportFailure();
             if (!allowProxyRetries || !acquired) {
                 throw;
             }
-            util::log(util::LogLevel::warn,
-                      "Proxy attempt " + std::to_string(attempt + 1) + "/" +
-                          std::to_string(std::max(1u, proxyAttemptLimit)) +
-                          " failed: " + ex.what());
+            QG_LOG_WARN("Proxy attempt {}/{} failed: {}", attempt + 1, std::max(1u, proxyAttemptLimit), ex.what());
             lastException = std::current_exception();
             continue;
         }
@@ -1,6 +1,43 @@
 #include "quickgrab/util/JsonUtil.hpp"
 
+#include <boost/json/basic_parser_impl.hpp>
+
+#include <cstdint>
+
 namespace quickgrab::util {
+namespace {
+
+// basic_parser 的空处理器：所有事件直接放行，仅借用解析器的语法检查
+struct NullHandler {
+    using error_code = boost::json::error_code;
+    using string_view = boost::json::string_view;
+
+    static constexpr std::size_t max_object_size = std::size_t(-1);
+    static constexpr std::size_t max_array_size = std::size_t(-1);
+    static constexpr std::size_t max_key_size = std::size_t(-1);
+    static constexpr std::size_t max_string_size = std::size_t(-1);
+
+    bool on_document_begin(error_code&) { return true; }
+    bool on_document_end(error_code&) { return true; }
+    bool on_object_begin(error_code&) { return true; }
+    bool on_object_end(std::size_t, error_code&) { return true; }
+    bool on_array_begin(error_code&) { return true; }
+    bool on_array_end(std::size_t, error_code&) { return true; }
+    bool on_key_part(string_view, std::size_t, error_code&) { return true; }
+    bool on_key(string_view, std::size_t, error_code&) { return true; }
+    bool on_string_part(string_view, std::size_t, error_code&) { return true; }
+    bool on_string(string_view, std::size_t, error_code&) { return true; }
+    bool on_number_part(string_view, error_code&) { return true; }
+    bool on_int64(std::int64_t, string_view, error_code&) { return true; }
+    bool on_uint64(std::uint64_t, string_view, error_code&) { return true; }
+    bool on_double(double, string_view, error_code&) { return true; }
+    bool on_bool(bool, error_code&) { return true; }
+    bool on_null(error_code&) { return true; }
+    bool on_comment_part(string_view, error_code&) { return true; }
+    bool on_comment(string_view, error_code&) { return true; }
+};
+
+} // namespace
 
 boost::json::value parseJson(const std::string& payload) {
     return boost::json::parse(payload);
@@ -10,4 +47,14 @@ std::string stringifyJson(const boost::json::value& value) {
     return boost::json::serialize(value);
 }
 
+bool isValidJson(std::string_view payload) {
+    if (payload.empty()) {
+        return false;
+    }
+    boost::json::basic_parser<NullHandler> parser{boost::json::parse_options{}};
+    boost::json::error_code ec;
+    const auto consumed = parser.write_some(false, payload.data(), payload.size(), ec);
+    return !ec && consumed == payload.size();
+}
+
 } // namespace quickgrab::util
@@ -0,0 +1,161 @@
+#include "quickgrab/util/JsonWriter.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <utility>
+
+namespace quickgrab::util {
+
+JsonWriter::JsonWriter(std::string& out)
+    : out_(out) {}
+
+void JsonWriter::setFlushHandler(std::size_t threshold, FlushHandler handler) {
+    flushThreshold_ = threshold;
+    flushHandler_ = std::move(handler);
+}
+
+void JsonWriter::separate() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (first_.empty()) {
+        return;
+    }
+    if (first_.back()) {
+        first_.back() = false;
+    } else {
+        out_.push_back(',');
+    }
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    separate();
+    out_.push_back('{');
+    first_.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    out_.push_back('}');
+    first_.pop_back();
+    maybeFlush();
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    separate();
+    out_.push_back('[');
+    first_.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    out_.push_back(']');
+    first_.pop_back();
+    maybeFlush();
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separate();
+    appendEscaped(name);
+    out_.push_back(':');
+    afterKey_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view text) {
+    separate();
+    appendEscaped(text);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::int64_t number) {
+    separate();
+    char buffer[24];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    out_.append(buffer, end);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+    separate();
+    if (!std::isfinite(number)) {
+        out_.append("null");
+        return *this;
+    }
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    out_.append(buffer, end);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    out_.append(flag ? "true" : "false");
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const boost::json::value& json) {
+    separate();
+    out_.append(boost::json::serialize(json));
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out_.append("null");
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(std::string_view json) {
+    separate();
+    out_.append(json);
+    return *this;
+}
+
+void JsonWriter::flush() {
+    if (flushHandler_ && !out_.empty()) {
+        flushHandler_(out_);
+    }
+}
+
+void JsonWriter::maybeFlush() {
+    // 只在顶层数组的元素边界上切块，保证每块都是完整的行
+    if (flushHandler_ && first_.size() <= 1 && out_.size() >= flushThreshold_) {
+        flushHandler_(out_);
+    }
+}
+
+void JsonWriter::appendEscaped(std::string_view text) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    out_.push_back('"');
+    std::size_t runStart = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const auto ch = static_cast<unsigned char>(text[i]);
+        if (ch >= 0x20 && ch != '"' && ch != '\\') {
+            continue;
+        }
+        out_.append(text.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (ch) {
+        case '"': out_.append("\\\""); break;
+        case '\\': out_.append("\\\\"); break;
+        case '\b': out_.append("\\b"); break;
+        case '\f': out_.append("\\f"); break;
+        case '\n': out_.append("\\n"); break;
+        case '\r': out_.append("\\r"); break;
+        case '\t': out_.append("\\t"); break;
+        default:
+            out_.append("\\u00");
+            out_.push_back(kHex[ch >> 4]);
+            out_.push_back(kHex[ch & 0x0F]);
+            break;
+        }
+    }
+    out_.append(text.data() + runStart, text.size() - runStart);
+    out_.push_back('"');
+}
+
+} // namespace quickgrab::util
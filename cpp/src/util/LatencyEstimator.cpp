@@ -0,0 +1,146 @@
+#include "quickgrab/util/LatencyEstimator.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace quickgrab::util {
+namespace {
+
+double percentile(std::vector<std::uint32_t>& values, double q) {
+    const auto rank = static_cast<std::size_t>(q * static_cast<double>(values.size() - 1) + 0.5);
+    auto nth = values.begin() + static_cast<std::ptrdiff_t>(std::min(rank, values.size() - 1));
+    std::nth_element(values.begin(), nth, values.end());
+    return static_cast<double>(*nth);
+}
+
+} // namespace
+
+std::string_view latencyKindName(LatencyKind kind) noexcept {
+    switch (kind) {
+    case LatencyKind::setup:
+        return "setup";
+    case LatencyKind::first_byte:
+        return "first_byte";
+    }
+    return "unknown";
+}
+
+std::string LatencyEstimator::keyFor(std::string_view host, std::string_view proxy) {
+    std::string key;
+    key.reserve(host.size() + proxy.size() + 1);
+    key.append(host).append(" ").append(proxy);
+    return key;
+}
+
+void LatencyEstimator::observe(std::string_view host, std::string_view proxy, LatencyKind kind,
+                               std::chrono::steady_clock::duration elapsed) {
+    const auto micros = std::clamp<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), 0,
+        std::numeric_limits<std::uint32_t>::max());
+    const auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto key = keyFor(host, proxy);
+    auto it = tracks_.find(key);
+    if (it == tracks_.end()) {
+        Track track;
+        track.host = std::string(host);
+        track.proxy = std::string(proxy);
+        it = tracks_.emplace(std::move(key), std::move(track)).first;
+    }
+    auto& series = it->second.kinds[static_cast<std::size_t>(kind)];
+    // 久未更新的旧水平不再代表当前网络，直接以新样本重新起算
+    if (series.count == 0 || now - series.updated > kMaxAge) {
+        series.ewmaMicros = static_cast<double>(micros);
+    } else {
+        series.ewmaMicros += kAlpha * (static_cast<double>(micros) - series.ewmaMicros);
+    }
+    series.window[series.next] = static_cast<std::uint32_t>(micros);
+    series.next = (series.next + 1) % kWindow;
+    ++series.count;
+    series.updated = now;
+}
+
+LatencySummary LatencyEstimator::summarize(const Series& series) {
+    LatencySummary summary;
+    summary.samples = series.count;
+    summary.ewmaMicros = series.ewmaMicros;
+    summary.updated = series.updated;
+    std::vector<std::uint32_t> values(series.window.begin(),
+                                      series.window.begin() + static_cast<std::ptrdiff_t>(std::min(series.count, kWindow)));
+    if (!values.empty()) {
+        summary.p50Micros = percentile(values, 0.50);
+        summary.p90Micros = percentile(values, 0.90);
+        summary.p99Micros = percentile(values, 0.99);
+    }
+    return summary;
+}
+
+const LatencyEstimator::Series* LatencyEstimator::findLocked(std::string_view host, std::string_view proxy,
+                                                             LatencyKind kind) const {
+    auto it = tracks_.find(keyFor(host, proxy));
+    if (it == tracks_.end()) {
+        return nullptr;
+    }
+    const auto& series = it->second.kinds[static_cast<std::size_t>(kind)];
+    return series.count == 0 ? nullptr : &series;
+}
+
+std::optional<LatencySummary> LatencyEstimator::summary(std::string_view host, std::string_view proxy,
+                                                        LatencyKind kind) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto* series = findLocked(host, proxy, kind);
+    if (!series) {
+        return std::nullopt;
+    }
+    return summarize(*series);
+}
+
+std::vector<LatencyEstimator::Entry> LatencyEstimator::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Entry> entries;
+    for (const auto& [key, track] : tracks_) {
+        for (std::size_t i = 0; i < track.kinds.size(); ++i) {
+            if (track.kinds[i].count == 0) {
+                continue;
+            }
+            entries.push_back(Entry{track.host, track.proxy, static_cast<LatencyKind>(i), summarize(track.kinds[i])});
+        }
+    }
+    return entries;
+}
+
+std::optional<std::chrono::microseconds> LatencyEstimator::fireLead(std::string_view host, std::string_view proxy,
+                                                                    bool warm) const {
+    const auto now = std::chrono::steady_clock::now();
+    auto usable = [&](const Series* series) {
+        return series && series->count >= kMinSamples && now - series->updated <= kMaxAge;
+    };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto* firstByte = findLocked(host, proxy, LatencyKind::first_byte);
+    if (!usable(firstByte)) {
+        return std::nullopt;
+    }
+    double lead = firstByte->ewmaMicros / 2.0;
+    if (!warm) {
+        const auto* setup = findLocked(host, proxy, LatencyKind::setup);
+        if (!usable(setup)) {
+            return std::nullopt;
+        }
+        lead += setup->ewmaMicros;
+    }
+    return std::chrono::microseconds(static_cast<std::int64_t>(lead));
+}
+
+void LatencyEstimator::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tracks_.clear();
+}
+
+LatencyEstimator& latencyEstimator() {
+    static LatencyEstimator instance;
+    return instance;
+}
+
+} // namespace quickgrab::util
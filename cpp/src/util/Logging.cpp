@@ -1,23 +1,29 @@
 #include "quickgrab/util/Logging.hpp"
+#include "quickgrab/util/DateTime.hpp"
 
-#include <ctime>
-#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <memory>
 #include <mutex>
-#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 #include <format> // C++20
 namespace quickgrab::util {
+
+std::atomic<LogLevel> detail::runtimeLevel{LogLevel::info};
+
 namespace {
 std::mutex& logMutex() {
     static std::mutex m;
     return m;
 }
 
-LogLevel& globalLevel() {
-    static LogLevel level = LogLevel::info;
-    return level;
-}
-
 const char* toString(LogLevel level) {
     switch (level) {
     case LogLevel::trace: return "TRACE";
@@ -29,40 +35,297 @@ const char* toString(LogLevel level) {
     return "INFO";
 }
 
-bool shouldLog(LogLevel level) {
-    return static_cast<int>(level) >= static_cast<int>(globalLevel());
+void appendLine(std::string& out, std::chrono::system_clock::time_point time, LogLevel level, std::string_view message) {
+    char stamp[kDateTimeMillisLength];
+    formatDateTimeMillis(time, stamp);
+    out.append(stamp, sizeof(stamp));
+    out.append(" [");
+    out.append(toString(level));
+    out.append("] ");
+    out.append(message);
+    out.push_back('\n');
 }
+
+struct LogEntry {
+    std::chrono::system_clock::time_point time;
+    LogLevel level{LogLevel::info};
+    std::string message;
+};
+
+// 有界多生产者单消费者环形队列（Vyukov 序号法），生产者只做一次 CAS，不加锁
+class LogRing {
+public:
+    explicit LogRing(std::size_t capacity)
+        : mask_(roundUp(capacity) - 1), slots_(mask_ + 1) {
+        for (std::size_t i = 0; i < slots_.size(); ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(LogEntry&& entry) {
+        auto pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& slot = slots_[pos & mask_];
+            const auto seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.entry = std::move(entry);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 仅由后台线程调用
+    bool tryPop(LogEntry& out) {
+        auto& slot = slots_[dequeuePos_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+            return false;
+        }
+        out = std::move(slot.entry);
+        slot.sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+        ++dequeuePos_;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        LogEntry entry;
+    };
+
+    static std::size_t roundUp(std::size_t value) {
+        std::size_t capacity = 2;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    const std::size_t mask_;
+    std::vector<Slot> slots_;
+    alignas(64) std::atomic<std::size_t> enqueuePos_{0};
+    alignas(64) std::size_t dequeuePos_{0};
+};
+
+// 后台写线程：批量取出消息，格式化时间戳后写文件，并按大小/时间轮转
+class AsyncSink {
+public:
+    explicit AsyncSink(LogConfig config)
+        : config_(std::move(config)), ring_(config_.queueCapacity) {
+        if (!config_.directory.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(config_.directory, ec);
+            openFile();
+        }
+        worker_ = std::thread([this]() { run(); });
+    }
+
+    ~AsyncSink() { stop(); }
+
+    bool push(LogLevel level, std::string&& message) {
+        if (ring_.tryPush(LogEntry{std::chrono::system_clock::now(), level, std::move(message)})) {
+            return true;
+        }
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void stop() {
+        if (running_.exchange(false) && worker_.joinable()) {
+            worker_.join();
+        }
+        closeFile();
+    }
+
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void run() {
+        std::string buffer;
+        buffer.reserve(64 * 1024);
+        LogEntry entry;
+        for (;;) {
+            const bool running = running_.load(std::memory_order_acquire);
+            buffer.clear();
+            std::size_t drained = 0;
+            while (drained < 4096 && ring_.tryPop(entry)) {
+                appendLine(buffer, entry.time, entry.level, entry.message);
+                entry.message = {};
+                ++drained;
+            }
+            if (auto dropped = dropped_.load(std::memory_order_relaxed); dropped != reportedDrops_) {
+                appendLine(buffer, std::chrono::system_clock::now(), LogLevel::warn,
+                           "日志队列已满，累计丢弃 " + std::to_string(dropped) + " 条日志");
+                reportedDrops_ = dropped;
+            }
+            if (!buffer.empty()) {
+                write(buffer);
+            }
+            if (drained == 0) {
+                if (!running) {
+                    break;
+                }
+                maybeRotate();
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    }
+
+    void write(const std::string& text) {
+        if (config_.console) {
+            std::fwrite(text.data(), 1, text.size(), stderr);
+        }
+        if (file_) {
+            std::fwrite(text.data(), 1, text.size(), file_);
+            std::fflush(file_);
+            fileBytes_ += text.size();
+            maybeRotate();
+        }
+    }
+
+    std::filesystem::path activePath() const {
+        return std::filesystem::path(config_.directory) / (config_.baseName + ".log");
+    }
+
+    void openFile() {
+        const auto path = activePath();
+        file_ = std::fopen(path.string().c_str(), "ab");
+        if (!file_) {
+            std::clog << "无法打开日志文件 " << path.string() << "，仅输出到控制台\n";
+            return;
+        }
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path, ec);
+        fileBytes_ = ec ? 0 : static_cast<std::size_t>(size);
+        openedAt_ = std::chrono::steady_clock::now();
+    }
+
+    void closeFile() {
+        if (file_) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    void maybeRotate() {
+        if (!file_) {
+            return;
+        }
+        const bool bySize = config_.maxFileBytes > 0 && fileBytes_ >= config_.maxFileBytes;
+        const bool byTime = config_.rotateInterval.count() > 0 && fileBytes_ > 0 &&
+                            std::chrono::steady_clock::now() - openedAt_ >= config_.rotateInterval;
+        if (!bySize && !byTime) {
+            return;
+        }
+        closeFile();
+        const auto stamp = formatCompactDateTime(std::chrono::system_clock::now());
+        auto target = std::filesystem::path(config_.directory) / (config_.baseName + "-" + stamp + ".log");
+        // 同一秒内多次轮转时追加序号，"_NN" 排在无序号文件之后，保证按名称排序即按时间排序
+        for (int suffix = 1; std::filesystem::exists(target); ++suffix) {
+            target = std::filesystem::path(config_.directory) /
+                     (config_.baseName + "-" + stamp + (suffix < 10 ? "_0" : "_") + std::to_string(suffix) + ".log");
+        }
+        std::error_code ec;
+        std::filesystem::rename(activePath(), target, ec);
+        pruneRotated();
+        openFile();
+    }
+
+    void pruneRotated() {
+        std::vector<std::filesystem::path> rotated;
+        std::error_code ec;
+        const auto prefix = config_.baseName + "-";
+        for (const auto& item : std::filesystem::directory_iterator(config_.directory, ec)) {
+            const auto name = item.path().filename().string();
+            if (name.rfind(prefix, 0) == 0 && item.path().extension() == ".log") {
+                rotated.push_back(item.path());
+            }
+        }
+        if (rotated.size() <= config_.maxFiles) {
+            return;
+        }
+        std::sort(rotated.begin(), rotated.end());
+        for (std::size_t i = 0; i + config_.maxFiles < rotated.size(); ++i) {
+            std::filesystem::remove(rotated[i], ec);
+        }
+    }
+
+    LogConfig config_;
+    LogRing ring_;
+    std::atomic<bool> running_{true};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::uint64_t reportedDrops_{0};
+    std::FILE* file_{nullptr};
+    std::size_t fileBytes_{0};
+    std::chrono::steady_clock::time_point openedAt_{};
+    std::thread worker_;
+};
+
+std::atomic<AsyncSink*>& activeSink() {
+    static std::atomic<AsyncSink*> sink{nullptr};
+    return sink;
 }
 
-void initLogging(LogLevel level) {
-    globalLevel() = level;
+// 已停止的后台实例不释放：其他线程可能刚读到指针仍在入队
+std::vector<std::unique_ptr<AsyncSink>>& sinkStorage() {
+    static std::vector<std::unique_ptr<AsyncSink>> storage;
+    return storage;
 }
 
+std::atomic<std::uint64_t>& retiredDrops() {
+    static std::atomic<std::uint64_t> drops{0};
+    return drops;
+}
+}
 
+void initLogging(LogLevel level) {
+    detail::runtimeLevel.store(level, std::memory_order_relaxed);
+}
 
-void log(LogLevel level, const std::string& message) {
-    if (!shouldLog(level)) return;
+void initLogging(const LogConfig& config) {
+    shutdownLogging();
+    initLogging(config.level);
+    auto sink = std::make_unique<AsyncSink>(config);
+    std::lock_guard lk(logMutex());
+    activeSink().store(sink.get(), std::memory_order_release);
+    sinkStorage().push_back(std::move(sink));
+}
 
-    using namespace std::chrono;
+void shutdownLogging() {
+    auto* sink = activeSink().exchange(nullptr, std::memory_order_acq_rel);
+    if (sink) {
+        sink->stop();
+        retiredDrops().fetch_add(sink->dropped(), std::memory_order_relaxed);
+    }
+}
 
-    const auto now = system_clock::now();
-    const auto sec_tp = floor<seconds>(now);
-    const auto ms = duration_cast<milliseconds>(now - sec_tp).count();
+std::uint64_t droppedLogCount() {
+    auto total = retiredDrops().load(std::memory_order_relaxed);
+    if (auto* sink = activeSink().load(std::memory_order_acquire)) {
+        total += sink->dropped();
+    }
+    return total;
+}
 
-    std::time_t t = system_clock::to_time_t(sec_tp);
-    std::tm tmBuf{};
-#ifdef _WIN32
-    localtime_s(&tmBuf, &t);
-#else
-    localtime_r(&t, &tmBuf);
-#endif
+void log(LogLevel level, std::string message) {
+    if (static_cast<int>(level) < static_cast<int>(detail::runtimeLevel.load(std::memory_order_relaxed))) return;
 
-    std::ostringstream oss;
-    oss << std::put_time(&tmBuf, "%Y-%m-%d %H:%M:%S")
-        << '.' << std::setw(3) << std::setfill('0') << ms;
+    if (auto* sink = activeSink().load(std::memory_order_acquire)) {
+        sink->push(level, std::move(message));
+        return;
+    }
 
+    std::string line;
+    appendLine(line, std::chrono::system_clock::now(), level, message);
     std::lock_guard lk(logMutex());
-    std::clog << oss.str() << " [" << toString(level) << "] " << message << '\n';
+    std::clog << line;
 }
 
 
@@ -0,0 +1,322 @@
+#include "quickgrab/util/Metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <mutex>
+#include <stdexcept>
+
+namespace quickgrab::util {
+namespace {
+
+// 暴露给 Prometheus 的 le 边界（秒）。内部桶更细，这里按 1-2.5-5 取点，便于 histogram_quantile 计算
+constexpr std::array<double, 20> kExpositionBounds{
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1,
+    0.25,   0.5,     1.0,    2.5,   5.0,    10.0,  25.0, 50.0,  100.0, 300.0};
+
+const char* typeName(int type) {
+    switch (type) {
+    case 0: return "counter";
+    case 1: return "gauge";
+    default: return "histogram";
+    }
+}
+
+void appendEscaped(std::string& out, std::string_view value, bool help) {
+    for (char ch : value) {
+        switch (ch) {
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '"':
+            if (help) {
+                out.push_back(ch);
+            } else {
+                out.append("\\\"");
+            }
+            break;
+        default: out.push_back(ch); break;
+        }
+    }
+}
+
+void appendNumber(std::string& out, std::uint64_t value) {
+    char buffer[24];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, end);
+}
+
+void appendNumber(std::string& out, std::int64_t value) {
+    char buffer[24];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, end);
+}
+
+void appendNumber(std::string& out, double value) {
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, end);
+}
+
+// name{k="v",...,extraKey="extraValue"}
+void appendSeriesName(std::string& out,
+                      std::string_view name,
+                      std::string_view suffix,
+                      const std::vector<std::pair<std::string, std::string>>& labels,
+                      std::string_view extraKey = {},
+                      std::string_view extraValue = {}) {
+    out.append(name);
+    out.append(suffix);
+    if (labels.empty() && extraKey.empty()) {
+        return;
+    }
+    out.push_back('{');
+    bool first = true;
+    auto appendLabel = [&](std::string_view key, std::string_view value) {
+        if (!first) {
+            out.push_back(',');
+        }
+        first = false;
+        out.append(key);
+        out.append("=\"");
+        appendEscaped(out, value, false);
+        out.push_back('"');
+    };
+    for (const auto& [key, value] : labels) {
+        appendLabel(key, value);
+    }
+    if (!extraKey.empty()) {
+        appendLabel(extraKey, extraValue);
+    }
+    out.push_back('}');
+}
+
+std::string& keyBuffer() {
+    thread_local std::string buffer;
+    return buffer;
+}
+
+} // namespace
+
+namespace detail {
+std::size_t metricShard() noexcept {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t shard = next.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+} // namespace detail
+
+std::uint64_t Counter::value() const noexcept {
+    std::uint64_t total = 0;
+    for (const auto& cell : cells_) {
+        total += cell.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::size_t Histogram::bucketFor(std::uint64_t micros) noexcept {
+    if (micros < kSubBuckets) {
+        return static_cast<std::size_t>(micros);
+    }
+    const auto exponent = static_cast<std::size_t>(std::bit_width(micros) - 1);
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    const auto group = exponent - 3;
+    const auto sub = static_cast<std::size_t>(micros >> group) - kSubBuckets;
+    return kSubBuckets + group * kSubBuckets + sub;
+}
+
+std::uint64_t Histogram::bucketUpperBound(std::size_t index) noexcept {
+    if (index < kSubBuckets) {
+        return index + 1;
+    }
+    const auto group = (index - kSubBuckets) / kSubBuckets;
+    const auto sub = (index - kSubBuckets) % kSubBuckets;
+    return static_cast<std::uint64_t>(kSubBuckets + sub + 1) << group;
+}
+
+Histogram::Snapshot Histogram::snapshot() const noexcept {
+    Snapshot result;
+    for (const auto& shard : shards_) {
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            result.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        result.count += shard.count.load(std::memory_order_relaxed);
+        result.sumMicros += shard.sumMicros.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+double Histogram::Snapshot::quantileMicros(double q) const noexcept {
+    std::uint64_t total = 0;
+    for (auto value : buckets) {
+        total += value;
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+    const auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(total - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            const auto upper = bucketUpperBound(i);
+            const auto lower = i == 0 ? 0 : bucketUpperBound(i - 1);
+            return (static_cast<double>(lower) + static_cast<double>(upper)) / 2.0;
+        }
+    }
+    return static_cast<double>(bucketUpperBound(kBucketCount - 1));
+}
+
+MetricsRegistry::Series& MetricsRegistry::resolve(Type type,
+                                                  std::string_view name,
+                                                  std::string_view help,
+                                                  MetricLabels labels) {
+    auto& key = keyBuffer();
+    key.clear();
+    for (const auto& [labelKey, labelValue] : labels) {
+        key.append(labelKey);
+        key.push_back('=');
+        key.append(labelValue);
+        key.push_back('\x1f');
+    }
+
+    {
+        std::shared_lock lock(mutex_);
+        if (auto family = families_.find(name); family != families_.end()) {
+            if (auto series = family->second.series.find(std::string_view{key}); series != family->second.series.end()) {
+                return series->second;
+            }
+        }
+    }
+
+    std::unique_lock lock(mutex_);
+    auto family = families_.find(name);
+    if (family == families_.end()) {
+        family = families_.emplace(std::string(name), Family{}).first;
+        family->second.type = type;
+        family->second.help = std::string(help);
+    }
+    auto& seriesMap = family->second.series;
+    if (auto series = seriesMap.find(std::string_view{key}); series != seriesMap.end()) {
+        return series->second;
+    }
+
+    Series series;
+    if (seriesMap.size() >= kMaxSeries && labels.size() > 0) {
+        key.clear();
+        for (const auto& [labelKey, labelValue] : labels) {
+            key.append(labelKey);
+            key.append("=other\x1f");
+            series.labels.emplace_back(std::string(labelKey), "other");
+        }
+        if (auto overflow = seriesMap.find(std::string_view{key}); overflow != seriesMap.end()) {
+            return overflow->second;
+        }
+    } else {
+        for (const auto& [labelKey, labelValue] : labels) {
+            series.labels.emplace_back(std::string(labelKey), std::string(labelValue));
+        }
+    }
+    switch (family->second.type) {
+    case Type::counter: series.counter = std::make_unique<Counter>(); break;
+    case Type::gauge: series.gauge = std::make_unique<Gauge>(); break;
+    case Type::histogram: series.histogram = std::make_unique<Histogram>(); break;
+    }
+    return seriesMap.emplace(key, std::move(series)).first->second;
+}
+
+Counter& MetricsRegistry::counter(std::string_view name, std::string_view help, MetricLabels labels) {
+    auto& series = resolve(Type::counter, name, help, labels);
+    if (!series.counter) {
+        throw std::logic_error("metric " + std::string(name) + " 已注册为其他类型");
+    }
+    return *series.counter;
+}
+
+Gauge& MetricsRegistry::gauge(std::string_view name, std::string_view help, MetricLabels labels) {
+    auto& series = resolve(Type::gauge, name, help, labels);
+    if (!series.gauge) {
+        throw std::logic_error("metric " + std::string(name) + " 已注册为其他类型");
+    }
+    return *series.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(std::string_view name, std::string_view help, MetricLabels labels) {
+    auto& series = resolve(Type::histogram, name, help, labels);
+    if (!series.histogram) {
+        throw std::logic_error("metric " + std::string(name) + " 已注册为其他类型");
+    }
+    return *series.histogram;
+}
+
+std::string MetricsRegistry::renderPrometheus() const {
+    std::string out;
+    out.reserve(64 * 1024);
+    std::shared_lock lock(mutex_);
+    for (const auto& [name, family] : families_) {
+        out.append("# HELP ");
+        out.append(name);
+        out.push_back(' ');
+        appendEscaped(out, family.help, true);
+        out.append("\n# TYPE ");
+        out.append(name);
+        out.push_back(' ');
+        out.append(typeName(static_cast<int>(family.type)));
+        out.push_back('\n');
+
+        for (const auto& [key, series] : family.series) {
+            if (series.counter) {
+                appendSeriesName(out, name, {}, series.labels);
+                out.push_back(' ');
+                appendNumber(out, series.counter->value());
+                out.push_back('\n');
+            } else if (series.gauge) {
+                appendSeriesName(out, name, {}, series.labels);
+                out.push_back(' ');
+                appendNumber(out, series.gauge->value());
+                out.push_back('\n');
+            } else if (series.histogram) {
+                const auto snapshot = series.histogram->snapshot();
+                std::size_t bucket = 0;
+                std::uint64_t cumulative = 0;
+                for (double bound : kExpositionBounds) {
+                    const auto boundMicros = static_cast<std::uint64_t>(bound * 1e6);
+                    while (bucket < Histogram::kBucketCount && Histogram::bucketUpperBound(bucket) <= boundMicros) {
+                        cumulative += snapshot.buckets[bucket++];
+                    }
+                    char le[32];
+                    auto [end, ec] = std::to_chars(le, le + sizeof(le), bound);
+                    appendSeriesName(out, name, "_bucket", series.labels, "le", std::string_view(le, end - le));
+                    out.push_back(' ');
+                    appendNumber(out, cumulative);
+                    out.push_back('\n');
+                }
+                // 各分片的计数与桶非原子地一起读取，总数以桶为准，保证 +Inf 与各桶一致
+                while (bucket < Histogram::kBucketCount) {
+                    cumulative += snapshot.buckets[bucket++];
+                }
+                appendSeriesName(out, name, "_bucket", series.labels, "le", "+Inf");
+                out.push_back(' ');
+                appendNumber(out, cumulative);
+                out.push_back('\n');
+                appendSeriesName(out, name, "_sum", series.labels);
+                out.push_back(' ');
+                appendNumber(out, static_cast<double>(snapshot.sumMicros) / 1e6);
+                out.push_back('\n');
+                appendSeriesName(out, name, "_count", series.labels);
+                out.push_back(' ');
+                appendNumber(out, cumulative);
+                out.push_back('\n');
+            }
+        }
+    }
+    return out;
+}
+
+MetricsRegistry& metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+} // namespace quickgrab::util
@@ -0,0 +1,183 @@
+#include "quickgrab/util/Timeline.hpp"
+#include "quickgrab/util/DateTime.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace quickgrab::util {
+namespace {
+constexpr std::size_t kMaxRecentTimelines = 256;
+
+std::int64_t micros(std::chrono::steady_clock::duration value) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(value).count();
+}
+
+// Chrome trace 的 ts 以进程内固定起点计，不同请求的时间线可以对齐比较
+std::chrono::steady_clock::time_point traceEpoch() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return epoch;
+}
+
+GrabTimeline*& currentSlot() {
+    thread_local GrabTimeline* current = nullptr;
+    return current;
+}
+
+struct RecentTimelines {
+    std::mutex mutex;
+    std::deque<std::shared_ptr<const GrabTimeline>> items;
+};
+
+RecentTimelines& recent() {
+    static RecentTimelines store;
+    return store;
+}
+} // namespace
+
+GrabTimeline::GrabTimeline(int requestId)
+    : requestId_(requestId)
+    , origin_(Clock::now())
+    , wallOrigin_(std::chrono::system_clock::now()) {
+    traceEpoch();
+    events_.reserve(32);
+}
+
+void GrabTimeline::push(Event event) {
+    if (events_.size() >= kMaxEvents) {
+        ++dropped_;
+        return;
+    }
+    events_.push_back(std::move(event));
+}
+
+void GrabTimeline::mark(const char* name, std::string detail) {
+    const auto now = Clock::now();
+    push(Event{name, now, now, std::move(detail), true});
+}
+
+void GrabTimeline::span(const char* name, Clock::time_point start, Clock::time_point end, std::string detail) {
+    push(Event{name, start, end, std::move(detail), false});
+}
+
+boost::json::object GrabTimeline::toJson() const {
+    // 区间在结束时才写入，按开始时刻重排后再输出
+    std::vector<const Event*> ordered;
+    ordered.reserve(events_.size());
+    for (const auto& event : events_) {
+        ordered.push_back(&event);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(), [](const Event* lhs, const Event* rhs) {
+        return lhs->start < rhs->start;
+    });
+
+    boost::json::array events;
+    events.reserve(ordered.size());
+    for (const auto* entry : ordered) {
+        const auto& event = *entry;
+        boost::json::object item;
+        item["name"] = event.name;
+        item["atUs"] = micros(event.start - origin_);
+        if (!event.instant) {
+            item["durUs"] = micros(event.end - event.start);
+        }
+        if (!event.detail.empty()) {
+            item["detail"] = event.detail;
+        }
+        events.push_back(std::move(item));
+    }
+    boost::json::object timeline;
+    timeline["startedAt"] = formatDateTimeMillis(wallOrigin_);
+    timeline["events"] = std::move(events);
+    if (dropped_ > 0) {
+        timeline["droppedEvents"] = static_cast<std::int64_t>(dropped_);
+    }
+    return timeline;
+}
+
+void GrabTimeline::appendTraceEvents(JsonWriter& writer) const {
+    const auto epoch = traceEpoch();
+    writer.beginObject()
+        .key("name").value(std::string_view{"thread_name"})
+        .key("ph").value(std::string_view{"M"})
+        .key("pid").value(std::int64_t{1})
+        .key("tid").value(static_cast<std::int64_t>(requestId_))
+        .key("args").beginObject().key("name").value("请求 " + std::to_string(requestId_)).endObject()
+        .endObject();
+    for (const auto& event : events_) {
+        writer.beginObject()
+            .key("name").value(std::string_view{event.name})
+            .key("ph").value(std::string_view{event.instant ? "i" : "X"})
+            .key("pid").value(std::int64_t{1})
+            .key("tid").value(static_cast<std::int64_t>(requestId_))
+            .key("ts").value(micros(event.start - epoch));
+        if (event.instant) {
+            writer.key("s").value(std::string_view{"t"});
+        } else {
+            writer.key("dur").value(micros(event.end - event.start));
+        }
+        if (!event.detail.empty()) {
+            writer.key("args").beginObject().key("detail").value(std::string_view{event.detail}).endObject();
+        }
+        writer.endObject();
+    }
+}
+
+TimelineSpan::TimelineSpan(GrabTimeline* timeline, const char* name, std::string detail)
+    : timeline_(timeline), name_(name), detail_(std::move(detail)), start_(GrabTimeline::Clock::now()) {}
+
+TimelineSpan::~TimelineSpan() {
+    if (timeline_) {
+        timeline_->span(name_, start_, GrabTimeline::Clock::now(), std::move(detail_));
+    }
+}
+
+GrabTimeline* currentTimeline() noexcept {
+    return currentSlot();
+}
+
+TimelineScope::TimelineScope(GrabTimeline* timeline) noexcept
+    : previous_(std::exchange(currentSlot(), timeline)) {}
+
+TimelineScope::~TimelineScope() {
+    currentSlot() = previous_;
+}
+
+void recordTimeline(std::shared_ptr<const GrabTimeline> timeline) {
+    if (!timeline) {
+        return;
+    }
+    auto& store = recent();
+    std::lock_guard<std::mutex> lock(store.mutex);
+    store.items.push_back(std::move(timeline));
+    if (store.items.size() > kMaxRecentTimelines) {
+        store.items.pop_front();
+    }
+}
+
+std::vector<std::shared_ptr<const GrabTimeline>> recentTimelines(std::size_t limit, std::optional<int> requestId) {
+    std::vector<std::shared_ptr<const GrabTimeline>> result;
+    auto& store = recent();
+    std::lock_guard<std::mutex> lock(store.mutex);
+    for (auto it = store.items.rbegin(); it != store.items.rend() && result.size() < limit; ++it) {
+        if (!requestId || (*it)->requestId() == *requestId) {
+            result.push_back(*it);
+        }
+    }
+    return result;
+}
+
+std::string chromeTraceJson(const std::vector<std::shared_ptr<const GrabTimeline>>& timelines) {
+    std::string out;
+    out.reserve(256 + timelines.size() * 2048);
+    JsonWriter writer(out);
+    writer.beginObject().key("traceEvents").beginArray();
+    for (const auto& timeline : timelines) {
+        timeline->appendTraceEvents(writer);
+    }
+    writer.endArray().key("displayTimeUnit").value(std::string_view{"ms"}).endObject();
+    return out;
+}
+
+} // namespace quickgrab::util
@@ -1,6 +1,10 @@
 #include "quickgrab/workflow/GrabWorkflow.hpp"
+#include "quickgrab/util/ClockSync.hpp"
 #include "quickgrab/util/CommonUtil.hpp"
+#include "quickgrab/util/DomainScoreboard.hpp"
 #include "quickgrab/util/JsonUtil.hpp"
+#include "quickgrab/util/LatencyEstimator.hpp"
+#include "quickgrab/util/Metrics.hpp"
 #include "quickgrab/util/WeidianParser.hpp"
 
 #include <algorithm>
@@ -17,11 +21,20 @@
 #include <boost/beast/http.hpp>
 #include <boost/json.hpp>
 #include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
 #include <iostream>
 
 namespace quickgrab::workflow {
 namespace {
 constexpr int kMaxRetries = 3;
+// 首个 CreateOrder 固定发往的域名；命名空间级常量，开抢时不会触发静态初始化
+const std::string kFireDomain{"thor.weidian.com"};
+// 开抢前多久建立直连：太早会被上游按空闲连接关闭
+constexpr std::chrono::seconds kConnectionWarmLead{2};
+// 开抢后参数刷新最多持续的时长，防止异常情况下刷新任务残留
+constexpr std::chrono::seconds kRefreshAfterFire{60};
+// 参数刷新线程数：刷新是阻塞的加购页请求，与开抢所用的 worker 隔离
+constexpr std::size_t kRefreshThreads = 2;
 constexpr char kUserAgent[] = "Android/9 WDAPP(WDBuyer/7.6.2) Thor/2.3.25";
 constexpr char kReferer[] = "https://android.weidian.com/";
 constexpr char kDesktopUA[] =
@@ -40,6 +53,9 @@ constexpr std::array<std::string_view, 11> kRetryKeywords{
     "啊哦~ 人潮拥挤，请稍后重试~",
     "请升级到最新版本后重试"};
 
+// 上游过载时的提示，计入域名计分板的繁忙率
+constexpr std::array<std::string_view, 2> kBusyKeywords{"拥挤", "开小差"};
+
 constexpr std::array<std::string_view, 12> kUpdateKeywords{
     "确认",
     "地址",
@@ -54,16 +70,23 @@ constexpr std::array<std::string_view, 12> kUpdateKeywords{
     "系统开小差，请稍后重试",
     "自提点地址不能为空"};
 
-std::string randomDomain(const boost::json::object& extension) {
+// 按共享计分板从扩展字段的 domains 中加权选取，慢或常拥挤的域名被选中的机会更少
+std::string pickDomain(const boost::json::object& extension) {
     if (auto it = extension.if_contains("domains")) {
         if (it->is_array() && !it->as_array().empty()) {
-            static thread_local std::mt19937 rng{std::random_device{}()};
-            const auto& arr = it->as_array();
-            std::uniform_int_distribution<std::size_t> dist(0, arr.size() - 1);
-            return arr.at(dist(rng)).as_string().c_str();
+            std::vector<std::string_view> candidates;
+            candidates.reserve(it->as_array().size());
+            for (const auto& domain : it->as_array()) {
+                if (domain.is_string() && !domain.as_string().empty()) {
+                    candidates.emplace_back(domain.as_string().data(), domain.as_string().size());
+                }
+            }
+            if (!candidates.empty()) {
+                return std::string(candidates[util::domainScoreboard().pick(candidates)]);
+            }
         }
     }
-    return "thor.weidian.com";
+    return kFireDomain;
 }
 
 template <std::size_t N>
@@ -76,15 +99,92 @@ bool containsKeyword(std::string_view message, const std::array<std::string_view
     return false;
 }
 
+// 已挂到 worker 定时器上尚未开始的任务数
+util::Gauge& scheduledTasks() {
+    static auto& gauge = util::metrics().gauge("quickgrab_worker_tasks", "Grab tasks on the worker pool by state",
+                                               {{"state", "scheduled"}});
+    return gauge;
+}
+
+// 在 worker 线程上执行期间计入 running
+class RunningTaskScope {
+public:
+    RunningTaskScope() { gauge().add(1); }
+    ~RunningTaskScope() { gauge().add(-1); }
+    RunningTaskScope(const RunningTaskScope&) = delete;
+    RunningTaskScope& operator=(const RunningTaskScope&) = delete;
+
+private:
+    static util::Gauge& gauge() {
+        static auto& running = util::metrics().gauge("quickgrab_worker_tasks", "Grab tasks on the worker pool by state",
+                                                     {{"state", "running"}});
+        return running;
+    }
+};
+
+// 定时器实际触发时刻与目标时刻之差：包含定时器精度与 worker 池排队时间
+void recordFireError(const GrabContext& ctx,
+                     std::chrono::steady_clock::time_point target,
+                     std::chrono::steady_clock::time_point fired) {
+    static auto& histogram = util::metrics().histogram(
+        "quickgrab_grab_fire_error_seconds", "Lateness of the first CreateOrder relative to its scheduled time");
+    const auto lateness = fired - target;
+    histogram.observe(lateness);
+    if (ctx.timeline) {
+        ctx.timeline->mark("fire",
+                           "late " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(lateness).count()) +
+                               "us");
+    }
+}
+
+// outcome: success / update / retry / rejected / invalid_response / proxy_error / error
+void recordCreateOrder(const GrabContext& ctx, std::string_view outcome, std::chrono::steady_clock::time_point started) {
+    if (ctx.timeline) {
+        ctx.timeline->mark("classified", std::string(outcome));
+    }
+    auto& registry = util::metrics();
+    registry.counter("quickgrab_create_order_total", "CreateOrder calls by classified outcome", {{"outcome", outcome}})
+        .inc();
+    registry
+        .histogram("quickgrab_create_order_duration_seconds", "CreateOrder round trip by classified outcome",
+                   {{"outcome", outcome}})
+        .observe(std::chrono::steady_clock::now() - started);
+}
+
+// 首个 CreateOrder 按实测时延应提前的时长。直连走预热连接只需单程时延；指定代理时另加建连耗时；
+// 经代理池（未指定代理）时出口不确定，不做估计
+std::optional<std::chrono::microseconds> estimateFireLead(bool useProxy,
+                                                         const std::optional<proxy::ProxyEndpoint>& assignedProxy) {
+    if (assignedProxy) {
+        const auto proxy = assignedProxy->host + ":" + std::to_string(assignedProxy->port);
+        return util::latencyEstimator().fireLead(kFireDomain, proxy, false);
+    }
+    if (useProxy) {
+        return std::nullopt;
+    }
+    return util::latencyEstimator().fireLead(kFireDomain, "direct", true);
+}
+
+// 与 GrabService 记录的调度使用同一组输入：路由与上报时延（__adjustedFactor）
 long computeDelay(const GrabContext& ctx) {
-    const auto now = std::chrono::system_clock::now();
-    const auto start = ctx.request.startTime;
-    auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(start - now).count();
-    const auto needDelay = ctx.request.delay;
-    long delay = static_cast<long>(needDelay /*- ctx.adjustedFactor - ctx.processingTime*/);
-    long advanceMs = 100; //提前启动
-    long timeRemaining = std::max<long>(0, static_cast<long>(delta) + delay - advanceMs);
-    return timeRemaining;
+    const auto lead = GrabWorkflow::fireLead(ctx.useProxy, ctx.assignedProxy, ctx.adjustedFactor);
+    return static_cast<long>(GrabWorkflow::fireDelay(ctx.request, lead.lead, std::chrono::system_clock::now()).count());
+}
+
+// ReConfirmOrder 的 result.access_time 是上游处理请求时的毫秒时间戳
+void sampleAccessTime(const std::string& host,
+                      std::chrono::system_clock::time_point sent,
+                      std::chrono::system_clock::time_point received,
+                      const boost::json::value& response) {
+    const auto* obj = response.if_object();
+    const auto* result = obj ? obj->if_contains("result") : nullptr;
+    const auto* resultObj = result ? result->if_object() : nullptr;
+    const auto* access = resultObj ? resultObj->if_contains("access_time") : nullptr;
+    if (!access || !access->is_int64() || access->as_int64() <= 0) {
+        return;
+    }
+    const std::chrono::system_clock::time_point serverTime{std::chrono::milliseconds(access->as_int64())};
+    util::clockSync().observe(host, sent, received, serverTime, std::chrono::milliseconds{1}, "access_time");
 }
 
 boost::json::object parseExtension(const model::Request& request) {
@@ -159,24 +259,25 @@ std::string resolveAffinity(const boost::json::object& extension) {
     }
     return {};
 }
-
-std::string toQuery(const std::string& payload) {
-    std::string encoded;
-    encoded.reserve(payload.size() * 2);
-    static constexpr char hex[] = "0123456789ABCDEF";
-    for (unsigned char c : payload) {
-        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
-            encoded.push_back(static_cast<char>(c));
-        } else {
-            encoded.push_back('%');
-            encoded.push_back(hex[c >> 4]);
-            encoded.push_back(hex[c & 0x0F]);
-        }
-    }
-    return "param=" + encoded;
-}
 }
 
+struct GrabWorkflow::ParameterRefresh {
+    explicit ParameterRefresh(boost::asio::thread_pool::executor_type executor)
+        : strand(boost::asio::make_strand(executor))
+        , timer(strand) {}
+
+    // 抢购上下文的副本，不带时间线：刷新与抢购线程并发执行
+    GrabContext ctx;
+    std::shared_ptr<OrderParametersSlot> slot;
+    // 定时器与以下状态只在 strand 上访问
+    boost::asio::strand<boost::asio::thread_pool::executor_type> strand;
+    boost::asio::steady_timer timer;
+    std::chrono::steady_clock::time_point fireAt;
+    // 每次重新布置定时器加一，已被取代的回调直接返回
+    std::uint64_t generation{0};
+    std::chrono::steady_clock::time_point lastRefreshed{};
+};
+
 GrabWorkflow::GrabWorkflow(boost::asio::io_context& io,
                            boost::asio::thread_pool& worker,
                            util::HttpClient& httpClient,
@@ -184,12 +285,14 @@ GrabWorkflow::GrabWorkflow(boost::asio::io_context& io,
     : io_(io)
     , worker_(worker)
     , httpClient_(httpClient)
-    , proxyPool_(proxyPool) {}
+    , proxyPool_(proxyPool)
+    , refreshPool_(kRefreshThreads) {}
 
 void GrabWorkflow::run(const model::Request& request,
                        std::function<void(const GrabResult&)> onFinished) {
     GrabContext ctx;
     prepareContext(request, ctx);
+    ctx.timeline = std::make_shared<util::GrabTimeline>(request.id);
     const bool pickMode = (request.type == 3) || ctx.autoPick;
     if (pickMode) {
         schedulePick(std::move(ctx), std::move(onFinished));
@@ -198,10 +301,39 @@ void GrabWorkflow::run(const model::Request& request,
     }
 }
 
+void GrabWorkflow::setParameterRefresh(ParameterRefreshConfig config) {
+    refreshConfig_ = config;
+}
+
+void GrabWorkflow::setFireProbe(std::function<void(bool written)> probe) {
+    fireProbe_ = std::move(probe);
+}
+
+const std::string& GrabWorkflow::fireDomain() {
+    return kFireDomain;
+}
+
+FireLead GrabWorkflow::fireLead(bool useProxy, const std::optional<proxy::ProxyEndpoint>& assignedProxy,
+                                long reportedMs) {
+    if (const auto lead = estimateFireLead(useProxy, assignedProxy)) {
+        return FireLead{std::chrono::duration_cast<std::chrono::milliseconds>(*lead), true};
+    }
+    return FireLead{std::chrono::milliseconds(std::max<long>(0, reportedMs)), false};
+}
+
+std::chrono::milliseconds GrabWorkflow::fireDelay(const model::Request& request,
+                                                  std::chrono::milliseconds lead,
+                                                  std::chrono::system_clock::time_point now) {
+    // 开售时刻按上游时钟给出，换算为本机时刻后再计时
+    const auto start = util::clockSync().toLocal(kFireDomain, request.startTime);
+    const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(start - now);
+    return std::max(std::chrono::milliseconds::zero(), delta + std::chrono::milliseconds(request.delay) - lead);
+}
+
 void GrabWorkflow::prepareContext(const model::Request& request, GrabContext& ctx) {
     ctx.request = request;
     ctx.extension = parseExtension(request);
-    ctx.domain = randomDomain(ctx.extension);
+    ctx.domain = pickDomain(ctx.extension);
     ctx.start = std::chrono::steady_clock::now();
     ctx.quickMode = tryGetBool(ctx.extension, "quickMode", false);
     ctx.steadyOrder = tryGetBool(ctx.extension, "steadyOrder", false);
@@ -282,11 +414,17 @@ void GrabWorkflow::prepareContext(const model::Request& request, GrabContext& ct
     }
 }
 
-GrabResult GrabWorkflow::createOrder(const GrabContext& ctx, const boost::json::object& payload) {
+GrabResult GrabWorkflow::createOrder(const GrabContext& ctx,
+                                     const std::string& domain,
+                                     const boost::json::object& payload) {
+    const auto started = std::chrono::steady_clock::now();
+    util::TimelineSpan span(ctx.timeline.get(), "create_order", domain);
     GrabResult result;
-    auto requestBody = quickgrab::util::stringifyJson(payload);
-
-    auto req = buildPost("https://" + ctx.domain + "/vbuy/CreateOrder/1.0", ctx, toQuery(requestBody));
+    // 参数未变时复用预先序列化的请求，省去每次的 stringifyJson/toQuery/buildPost
+    auto req = ctx.preparedOrder
+                   ? ctx.preparedOrder->toRequest(domain)
+                   : buildPost("https://" + domain + "/vbuy/CreateOrder/1.0", ctx,
+                               util::toQuery(quickgrab::util::stringifyJson(payload)));
     bool useProxy = ctx.useProxy;
     std::optional<proxy::ProxyEndpoint> overrideProxy = ctx.assignedProxy;
     const std::string& affinity = ctx.proxyAffinity.empty() ? ctx.request.threadId : ctx.proxyAffinity;
@@ -297,76 +435,136 @@ GrabResult GrabWorkflow::createOrder(const GrabContext& ctx, const boost::json::
             std::chrono::seconds{ 30 },
             useProxy,
             overrideProxy ? &*overrideProxy : nullptr);
-        result.statusCode = static_cast<int>(response.result());
+        classifyCreateOrder(ctx, domain, response, result, started);
+    }
+    catch (const std::exception& ex) {
+        recordCreateOrder(ctx, dynamic_cast<const util::ProxyError*>(&ex) ? "proxy_error" : "error", started);
+        QG_LOG_WARN("CreateOrder failed: {}", ex.what());
+        result.success = false;
+        result.error = ex.what();
+        result.message.clear();
+    }
 
-        auto json = quickgrab::util::parseJson(response.body());
-        result.response = json;
-        result.attempts = 1;
+    return result;
+}
 
-        if (json.is_object()) {
-            const auto& obj = json.as_object();
-            if (auto* status = obj.if_contains("status"); status && status->is_object()) {
-                const auto& statusObj = status->as_object();
-                if (auto* description = statusObj.if_contains("description"); description && description->is_string()) {
-                    result.description = std::string(description->as_string());
-                }
-                if (auto* message = statusObj.if_contains("message"); message && message->is_string()) {
-                    result.message = std::string(message->as_string());
-                }
-                if (auto* code = statusObj.if_contains("code"); code && code->is_int64()) {
-                    result.statusCode = static_cast<int>(code->as_int64());
-                }
-            }
+// 首个 CreateOrder 固定发往 thor。持有预热连接时直接写出预序列化的请求：从定时器触发到写出之间
+// 不做堆分配，触发偏差、时间线与指标都在写出之后补记；连接不可用时退回普通路径
+GrabResult GrabWorkflow::fireCreateOrder(GrabContext& ctx,
+                                         std::chrono::steady_clock::time_point fired,
+                                         std::chrono::steady_clock::time_point target) {
+    auto warm = std::move(ctx.warmConnection);
+    auto prepared = ctx.preparedOrder;
+    if (ctx.freshParameters) {
+        std::lock_guard<std::mutex> lock(ctx.freshParameters->mutex);
+        prepared = ctx.freshParameters->prepared;
+    }
+    if (warm && prepared && httpClient_.writePrepared(*warm, *prepared, kFireDomain)) {
+        if (fireProbe_) {
+            fireProbe_(true);
+        }
+        recordFireError(ctx, target, fired);
+        // JSON 参数在写出之后再同步，供重试与 ReConfirm 使用
+        adoptRefreshedParameters(ctx);
+        GrabResult result;
+        try {
+            auto response = httpClient_.readPrepared(*warm);
+            classifyCreateOrder(ctx, kFireDomain, response, result, fired);
+        }
+        catch (const std::exception& ex) {
+            recordCreateOrder(ctx, "error", fired);
+            QG_LOG_WARN("CreateOrder failed: {}", ex.what());
+            result.success = false;
+            result.error = ex.what();
+            result.message.clear();
+        }
+        if (ctx.timeline) {
+            ctx.timeline->span("create_order", fired, std::chrono::steady_clock::now(), kFireDomain + " warm");
+        }
+        return result;
+    }
 
-            bool success = false;
-            if (auto* isSuccess = obj.if_contains("isSuccess"); isSuccess && isSuccess->is_int64()) {
-                success = isSuccess->as_int64() == 1;
+    if (warm) {
+        QG_LOG_INFO("请求ID={} 预热连接已不可用，改为新建连接下单", ctx.request.id);
+    }
+    recordFireError(ctx, target, fired);
+    adoptRefreshedParameters(ctx);
+    return createOrder(ctx, kFireDomain, ctx.request.orderParameters.as_object());
+}
+
+void GrabWorkflow::classifyCreateOrder(const GrabContext& ctx,
+                                       std::string_view domain,
+                                       const util::HttpClient::HttpResponse& response,
+                                       GrabResult& result,
+                                       std::chrono::steady_clock::time_point started) const {
+    result.statusCode = static_cast<int>(response.result());
+
+    auto json = quickgrab::util::parseJson(response.body());
+    if (ctx.timeline) {
+        ctx.timeline->mark("parsed");
+    }
+    result.response = json;
+    result.attempts = 1;
+
+    if (json.is_object()) {
+        const auto& obj = json.as_object();
+        if (auto* status = obj.if_contains("status"); status && status->is_object()) {
+            const auto& statusObj = status->as_object();
+            if (auto* description = statusObj.if_contains("description"); description && description->is_string()) {
+                result.description = std::string(description->as_string());
             }
-            if (!success) {
-                if (auto* status = obj.if_contains("status"); status && status->is_object()) {
-                    const auto& statusObj = status->as_object();
-                    if (auto* code = statusObj.if_contains("code"); code && code->is_int64()) {
-                        success = code->as_int64() == 0;
-                    }
-                }
+            if (auto* message = statusObj.if_contains("message"); message && message->is_string()) {
+                result.message = std::string(message->as_string());
             }
-
-            result.success = success;
-            if (result.success) {
-                result.shouldContinue = false;
-                result.shouldUpdate = false;
-                return result;
+            if (auto* code = statusObj.if_contains("code"); code && code->is_int64()) {
+                result.statusCode = static_cast<int>(code->as_int64());
             }
+        }
 
-            bool updateHint = containsKeyword(result.message, kUpdateKeywords) ||
-                (obj.if_contains("isUpdate") && obj.at("isUpdate").is_bool() && obj.at("isUpdate").as_bool());
-            bool retryHint = containsKeyword(result.message, kRetryKeywords) ||
-                (obj.if_contains("isContinue") && obj.at("isContinue").is_bool() && obj.at("isContinue").as_bool());
-
-            result.shouldUpdate = updateHint;
-            result.shouldContinue = retryHint && !updateHint;
+        bool success = false;
+        if (auto* isSuccess = obj.if_contains("isSuccess"); isSuccess && isSuccess->is_int64()) {
+            success = isSuccess->as_int64() == 1;
         }
-        else {
-            result.message = "未知响应";
+        if (!success) {
+            if (auto* status = obj.if_contains("status"); status && status->is_object()) {
+                const auto& statusObj = status->as_object();
+                if (auto* code = statusObj.if_contains("code"); code && code->is_int64()) {
+                    success = code->as_int64() == 0;
+                }
+            }
+        }
+
+        result.success = success;
+        util::domainScoreboard().recordBusy(domain, !success && containsKeyword(result.message, kBusyKeywords));
+        if (result.success) {
             result.shouldContinue = false;
+            result.shouldUpdate = false;
+            recordCreateOrder(ctx, "success", started);
+            return;
         }
 
+        bool updateHint = containsKeyword(result.message, kUpdateKeywords) ||
+            (obj.if_contains("isUpdate") && obj.at("isUpdate").is_bool() && obj.at("isUpdate").as_bool());
+        bool retryHint = containsKeyword(result.message, kRetryKeywords) ||
+            (obj.if_contains("isContinue") && obj.at("isContinue").is_bool() && obj.at("isContinue").as_bool());
+
+        result.shouldUpdate = updateHint;
+        result.shouldContinue = retryHint && !updateHint;
+        recordCreateOrder(ctx, updateHint ? "update" : (result.shouldContinue ? "retry" : "rejected"), started);
     }
-    catch (const std::exception& ex) {
-        util::log(util::LogLevel::warn, std::string{ "CreateOrder failed: " } + ex.what());
-        result.success = false;
-        result.error = ex.what();
-        result.message.clear();
+    else {
+        result.message = "未知响应";
+        result.shouldContinue = false;
+        recordCreateOrder(ctx, "invalid_response", started);
     }
-
-    return result;
 }
 
 
 GrabResult GrabWorkflow::reConfirmOrder(const GrabContext& ctx, const boost::json::object& payload) {
+    util::TimelineSpan span(ctx.timeline.get(), "reconfirm_order", ctx.domain);
     GrabResult result;
     auto requestBody = quickgrab::util::stringifyJson(payload);
-    auto req = buildPost("https://" + ctx.domain + "/vbuy/ReConfirmOrder/1.0", ctx, toQuery(requestBody));
+    auto req = buildPost("https://" + ctx.domain + "/vbuy/ReConfirmOrder/1.0", ctx, util::toQuery(requestBody));
     bool useProxy = ctx.useProxy;
     std::optional<proxy::ProxyEndpoint> overrideProxy = ctx.assignedProxy;
 
@@ -398,18 +596,23 @@ GrabResult GrabWorkflow::reConfirmOrder(const GrabContext& ctx, const boost::jso
         };
 
         try {
+            const auto sent = std::chrono::system_clock::now();
             auto response = httpClient_.fetch(req,
                                              affinity,
                                              std::chrono::seconds{20},
                                              useProxy,
                                              overrideProxy ? &*overrideProxy : nullptr);
+            const auto received = std::chrono::system_clock::now();
             result.statusCode = static_cast<int>(response.result());
             auto json = quickgrab::util::parseJson(response.body());
             result.attempts = attempt + 1;
+            if (!httpClient_.replaying()) {
+                sampleAccessTime(ctx.domain, sent, received, json);
+            }
 
             if (!json.is_object()) {
                 lastError = "ReConfirmOrder 响应不是 JSON 对象";
-                util::log(util::LogLevel::warn, lastError);
+                QG_LOG_WARN("{}", lastError);
                 if (!scheduleRetry(lastError)) {
                     break;
                 }
@@ -465,25 +668,20 @@ GrabResult GrabWorkflow::reConfirmOrder(const GrabContext& ctx, const boost::jso
             }
 
             lastError = !result.message.empty() ? result.message : "ReConfirmOrder 响应缺少成功结果";
-            util::log(util::LogLevel::warn,
-                      "ReConfirmOrder attempt " + std::to_string(attempt + 1) + " failed: " + lastError);
+            QG_LOG_WARN("ReConfirmOrder attempt {} failed: {}", attempt + 1, lastError);
             if (!scheduleRetry(lastError)) {
                 break;
             }
         } catch (const util::ProxyError& ex) {
-            util::log(util::LogLevel::warn, std::string{"ReConfirmOrder attempt failed: "} + ex.what());
+            QG_LOG_WARN("ReConfirmOrder attempt failed: {}", ex.what());
             bool retried = false;
             if (overrideProxy) {
-                util::log(util::LogLevel::info,
-                          std::string("ReConfirmOrder proxy ") + overrideProxy->host + ":" +
-                              std::to_string(overrideProxy->port) + " failed with status " +
-                              std::to_string(ex.status()) + ", retrying with proxy pool or direct connection");
+                QG_LOG_INFO("ReConfirmOrder proxy {}:{} failed with status {}, retrying with proxy pool or direct connection",
+                            overrideProxy->host, overrideProxy->port, ex.status());
                 overrideProxy.reset();
                 retried = true;
             } else if (useProxy) {
-                util::log(util::LogLevel::info,
-                          std::string("ReConfirmOrder proxy request failed with status ") +
-                              std::to_string(ex.status()) + ", retrying without proxy");
+                QG_LOG_INFO("ReConfirmOrder proxy request failed with status {}, retrying without proxy", ex.status());
                 useProxy = false;
                 retried = true;
             }
@@ -496,7 +694,7 @@ GrabResult GrabWorkflow::reConfirmOrder(const GrabContext& ctx, const boost::jso
                 break;
             }
         } catch (const std::exception& ex) {
-            util::log(util::LogLevel::warn, std::string{"ReConfirmOrder attempt failed: "} + ex.what());
+            QG_LOG_WARN("ReConfirmOrder attempt failed: {}", ex.what());
             lastError = ex.what();
             if (!scheduleRetry(ex.what())) {
                 result.error = ex.what();
@@ -515,32 +713,79 @@ void GrabWorkflow::scheduleExecution(
     GrabContext ctx,
     std::function<void(const GrabResult&)> onFinished
 ) {
-    refreshOrderParameters(ctx);  //先准备一次请求参数，让第一次请求可以直接调用
+    // 离开抢超过一个刷新周期时由后台刷新任务立即拉取参数，布置本身不阻塞在加购页请求上
+    const bool refreshInBackground = refreshConfig_.interval.count() > 0 && !ctx.quickMode &&
+                                     std::chrono::milliseconds(computeDelay(ctx)) > refreshConfig_.interval;
+    {
+        util::TimelineScope scope(ctx.timeline.get());
+        util::TimelineSpan prewarm(ctx.timeline.get(), "prewarm");
+        if (!refreshInBackground) {
+            refreshOrderParameters(ctx);  //先准备一次请求参数，让第一次请求可以直接调用
+        }
+        prepareOrderRequest(ctx);
+    }
     const auto delay_ms = computeDelay(ctx); 
     const auto target_tp = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms);
+    const auto now = std::chrono::steady_clock::now();
+    startParameterRefresh(ctx, target_tp, refreshInBackground ? now : now + refreshConfig_.interval);
+    ctx.timeline->mark("armed", "delay " + std::to_string(delay_ms) + "ms");
 
-    util::log(
-        util::LogLevel::info,
-        "请求ID=" + std::to_string(ctx.request.id) +
-        (ctx.quickMode ? " [快速模式]" : "") +
-        (ctx.steadyOrder ? " [稳定抢购]" : "") +
-        (ctx.autoPick ? " [自动选取]" : "") +
-        " 将在 " + std::to_string(delay_ms) + "ms 后开始抢购"
-    );
+    QG_LOG_INFO("请求ID={}{}{}{} 将在 {}ms 后开始抢购",
+                ctx.request.id,
+                ctx.quickMode ? " [快速模式]" : "",
+                ctx.steadyOrder ? " [稳定抢购]" : "",
+                ctx.autoPick ? " [自动选取]" : "",
+                delay_ms);
 
 
 
     auto timer = std::make_shared<boost::asio::steady_timer>(worker_.get_executor());
-    timer->expires_at(target_tp);
+    scheduledTasks().add(1);
 
+    // 直连时在开抢前 kConnectionWarmLead 建好到 thor 的 TLS 连接，首个 CreateOrder 免去解析与握手；
+    // 走代理或不足 kConnectionWarmLead 时照常处理（后者由定时器立即触发预热）
+    const bool warmable = (ctx.preparedOrder || ctx.freshParameters) && !ctx.useProxy && !ctx.assignedProxy;
+    if (!warmable) {
+        armFire(std::move(ctx), std::move(onFinished), std::move(timer), target_tp);
+        return;
+    }
+    timer->expires_at(target_tp - kConnectionWarmLead);
     timer->async_wait(
-        [this, ctx = std::move(ctx), onFinished = std::move(onFinished), timer]
+        [this, ctx = std::move(ctx), onFinished = std::move(onFinished), timer, target_tp]
         (const boost::system::error_code& ec) mutable {
+            if (!ec) {
+                util::TimelineScope scope(ctx.timeline.get());
+                warmConnection(ctx);
+            }
+            armFire(std::move(ctx), std::move(onFinished), timer, target_tp);
+        }
+    );
+}
+
+void GrabWorkflow::armFire(
+    GrabContext ctx,
+    std::function<void(const GrabResult&)> onFinished,
+    TimerPtr timer,
+    std::chrono::steady_clock::time_point target_tp
+) {
+    timer->expires_at(target_tp);
+    timer->async_wait(
+        [this, ctx = std::move(ctx), onFinished = std::move(onFinished), timer, target_tp]
+        (const boost::system::error_code& ec) mutable {
+            const auto fired = std::chrono::steady_clock::now();
+            if (!ec && fireProbe_) {
+                fireProbe_(false);
+            }
+            scheduledTasks().add(-1);
             if (ec) {
+                if (ctx.freshParameters) {
+                    ctx.freshParameters->finished.store(true, std::memory_order_release);
+                }
                 GrabResult cancelled;
                 cancelled.success = false;
                 cancelled.statusCode = 499;
                 cancelled.message = ec.message();
+                cancelled.timeline = ctx.timeline;
                 boost::asio::post(
                     io_,
                     [onFinished = std::move(onFinished), cancelled]() mutable {
@@ -550,15 +795,15 @@ void GrabWorkflow::scheduleExecution(
                 return;
             }
 
+            util::TimelineScope scope(ctx.timeline.get());
+            RunningTaskScope running;
+
             // 由于定时器绑定到了 worker_ 的执行器，抢购流程从延时等待开始便已经在工作线程
             // 上排队执行。这样可以确保单个请求在 worker_ 池中始终只占用一个线程，避免了
             // 先由 io_context 线程触发再切换到 worker_ 造成的双重占用问题。
 
             // 首次下单：固定 thor
-            GrabContext mainCtx = ctx;
-            mainCtx.domain = "thor.weidian.com";
-
-            auto result = createOrder(mainCtx, ctx.request.orderParameters.as_object());
+            auto result = fireCreateOrder(ctx, fired, target_tp);
             if (result.success) {
                 result.statusCode = 1;
             }
@@ -580,22 +825,33 @@ void GrabWorkflow::scheduleExecution(
 
                     // 先 reConfirm，再视结果刷新参数
                     auto confirm = reConfirmOrder(ctx, ctx.request.orderParameters.as_object());
-                    if (confirm.success && confirm.response.is_object()) {
-                        refreshOrderParameters(ctx);
-                    }
+                    // 失败之后后台刷新已完成：直接取用新参数，重试立即发出；
+                    // 否则手里仍是刚被拒绝的参数，照旧现场刷新并节流，同时让后台立即再拉一次
+                    if (!adoptRefreshedParameters(ctx)) {
+                        if (ctx.freshParameters && ctx.freshParameters->refreshNow) {
+                            ctx.freshParameters->refreshNow();
+                        }
+                        if (confirm.success && confirm.response.is_object()) {
+                            util::TimelineSpan refresh(ctx.timeline.get(), "refresh_parameters");
+                            if (refreshOrderParameters(ctx) && ctx.freshParameters) {
+                                // 现场刷新的参数比槽中现有版本新，之后只取用在此之后完成的刷新
+                                std::lock_guard<std::mutex> lock(ctx.freshParameters->mutex);
+                                ctx.parametersVersion = ctx.freshParameters->version;
+                            }
+                            prepareOrderRequest(ctx);
+                        }
 
-                    // 稳定节流：确保“确认→下单”至少 1s
-                    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                        std::chrono::steady_clock::now() - attemptStart);
-                    if (elapsed.count() < 1000) {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(1000 - elapsed.count()));
+                        // 稳定节流：确保“确认→下单”至少 1s
+                        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - attemptStart);
+                        if (elapsed.count() < 1000) {
+                            util::TimelineSpan throttle(ctx.timeline.get(), "throttle");
+                            std::this_thread::sleep_for(std::chrono::milliseconds(1000 - elapsed.count()));
+                        }
                     }
 
                     // 更新域名（容灾/分流）
-                    GrabContext updatedCtx = ctx;
-                    updatedCtx.domain = randomDomain(ctx.extension);
-
-                    result = createOrder(updatedCtx, ctx.request.orderParameters.as_object());
+                    result = createOrder(ctx, pickDomain(ctx.extension), ctx.request.orderParameters.as_object());
                     if (!result.success) result.statusCode = 2;
 
                 }
@@ -611,9 +867,13 @@ void GrabWorkflow::scheduleExecution(
                         delayMs += dist(rng);
                         if (delayMs < 0) delayMs = 0;
                     }
-                    std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+                    {
+                        util::TimelineSpan backoff(ctx.timeline.get(), "backoff");
+                        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+                    }
 
-                    result = createOrder(ctx, ctx.request.orderParameters.as_object());
+                    adoptRefreshedParameters(ctx);
+                    result = createOrder(ctx, ctx.domain, ctx.request.orderParameters.as_object());
                     if (!result.success) result.statusCode = 2;
 
                     // 指数退避推进（仅在普通重试连续时推进；若 next 次进入更新分支会被重置）
@@ -636,6 +896,10 @@ void GrabWorkflow::scheduleExecution(
                 ++attemptCount;
             }
 
+            if (ctx.freshParameters) {
+                ctx.freshParameters->finished.store(true, std::memory_order_release);
+            }
+
             // 补充统计信息
             if (result.response.is_object()) {
                 auto& responseObj = result.response.as_object();
@@ -646,6 +910,7 @@ void GrabWorkflow::scheduleExecution(
             }
             if (!result.success) result.statusCode = 3; // 最终失败再标
             result.attempts = attemptCount;
+            result.timeline = ctx.timeline;
 
             // 切回 io_ 执行回调
             boost::asio::post(
@@ -662,27 +927,30 @@ void GrabWorkflow::schedulePick(
     GrabContext ctx,
     std::function<void(const GrabResult&)> onFinished
 ) {
-    util::log(
-        util::LogLevel::info,
-        "请求ID=" + std::to_string(ctx.request.id) +
-            (ctx.quickMode ? " [快速模式]" : "") +
-            " [捡漏] 即刻开始执行"
-    );
+    QG_LOG_INFO("请求ID={}{} [捡漏] 即刻开始执行", ctx.request.id, ctx.quickMode ? " [快速模式]" : "");
 
-    refreshOrderParameters(ctx);
+    {
+        util::TimelineScope scope(ctx.timeline.get());
+        util::TimelineSpan prewarm(ctx.timeline.get(), "prewarm");
+        refreshOrderParameters(ctx);
+    }
+    ctx.timeline->mark("armed", "pick");
 
     auto timer = std::make_shared<boost::asio::steady_timer>(worker_.get_executor());
     timer->expires_after(std::chrono::milliseconds(0));
 
+    scheduledTasks().add(1);
     timer->async_wait(
         [this, ctx = std::move(ctx), onFinished = std::move(onFinished), timer]
         (const boost::system::error_code& ec) mutable {
+            scheduledTasks().add(-1);
             if (ec) {
                 GrabResult cancelled;
                 cancelled.success = false;
                 //cancelled.statusCode = 499;
                 cancelled.statusCode = 3;
                 cancelled.message = ec.message();
+                cancelled.timeline = ctx.timeline;
                 boost::asio::post(
                     io_,
                     [onFinished = std::move(onFinished), cancelled]() mutable {
@@ -692,6 +960,9 @@ void GrabWorkflow::schedulePick(
                 return;
             }
 
+            util::TimelineScope scope(ctx.timeline.get());
+            ctx.timeline->mark("fire", "pick");
+            RunningTaskScope running;
             GrabResult finalResult;
             finalResult.success = false;
             finalResult.shouldContinue = false;
@@ -708,9 +979,7 @@ void GrabWorkflow::schedulePick(
                             paramsObj = ctx.request.orderParameters.if_object();
                         }
                     } catch (const std::exception& ex) {
-                        util::log(util::LogLevel::warn,
-                                  "请求ID=" + std::to_string(ctx.request.id) +
-                                      " 解析订单参数失败: " + ex.what());
+                        QG_LOG_WARN("请求ID={} 解析订单参数失败: {}", ctx.request.id, ex.what());
                     }
                 }
 
@@ -779,8 +1048,7 @@ void GrabWorkflow::schedulePick(
 
                 int frequency = ctx.request.frequency;
                 frequency = std::max(frequency - 150, 100);
-                util::log(util::LogLevel::info,
-                          "请求ID=" + std::to_string(ctx.request.id) + " 检查商品库存");
+                QG_LOG_INFO("请求ID={} 检查商品库存", ctx.request.id);
 
                 bool useProxy = ctx.useProxy;
                 std::optional<proxy::ProxyEndpoint> overrideProxy = ctx.assignedProxy;
@@ -810,20 +1078,15 @@ void GrabWorkflow::schedulePick(
                                                               overrideProxy ? &*overrideProxy : nullptr);
                             return quickgrab::util::parseJson(response.body());
                         } catch (const util::ProxyError& ex) {
-                            util::log(util::LogLevel::warn,
-                                      "请求ID=" + std::to_string(ctx.request.id) + " " + std::string(action) +
-                                          " 失败: " + ex.what());
+                            QG_LOG_WARN("请求ID={} {} 失败: {}", ctx.request.id, action, ex.what());
                             bool retried = false;
                             if (overrideProxy) {
-                                util::log(util::LogLevel::info,
-                                          "请求ID=" + std::to_string(ctx.request.id) + " 指定代理 " + overrideProxy->host +
-                                              ":" + std::to_string(overrideProxy->port) + " 失效，将尝试代理池或直连");
+                                QG_LOG_INFO("请求ID={} 指定代理 {}:{} 失效，将尝试代理池或直连",
+                                            ctx.request.id, overrideProxy->host, overrideProxy->port);
                                 overrideProxy.reset();
                                 retried = true;
                             } else if (useProxy) {
-                                util::log(util::LogLevel::info,
-                                          "请求ID=" + std::to_string(ctx.request.id) +
-                                              " 代理请求失败，将改为直连重试");
+                                QG_LOG_INFO("请求ID={} 代理请求失败，将改为直连重试", ctx.request.id);
                                 useProxy = false;
                                 retried = true;
                             }
@@ -831,9 +1094,7 @@ void GrabWorkflow::schedulePick(
                                 return std::nullopt;
                             }
                         } catch (const std::exception& ex) {
-                            util::log(util::LogLevel::warn,
-                                      "请求ID=" + std::to_string(ctx.request.id) + " " + std::string(action) +
-                                          " 异常: " + ex.what());
+                            QG_LOG_WARN("请求ID={} {} 异常: {}", ctx.request.id, action, ex.what());
                             return std::nullopt;
                         }
                     }
@@ -847,25 +1108,25 @@ void GrabWorkflow::schedulePick(
                     payload["skuId"] = skuIdValue;
                     payload["count"] = quantity;
                     auto jsonPayload = quickgrab::util::stringifyJson(payload);
-                    return "https://" + domain + "/vcart/addCart/2.0?" + toQuery(jsonPayload);
+                    return "https://" + domain + "/vcart/addCart/2.0?" + util::toQuery(jsonPayload);
                 };
 
                 auto buildSkuInfoUrl = [&](const std::string& domain) {
                     boost::json::object payload;
                     payload["itemId"] = *itemId;
                     auto jsonPayload = quickgrab::util::stringifyJson(payload);
-                    return "https://" + domain + "/detailmjb/getItemSkuInfo/1.0?" + toQuery(jsonPayload);
+                    return "https://" + domain + "/detailmjb/getItemSkuInfo/1.0?" + util::toQuery(jsonPayload);
                 };
 
                 GrabContext createCtx = ctx;
-                createCtx.domain = randomDomain(ctx.extension);
+                createCtx.domain = pickDomain(ctx.extension);
 
                 int count = 0;
                 bool virtualItem = false;
                 std::optional<GrabResult> pickResult;
 
                 while (std::chrono::system_clock::now() < endTime) {
-                    auto inventoryUrl = buildInventoryUrl(randomDomain(ctx.extension));
+                    auto inventoryUrl = buildInventoryUrl(pickDomain(ctx.extension));
                     auto inventory = fetchJson(inventoryUrl, std::chrono::seconds{20}, "获取商品库存");
                     if (inventory && inventory->is_object()) {
                         const auto& invObj = inventory->as_object();
@@ -878,19 +1139,17 @@ void GrabWorkflow::schedulePick(
                         }
 
                         if (statusCode == 12) {
-                            util::log(util::LogLevel::info,
-                                      "请求ID=" + std::to_string(ctx.request.id) + " 商品不支持加购物车，尝试虚拟库存流程");
+                            QG_LOG_INFO("请求ID={} 商品不支持加购物车，尝试虚拟库存流程", ctx.request.id);
                             virtualItem = true;
                             break;
                         }
 
                         if (statusCode == 0 || statusCode == 3) {
-                            util::log(util::LogLevel::info,
-                                      "请求ID=" + std::to_string(ctx.request.id) + " 商品有货，尝试下单");
+                            QG_LOG_INFO("请求ID={} 商品有货，尝试下单", ctx.request.id);
                             createCtx.useProxy = useProxy;
                             createCtx.assignedProxy = overrideProxy;
                             createCtx.proxyAffinity = affinity;
-                            auto attempt = createOrder(createCtx, *paramsObj);
+                            auto attempt = createOrder(createCtx, createCtx.domain, *paramsObj);
                             if (attempt.success) {
                                 attempt.statusCode = 1;
                             }
@@ -914,8 +1173,7 @@ void GrabWorkflow::schedulePick(
                             }
                         }
                     } else {
-                        util::log(util::LogLevel::warn,
-                                  "请求ID=" + std::to_string(ctx.request.id) + " 获取商品库存失败");
+                        QG_LOG_WARN("请求ID={} 获取商品库存失败", ctx.request.id);
                     }
 
                     ++count;
@@ -924,7 +1182,7 @@ void GrabWorkflow::schedulePick(
 
                 if (virtualItem && std::chrono::system_clock::now() < endTime && !pickResult) {
                     while (std::chrono::system_clock::now() < endTime) {
-                        auto skuInfoUrl = buildSkuInfoUrl(randomDomain(ctx.extension));
+                        auto skuInfoUrl = buildSkuInfoUrl(pickDomain(ctx.extension));
                         auto skuInfo = fetchJson(skuInfoUrl, std::chrono::seconds{20}, "获取虚拟库存信息");
                         if (skuInfo && skuInfo->is_object()) {
                             const auto& skuRoot = skuInfo->as_object();
@@ -965,12 +1223,11 @@ void GrabWorkflow::schedulePick(
                             }
 
                             if (stock > 0) {
-                                util::log(util::LogLevel::info,
-                                          "请求ID=" + std::to_string(ctx.request.id) + " 虚拟商品有库存，尝试下单");
+                                QG_LOG_INFO("请求ID={} 虚拟商品有库存，尝试下单", ctx.request.id);
                                 createCtx.useProxy = useProxy;
                                 createCtx.assignedProxy = overrideProxy;
                                 createCtx.proxyAffinity = affinity;
-                                auto attempt = createOrder(createCtx, *paramsObj);
+                                auto attempt = createOrder(createCtx, createCtx.domain, *paramsObj);
                                 if (attempt.success) {
                                     attempt.statusCode = 1;
                                 }
@@ -994,8 +1251,7 @@ void GrabWorkflow::schedulePick(
                                 }
                             }
                         } else {
-                            util::log(util::LogLevel::warn,
-                                      "请求ID=" + std::to_string(ctx.request.id) + " 获取虚拟库存失败");
+                            QG_LOG_WARN("请求ID={} 获取虚拟库存失败", ctx.request.id);
                         }
 
                         ++count;
@@ -1004,14 +1260,12 @@ void GrabWorkflow::schedulePick(
                 }
 
                 if (pickResult) {
-                    util::log(util::LogLevel::info,
-                              "请求ID=" + std::to_string(ctx.request.id) + " 捡漏结束");
+                    QG_LOG_INFO("请求ID={} 捡漏结束", ctx.request.id);
                     finalResult = std::move(*pickResult);
                     break;
                 }
 
-                util::log(util::LogLevel::info,
-                          "请求ID=" + std::to_string(ctx.request.id) + " 捡漏超时");
+                QG_LOG_INFO("请求ID={} 捡漏超时", ctx.request.id);
                 boost::json::object status;
                 status["code"] = 400;
                 status["message"] = "抢购失败";
@@ -1023,6 +1277,7 @@ void GrabWorkflow::schedulePick(
                 finalResult.message = "捡漏超时";
                 finalResult.attempts = count;
             } while (false);
+            finalResult.timeline = ctx.timeline;
 
             boost::asio::post(
                 io_,
@@ -1036,18 +1291,16 @@ void GrabWorkflow::schedulePick(
 
 
 
-void GrabWorkflow::refreshOrderParameters(GrabContext& ctx) {
+bool GrabWorkflow::refreshOrderParameters(GrabContext& ctx) {
     if (ctx.quickMode) {
-        util::log(util::LogLevel::info,
-                  "请求ID=" + std::to_string(ctx.request.id) + " 使用快速模式，跳过重新生成订单参数");
-        return;
+        QG_LOG_INFO("请求ID={} 使用快速模式，跳过重新生成订单参数", ctx.request.id);
+        return false;
     }
 
     auto dataObj = fetchAddOrderData(ctx);
     if (!dataObj) {
-        util::log(util::LogLevel::warn,
-                  "请求ID=" + std::to_string(ctx.request.id) + " 无法获取下单数据，将尝试使用已有参数");
-        return;
+        QG_LOG_WARN("请求ID={} 无法获取下单数据，将尝试使用已有参数", ctx.request.id);
+        return false;
     }
 
     const auto& root = *dataObj;
@@ -1063,14 +1316,109 @@ void GrabWorkflow::refreshOrderParameters(GrabContext& ctx) {
 
     auto orderParams = quickgrab::util::generateOrderParameters(ctx.request, *result, true);
     if (!orderParams) {
-        util::log(util::LogLevel::warn,
-                  "请求ID=" + std::to_string(ctx.request.id) + " 解析下单数据失败，将尝试使用已有参数");
-        return;
+        QG_LOG_WARN("请求ID={} 解析下单数据失败，将尝试使用已有参数", ctx.request.id);
+        return false;
     }
 
     ctx.request.orderParameters = *orderParams;
     ctx.request.orderParametersRaw = quickgrab::util::stringifyJson(*orderParams);
+    return true;
+}
+
+void GrabWorkflow::prepareOrderRequest(GrabContext& ctx) const {
+    const auto* payload = ctx.request.orderParameters.if_object();
+    if (!payload) {
+        ctx.preparedOrder.reset();
+        return;
+    }
+    ctx.preparedOrder = std::make_shared<const util::PreparedRequest>(
+        buildPost("https://" + kFireDomain + "/vbuy/CreateOrder/1.0", ctx,
+                  util::toQuery(quickgrab::util::stringifyJson(*payload))));
+}
+
+void GrabWorkflow::startParameterRefresh(GrabContext& ctx,
+                                         std::chrono::steady_clock::time_point fireAt,
+                                         std::chrono::steady_clock::time_point first) {
+    if (refreshConfig_.interval.count() <= 0 || ctx.quickMode) {
+        return;
+    }
+    auto slot = std::make_shared<OrderParametersSlot>();
+    slot->parameters = ctx.request.orderParameters;
+    slot->prepared = ctx.preparedOrder;
+    ctx.freshParameters = slot;
+    ctx.parametersVersion = 0;
+
+    auto refresh = std::make_shared<ParameterRefresh>(refreshPool_.get_executor());
+    refresh->ctx = ctx;
+    refresh->ctx.timeline.reset();
+    refresh->ctx.freshParameters.reset();
+    refresh->slot = slot;
+    refresh->fireAt = fireAt;
+    // 只持有弱引用：刷新链结束后槽不再让它存活
+    slot->refreshNow = [this, weak = std::weak_ptr<ParameterRefresh>(refresh)] {
+        auto refresh = weak.lock();
+        if (!refresh) {
+            return;
+        }
+        boost::asio::post(refresh->strand, [this, refresh, requested = std::chrono::steady_clock::now()] {
+            // 请求之后已完成过一次刷新（例如正在进行的那次）则不必重复
+            if (refresh->lastRefreshed < requested) {
+                scheduleParameterRefresh(refresh, requested);
+            }
+        });
+    };
+    boost::asio::post(refresh->strand, [this, refresh, first] { scheduleParameterRefresh(refresh, first); });
+}
 
+void GrabWorkflow::scheduleParameterRefresh(std::shared_ptr<ParameterRefresh> refresh,
+                                            std::chrono::steady_clock::time_point next) {
+    // 开抢前 guard 内不刷新，顺延到开抢时刻，开抢瞬间不与首单争抢网络
+    if (next >= refresh->fireAt - refreshConfig_.guard && next < refresh->fireAt) {
+        next = refresh->fireAt;
+    }
+    if (next > refresh->fireAt + kRefreshAfterFire) {
+        return;
+    }
+    const auto generation = ++refresh->generation;
+    refresh->timer.expires_at(next);
+    refresh->timer.async_wait([this, refresh, generation](const boost::system::error_code& ec) {
+        if (ec || generation != refresh->generation || refresh->slot->finished.load(std::memory_order_acquire)) {
+            return;
+        }
+        if (refreshOrderParameters(refresh->ctx)) {
+            prepareOrderRequest(refresh->ctx);
+            std::lock_guard<std::mutex> lock(refresh->slot->mutex);
+            refresh->slot->parameters = refresh->ctx.request.orderParameters;
+            refresh->slot->prepared = refresh->ctx.preparedOrder;
+            ++refresh->slot->version;
+        }
+        refresh->lastRefreshed = std::chrono::steady_clock::now();
+        scheduleParameterRefresh(refresh, refresh->lastRefreshed + refreshConfig_.interval);
+    });
+}
+
+bool GrabWorkflow::adoptRefreshedParameters(GrabContext& ctx) const {
+    if (!ctx.freshParameters) {
+        return false;
+    }
+    auto& slot = *ctx.freshParameters;
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (slot.version <= ctx.parametersVersion) {
+        return false;
+    }
+    ctx.request.orderParameters = slot.parameters;
+    ctx.preparedOrder = slot.prepared;
+    ctx.parametersVersion = slot.version;
+    return true;
+}
+
+void GrabWorkflow::warmConnection(GrabContext& ctx) {
+    util::TimelineSpan span(ctx.timeline.get(), "warm_connection", kFireDomain);
+    try {
+        ctx.warmConnection = httpClient_.warmUp(kFireDomain, std::chrono::seconds{5});
+    } catch (const std::exception& ex) {
+        QG_LOG_WARN("请求ID={} 预热连接失败，开抢时新建连接: {}", ctx.request.id, ex.what());
+    }
 }
 
 std::optional<boost::json::object> GrabWorkflow::fetchAddOrderData(const GrabContext& ctx) const {
@@ -1087,22 +1435,21 @@ std::optional<boost::json::object> GrabWorkflow::fetchAddOrderData(const GrabCon
     try {
         for (int attempt = 0; attempt < 2; ++attempt) {
             try {
-                util::log(
-                    util::LogLevel::info,
-                    "请求ID=" + std::to_string(ctx.request.id) +
-                    " 开始获取订单参数"
-                    ", affinity=" + affinity +
-                    ", useProxy=" + (useProxy ? "true" : "false") +
-                    (overrideProxy
-                        ? (", overrideProxy=" + overrideProxy->host + ":" + std::to_string(overrideProxy->port))
-                        : ", overrideProxy=<none>") +
-                    ", timeout=30s, maxRedirects=5"
-                );
+                if (overrideProxy) {
+                    QG_LOG_INFO("请求ID={} 开始获取订单参数, affinity={}, useProxy={}, overrideProxy={}:{}, "
+                                "timeout=30s, maxRedirects=5",
+                                ctx.request.id, affinity, useProxy, overrideProxy->host, overrideProxy->port);
+                } else {
+                    QG_LOG_INFO("请求ID={} 开始获取订单参数, affinity={}, useProxy={}, overrideProxy=<none>, "
+                                "timeout=30s, maxRedirects=5",
+                                ctx.request.id, affinity, useProxy);
+                }
 
+                if (util::isEnabled(util::LogLevel::debug)) {
                     for (const auto& h : headers) {
-                        util::log(util::LogLevel::debug, "请求ID=" + std::to_string(ctx.request.id) +
-                            " header: " + h.name + " = " + h.value);
+                        QG_LOG_DEBUG("请求ID={} header: {} = {}", ctx.request.id, h.name, h.value);
                     }
+                }
                 const auto t0 = std::chrono::steady_clock::now();
                 auto response = httpClient_.fetch("GET",
                                                   ctx.request.link,
@@ -1118,30 +1465,22 @@ std::optional<boost::json::object> GrabWorkflow::fetchAddOrderData(const GrabCon
                 const auto t1 = std::chrono::steady_clock::now();
                 const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
 
-                quickgrab::util::log(quickgrab::util::LogLevel::info,
-                    std::string("HTTP fetch ok: ") + ctx.request.link +
-                    " cost=" + std::to_string(ms) + " ms");
+                QG_LOG_INFO("HTTP fetch ok: {} cost={} ms", ctx.request.link, ms);
                 auto data = util::extractDataObject(response.body());
                 if (!data || !data->is_object()) {
                     return std::nullopt;
                 }
                 return data->as_object();
             } catch (const util::ProxyError& ex) {
-                util::log(util::LogLevel::warn,
-                          std::string{"请求ID="} + std::to_string(ctx.request.id) +
-                              " 获取下单页面失败: " + ex.what());
+                QG_LOG_WARN("请求ID={} 获取下单页面失败: {}", ctx.request.id, ex.what());
                 bool retried = false;
                 if (overrideProxy) {
-                    util::log(util::LogLevel::info,
-                              std::string{"请求ID="} + std::to_string(ctx.request.id) + " 指定代理 " + overrideProxy->host +
-                                  ":" + std::to_string(overrideProxy->port) + " 失败(" +
-                                  std::to_string(ex.status()) + "), 将尝试代理池或直连重试获取下单页面");
+                    QG_LOG_INFO("请求ID={} 指定代理 {}:{} 失败({}), 将尝试代理池或直连重试获取下单页面",
+                                ctx.request.id, overrideProxy->host, overrideProxy->port, ex.status());
                     overrideProxy.reset();
                     retried = true;
                 } else if (useProxy) {
-                    util::log(util::LogLevel::info,
-                              std::string{"请求ID="} + std::to_string(ctx.request.id) +
-                                  " 代理连接失败(" + std::to_string(ex.status()) + "), 将改用直连重试获取下单页面");
+                    QG_LOG_INFO("请求ID={} 代理连接失败({}), 将改用直连重试获取下单页面", ctx.request.id, ex.status());
                     useProxy = false;
                     retried = true;
                 }
@@ -1151,14 +1490,10 @@ std::optional<boost::json::object> GrabWorkflow::fetchAddOrderData(const GrabCon
             }
         }
     } catch (const util::ProxyError& ex) {
-        util::log(util::LogLevel::warn,
-                  std::string{"请求ID="} + std::to_string(ctx.request.id) +
-                      " 获取下单页面失败: " + ex.what());
+        QG_LOG_WARN("请求ID={} 获取下单页面失败: {}", ctx.request.id, ex.what());
         return std::nullopt;
     } catch (const std::exception& ex) {
-        util::log(util::LogLevel::warn,
-                  std::string{"请求ID="} + std::to_string(ctx.request.id) +
-                      " 获取下单页面失败: " + ex.what());
+        QG_LOG_WARN("请求ID={} 获取下单页面失败: {}", ctx.request.id, ex.what());
         return std::nullopt;
     }
 
@@ -5,12 +5,18 @@ class ListHandler {
             containerId: '',
             fetchUrl: '',
             isRequest: false,
+            detailUrl: '',
             limit: 15,
             ...options
         };
 
         this.offset = 0;
+        this.cursor = '';
+        this.exhausted = false;
         this.loading = false;
+        this.items = new Map();
+        this.eventSource = null;
+        this.refreshTimer = null;
 
         // 绑定事件处理器
         this.bindEvents();
@@ -24,6 +30,7 @@ class ListHandler {
         this.fetchBuyers()
             .then(() => {
                 this.fetchItems();
+                this.subscribeEvents();
             })
             .catch(error => console.error('Error during initialization:', error));
     }
@@ -38,6 +45,12 @@ class ListHandler {
             }
         });
 
+        // 切换买家后按新的买家重新订阅
+        const buyerSelect = document.getElementById('buyerSelect');
+        if (buyerSelect) {
+            buyerSelect.addEventListener('change', () => this.subscribeEvents());
+        }
+
         // 绑定滚动事件
         const container = document.getElementById(this.options.containerId);
         if (container) {
@@ -79,9 +92,80 @@ class ListHandler {
         }
     }
 
+    // 订阅服务端推送的抢购事件，替代轮询
+    subscribeEvents() {
+        if (typeof EventSource === 'undefined') return;
+        if (this.eventSource) {
+            this.eventSource.close();
+        }
+
+        const buyerId = document.getElementById('buyerSelect').value;
+        const query = buyerId ? `?buyerId=${encodeURIComponent(buyerId)}` : '';
+        this.eventSource = new EventSource(`/api/events${query}`);
+
+        if (this.options.isRequest) {
+            this.eventSource.addEventListener('request', (e) => this.onRequestEvent(JSON.parse(e.data)));
+            this.eventSource.addEventListener('request_removed', (e) => this.removeItem(JSON.parse(e.data).requestId));
+        } else {
+            this.eventSource.addEventListener('result', () => this.scheduleRefresh());
+        }
+    }
+
+    // 已渲染的请求原地更新状态，新请求则刷新列表
+    onRequestEvent(event) {
+        const item = this.items.get(event.requestId);
+        if (!item) {
+            this.scheduleRefresh();
+            return;
+        }
+        item.status = event.status;
+        const container = document.getElementById(this.options.containerId);
+        const element = container && container.querySelector(`[data-id="${event.requestId}"] .status-indicator`);
+        if (element) {
+            element.className = `status-indicator ${this.options.getStatusClass(event.status)}`;
+            element.textContent = this.options.getStatusText(event.status);
+        }
+    }
+
+    removeItem(id) {
+        this.items.delete(id);
+        const container = document.getElementById(this.options.containerId);
+        const element = container && container.querySelector(`[data-id="${id}"]`);
+        if (element) {
+            element.remove();
+        }
+    }
+
+    // 列表只有摘要字段，点击时按 id 加载完整记录
+    async openDetails(item) {
+        if (!this.options.detailUrl) {
+            window.showDetails(item);
+            return;
+        }
+        try {
+            const response = await fetch(`${this.options.detailUrl}/${item.id}`);
+            if (!response.ok) throw new Error(`HTTP ${response.status}`);
+            window.showDetails(await response.json());
+        } catch (error) {
+            console.error('加载详情失败:', error);
+        }
+    }
+
+    // 短时间内的多条事件合并为一次刷新
+    scheduleRefresh() {
+        if (this.refreshTimer) return;
+        this.refreshTimer = setTimeout(() => {
+            this.refreshTimer = null;
+            this.resetAndFetch();
+        }, 1000);
+    }
+
     // 重置并获取数据
     resetAndFetch() {
         this.offset = 0;
+        this.cursor = '';
+        this.exhausted = false;
+        this.items.clear();
         document.getElementById(this.options.containerId).innerHTML = '';
         this.fetchItems();
     }
@@ -94,24 +178,29 @@ class ListHandler {
             status: document.getElementById('status').value,
             keyword: document.getElementById('keywordInput').value,
             order: document.getElementById('order').value,
-            offset: this.offset,
+            // 键集分页：服务端只返回列表摘要，详情点击时再加载
+            view: 'summary',
+            cursor: this.cursor,
             limit: this.options.limit
         };
     }
 
     // 获取列表数据
     async fetchItems() {
-        if (this.loading) return;
+        if (this.loading || this.exhausted) return;
         this.loading = true;
 
         try {
             const query = new URLSearchParams(this.getQueryParams());
             const response = await fetch(`${this.options.fetchUrl}?${query.toString()}`);
             const data = await response.json();
+            const items = Array.isArray(data) ? data : (data.items || []);
 
-            this.renderItems(data);
+            this.renderItems(items);
 
-            this.offset += this.options.limit;
+            this.offset += items.length;
+            this.cursor = data.nextCursor || '';
+            this.exhausted = !data.nextCursor;
             this.loading = false;
         } catch (error) {
             console.error('查询失败:', error);
@@ -160,6 +249,8 @@ class ListHandler {
                 ? `${nickName}-${orderNote}`
                 : nickName;
 
+            this.items.set(item.id, item);
+
             const itemElement = document.createElement('div');
             itemElement.className = 'result-item';
             itemElement.setAttribute('data-id', item.id);
@@ -182,7 +273,7 @@ class ListHandler {
             // 使用事件委托来处理点击事件
             itemElement.addEventListener('click', (e) => {
                 if (e.target && !e.target.closest('.no-details')) {
-                    window.showDetails(item);
+                    this.openDetails(item);
                 }
             });
 